@@ -0,0 +1,768 @@
+/// @file
+/// @brief Benchmarks of solver, parsers and printers
+///
+/// Usage: bench.exe [-n equations] [-r repetitions] [-w warmup] [--seed N] [--filter substring]
+///                  [-o report.json] [--tag label] [--dir directory for temporary files]
+///
+/// Human-readable table is printed to stderr, JSON report is written to file. <br>
+/// stdout is redirected to null device, so printing benchmarks measure formatting, not terminal
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "quadraticSolver.h"
+#include "quadraticPrinter.h"
+#include "inputHandler.h"
+#include "unitTester.h"
+#include "utils.h"
+#include "genericSolver.h"
+#include "batchSolver.h"
+#include "preciseSolver.h"
+#include "resultCache.h"
+#include "batchDedup.h"
+#include "asyncIO.h"
+#include "polynomialSolver.h"
+#include "batchProcessor.h"
+#include "simdKernels.h"
+#include "sweepSolver.h"
+#include "planeMap.h"
+#include "inputClassifier.h"
+#include "mappedFile.h"
+#include "kvbFormat.h"
+#include "benchmark.h"
+
+#ifdef _WIN32
+const char NULL_DEVICE[] = "NUL";
+#else
+const char NULL_DEVICE[] = "/dev/null";
+#endif
+
+/// @brief Printing is much slower than solving, so it is measured on part of data
+const size_t PRINT_DIVIDER = 16;
+
+/// @brief Fixed coefficients and length of range of c in sweep benchmarks
+const double SWEEP_BENCH_A = 1.37, SWEEP_BENCH_B = -2.9, SWEEP_BENCH_RANGE = 100;
+
+/// @brief Rows of plane in plane benchmark, columns are count / PLANE_BENCH_ROWS
+const size_t PLANE_BENCH_ROWS = 256;
+
+/// @brief Maximum length of file name with work directory
+const size_t MAX_PATH_LEN = 512;
+
+
+/// @brief Data shared by all benchmarks, generated once from seed
+typedef struct benchData {
+    size_t count;                       ///< Number of equations
+    quadraticEquation_t *equations;     ///< Equations for scalar solver and printers
+    quadraticBatch_t batch;             ///< The same equations as columns
+    quadraticBatchF_t batchF;           ///< The same equations rounded to float
+    polynomialBatch_t cubics;           ///< Random cubic equations
+    polynomialBatch_t quartics;         ///< Random quartic equations
+    sweep_t sweep;                      ///< Sweep of c with count points
+    quadraticBatch_t sweepBatch;        ///< Columns of sweep, a and b hold its fixed coefficients
+
+    char *numbers;                      ///< Coefficients as strings, MAX_NUMBER_LEN bytes for each
+    char **cmdArgs;                     ///< Pointers to numbers, 3 per equation, like argv
+
+    char *text;                         ///< Lines "a b c"
+    size_t textSize;                    ///< Size of text
+    char *tests;                        ///< Unit tests in file format
+    size_t testsSize;                   ///< Size of tests
+
+    char *lines;                        ///< Buffer for formatted result lines
+    uint64_t *maskBuffer;               ///< Three masks of classifyColumns() in one allocation
+    uint64_t *packedCodes;              ///< Packed column of classifyEquationsPacked()
+    resultCache_t *cache;               ///< Cache big enough for all equations, after warmup only hits are measured
+    dedupBuffer_t dedup;                ///< Buffer for blocks of deduplication
+    char textFile[MAX_PATH_LEN];        ///< Temporary file with text
+    char testsFile[MAX_PATH_LEN];       ///< Temporary file with unit tests
+    char kvbFile[MAX_PATH_LEN];         ///< Temporary .kvb file with coefficients
+    char kvbOutFile[MAX_PATH_LEN];      ///< Temporary .kvb file with results
+    plane_t plane;                      ///< Plane of b and c with count points
+    char planeFile[MAX_PATH_LEN];       ///< Temporary .pgm file with map of plane
+
+    FILE *nullStream;                   ///< Null device for text output
+    double sink;                        ///< Results are accumulated here, so compiler can't remove work
+} benchData_t;
+
+
+/// @brief Benchmark of one batch kernel
+typedef struct kernelBench {
+    benchData_t *data;
+    batchKernel_t kernel;
+    batchKernelF_t kernelF;     ///< Single-precision kernel of the same type
+    batchKernel_t kernelComplex;///< Kernel of the same type that finds complex roots
+    classifyKernel_t kernelClassify; ///< Kernel of the same type that finds only codes
+} kernelBench_t;
+
+
+/// @brief Benchmark list entry
+typedef struct benchEntry {
+    const char *name;           ///< Name in report
+    benchFunction_t function;   ///< Function that processes all items
+    size_t divider;             ///< Function processes count / divider items
+} benchEntry_t;
+
+
+static enum error parseBenchArgs(int argc, char *argv[], benchConfig_t *config);
+static enum error generateData(benchData_t *data, const benchConfig_t *config);
+static enum error writeWholeFile(const char name[], const char *text, size_t size);
+static void freeData(benchData_t *data);
+
+static void benchSolveScalar(void *arg);
+static void benchSolveUnchecked(void *arg);
+static void benchSolveColumns(void *arg);
+static void benchSolvePrecise(void *arg);
+static void benchSolveCached(void *arg);
+static void benchKernel(void *arg);
+static void benchKernelF(void *arg);
+static void benchKernelComplex(void *arg);
+static void benchKernelClassify(void *arg);
+static void benchSolveColumnsF(void *arg);
+static void benchSolveColumnsComplex(void *arg);
+static void benchClassifyEquations(void *arg);
+static void benchClassifyPacked(void *arg);
+static void benchSweepScalar(void *arg);
+static void benchSweepColumns(void *arg);
+static void benchSweepHoisted(void *arg);
+static void benchSolveCubics(void *arg);
+static void benchSolveQuartics(void *arg);
+static void benchCmpDouble(void *arg);
+static void benchIsZero(void *arg);
+static void benchClassify(void *arg);
+static void benchDedup(void *arg);
+static void benchScanCmdArgs(void *arg);
+static void benchScanLines(void *arg);
+static void benchParseUnitTests(void *arg);
+static void benchReadUnitTest(void *arg);
+static void benchPrintAnswer(void *arg);
+static void benchPrintKvadr(void *arg);
+static void benchFormatResults(void *arg);
+static void benchFileText(void *arg);
+static void benchFileKvb(void *arg);
+static void benchFilePlane(void *arg);
+
+
+int main(int argc, char *argv[]) {
+    benchConfig_t config = DEFAULT_BENCH_CONFIG;
+    if (parseBenchArgs(argc, argv, &config) != GOOD_EXIT) {
+        fprintf(stderr, "Usage: %s [-n equations] [-r repetitions] [-w warmup] [--seed N] [--filter substring] "
+                        "[-o report.json] [--tag label] [--dir directory]\n", argv[0]);
+        return 1;
+    }
+
+    benchData_t *data = (benchData_t*) calloc(1, sizeof(benchData_t));
+    if (!data || generateData(data, &config) != GOOD_EXIT) {
+        fprintf(stderr, RED "Can't generate benchmark data\n" RESET_C);
+        if (data) freeData(data);
+        free(data);
+        return 1;
+    }
+    //printers write to stdout
+    if (!freopen(NULL_DEVICE, "w", stdout))
+        fprintf(stderr, "Can't redirect stdout, printing benchmarks will write to it\n");
+
+    const benchEntry_t entries[] = {
+        {"solve/scalar",            benchSolveScalar,       1},
+        {"solve/scalarUnchecked",   benchSolveUnchecked,    1},
+        {"solve/columns",           benchSolveColumns,      1},
+        {"solve/columnsFloat",      benchSolveColumnsF,     1},
+        {"solve/columnsComplex",    benchSolveColumnsComplex, 1},
+        {"solve/classifyColumns",   benchClassifyEquations, 1},
+        {"solve/classifyPacked",    benchClassifyPacked,    1},
+        {"solve/cubicColumns",      benchSolveCubics,       1},
+        {"solve/quarticColumns",    benchSolveQuartics,     1},
+        {"solve/precise",           benchSolvePrecise,      1},
+        {"solve/cached",            benchSolveCached,       1},
+        {"sweep/scalar",            benchSweepScalar,       1},
+        {"sweep/columns",           benchSweepColumns,      1},
+        {"sweep/hoisted",           benchSweepHoisted,      1},
+        {"utils/cmpDouble",         benchCmpDouble,         1},
+        {"utils/isZero",            benchIsZero,            1},
+        {"utils/classifyColumns",   benchClassify,          1},
+        {"utils/dedupColumns",      benchDedup,             1},
+        {"parse/scanFromCmdArgs",   benchScanCmdArgs,       1},
+        {"parse/scanLineFromBuffer",benchScanLines,         1},
+        {"parse/parseUnitTests",    benchParseUnitTests,    1},
+        {"parse/readUnitTest",      benchReadUnitTest,      1},
+        {"print/printAnswer",       benchPrintAnswer,       PRINT_DIVIDER},
+        {"print/printKvadr",        benchPrintKvadr,        PRINT_DIVIDER},
+        {"print/formatResultLine",  benchFormatResults,     1},
+        {"file/text",               benchFileText,          1},
+        {"file/kvb",                benchFileKvb,           1},
+        {"file/planeMap",           benchFilePlane,         1}
+    };
+    const size_t entriesCount = sizeof(entries) / sizeof(entries[0]);
+
+    benchStats_t *stats = (benchStats_t*) calloc(entriesCount + 4 * KERNEL_TYPES_COUNT, sizeof(benchStats_t));
+    if (!stats) {
+        fprintf(stderr, RED "Can't allocate memory for statistics\n" RESET_C);
+        freeData(data);
+        free(data);
+        return 1;
+    }
+
+    size_t statsCount = 0;
+    enum error result = GOOD_EXIT;
+    for (size_t i = 0; i < entriesCount && result != FAIL; i++) {
+        result = runBenchmark(entries[i].name, entries[i].function, data, data->count / entries[i].divider,
+                              &config, &stats[statsCount]);
+        if (result == GOOD_EXIT)
+            printBenchStats(stderr, &stats[statsCount++]);
+    }
+    for (int type = 0; type < KERNEL_TYPES_COUNT && result != FAIL; type++) {
+        kernelBench_t kernel = {data, getKernelByType((enum kernelType) type), getKernelFByType((enum kernelType) type),
+                                getComplexKernelByType((enum kernelType) type),
+                                getClassifyKernelByType((enum kernelType) type)};
+        if (!kernel.kernel) continue;
+
+        char name[BENCH_NAME_LEN] = "";
+        snprintf(name, sizeof(name), "kernel/%s", kernelName((enum kernelType) type));
+        result = runBenchmark(name, benchKernel, &kernel, data->count, &config, &stats[statsCount]);
+        if (result == GOOD_EXIT)
+            printBenchStats(stderr, &stats[statsCount++]);
+
+        //float kernel of the same instruction set, vector has twice more lanes
+        snprintf(name, sizeof(name), "kernel/%sFloat", kernelName((enum kernelType) type));
+        if (result != FAIL)
+            result = runBenchmark(name, benchKernelF, &kernel, data->count, &config, &stats[statsCount]);
+        if (result == GOOD_EXIT)
+            printBenchStats(stderr, &stats[statsCount++]);
+
+        //the same pass with complex roots for negative discriminants
+        snprintf(name, sizeof(name), "kernel/%sComplex", kernelName((enum kernelType) type));
+        if (result != FAIL)
+            result = runBenchmark(name, benchKernelComplex, &kernel, data->count, &config, &stats[statsCount]);
+        if (result == GOOD_EXIT)
+            printBenchStats(stderr, &stats[statsCount++]);
+
+        //only codes, without sqrt and divisions
+        snprintf(name, sizeof(name), "kernel/%sClassify", kernelName((enum kernelType) type));
+        if (result != FAIL)
+            result = runBenchmark(name, benchKernelClassify, &kernel, data->count, &config, &stats[statsCount]);
+        if (result == GOOD_EXIT)
+            printBenchStats(stderr, &stats[statsCount++]);
+    }
+
+    FILE *report = fopen(config.output, "w");
+    if (!report) {
+        fprintf(stderr, "Can't create file \"%s\"\n", config.output);
+        result = FAIL;
+    } else {
+        if (writeBenchJson(report, stats, statsCount, &config) != GOOD_EXIT)
+            result = FAIL;
+        fclose(report);
+    }
+    fprintf(stderr, "Report: %s, checksum %g\n", config.output, data->sink);
+
+    free(stats);
+    freeData(data);
+    free(data);
+    return (result == FAIL) ? 1 : 0;
+}
+
+
+static enum error parseBenchArgs(int argc, char *argv[], benchConfig_t *config) {
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) return BAD_EXIT; //every option has value
+        const char *option = argv[i], *value = argv[++i];
+
+        if (!strcmp(option, "-n"))
+            config->equations = strtoull(value, NULL, 10);
+        else if (!strcmp(option, "-r"))
+            config->repetitions = strtoull(value, NULL, 10);
+        else if (!strcmp(option, "-w"))
+            config->warmup = strtoull(value, NULL, 10);
+        else if (!strcmp(option, "--seed"))
+            config->seed = strtoull(value, NULL, 10);
+        else if (!strcmp(option, "--filter"))
+            config->filter = value;
+        else if (!strcmp(option, "-o"))
+            config->output = value;
+        else if (!strcmp(option, "--tag"))
+            config->tag = value;
+        else if (!strcmp(option, "--dir"))
+            config->workDir = value;
+        else
+            return BAD_EXIT;
+    }
+    if (config->equations < PRINT_DIVIDER || config->repetitions == 0 || config->seed == 0)
+        return BAD_EXIT;
+    return GOOD_EXIT;
+}
+
+
+static enum error writeWholeFile(const char name[], const char *text, size_t size) {
+    FILE *file = fopen(name, "wb");
+    if (!file) {
+        fprintf(stderr, "Can't create file \"%s\"\n", name);
+        return FAIL;
+    }
+    const size_t written = fwrite(text, 1, size, file);
+    if (fclose(file) != 0 || written != size) {
+        fprintf(stderr, "Can't write file \"%s\"\n", name);
+        return FAIL;
+    }
+    return GOOD_EXIT;
+}
+
+
+static enum error generateData(benchData_t *data, const benchConfig_t *config) {
+    const size_t count = config->equations;
+    data->count = count;
+    data->equations = (quadraticEquation_t*) calloc(count, sizeof(quadraticEquation_t));
+    data->numbers   = (char*) calloc(3 * count, MAX_NUMBER_LEN);
+    data->cmdArgs   = (char**) calloc(3 * count, sizeof(char*));
+    data->text      = (char*) calloc(count, 3 * MAX_NUMBER_LEN);
+    data->tests     = (char*) calloc(count + 1, 6 * MAX_NUMBER_LEN);
+    data->lines     = (char*) calloc(count, MAX_RESULT_LINE_LEN);
+    data->maskBuffer = (uint64_t*) calloc(3 * maskWords(count) + 1, sizeof(uint64_t));
+    data->packedCodes = (uint64_t*) calloc(packedCodeWords(count) + 1, sizeof(uint64_t));
+    data->cache     = resultCacheCreate(2 * count, 0);
+    if (!data->equations || !data->numbers || !data->cmdArgs || !data->text || !data->tests || !data->lines
+        || !data->maskBuffer || !data->packedCodes || !data->cache)
+        return FAIL;
+    PROPAGATE_ERROR(batchAlloc(&data->batch, count));
+    PROPAGATE_ERROR(batchAllocF(&data->batchF, count));
+    PROPAGATE_ERROR(polyBatchAlloc(&data->cubics, 3, count));
+    PROPAGATE_ERROR(polyBatchAlloc(&data->quartics, 4, count));
+    PROPAGATE_ERROR(dedupReserve(&data->dedup, count));
+    PROPAGATE_ERROR(batchAlloc(&data->sweepBatch, count));
+
+    //coefficients are rounded to 6 digits like typical input, some equations are linear or degenerate
+    uint64_t state = config->seed;
+    char *text = data->text, *tests = data->tests;
+    tests += sprintf(tests, "%zu\n", count);
+    for (size_t i = 0; i < count; i++) {
+        quadraticEquation_t equation = BLANK_QUADRATIC_EQUATION;
+        double *coeffs[] = {&equation.a, &equation.b, &equation.c};
+        for (int j = 0; j < 3; j++) {
+            char *number = data->numbers + (3 * i + (size_t) j) * MAX_NUMBER_LEN;
+            const uint64_t kind = benchRandom(&state) % 64;
+            const double value = (kind == 0) ? 0 : benchRandomDouble(&state, -10, 10);
+            snprintf(number, MAX_NUMBER_LEN, "%.6g", value);
+            *coeffs[j] = strtod(number, NULL);
+            data->cmdArgs[3 * i + (size_t) j] = number;
+        }
+        data->equations[i] = equation;
+        data->batch.a[i] = equation.a;
+        data->batch.b[i] = equation.b;
+        data->batch.c[i] = equation.c;
+        data->batchF.a[i] = (float) equation.a;
+        data->batchF.b[i] = (float) equation.b;
+        data->batchF.c[i] = (float) equation.c;
+
+        text += sprintf(text, "%s %s %s\n", data->cmdArgs[3 * i], data->cmdArgs[3 * i + 1], data->cmdArgs[3 * i + 2]);
+
+        solveEquation(&equation);
+        tests += sprintf(tests, "%s %s %s %d %.17g %.17g\n",
+                         data->cmdArgs[3 * i], data->cmdArgs[3 * i + 1], data->cmdArgs[3 * i + 2],
+                         equation.answer.code, equation.answer.x1, equation.answer.x2);
+    }
+    data->batch.size = count;
+    data->batchF.size = count;
+
+    //polynomials are generated after quadratic equations, so they don't change them
+    polynomialBatch_t *polynomials[] = {&data->cubics, &data->quartics};
+    for (int p = 0; p < 2; p++) {
+        for (int j = 0; j <= polynomials[p]->degree; j++) {
+            for (size_t i = 0; i < count; i++)
+                polynomials[p]->coeffs[j][i] = benchRandomDouble(&state, -10, 10);
+        }
+        polynomials[p]->size = count;
+    }
+
+    //sweep crosses D = 0 in the middle, so every code and branch is met
+    const quadraticEquation_t sweepBase = {SWEEP_BENCH_A, SWEEP_BENCH_B, NAN, BLANK_SOLUTION};
+    const double sweepStep = SWEEP_BENCH_RANGE / (double) count;
+    PROPAGATE_ERROR(sweepInit(&data->sweep, &sweepBase, SWEEP_C, -SWEEP_BENCH_RANGE / 2,
+                              SWEEP_BENCH_RANGE / 2, sweepStep, 0));
+    for (size_t i = 0; i < count; i++) {
+        data->sweepBatch.a[i] = SWEEP_BENCH_A;
+        data->sweepBatch.b[i] = SWEEP_BENCH_B;
+    }
+    data->sweepBatch.size = count;
+
+    data->textSize = (size_t) (text - data->text);
+    data->testsSize = (size_t) (tests - data->tests);
+
+    snprintf(data->textFile,   MAX_PATH_LEN, "%s/bench_input.txt",   config->workDir);
+    snprintf(data->testsFile,  MAX_PATH_LEN, "%s/bench_tests.txt",   config->workDir);
+    snprintf(data->kvbFile,    MAX_PATH_LEN, "%s/bench_input.kvb",   config->workDir);
+    snprintf(data->kvbOutFile, MAX_PATH_LEN, "%s/bench_results.kvb", config->workDir);
+    snprintf(data->planeFile,  MAX_PATH_LEN, "%s/bench_plane.pgm",   config->workDir);
+
+    //a few points less than count, so items of benchmark are a bit overestimated
+    char planeText[2 * MAX_NUMBER_LEN + 64] = "";
+    const size_t planeWidth = (count > PLANE_BENCH_ROWS) ? count / PLANE_BENCH_ROWS : 1;
+    snprintf(planeText, sizeof(planeText), "b:-4:4:%.17g,c:-4:4:%.17g",
+             (planeWidth > 1) ? 8.0 / (double) (planeWidth - 1) : 8.0, 8.0 / (double) (PLANE_BENCH_ROWS - 1));
+    const quadraticEquation_t planeBase = {1, NAN, NAN, BLANK_SOLUTION};
+    PROPAGATE_ERROR(planeInit(&data->plane, &planeBase, planeText, 0));
+    PROPAGATE_ERROR(writeWholeFile(data->textFile, data->text, data->textSize));
+    PROPAGATE_ERROR(writeWholeFile(data->testsFile, data->tests, data->testsSize));
+
+    writableFile_t kvb = BLANK_WRITABLE_FILE;
+    PROPAGATE_ERROR(mapFileForWriting(data->kvbFile, kvbFileSize(count, KVB_HAS_COEFFS), &kvb));
+    quadraticBatch_t columns = BLANK_BATCH;
+    enum error result = kvbCreate(kvb.data, count, KVB_HAS_COEFFS, &columns);
+    if (result == GOOD_EXIT) {
+        memcpy(columns.a, data->batch.a, count * sizeof(double));
+        memcpy(columns.b, data->batch.b, count * sizeof(double));
+        memcpy(columns.c, data->batch.c, count * sizeof(double));
+    }
+    PROPAGATE_ERROR(unmapWritableFile(&kvb));
+    PROPAGATE_ERROR(result);
+
+    data->nullStream = fopen(NULL_DEVICE, "w");
+    if (!data->nullStream) {
+        fprintf(stderr, "Can't open \"%s\"\n", NULL_DEVICE);
+        return FAIL;
+    }
+    return GOOD_EXIT;
+}
+
+
+static void freeData(benchData_t *data) {
+    free(data->equations);
+    batchFree(&data->batch);
+    batchFreeF(&data->batchF);
+    polyBatchFree(&data->cubics);
+    polyBatchFree(&data->quartics);
+    batchFree(&data->sweepBatch);
+    free(data->numbers);
+    free(data->cmdArgs);
+    free(data->text);
+    free(data->tests);
+    free(data->lines);
+    free(data->maskBuffer);
+    free(data->packedCodes);
+    resultCacheDestroy(data->cache);
+    dedupFree(&data->dedup);
+    if (data->nullStream) fclose(data->nullStream);
+
+    const char *files[] = {data->textFile, data->testsFile, data->kvbFile, data->kvbOutFile, data->planeFile};
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        if (files[i][0]) remove(files[i]);
+    }
+}
+
+
+static void benchSolveScalar(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    for (size_t i = 0; i < data->count; i++) {
+        data->equations[i].answer = BLANK_SOLUTION;
+        solveEquation(&data->equations[i]);
+    }
+    data->sink += data->equations[data->count / 2].answer.code;
+}
+
+
+static void benchSolveUnchecked(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    //generated coefficients are always finite, so checks can be skipped
+    for (size_t i = 0; i < data->count; i++) {
+        quadraticEquation_t *equation = &data->equations[i];
+        typedSolution<double> answer = BLANK_TYPED_SOLUTION<double>;
+        solveQuadraticT<double, uncheckedPolicy_t>(equation->a, equation->b, equation->c, &answer);
+        equation->answer.code = answer.code;
+        equation->answer.x1 = answer.x1;
+        equation->answer.x2 = answer.x2;
+    }
+    data->sink += data->equations[data->count / 2].answer.code;
+}
+
+
+static void benchSolveColumns(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    solveEquationBatch(&data->batch);
+    data->sink += data->batch.code[data->count / 2];
+}
+
+
+static void benchSolveColumnsF(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    quadraticBatchF_t *batch = &data->batchF;
+    solveEquationColumnsF(batch->size, batch->a, batch->b, batch->c, batch->code, batch->x1, batch->x2);
+    data->sink += batch->code[data->count / 2];
+}
+
+
+static void benchSolveColumnsComplex(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    quadraticBatch_t *batch = &data->batch;
+    solveEquationColumnsComplex(batch->size, batch->a, batch->b, batch->c, batch->code, batch->x1, batch->x2);
+    data->sink += batch->code[data->count / 2];
+}
+
+
+static void benchClassifyEquations(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    quadraticBatch_t *batch = &data->batch;
+    classifyEquationColumns(batch->size, batch->a, batch->b, batch->c, batch->code);
+    data->sink += batch->code[data->count / 2];
+}
+
+
+static void benchClassifyPacked(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    quadraticBatch_t *batch = &data->batch;
+    classifyEquationsPacked(batch->size, batch->a, batch->b, batch->c, data->packedCodes);
+    data->sink += (double) data->packedCodes[packedCodeWords(data->count) / 2];
+}
+
+
+static void benchSweepScalar(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    const sweep_t *sweep = &data->sweep;
+    quadraticBatch_t *batch = &data->sweepBatch;
+    for (size_t i = 0; i < data->count; i++) {
+        quadraticEquation_t equation = {sweep->a, sweep->b, sweep->start + (double) i * sweep->step, BLANK_SOLUTION};
+        solveEquation(&equation);
+        batch->code[i] = equation.answer.code;
+        batch->x1[i] = equation.answer.x1;
+        batch->x2[i] = equation.answer.x2;
+    }
+    data->sink += batch->code[data->count / 2];
+}
+
+
+static void benchSweepColumns(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    const sweep_t *sweep = &data->sweep;
+    quadraticBatch_t *batch = &data->sweepBatch;
+    for (size_t i = 0; i < data->count; i++)
+        batch->c[i] = sweep->start + (double) i * sweep->step;
+    solveEquationColumns(data->count, batch->a, batch->b, batch->c, batch->code, batch->x1, batch->x2);
+    data->sink += batch->code[data->count / 2];
+}
+
+
+static void benchSweepHoisted(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    quadraticBatch_t *batch = &data->sweepBatch;
+    solveSweep(&data->sweep, 0, data->count, batch->c, batch->code, batch->x1, batch->x2);
+    data->sink += batch->code[data->count / 2];
+}
+
+
+static void benchSolveCubics(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    solvePolynomialColumns(&data->cubics);
+    data->sink += data->cubics.code[data->count / 2];
+}
+
+
+static void benchSolveQuartics(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    solvePolynomialColumns(&data->quartics);
+    data->sink += data->quartics.code[data->count / 2];
+}
+
+
+static void benchSolvePrecise(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    quadraticBatch_t *batch = &data->batch;
+    precisionStats_t stats = BLANK_PRECISION_STATS;
+    solveColumnsPrecise(batch->size, batch->a, batch->b, batch->c, batch->code, batch->x1, batch->x2, &stats);
+    data->sink += (double) stats.slowPath;
+}
+
+
+static void benchSolveCached(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    quadraticBatch_t *batch = &data->batch;
+    solveColumnsCached(data->cache, batch->size, batch->a, batch->b, batch->c, batch->code, batch->x1, batch->x2);
+    data->sink += batch->code[data->count / 2];
+}
+
+
+static void benchKernel(void *arg) {
+    kernelBench_t *bench = (kernelBench_t*) arg;
+    quadraticBatch_t *batch = &bench->data->batch;
+    bench->kernel(batch->size, batch->a, batch->b, batch->c, batch->code, batch->x1, batch->x2);
+    bench->data->sink += batch->code[batch->size / 2];
+}
+
+
+static void benchKernelF(void *arg) {
+    kernelBench_t *bench = (kernelBench_t*) arg;
+    quadraticBatchF_t *batch = &bench->data->batchF;
+    bench->kernelF(batch->size, batch->a, batch->b, batch->c, batch->code, batch->x1, batch->x2);
+    bench->data->sink += batch->code[batch->size / 2];
+}
+
+
+static void benchKernelComplex(void *arg) {
+    kernelBench_t *bench = (kernelBench_t*) arg;
+    quadraticBatch_t *batch = &bench->data->batch;
+    bench->kernelComplex(batch->size, batch->a, batch->b, batch->c, batch->code, batch->x1, batch->x2);
+    bench->data->sink += batch->code[batch->size / 2];
+}
+
+
+static void benchKernelClassify(void *arg) {
+    kernelBench_t *bench = (kernelBench_t*) arg;
+    quadraticBatch_t *batch = &bench->data->batch;
+    bench->kernelClassify(batch->size, batch->a, batch->b, batch->c, batch->code);
+    bench->data->sink += batch->code[batch->size / 2];
+}
+
+
+static void benchCmpDouble(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    int sum = 0;
+    for (size_t i = 0; i < data->count; i++)
+        sum += cmpDouble(data->batch.a[i], data->batch.b[i]);
+    data->sink += sum;
+}
+
+
+static void benchIsZero(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    int sum = 0;
+    for (size_t i = 0; i < data->count; i++)
+        sum += isZero(data->batch.a[i]);
+    data->sink += sum;
+}
+
+
+static void benchClassify(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    const size_t words = maskWords(data->count);
+    const rowMasks_t masks = {data->maskBuffer, data->maskBuffer + words, data->maskBuffer + 2 * words};
+    classifyColumns(data->count, data->batch.a, data->batch.b, data->batch.c, &masks);
+    data->sink += (double) (masks.allZero[0] & 1);
+}
+
+
+static void benchDedup(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    quadraticBatch_t *batch = &data->batch;
+    for (size_t begin = 0; begin < data->count; begin += DEDUP_BLOCK_ROWS) {
+        const size_t blockSize = (data->count - begin > DEDUP_BLOCK_ROWS) ? DEDUP_BLOCK_ROWS : data->count - begin;
+        dedupColumns(blockSize, batch->a + begin, batch->b + begin, batch->c + begin, &data->dedup);
+        scatterResults(blockSize, &data->dedup, batch->code + begin, batch->x1 + begin, batch->x2 + begin);
+    }
+    data->sink += (double) data->dedup.unique.size;
+}
+
+
+static void benchScanCmdArgs(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    quadraticEquation_t equation = BLANK_QUADRATIC_EQUATION;
+    double sum = 0;
+    for (size_t i = 0; i < data->count; i++) {
+        scanFromCmdArgs(&equation, data->cmdArgs + 3 * i);
+        sum += equation.c;
+    }
+    data->sink += sum;
+}
+
+
+static void benchScanLines(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    const char *pos = data->text, *end = data->text + data->textSize;
+    double sum = 0;
+    while (pos < end) {
+        quadraticEquation_t equation = BLANK_QUADRATIC_EQUATION;
+        scanLineFromBuffer(&pos, end, &equation);
+        sum += equation.c;
+    }
+    data->sink += sum;
+}
+
+
+static void benchParseUnitTests(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    unitTest_t *tests = NULL;
+    int testCount = 0;
+    if (parseUnitTests(data->tests, data->testsSize, &tests, &testCount) == GOOD_EXIT)
+        data->sink += tests[testCount - 1].inputData.c;
+    free(tests);
+}
+
+
+static void benchReadUnitTest(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    FILE *testsFile = fopen(data->testsFile, "r");
+    if (!testsFile) return;
+
+    int testCount = 0;
+    if (fscanf(testsFile, "%d", &testCount) == 1) {
+        unitTest_t test = BLANK_TEST;
+        for (int i = 0; i < testCount && readUnitTest(testsFile, &test) == GOOD_EXIT; i++)
+            data->sink += test.inputData.c;
+    }
+    fclose(testsFile);
+}
+
+
+static void benchPrintAnswer(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    for (size_t i = 0; i < data->count / PRINT_DIVIDER; i++)
+        printAnswer(&data->equations[i], SHORTEST_NUMBERS);
+    fflush(stdout);
+}
+
+
+static void benchPrintKvadr(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    for (size_t i = 0; i < data->count / PRINT_DIVIDER; i++)
+        printKvadr(&data->equations[i], SHORTEST_NUMBERS);
+    fflush(stdout);
+}
+
+
+static void benchFormatResults(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    const quadraticBatch_t *batch = &data->batch;
+    char *pos = data->lines;
+    for (size_t i = 0; i < batch->size; i++)
+        pos += formatResultLine(pos, batch->code[i], batch->x1[i], batch->x2[i], SHORTEST_NUMBERS);
+    data->sink += (double) (pos - data->lines);
+}
+
+
+static void benchFileText(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    mappedFile_t input = BLANK_MAPPED_FILE;
+    if (mapFile(data->textFile, &input) != GOOD_EXIT) return;
+
+    batchOptions_t options = DEFAULT_BATCH_OPTIONS;
+    solveBatchBuffer(input.data, input.size, data->nullStream, &options);
+    unmapFile(&input);
+}
+
+
+static void benchFileKvb(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    mappedFile_t input = BLANK_MAPPED_FILE;
+    if (mapFile(data->kvbFile, &input) != GOOD_EXIT) return;
+
+    kvbView_t view = BLANK_KVB_VIEW;
+    writableFile_t output = BLANK_WRITABLE_FILE;
+    quadraticBatch_t columns = BLANK_BATCH;
+    if (kvbParse(input.data, input.size, &view) == GOOD_EXIT &&
+        mapFileForWriting(data->kvbOutFile, kvbFileSize(view.count, KVB_HAS_RESULTS), &output) == GOOD_EXIT) {
+        if (kvbCreate(output.data, view.count, KVB_HAS_RESULTS, &columns) == GOOD_EXIT) {
+            batchOptions_t options = DEFAULT_BATCH_OPTIONS;
+            solveColumnsParallel(view.count, view.a, view.b, view.c, columns.code, columns.x1, columns.x2, &options);
+            data->sink += columns.code[view.count / 2];
+        }
+        unmapWritableFile(&output);
+    }
+    unmapFile(&input);
+}
+
+
+static void benchFilePlane(void *arg) {
+    benchData_t *data = (benchData_t*) arg;
+    planeStats_t stats = BLANK_PLANE_STATS;
+    if (writePlaneMap(data->planeFile, &data->plane, PLANE_PGM, 1, &stats) == GOOD_EXIT)
+        data->sink += (double) stats.codes[TWO_ROOTS];
+}
@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include <chrono>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "simdKernels.h"
+#include "benchmark.h"
+
+
+/// @brief Compares doubles for qsort
+static int compareDoubles(const void *first, const void *second);
+
+
+/// @brief Writes string in quotes, escaping characters that are special in JSON
+static void writeJsonString(FILE *out, const char str[]);
+
+
+static int compareDoubles(const void *first, const void *second) {
+    const double a = *(const double*) first, b = *(const double*) second;
+    return (a > b) - (a < b);
+}
+
+
+enum error runBenchmark(const char name[], benchFunction_t function, void *arg, size_t items,
+                        const benchConfig_t *config, benchStats_t *stats) {
+    MY_ASSERT(name && function, return FAIL);
+    MY_ASSERT(config && stats, return FAIL);
+    MY_ASSERT(config->repetitions > 0, return FAIL);
+
+    if (config->filter && !strstr(name, config->filter))
+        return BLANK;
+
+    double *times = (double*) calloc(config->repetitions, sizeof(double));
+    if (!times) {
+        fprintf(stderr, RED "Can't allocate memory for benchmark times\n" RESET_C);
+        return FAIL;
+    }
+
+    for (size_t i = 0; i < config->warmup; i++)
+        function(arg);
+
+    const double perItem = (items > 0) ? (double) items : 1.0;
+    for (size_t i = 0; i < config->repetitions; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        function(arg);
+        const auto end = std::chrono::steady_clock::now();
+        times[i] = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / perItem;
+    }
+
+    qsort(times, config->repetitions, sizeof(double), compareDoubles);
+    const size_t reps = config->repetitions;
+
+    double sum = 0;
+    for (size_t i = 0; i < reps; i++) sum += times[i];
+    const double mean = sum / (double) reps;
+    double squares = 0;
+    for (size_t i = 0; i < reps; i++) squares += (times[i] - mean) * (times[i] - mean);
+
+    strncpy(stats->name, name, BENCH_NAME_LEN - 1);
+    stats->name[BENCH_NAME_LEN - 1] = '\0';
+    stats->items = items;
+    stats->repetitions = reps;
+    stats->minNs = times[0];
+    stats->maxNs = times[reps - 1];
+    stats->medianNs = (reps % 2) ? times[reps / 2] : (times[reps / 2 - 1] + times[reps / 2]) / 2;
+    stats->meanNs = mean;
+    stats->stddevNs = (reps > 1) ? sqrt(squares / (double) (reps - 1)) : 0;
+    stats->itemsPerSecond = (stats->medianNs > 0) ? 1e9 / stats->medianNs : 0;
+
+    free(times);
+    return GOOD_EXIT;
+}
+
+
+void printBenchStats(FILE *out, const benchStats_t *stats) {
+    MY_ASSERT(out && stats, return);
+    fprintf(out, "%-32s %10.2f ns/item (min %9.2f, stddev %8.2f) %14.0f items/s\n",
+            stats->name, stats->medianNs, stats->minNs, stats->stddevNs, stats->itemsPerSecond);
+}
+
+
+static void writeJsonString(FILE *out, const char str[]) {
+    fputc('"', out);
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\')
+            fputc('\\', out);
+        if ((unsigned char) *str < ' ')
+            fprintf(out, "\\u%04x", (unsigned char) *str);
+        else
+            fputc(*str, out);
+    }
+    fputc('"', out);
+}
+
+
+enum error writeBenchJson(FILE *out, const benchStats_t stats[], size_t count, const benchConfig_t *config) {
+    MY_ASSERT(out && config, return FAIL);
+    MY_ASSERT(stats || count == 0, return FAIL);
+
+    fprintf(out, "{\n  \"tag\": ");
+    writeJsonString(out, config->tag);
+    fprintf(out, ",\n  \"timestamp\": %lld,\n", (long long) time(NULL));
+#ifdef __VERSION__
+    fprintf(out, "  \"compiler\": ");
+    writeJsonString(out, __VERSION__);
+    fprintf(out, ",\n");
+#endif
+    fprintf(out, "  \"kernel\": \"%s\",\n", kernelName(detectKernelType()));
+    fprintf(out, "  \"equations\": %zu,\n  \"repetitions\": %zu,\n  \"warmup\": %zu,\n  \"seed\": %llu,\n",
+            config->equations, config->repetitions, config->warmup, (unsigned long long) config->seed);
+
+    fprintf(out, "  \"benchmarks\": [");
+    for (size_t i = 0; i < count; i++) {
+        fprintf(out, "%s\n    {\"name\": ", (i == 0) ? "" : ",");
+        writeJsonString(out, stats[i].name);
+        fprintf(out, ", \"items\": %zu, \"repetitions\": %zu, "
+                     "\"ns_per_item\": {\"min\": %.3f, \"median\": %.3f, \"mean\": %.3f, \"max\": %.3f, \"stddev\": %.3f}, "
+                     "\"items_per_second\": %.1f}",
+                stats[i].items, stats[i].repetitions, stats[i].minNs, stats[i].medianNs, stats[i].meanNs,
+                stats[i].maxNs, stats[i].stddevNs, stats[i].itemsPerSecond);
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    if (ferror(out)) {
+        fprintf(stderr, RED "Can't write benchmark report\n" RESET_C);
+        return FAIL;
+    }
+    return GOOD_EXIT;
+}
+
+
+uint64_t benchRandom(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+
+double benchRandomDouble(uint64_t *state, double min, double max) {
+    //53 high bits give uniform double in [0, 1)
+    const double unit = (double) (benchRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+    return min + (max - min) * unit;
+}
@@ -0,0 +1,100 @@
+/// @file
+/// @brief Tiny framework for reproducible benchmarks: timing, statistics and JSON report
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdint.h>
+
+/// @brief Maximum length of benchmark name
+const size_t BENCH_NAME_LEN = 64;
+
+
+/// @brief Settings of benchmark run
+typedef struct benchConfig {
+    size_t equations;       ///< Number of equations in generated data
+    size_t repetitions;     ///< Number of measured runs of every benchmark
+    size_t warmup;          ///< Number of runs before measurement
+    uint64_t seed;          ///< Seed of random generator, same seed gives same data
+    const char *filter;     ///< Only benchmarks with this substring in name are run, NULL - all
+    const char *output;     ///< Name of file for JSON report
+    const char *tag;        ///< Arbitrary label of run (for example, version), written to report
+    const char *workDir;    ///< Directory for temporary files of end-to-end benchmarks
+} benchConfig_t;
+
+const benchConfig_t DEFAULT_BENCH_CONFIG = {1 << 20, 10, 2, 42, NULL, "bench.json", "", "."};
+
+
+/*!
+    @brief Statistics of one benchmark
+
+    Times are in nanoseconds per item (equation, test, line), so benchmarks of different size can be compared
+*/
+typedef struct benchStats {
+    char name[BENCH_NAME_LEN];  ///< Name of benchmark
+    size_t items;               ///< Number of items processed by one run
+    size_t repetitions;         ///< Number of measured runs
+    double minNs;               ///< The fastest run
+    double medianNs;            ///< Median run, main metric
+    double meanNs;              ///< Mean of runs
+    double maxNs;               ///< The slowest run
+    double stddevNs;            ///< Standard deviation of runs
+    double itemsPerSecond;      ///< Throughput computed from median
+} benchStats_t;
+
+
+/// @brief One run of benchmark, processes all items
+typedef void (*benchFunction_t)(void *arg);
+
+
+/*!
+    @brief Runs benchmark warmup + repetitions times and computes statistics
+
+    @param[in] name Name of benchmark
+    @param[in] function Function that processes items once
+    @param[in] arg Argument of function
+    @param[in] items Number of items processed by one call of function
+    @param[in] config Benchmark settings
+    @param[out] stats Statistics of measured runs
+
+    @return GOOD_EXIT, BLANK if benchmark is skipped by filter or FAIL
+*/
+enum error runBenchmark(const char name[], benchFunction_t function, void *arg, size_t items,
+                        const benchConfig_t *config, benchStats_t *stats);
+
+
+/*!
+    @brief Prints one row of human-readable table
+*/
+void printBenchStats(FILE *out, const benchStats_t *stats);
+
+
+/*!
+    @brief Writes report with settings and statistics of all benchmarks in JSON format
+
+    @param[in] out Output stream
+    @param[in] stats Array of statistics
+    @param[in] count Size of array
+    @param[in] config Benchmark settings
+
+    @return Enum with error code
+*/
+enum error writeBenchJson(FILE *out, const benchStats_t stats[], size_t count, const benchConfig_t *config);
+
+
+/*!
+    @brief Returns next number of xorshift64* generator
+
+    @param[in, out] state State of generator, must not be 0
+
+    Used instead of rand(), so data is the same on all platforms
+*/
+uint64_t benchRandom(uint64_t *state);
+
+
+/*!
+    @brief Returns random double uniformly distributed in [min, max)
+*/
+double benchRandomDouble(uint64_t *state, double min, double max);
+
+#endif
@@ -0,0 +1,262 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "error.h"
+#include "shmTransport.h"
+#include "shmClient.h"
+
+
+/// @brief Checks layout of mapped segment of size bytes
+static int segmentValid(const shmHeader_t *header, size_t size);
+
+
+/*!
+    @brief Stores pid of this process in header if segment is free or it's client is dead
+
+    @return GOOD_EXIT or BAD_EXIT if another client is alive
+*/
+static enum error claimSegment(shmHeader_t *header);
+
+
+/*!
+    @brief Waits until worker answers all requests of previous client and drops it's responses
+
+    @return GOOD_EXIT or FAIL if worker has stopped or hasn't answered in SHM_ATTACH_TIMEOUT_MS
+*/
+static enum error drainSegment(shmHeader_t *header);
+
+
+/// @brief Returns 1 if worker runs and it's process exists, crashed worker can't change state
+static int workerAlive(const shmHeader_t *header);
+
+
+/// @brief Fills columns of batch for slot number index
+static void batchView(const shmClient_t *client, uint32_t index, shmBatch_t *batch);
+
+
+static int segmentValid(const shmHeader_t *header, size_t size) {
+    const uint32_t slots = header->slots;
+    return header->magic.load(std::memory_order_acquire) == SHM_MAGIC && header->version == SHM_VERSION
+           && slots > 0 && (slots & (slots - 1)) == 0 && header->segmentSize <= size
+           && header->slotSize >= shmSlotSize(header->slotEquations)
+           && header->slotsOffset + (uint64_t) slots * header->slotSize <= header->segmentSize
+           && header->requestRingOffset + slots * sizeof(uint32_t) <= header->slotsOffset
+           && header->responseRingOffset + slots * sizeof(uint32_t) <= header->slotsOffset;
+}
+
+
+static enum error claimSegment(shmHeader_t *header) {
+    const uint32_t pid = (uint32_t) getpid();
+    uint32_t owner = 0;
+    if (header->clientPid.compare_exchange_strong(owner, pid)) return GOOD_EXIT;
+
+    //pid of crashed client stays in header, it's replaced only once if two new clients race
+    if (owner != pid && kill((pid_t) owner, 0) != 0 && errno == ESRCH
+        && header->clientPid.compare_exchange_strong(owner, pid))
+        return GOOD_EXIT;
+    return (owner == pid) ? GOOD_EXIT : BAD_EXIT;
+}
+
+
+static enum error drainSegment(shmHeader_t *header) {
+    const struct timespec pause = {0, 1000000};
+    for (long waited = 0; waited < SHM_ATTACH_TIMEOUT_MS; waited++) {
+        if (!workerAlive(header)) return FAIL;
+        const uint32_t tail = header->requestTail.value.load(std::memory_order_acquire);
+        if (header->requestHead.value.load(std::memory_order_acquire) == tail) {
+            header->responseHead.value.store(header->responseTail.value.load(std::memory_order_acquire),
+                                             std::memory_order_release);
+            return GOOD_EXIT;
+        }
+        nanosleep(&pause, NULL);
+    }
+    return FAIL;
+}
+
+
+static int workerAlive(const shmHeader_t *header) {
+    return header->state.load() == SHM_RUNNING && (kill((pid_t) header->workerPid, 0) == 0 || errno != ESRCH);
+}
+
+
+static void batchView(const shmClient_t *client, uint32_t index, shmBatch_t *batch) {
+    const uint32_t equations = client->header->slotEquations;
+    shmSlotHeader_t *slot = shmSlot(client->header, index);
+    batch->index = index;
+    batch->capacity = equations;
+    batch->slot = slot;
+    batch->a    = (double*) shmSlotColumn(slot, equations, 0);
+    batch->b    = (double*) shmSlotColumn(slot, equations, 1);
+    batch->c    = (double*) shmSlotColumn(slot, equations, 2);
+    batch->x1   = (double*) shmSlotColumn(slot, equations, 3);
+    batch->x2   = (double*) shmSlotColumn(slot, equations, 4);
+    batch->code = (int32_t*) shmSlotColumn(slot, equations, 5);
+}
+
+
+enum error shmClientOpen(const char name[], shmClient_t *client) {
+    MY_ASSERT(name, return FAIL);
+    MY_ASSERT(client, return FAIL);
+    *client = BLANK_SHM_CLIENT;
+
+    const int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Can't open shared memory \"%s\": %s\n", name, strerror(errno));
+        return BAD_EXIT;
+    }
+    struct stat info = {};
+    void *segment = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t) info.st_size >= sizeof(shmHeader_t))
+        segment = mmap(NULL, (size_t) info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED) {
+        fprintf(stderr, "Can't map shared memory \"%s\"\n", name);
+        return BAD_EXIT;
+    }
+
+    shmHeader_t *header = (shmHeader_t*) segment;
+    if (!segmentValid(header, (size_t) info.st_size) || header->state.load() != SHM_RUNNING) {
+        fprintf(stderr, "Shared memory \"%s\" isn't served by worker of this version\n", name);
+        munmap(segment, (size_t) info.st_size);
+        return BAD_EXIT;
+    }
+    if (claimSegment(header) != GOOD_EXIT) {
+        fprintf(stderr, "Shared memory \"%s\" already has client\n", name);
+        munmap(segment, (size_t) info.st_size);
+        return BAD_EXIT;
+    }
+
+    uint32_t *freeSlots = (uint32_t*) calloc(header->slots, sizeof(uint32_t));
+    const enum error drained = freeSlots ? drainSegment(header) : FAIL;
+    if (drained != GOOD_EXIT) {
+        fprintf(stderr, freeSlots ? "Worker of \"%s\" doesn't answer\n" : "Can't allocate memory for client of \"%s\"\n",
+                name);
+        free(freeSlots);
+        header->clientPid.store(0);
+        munmap(segment, (size_t) info.st_size);
+        return FAIL;
+    }
+
+    client->header = header;
+    client->requestRing = (uint32_t*) ((char*) header + header->requestRingOffset);
+    client->responseRing = (const uint32_t*) ((char*) header + header->responseRingOffset);
+    client->mask = header->slots - 1;
+    client->requestTail = header->requestTail.value.load();
+    client->responseHead = header->responseHead.value.load();
+    client->freeSlots = freeSlots;
+    //stack is popped from the end, so slot 0 goes first
+    for (uint32_t slot = 0; slot < header->slots; slot++)
+        freeSlots[slot] = header->slots - 1 - slot;
+    client->freeCount = header->slots;
+    return GOOD_EXIT;
+}
+
+
+void shmClientClose(shmClient_t *client) {
+    if (!client || !client->header) return;
+    client->header->clientPid.store(0);
+    munmap(client->header, client->header->segmentSize);
+    free(client->freeSlots);
+    *client = BLANK_SHM_CLIENT;
+}
+
+
+enum error shmAcquire(shmClient_t *client, shmBatch_t *batch) {
+    MY_ASSERT(client && client->header, return FAIL);
+    MY_ASSERT(batch, return FAIL);
+    if (client->freeCount == 0) return BAD_EXIT;
+
+    batchView(client, client->freeSlots[--client->freeCount], batch);
+    return GOOD_EXIT;
+}
+
+
+enum error shmSubmit(shmClient_t *client, shmBatch_t *batch, uint32_t count, uint64_t id) {
+    MY_ASSERT(client && client->header, return FAIL);
+    MY_ASSERT(batch && batch->slot, return FAIL);
+    if (count > batch->capacity) return BAD_EXIT;
+
+    batch->slot->id = id;
+    batch->slot->count = count;
+    client->requestRing[client->requestTail & client->mask] = batch->index;
+    shmPublishIndex(&client->header->requestTail, ++client->requestTail);
+    client->inFlight++;
+    *batch = BLANK_SHM_BATCH;
+    return GOOD_EXIT;
+}
+
+
+enum error shmWaitResponse(shmClient_t *client, shmBatch_t *batch) {
+    MY_ASSERT(client && client->header, return FAIL);
+    MY_ASSERT(batch, return FAIL);
+    if (client->inFlight == 0) return BAD_EXIT;
+
+    shmHeader_t *header = client->header;
+    //worker answers before it stops, so ring is checked before worker
+    while (header->responseTail.value.load(std::memory_order_acquire) == client->responseHead) {
+        if (!shmWaitIndex(&header->responseTail, client->responseHead)
+            && header->responseTail.value.load(std::memory_order_acquire) == client->responseHead
+            && !workerAlive(header))
+            return FAIL;
+    }
+
+    batchView(client, client->responseRing[client->responseHead & client->mask], batch);
+    header->responseHead.value.store(++client->responseHead, std::memory_order_release);
+    client->inFlight--;
+    return GOOD_EXIT;
+}
+
+
+void shmRelease(shmClient_t *client, shmBatch_t *batch) {
+    MY_ASSERT(client && client->header, return);
+    MY_ASSERT(batch && batch->slot, return);
+    client->freeSlots[client->freeCount++] = batch->index;
+    *batch = BLANK_SHM_BATCH;
+}
+
+
+enum error shmSolve(shmClient_t *client, size_t count, const double a[], const double b[], const double c[],
+                    int32_t code[], double x1[], double x2[]) {
+    MY_ASSERT(client && client->header, return FAIL);
+    MY_ASSERT(count == 0 || (a && b && c && code && x1 && x2), return FAIL);
+
+    enum error result = GOOD_EXIT;
+    size_t submitted = 0;
+    shmBatch_t batch = BLANK_SHM_BATCH;
+    //after failed slot nothing is submitted, but submitted slots are taken back, so client stays usable
+    while ((result == GOOD_EXIT && submitted < count) || client->inFlight > 0) {
+        //all free slots are filled before waiting, id of slot is index of it's first equation
+        if (result == GOOD_EXIT && submitted < count && shmAcquire(client, &batch) == GOOD_EXIT) {
+            const size_t size = (count - submitted < batch.capacity) ? count - submitted : batch.capacity;
+            memcpy(batch.a, a + submitted, size * sizeof(double));
+            memcpy(batch.b, b + submitted, size * sizeof(double));
+            memcpy(batch.c, c + submitted, size * sizeof(double));
+            shmSubmit(client, &batch, (uint32_t) size, submitted);
+            submitted += size;
+            continue;
+        }
+
+        if (shmWaitResponse(client, &batch) != GOOD_EXIT) return FAIL;
+        const size_t first = batch.slot->id;
+        const size_t size = batch.slot->count;
+        if (batch.slot->status != SHM_OK || first + size > count)
+            result = FAIL;
+        else {
+            memcpy(code + first, batch.code, size * sizeof(int32_t));
+            memcpy(x1 + first, batch.x1, size * sizeof(double));
+            memcpy(x2 + first, batch.x2, size * sizeof(double));
+        }
+        shmRelease(client, &batch);
+    }
+    return result;
+}
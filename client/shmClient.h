@@ -0,0 +1,116 @@
+/// @file
+/// @brief Client of shared memory worker (--shm): fills slots of segment in place and takes them back solved
+///
+/// Needs error.h and shmTransport.h to be included before it, links with libkvadratka_shm.a (make client). <br>
+/// Zero-copy use: shmAcquire() gives free slot, caller writes coefficients to it's columns, shmSubmit() passes it
+/// to worker, shmWaitResponse() returns solved slot with roots in the same columns, shmRelease() frees it. <br>
+/// Many slots can be submitted before the first response, so client prepares next batches while worker solves.
+/// shmSolve() does all of it for columns in process memory, but copies them.
+#ifndef SHM_CLIENT_H
+#define SHM_CLIENT_H
+
+/// @brief Time in ms that new client waits for worker to answer requests of previous client
+const long SHM_ATTACH_TIMEOUT_MS = 5000;
+
+
+/// @brief Attached segment, must be filled with shmClientOpen()
+typedef struct shmClient {
+    shmHeader_t *header;        ///< Mapped segment
+    uint32_t *requestRing;
+    const uint32_t *responseRing;
+    uint32_t mask;              ///< Number of slots - 1
+    uint32_t requestTail;       ///< Only client moves it, so local copy is exact
+    uint32_t responseHead;      ///< Only client moves it
+    uint32_t inFlight;          ///< Submitted slots without taken response
+    uint32_t *freeSlots;        ///< Stack of slots that client owns and hasn't acquired
+    uint32_t freeCount;
+} shmClient_t;
+
+const shmClient_t BLANK_SHM_CLIENT = {NULL, NULL, NULL, 0, 0, 0, 0, NULL, 0};
+
+
+/// @brief Slot that client owns: columns point straight to shared memory
+typedef struct shmBatch {
+    uint32_t index;             ///< Number of slot
+    uint32_t capacity;          ///< Maximum number of equations in slot
+    shmSlotHeader_t *slot;      ///< Header with id, count and status
+    double *a, *b, *c;          ///< Coefficients, written by client
+    double *x1, *x2;            ///< Roots, written by worker
+    int32_t *code;              ///< Values of solutionCode, written by worker
+} shmBatch_t;
+
+const shmBatch_t BLANK_SHM_BATCH = {0, 0, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+
+
+/*!
+    @brief Attaches to segment of running worker
+
+    @param[in] name Name of shared memory, the same as worker's --shm
+    @param[out] client Pointer to client
+
+    @return GOOD_EXIT, BAD_EXIT if segment doesn't exist, has other layout or another live client or FAIL
+
+    Segment serves one client: it's pid is stored in header, pid of dead client is replaced. <br>
+    Slots that previous client left in rings are answered by worker and dropped, then all slots are free
+*/
+enum error shmClientOpen(const char name[], shmClient_t *client);
+
+
+/// @brief Detaches from segment, slots in rings are dropped by the next client
+void shmClientClose(shmClient_t *client);
+
+
+/*!
+    @brief Takes free slot
+
+    @return GOOD_EXIT or BAD_EXIT if all slots are submitted or taken, then shmWaitResponse() frees one
+*/
+enum error shmAcquire(shmClient_t *client, shmBatch_t *batch);
+
+
+/*!
+    @brief Passes slot with count equations to worker, batch can't be used until it's response
+
+    @param[in] client Client
+    @param[in] batch Slot from shmAcquire() or shmWaitResponse(), columns a, b, c are filled
+    @param[in] count Number of equations, not greater than capacity
+    @param[in] id Any number, it's returned in response
+
+    @return GOOD_EXIT or BAD_EXIT if count is too big
+*/
+enum error shmSubmit(shmClient_t *client, shmBatch_t *batch, uint32_t count, uint64_t id);
+
+
+/*!
+    @brief Waits for the oldest submitted slot
+
+    @param[in] client Client
+    @param[out] batch Solved slot, it's status is in batch->slot->status
+
+    @return GOOD_EXIT, BAD_EXIT if nothing is submitted or FAIL if worker has stopped or crashed
+
+    Spins SHM_SPIN_LIMIT times, then sleeps on futex and checks state and process of worker every SHM_WAIT_MS
+*/
+enum error shmWaitResponse(shmClient_t *client, shmBatch_t *batch);
+
+
+/// @brief Returns slot to free slots
+void shmRelease(shmClient_t *client, shmBatch_t *batch);
+
+
+/*!
+    @brief Solves columns of equations through all slots of segment
+
+    @param[in] client Client without acquired or submitted slots
+    @param[in] count Number of equations
+    @param[in] a, b, c Columns of coefficients
+    @param[out] code, x1, x2 Columns for results
+
+    @return GOOD_EXIT, FAIL if worker has stopped or couldn't solve some slot
+
+    Columns are copied to slots by pieces of capacity, next pieces are copied while worker solves previous ones
+*/
+enum error shmSolve(shmClient_t *client, size_t count, const double a[], const double b[], const double c[],
+                    int32_t code[], double x1[], double x2[]);
+
+#endif
@@ -0,0 +1,142 @@
+/// @file
+/// @brief Example client of shared memory worker: solves x^2 - k = 0 for k = 1..N in slots and with shmSolve()
+///
+/// Run worker with "main.exe --shm /kvadratka" and then "shmExample.exe /kvadratka 1000000"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "error.h"
+#include "shmTransport.h"
+#include "shmClient.h"
+
+
+/// @brief Number of equations if it isn't set in argv
+const size_t EXAMPLE_DEFAULT_COUNT = 1 << 20;
+
+/// @brief Code of equation with two roots, the same as TWO_ROOTS of solver
+const int32_t EXAMPLE_TWO_ROOTS = 2;
+
+
+/// @brief Returns monotonic time in seconds
+static double nowSeconds();
+
+
+/// @brief Returns 1 if x1, x2 are roots of x^2 - k = 0
+static int rootsRight(double k, int32_t code, double x1, double x2);
+
+
+/*!
+    @brief Solves equations in slots: coefficients are written straight to shared memory
+
+    @return Number of wrong answers or -1 if worker has failed
+*/
+static long solveInSlots(shmClient_t *client, size_t count);
+
+
+/*!
+    @brief Solves the same equations from columns of this process with shmSolve()
+
+    @return Number of wrong answers or -1 if worker has failed
+*/
+static long solveColumns(shmClient_t *client, size_t count);
+
+
+static double nowSeconds() {
+    struct timespec time = {};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double) time.tv_sec + (double) time.tv_nsec / 1e9;
+}
+
+
+static int rootsRight(double k, int32_t code, double x1, double x2) {
+    const double root = sqrt(k);
+    return code == EXAMPLE_TWO_ROOTS && fabs(fabs(x1) - root) <= 1e-12 * root && fabs(x1 + x2) <= 1e-12 * root;
+}
+
+
+static long solveInSlots(shmClient_t *client, size_t count) {
+    long wrong = 0;
+    size_t submitted = 0;
+    shmBatch_t batch = BLANK_SHM_BATCH;
+    while (submitted < count || client->inFlight > 0) {
+        if (submitted < count && shmAcquire(client, &batch) == GOOD_EXIT) {
+            const size_t size = (count - submitted < batch.capacity) ? count - submitted : batch.capacity;
+            for (size_t i = 0; i < size; i++) {
+                batch.a[i] = 1;
+                batch.b[i] = 0;
+                batch.c[i] = -(double) (submitted + i + 1);
+            }
+            shmSubmit(client, &batch, (uint32_t) size, submitted);
+            submitted += size;
+            continue;
+        }
+
+        if (shmWaitResponse(client, &batch) != GOOD_EXIT || batch.slot->status != SHM_OK) return -1;
+        for (uint32_t i = 0; i < batch.slot->count; i++)
+            wrong += !rootsRight(-batch.c[i], batch.code[i], batch.x1[i], batch.x2[i]);
+        shmRelease(client, &batch);
+    }
+    return wrong;
+}
+
+
+static long solveColumns(shmClient_t *client, size_t count) {
+    double *columns = (double*) calloc(5 * count, sizeof(double));
+    int32_t *code = (int32_t*) calloc(count, sizeof(int32_t));
+    if (!columns || !code) {
+        fprintf(stderr, "Can't allocate memory for %zu equations\n", count);
+        free(columns);
+        free(code);
+        return -1;
+    }
+    double *a = columns, *b = a + count, *c = b + count, *x1 = c + count, *x2 = x1 + count;
+    for (size_t i = 0; i < count; i++) {
+        a[i] = 1;
+        c[i] = -(double) (i + 1);
+    }
+
+    long wrong = -1;
+    if (shmSolve(client, count, a, b, c, code, x1, x2) == GOOD_EXIT) {
+        wrong = 0;
+        for (size_t i = 0; i < count; i++)
+            wrong += !rootsRight(-c[i], code[i], x1[i], x2[i]);
+    }
+    free(columns);
+    free(code);
+    return wrong;
+}
+
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s NAME [COUNT]\n", argv[0]);
+        return 1;
+    }
+    const size_t count = (argc > 2) ? strtoull(argv[2], NULL, 10) : EXAMPLE_DEFAULT_COUNT;
+
+    shmClient_t client = BLANK_SHM_CLIENT;
+    if (shmClientOpen(argv[1], &client) != GOOD_EXIT) return 1;
+
+    double start = nowSeconds();
+    const long slotsWrong = solveInSlots(&client, count);
+    const double slotsTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    const long columnsWrong = (slotsWrong < 0) ? -1 : solveColumns(&client, count);
+    const double columnsTime = nowSeconds() - start;
+    shmClientClose(&client);
+
+    if (slotsWrong < 0 || columnsWrong < 0) {
+        fprintf(stderr, "Worker has stopped or failed\n");
+        return 1;
+    }
+    printf("In slots: %zu equations in %.3f s (%.1f ns per equation), %ld wrong\n",
+           count, slotsTime, slotsTime * 1e9 / (double) (count ? count : 1), slotsWrong);
+    printf("shmSolve: %zu equations in %.3f s (%.1f ns per equation), %ld wrong\n",
+           count, columnsTime, columnsTime * 1e9 / (double) (count ? count : 1), columnsWrong);
+    return (slotsWrong == 0 && columnsWrong == 0) ? 0 : 1;
+}
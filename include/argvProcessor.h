@@ -33,15 +33,55 @@ enum argNamesEnum {
     UNIT,
     FILENAME,
     COEFFS,
-    HELP
+    HELP,
+    BATCH,
+    THREADS,
+    OUTPUT,
+    CONVERT,
+    PRECISE,
+    PRETTY,
+    CACHE,
+    DEDUP,
+    SERVE,
+    IO,
+    PIPELINE,
+    SINGLE,
+    STRESS,
+    SEED,
+    TRACE,
+    COMPLEX,
+    CLASSIFY,
+    SWEEP,
+    PLANE,
+    SHM
 };
 
 const argDescriptor_t args[] {
     {tBLANK,    "-s",   "--silent", "Reduce amount of prints"},
     {tBLANK,    "-u",   "--unit",   "Run unit tests"},
-    {tSTRING,   "-f",   "--file",   "Next argument is name of file, from which program will read unit test"},
+    {tSTRING,   "-f",   "--file",   "Next argument is name of file with unit tests or with equations for batch mode"},
     {tARRAYPTR, "-c",   "--coeffs", "Coefficients of equation: a, b, c"},
-    {tBLANK,    "-h",   "--help",   "Prints help message"}
+    {tBLANK,    "-h",   "--help",   "Prints help message"},
+    {tBLANK,    "-b",   "--batch",  "Solve lines \"a b c\" from file (-f) or stdin, print \"code x1 x2\" for each, 4 or 5 numbers are cubic or quartic"},
+    {tINT,      "-t",   "--threads", "Number of threads for batch mode, 0 - all CPU cores"},
+    {tSTRING,   "-o",   "--output", "Next argument is name of file for batch results, *.kvb means binary format"},
+    {tBLANK,    "-k",   "--convert", "Batch mode only converts input (-f) between text and .kvb to file (-o) without solving"},
+    {tBLANK,    "-p",   "--precise", "Use adaptive-precision solver, ill-conditioned equations are solved in double-double"},
+    {tBLANK,    "-g",   "--pretty", "Print numbers like %g with 6 significant digits instead of the shortest exact form"},
+    {tINT,      "-m",   "--cache",  "Batch mode caches up to N solutions, repeated equations aren't solved again"},
+    {tBLANK,    "-d",   "--dedup",  "Batch mode solves only unique equations of blocks with enough duplicates, only with -p or -m: SIMD solver is cheaper"},
+    {tSTRING,   "-l",   "--serve",  "Next argument is path of Unix socket, solves batches of clients until SIGINT or SIGTERM"},
+    {tSTRING,   "-i",   "--io",     "Batch I/O of files: stdio (default), pread or uring - next blocks are read while chunks are solved"},
+    {tBLANK,    "-e",   "--pipeline", "Batch mode parses, solves and prints text file (-f) in three threads, prints their load"},
+    {tBLANK,    "-x",   "--float",  "Batch mode solves text in single precision: float SIMD kernels, roots are printed as float"},
+    {tINT,      "-r",   "--stress", "Solves N random equations with known roots on all threads, prints speed and wrong answers"},
+    {tINT,      "-n",   "--seed",   "Seed of random equations for --stress, the same seed gives the same equations"},
+    {tSTRING,   "-j",   "--trace",  "Next argument is name of JSON file for spans of parsing, solving, formatting and I/O in all threads"},
+    {tBLANK,    "-z",   "--complex", "Equations with negative discriminant get complex roots: code 7, real and imaginary parts"},
+    {tBLANK,    "-y",   "--classify", "Only number of real roots (code) is found without roots, *.kvb output packs codes by 3 bits"},
+    {tSTRING,   "-w",   "--sweep",  "Next argument is \"c:start:stop:step\" (or a, b), equation from -c is solved for every value, prints \"value code x1 x2\""},
+    {tSTRING,   "-q",   "--plane",  "Next argument is \"b:start:stop:step,c:start:stop:step\", codes of equations from -c on this grid go to image -o (*.pgm, *.ppm or raw bytes)"},
+    {tSTRING,   "-a",   "--shm",    "Next argument is name of shared memory, solves batches that client puts to its slots until SIGINT or SIGTERM"}
 };
 
 const size_t argsSize = sizeof(args)/sizeof(argDescriptor_t);
@@ -0,0 +1,94 @@
+/// @file
+/// @brief Sequential reading and writing of files with several blocks in flight through io_uring
+
+#ifndef ASYNC_IO_H
+#define ASYNC_IO_H
+
+/// @brief Size of one read or write request in bytes
+const size_t ASYNC_BLOCK_SIZE = 1 << 20;
+
+/// @brief Number of read blocks and number of write blocks that can be in flight at once
+const size_t ASYNC_DEPTH = 4;
+
+
+/// @brief Ways to read and write files in batch mode
+enum ioBackend {
+    IO_STDIO = 0,   ///< fread() and fwrite(), nothing is in flight
+    IO_PREAD,       ///< pread() and pwrite() of whole blocks, they block like stdio
+    IO_URING        ///< io_uring, reads ahead and writes behind while chunks are solved
+};
+
+
+/// @brief Opaque reader and writer, created with asyncIOCreate()
+typedef struct asyncIO asyncIO_t;
+
+
+/*!
+    @brief Starts reading input and prepares writing of output
+
+    @param[in] inFd Descriptor of regular file that is read from it's current position, -1 if there is no input
+    @param[in] outFd Descriptor of regular file that is written from it's current position, -1 if there is no output
+    @param[in] backend IO_URING or IO_PREAD
+
+    @return Pointer to reader or NULL if memory can't be allocated
+
+    If io_uring can't be created, IO_PREAD is used, asyncIOBackend() tells which backend works. <br>
+    ASYNC_DEPTH reads are submitted here, then every consumed block is read again from further offset
+*/
+asyncIO_t *asyncIOCreate(int inFd, int outFd, enum ioBackend backend);
+
+
+/*!
+    @brief Waits for all writes, moves positions of descriptors after processed data and frees reader
+
+    @param[in] io Pointer to reader, can be NULL
+
+    @return GOOD_EXIT or FAIL if some read or write has failed
+*/
+enum error asyncIODestroy(asyncIO_t *io);
+
+
+/*!
+    @brief Returns backend that is really used
+*/
+enum ioBackend asyncIOBackend(const asyncIO_t *io);
+
+
+/// @brief Returns 1 if descriptor is regular file that can be read or written with offsets
+int isAsyncFile(int fd);
+
+
+/*!
+    @brief Copies next bytes of input, works like fread()
+
+    @param[in] io Pointer to reader
+    @param[out] buffer Buffer for bytes
+    @param[in] size Size of buffer
+
+    @return Number of copied bytes, it is less than size only if input ended or read failed
+
+    Waits only for blocks that aren't read yet
+*/
+size_t asyncRead(asyncIO_t *io, char *buffer, size_t size);
+
+
+/*!
+    @brief Copies bytes to write blocks, full blocks are submitted
+
+    @param[in] io Pointer to reader
+    @param[in] data Bytes to write
+    @param[in] size Number of bytes
+
+    @return GOOD_EXIT or FAIL if some write has failed
+
+    Waits only if all write blocks are in flight
+*/
+enum error asyncWrite(asyncIO_t *io, const char *data, size_t size);
+
+
+/*!
+    @brief Returns 1 if some read or write has failed
+*/
+int asyncIOFailed(const asyncIO_t *io);
+
+#endif
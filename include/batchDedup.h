@@ -0,0 +1,133 @@
+/// @file
+/// @brief Deduplication of equations inside batch: unique rows are solved once, results are scattered back
+
+#ifndef BATCH_DEDUP_H
+#define BATCH_DEDUP_H
+
+#include <stdint.h>
+
+/// @brief Maximum number of rows that are deduplicated together, columns and hash table of block fit in L2 cache
+const size_t DEDUP_BLOCK_ROWS = 1 << 14;
+
+/// @brief Smaller blocks are solved without deduplication
+const size_t DEDUP_MIN_ROWS = 256;
+
+/// @brief Maximum number of blocks that are solved without deduplication after it didn't pay off
+const size_t DEDUP_MAX_BACKOFF = 16;
+
+
+/*!
+    @brief Approximate costs of one row in nanoseconds, measured by bench
+
+    Deduplication costs hashing, probing and scattering of every row, it pays off only
+    if duplicates * solver cost is greater than rows * DEDUP_ROW_COST. <br>
+    Probing is the most expensive part, it costs from 6 ns for blocks with many duplicates to 11 ns for unique rows
+*/
+const double DEDUP_ROW_COST     = 10;
+const double KERNEL_ROW_COST    = 5;    ///< solveEquationColumns()
+const double PRECISE_ROW_COST   = 27;   ///< solveColumnsPrecise()
+const double CACHED_ROW_COST    = 40;   ///< solveColumnsCached()
+
+
+/// @brief Function that solves columns, for example wrapper of solveEquationColumns()
+typedef void (*columnsSolver_t)(size_t count, const double a[], const double b[], const double c[],
+                                enum solutionCode code[], double x1[], double x2[], void *arg);
+
+
+/*!
+    @brief Unique rows of block, map from rows of block to them and state of auto-off
+
+    Allocated once with dedupReserve() and reused for every block
+*/
+typedef struct dedupBuffer {
+    quadraticBatch_t unique;    ///< Unique coefficients and their results
+    uint32_t *index;            ///< Row i of block is row index[i] of unique
+    uint64_t *hashes;           ///< Hashes of rows of block
+    uint64_t *table;            ///< Open addressing hash table: high half of hash, then unique row + 1, 0 is empty slot
+    size_t tableCapacity;       ///< Number of allocated slots in table
+
+    size_t skipBlocks;          ///< Blocks that are solved without deduplication before the next try
+    size_t backoff;             ///< Value of skipBlocks after the next try that doesn't pay off
+} dedupBuffer_t;
+
+const dedupBuffer_t BLANK_DEDUP_BUFFER = {BLANK_BATCH, NULL, NULL, NULL, 0, 0, 1};
+
+
+/// @brief Counters of deduplication
+typedef struct dedupStats {
+    size_t rows;            ///< All rows that went through solveColumnsDedup()
+    size_t dedupRows;       ///< Rows of blocks that were deduplicated
+    size_t uniqueRows;      ///< Unique rows of these blocks, only they were solved
+} dedupStats_t;
+
+const dedupStats_t BLANK_DEDUP_STATS = {0, 0, 0};
+
+
+/*!
+    @brief Allocates buffer for blocks of rows
+
+    @param[in, out] buffer Pointer to buffer, it is reallocated only if it is smaller than needed
+    @param[in] rows Maximum size of block, values greater than DEDUP_BLOCK_ROWS are clamped
+
+    @return GOOD_EXIT or FAIL if memory can't be allocated
+*/
+enum error dedupReserve(dedupBuffer_t *buffer, size_t rows);
+
+
+/*!
+    @brief Frees buffer and sets it to BLANK_DEDUP_BUFFER
+
+    @param[in, out] buffer Pointer to buffer
+*/
+void dedupFree(dedupBuffer_t *buffer);
+
+
+/*!
+    @brief Finds unique rows of block
+
+    @param[in] count Number of rows, not greater than reserved size of buffer
+    @param[in] a, b, c Columns with coefficients
+    @param[in, out] buffer Allocated buffer, unique coefficients and index are written to it
+
+    @return Number of unique rows
+
+    Rows are equal if bit patterns of all three coefficients are equal,
+    so results of unique rows can be copied to duplicates without changing any bit
+*/
+size_t dedupColumns(size_t count, const double a[], const double b[], const double c[], dedupBuffer_t *buffer);
+
+
+/*!
+    @brief Copies results of unique rows to all rows of block
+
+    @param[in] count Number of rows that was passed to dedupColumns()
+    @param[in] buffer Buffer with solved unique rows
+    @param[out] code, x1, x2 Columns for results of block
+*/
+void scatterResults(size_t count, const dedupBuffer_t *buffer, enum solutionCode code[], double x1[], double x2[]);
+
+
+/*!
+    @brief Solves columns block by block, solver gets only unique rows of block
+
+    @param[in] count Number of rows
+    @param[in] a, b, c Columns with coefficients
+    @param[out] code, x1, x2 Columns for results
+    @param[in] solver Function that solves columns
+    @param[in] solverArg Argument of solver
+    @param[in] solverCost Cost of one row for solver, for example KERNEL_ROW_COST
+    @param[in, out] buffer Buffer, allocated here if it is needed
+    @param[in, out] stats Counters that are incremented, can be NULL
+
+    @return GOOD_EXIT or FAIL if memory can't be allocated
+
+    Results are the same as solver gives for all rows. <br>
+    If duplicates of block don't pay for deduplication, the next block is solved directly, then 2, 4, ...
+    up to DEDUP_MAX_BACKOFF blocks. Solvers that aren't more expensive than deduplication never use it
+*/
+enum error solveColumnsDedup(size_t count, const double a[], const double b[], const double c[],
+                             enum solutionCode code[], double x1[], double x2[],
+                             columnsSolver_t solver, void *solverArg, double solverCost,
+                             dedupBuffer_t *buffer, dedupStats_t *stats);
+
+#endif
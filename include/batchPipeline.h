@@ -0,0 +1,62 @@
+/// @file
+/// @brief Batch mode as three threads: parser, solver and formatter, connected by SPSC rings
+
+#ifndef BATCH_PIPELINE_H
+#define BATCH_PIPELINE_H
+
+/// @brief Maximum number of equations in one chunk of pipeline
+const size_t PIPELINE_CHUNK_ROWS = 1 << 12;
+
+/// @brief Number of chunks that circulate between stages, parser waits if all of them are in work
+const size_t PIPELINE_CHUNKS = 8;
+
+
+/// @brief Stages of pipeline in order of data flow
+enum pipelineStage {
+    STAGE_PARSE = 0,    ///< Reads lines with 3, 4 or 5 coefficients to columns, runs in calling thread
+    STAGE_SOLVE,        ///< Solves columns of chunk
+    STAGE_FORMAT,       ///< Formats lines "code x1 ... xn" and writes them to output
+    PIPELINE_STAGES     ///< Number of stages
+};
+
+
+/// @brief Names of stages for reports, indexed by enum pipelineStage
+const char *const PIPELINE_STAGE_NAMES[PIPELINE_STAGES] = {"parse", "solve", "format"};
+
+
+/// @brief Counters of pipeline
+typedef struct pipelineStats {
+    size_t chunks;                      ///< Number of chunks that went through all stages
+    double wallTime;                    ///< Seconds from start of the first stage to end of the last one
+    double busyTime[PIPELINE_STAGES];   ///< Seconds that every stage spent working, without waiting for rings
+} pipelineStats_t;
+
+const pipelineStats_t BLANK_PIPELINE_STATS = {0, 0, {0, 0, 0}};
+
+
+/*!
+    @brief Solves all equations from text that is already in memory with one thread per stage
+
+    @param[in] text Lines with coefficients, for example mapped file, doesn't need to be null-terminated
+    @param[in] size Size of text
+    @param[in] out Output stream
+    @param[in] options Batch settings, options->threads isn't used
+    @param[out] stats Counters of pipeline, can be NULL
+
+    @return Enum with error code
+
+    Output is the same as output of solveBatchBuffer() <br>
+    Chunks of up to PIPELINE_CHUNK_ROWS equations are passed between stages through lock-free rings,
+    empty chunks return to parser through another ring, so memory isn't allocated after start,
+    except columns for cubics and quartics that are allocated by the first such line of every chunk
+*/
+enum error solveBatchPipeline(const char *text, size_t size, FILE* out, const batchOptions_t* options,
+                              pipelineStats_t* stats);
+
+
+/*!
+    @brief Returns stage with the biggest busy time
+*/
+enum pipelineStage pipelineBottleneck(const pipelineStats_t* stats);
+
+#endif
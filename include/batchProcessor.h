@@ -0,0 +1,286 @@
+/// @file
+/// @brief Streaming solver for text files with many equations
+
+#ifndef BATCH_PROCESSOR_H
+#define BATCH_PROCESSOR_H
+
+/// @brief Size of one read from input stream in bytes
+const size_t BATCH_READ_SIZE = 1 << 20;
+
+
+/// @brief Settings of batch mode
+typedef struct batchOptions {
+    int silent;                 ///< Don't print warnings about bad lines
+    size_t threads;             ///< Number of threads of pool started by batchPoolStart(), 0 or 1 means calling thread
+    int precise;                ///< Solve with solveColumnsPrecise() instead of SIMD kernels
+    precisionStats_t *stats;    ///< Counters of precise solver, can be NULL
+    enum numberStyle style;     ///< Style of roots in text output
+    resultCache_t *cache;       ///< If not NULL, equations are solved with solveColumnsCached() instead of SIMD kernels
+    int dedup;                  ///< Solve only unique equations of blocks with solveColumnsDedup()
+    dedupStats_t *dedupStats;   ///< Counters of deduplication, can be NULL
+    enum ioBackend io;          ///< How solveBatchStream() reads and writes regular files
+    int single;                 ///< Text chunks are solved in single precision, can't be used with precise, cache or dedup
+    int complex;                ///< Quadratic equations with D < 0 get COMPLEX_ROOTS, can't be used with precise, cache or single
+    int classify;               ///< Only exit codes are found and printed, roots aren't computed
+    struct threadPool *pool;    ///< Threads shared by all calls with these options, NULL means that they run in calling thread
+} batchOptions_t;
+
+const batchOptions_t DEFAULT_BATCH_OPTIONS = {0, 1, 0, NULL, SHORTEST_NUMBERS, NULL, 0, NULL, IO_STDIO, 0, 0, 0, NULL};
+
+
+/*!
+    @brief Starts options->pool with options->threads threads, if there are more than one
+
+    @return GOOD_EXIT or FAIL if threads can't be started
+
+    Pool lives until batchPoolStop(), so one run or server creates threads only once
+*/
+enum error batchPoolStart(batchOptions_t *options);
+
+
+/// @brief Stops pool started by batchPoolStart(), options->pool becomes NULL
+void batchPoolStop(batchOptions_t *options);
+
+
+/*!
+    @brief Piece of input text with whole lines and everything needed to process it
+
+    Text isn't owned by chunk, it points to read buffer <br>
+    Batch and output buffer are owned and reused between chunks
+*/
+typedef struct batchChunk {
+    const char *text;           ///< Beginning of text with lines
+    size_t textSize;            ///< Size of text in bytes
+    size_t firstLine;           ///< Number of the first line in input, used in warnings
+
+    quadraticBatch_t batch;     ///< Parsed equations and their solutions
+    quadraticBatchF_t batchF;   ///< Equations converted to float and their solutions, used only in single precision
+    polynomialBatch_t cubics;   ///< Lines with 4 coefficients and their roots, allocated by the first such line
+    polynomialBatch_t quartics; ///< Lines with 5 coefficients and their roots, allocated by the first such line
+    unsigned char *degrees;     ///< Degree of every line, results of three batches are merged in input order by it
+
+    char *output;               ///< Formatted results
+    size_t outputSize;          ///< Number of bytes written to output
+    size_t outputCapacity;      ///< Number of allocated bytes in output
+
+    size_t badLines;            ///< Number of lines that couldn't be read
+    precisionStats_t stats;     ///< Counters of precise solver for this chunk
+
+    dedupBuffer_t dedup;        ///< Buffer for deduplication, keeps state of auto-off between chunks
+    dedupStats_t dedupStats;    ///< Counters of deduplication for this chunk
+} batchChunk_t;
+
+const batchChunk_t BLANK_CHUNK = {NULL, 0, 0, BLANK_BATCH, BLANK_BATCH_F, BLANK_POLY_BATCH, BLANK_POLY_BATCH, NULL,
+                                  NULL, 0, 0, 0, BLANK_PRECISION_STATS, BLANK_DEDUP_BUFFER, BLANK_DEDUP_STATS};
+
+
+/// @brief Maximum length of one formatted result line
+const size_t MAX_RESULT_LINE_LEN = 2 * MAX_NUMBER_LEN + 8;
+
+
+/*!
+    @brief Formats result of one equation as line "code x1 x2"
+
+    @param[out] out Buffer of at least MAX_RESULT_LINE_LEN bytes
+    @param[in] code Exit code
+    @param[in] x1, x2 Roots
+    @param[in] style Style of roots
+
+    @return Number of written characters, line isn't null-terminated
+*/
+size_t formatResultLine(char *out, enum solutionCode code, double x1, double x2, enum numberStyle style);
+
+
+/*!
+    @brief Same as formatResultLine(), but roots are float and printed with formatNumberF()
+*/
+size_t formatResultLineF(char *out, enum solutionCode code, float x1, float x2, enum numberStyle style);
+
+
+/// @brief Maximum length of one line formatted by formatCodeLine()
+const size_t MAX_CODE_LINE_LEN = 4;
+
+
+/*!
+    @brief Formats exit code as line "code" for classify mode
+
+    @param[out] out Buffer of at least MAX_CODE_LINE_LEN bytes
+    @param[in] code Exit code
+
+    @return Number of written characters, line isn't null-terminated
+*/
+size_t formatCodeLine(char *out, enum solutionCode code);
+
+
+/// @brief Maximum length of one formatted result line of cubic or quartic equation
+const size_t MAX_POLY_LINE_LEN = (size_t) MAX_DEGREE * MAX_NUMBER_LEN + 8;
+
+
+/*!
+    @brief Formats result of polynomial equation as line "code x1 ... xn"
+
+    @param[out] out Buffer of at least MAX_POLY_LINE_LEN bytes
+    @param[in] code Exit code
+    @param[in] roots Roots, unused ones are NaN
+    @param[in] degree Degree of polynomial, number of printed roots
+    @param[in] style Style of roots
+
+    @return Number of written characters, line isn't null-terminated
+*/
+size_t formatPolynomialLine(char *out, enum solutionCode code, const double roots[], int degree,
+                            enum numberStyle style);
+
+
+/*!
+    @brief Parses, solves and formats all lines of chunk
+
+    @param[in, out] chunk Chunk with text set
+    @param[in] options Batch settings
+
+    @return Enum with error code
+
+    Every line "a b c" produces exactly one line "code x1 x2" in chunk output <br>
+    Lines with 4 or 5 coefficients are cubic and quartic equations, they produce "code x1 x2 x3" and
+    "code x1 x2 x3 x4" and are solved with solvePolynomialColumns() in their own batches <br>
+    Empty lines are skipped, lines that can't be read produce BAD_INPUT line <br>
+    With options->single coefficients are rounded to float, coefficients out of float range give BAD_INPUT <br>
+    Precise solver, cache, deduplication and single precision are used only for quadratic lines <br>
+    With options->classify quadratic lines are only classified and every line produces "code"
+*/
+enum error processChunk(batchChunk_t* chunk, const batchOptions_t* options);
+
+
+/*!
+    @brief Frees memory owned by chunk
+
+    @param[in, out] chunk Pointer to chunk
+*/
+void chunkFree(batchChunk_t* chunk);
+
+
+/*!
+    @brief Solves all equations from input stream and writes results to output stream
+
+    @param[in] in Input stream with lines "a b c"
+    @param[in] out Output stream
+    @param[in] options Batch settings
+
+    @return Enum with error code
+
+    Reads input with big blocks, doesn't print any prompts <br>
+    Output has one line per non-empty input line <br>
+    If options->pool is set, chunks are solved in it, results are written in input order <br>
+    If options->io isn't IO_STDIO, streams that are regular files are read and written with asyncIO_t,
+    so next blocks of input are read and results are written while chunks are solved,
+    if input isn't a regular file, it's read with stdio and a note is printed unless options->silent is set
+*/
+enum error solveBatchStream(FILE* in, FILE* out, const batchOptions_t* options);
+
+
+/*!
+    @brief Solves all equations from text that is already in memory
+
+    @param[in] text Lines "a b c", for example mapped file, doesn't need to be null-terminated
+    @param[in] size Size of text
+    @param[in] out Output stream
+    @param[in] options Batch settings
+
+    @return Enum with error code
+
+    Same as solveBatchStream(), but chunks point directly to text, nothing is copied
+*/
+enum error solveBatchBuffer(const char *text, size_t size, FILE* out, const batchOptions_t* options);
+
+
+/*!
+    @brief Parses text with lines "a b c" to columns of batch
+
+    @param[in] text Lines "a b c", for example mapped file, doesn't need to be null-terminated
+    @param[in] size Size of text
+    @param[out] batch Batch that will be allocated and filled
+    @param[in] silent Don't print warnings about bad lines
+
+    @return Enum with error code
+
+    Empty lines are skipped, lines that can't be read get NaN coefficients (so they will have BAD_INPUT) <br>
+    Batch must be freed with batchFree()
+*/
+enum error loadCoeffsFromBuffer(const char *text, size_t size, quadraticBatch_t* batch, int silent);
+
+
+/*!
+    @brief Solves equations stored in columns, splits them between threads
+
+    @param[in] count Number of equations
+    @param[in] a, b, c Columns with coefficients, for example mapped from .kvb file
+    @param[out] code, x1, x2 Columns for results
+    @param[in] options Batch settings, silent isn't used
+
+    @return Enum with error code
+
+    Same as solveEquationColumns() (or solveColumnsPrecise() if options->precise is set,
+    solveColumnsCached() if options->cache is set), but if options->pool is set pieces of columns are solved in it <br>
+    With options->dedup every piece is deduplicated separately <br>
+    With options->classify only code is written with classifyEquationColumns(), x1 and x2 aren't changed
+*/
+enum error solveColumnsParallel(size_t count, const double a[], const double b[], const double c[],
+                                enum solutionCode code[], double x1[], double x2[], const batchOptions_t* options);
+
+
+/*!
+    @brief Finds exit codes of equations stored in columns and packs them, splits columns between threads
+
+    @param[in] count Number of equations
+    @param[in] a, b, c Columns with coefficients
+    @param[out] packed Packed column of packedCodeWords(count) words
+    @param[in] options Batch settings, only pool is used
+
+    @return Enum with error code
+
+    Same as classifyEquationsPacked(), but if options->pool is set ranges of whole words are classified in it
+*/
+enum error classifyPackedParallel(size_t count, const double a[], const double b[], const double c[],
+                                  uint64_t packed[], const batchOptions_t* options);
+
+
+/*!
+    @brief Writes lines "code x1 x2" for columns of results
+
+    @param[in] out Output stream
+    @param[in] count Number of equations
+    @param[in] code, x1, x2 Columns with results
+    @param[in] style Style of roots
+
+    @return Enum with error code
+*/
+enum error writeResultsText(FILE* out, size_t count, const enum solutionCode code[], const double x1[], const double x2[],
+                            enum numberStyle style);
+
+
+/*!
+    @brief Writes lines "code" for column of exit codes or for packed column
+
+    @param[in] out Output stream
+    @param[in] count Number of equations
+    @param[in] code Column with exit codes or NULL if packed is used
+    @param[in] packed Packed column, used if code is NULL
+
+    @return Enum with error code
+*/
+enum error writeCodesText(FILE* out, size_t count, const enum solutionCode code[], const uint64_t packed[]);
+
+
+/*!
+    @brief Writes lines "a b c" for columns of coefficients
+
+    @param[in] out Output stream
+    @param[in] count Number of equations
+    @param[in] a, b, c Columns with coefficients
+
+    @return Enum with error code
+
+    Coefficients are printed in SHORTEST_NUMBERS style, so they are read back exactly
+*/
+enum error writeCoeffsText(FILE* out, size_t count, const double a[], const double b[], const double c[]);
+
+#endif
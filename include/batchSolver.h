@@ -0,0 +1,222 @@
+/// @file
+/// @brief Functions to solve many quadratic equations stored as columns
+
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+#include <stdint.h>
+
+/// @brief Alignment of batch columns in bytes (enough for any SIMD register)
+const size_t BATCH_ALIGNMENT = 64;
+
+/// @brief Bits of one exit code in packed column, every code except BLANK_ROOT fits in them
+const unsigned PACKED_CODE_BITS = 3;
+
+/// @brief Number of codes in one word of packed column, the highest bit of word is 0
+const size_t PACKED_CODES_PER_WORD = 64 / PACKED_CODE_BITS;
+
+
+/*!
+    @brief Struct-of-arrays batch of quadratic equations
+
+    Each equation is stored in row i of every column <br>
+    Coefficients a, b, c are input, code, x1, x2 are output <br>
+    Roots that don't have practical sense are set to NAN
+*/
+typedef struct quadraticBatch {
+    size_t size;                ///< Number of equations in batch
+    size_t capacity;            ///< Number of allocated rows
+    double *a, *b, *c;          ///< Columns with coefficients of quadratic polynomial
+    enum solutionCode *code;    ///< Column with exit codes
+    double *x1, *x2;            ///< Columns with roots
+} quadraticBatch_t;
+
+const quadraticBatch_t BLANK_BATCH = {0, 0, NULL, NULL, NULL, NULL, NULL, NULL};
+
+
+/// @brief quadraticBatch_t with single-precision columns
+typedef struct quadraticBatchF {
+    size_t size;                ///< Number of equations in batch
+    size_t capacity;            ///< Number of allocated rows
+    float *a, *b, *c;           ///< Columns with coefficients of quadratic polynomial
+    enum solutionCode *code;    ///< Column with exit codes
+    float *x1, *x2;             ///< Columns with roots
+} quadraticBatchF_t;
+
+const quadraticBatchF_t BLANK_BATCH_F = {0, 0, NULL, NULL, NULL, NULL, NULL, NULL};
+
+
+/*!
+    @brief Allocates columns of batch
+
+    @param[out] batch Pointer to batch
+    @param[in] capacity Number of rows to allocate
+
+    @return GOOD_EXIT or FAIL if memory can't be allocated
+
+    Columns are aligned to BATCH_ALIGNMENT, size of batch is set to 0
+*/
+enum error batchAlloc(quadraticBatch_t* batch, size_t capacity);
+
+
+/*!
+    @brief Frees columns of batch and sets it to BLANK_BATCH
+
+    @param[in, out] batch Pointer to batch
+*/
+void batchFree(quadraticBatch_t* batch);
+
+
+/*!
+    @brief Allocates single-precision columns of batch, same as batchAlloc()
+*/
+enum error batchAllocF(quadraticBatchF_t* batch, size_t capacity);
+
+
+/*!
+    @brief Frees single-precision columns of batch and sets it to BLANK_BATCH_F
+*/
+void batchFreeF(quadraticBatchF_t* batch);
+
+
+/*!
+    @brief Solves equations stored in columns
+
+    @param[in] count Number of equations
+    @param[in] a, b, c Columns with coefficients
+    @param[out] code Column for exit codes
+    @param[out] x1, x2 Columns for roots
+
+    @return GOOD_EXIT or FAIL if pointers are NULL
+
+    Results are bit-identical to solveEquation() applied to equation initialized with BLANK_SOLUTION:
+    equations with inf or NaN get BAD_INPUT, -0 in roots is fixed <br>
+    Columns are classified by blocks with classifyColumns() first: BAD_INPUT and INF_ROOTS rows are filled
+    without kernel, rows with subnormal coefficients are solved separately, kernel gets only clean rows <br>
+    After clean block the next blocks skip classification for a while, kernel solves them as they are
+*/
+enum error solveEquationColumns(size_t count, const double a[], const double b[], const double c[],
+                                enum solutionCode code[], double x1[], double x2[]);
+
+
+/*!
+    @brief Same as solveEquationColumns(), but equations with D < 0 get COMPLEX_ROOTS
+
+    Results are bit-identical to solveEquationComplex(): x1 is real part and x2 is imaginary part of roots <br>
+    Complex roots come from the same pass of kernel, it doesn't read columns again
+*/
+enum error solveEquationColumnsComplex(size_t count, const double a[], const double b[], const double c[],
+                                       enum solutionCode code[], double x1[], double x2[]);
+
+
+/*!
+    @brief Finds only exit codes of equations stored in columns
+
+    @param[in] count Number of equations
+    @param[in] a, b, c Columns with coefficients
+    @param[out] code Column for exit codes
+
+    @return GOOD_EXIT or FAIL if pointers are NULL
+
+    Codes are bit-identical to codes of solveEquationColumns() and classifyEquation(), but roots aren't computed:
+    kernel from getClassifyKernel() has no sqrt and divisions
+*/
+enum error classifyEquationColumns(size_t count, const double a[], const double b[], const double c[],
+                                   enum solutionCode code[]);
+
+
+/*!
+    @brief Returns number of words in packed column for count codes
+*/
+size_t packedCodeWords(size_t count);
+
+
+/*!
+    @brief Packs exit codes by PACKED_CODE_BITS bits
+
+    @param[in] count Number of codes
+    @param[in] code Column with exit codes, BLANK_ROOT can't be packed
+    @param[out] packed Packed column of packedCodeWords(count) words
+
+    Code i is in bits 3 * (i % 21) ... 3 * (i % 21) + 2 of word i / 21, unused bits are 0
+*/
+void packCodes(size_t count, const enum solutionCode code[], uint64_t packed[]);
+
+
+/*!
+    @brief Returns exit code number index from packed column
+*/
+enum solutionCode unpackCode(const uint64_t packed[], size_t index);
+
+
+/*!
+    @brief Finds exit codes of equations and writes them straight to packed column
+
+    @param[in] count Number of equations
+    @param[in] a, b, c Columns with coefficients
+    @param[out] packed Packed column of packedCodeWords(count) words
+
+    @return GOOD_EXIT or FAIL if pointers are NULL
+
+    Same as classifyEquationColumns() and packCodes(), but unpacked codes live only in small block on stack,
+    so output takes 3 bits instead of 32 bits of code and 128 bits of roots per equation
+*/
+enum error classifyEquationsPacked(size_t count, const double a[], const double b[], const double c[],
+                                   uint64_t packed[]);
+
+
+/*!
+    @brief Solves all equations in batch
+
+    @param[in, out] batch Pointer to batch
+
+    @return Enum with error code
+
+    @see solveEquationColumns
+*/
+enum error solveEquationBatch(quadraticBatch_t* batch);
+
+
+/*!
+    @brief Solves equations stored in single-precision columns
+
+    @param[in] count Number of equations
+    @param[in] a, b, c Columns with coefficients
+    @param[out] code Column for exit codes
+    @param[out] x1, x2 Columns for roots
+
+    @return GOOD_EXIT or FAIL if pointers are NULL
+
+    Results are bit-identical to solveEquationF() applied to equation initialized with BLANK_SOLUTION_F <br>
+    Whole columns go to the best single-precision kernel, it handles special rows itself:
+    vector has twice more lanes than in double kernels
+*/
+enum error solveEquationColumnsF(size_t count, const float a[], const float b[], const float c[],
+                                 enum solutionCode code[], float x1[], float x2[]);
+
+
+/*!
+    @brief Copies coefficients from array of equations to batch (AoS -> SoA)
+
+    @param[in, out] batch Allocated batch, it's size will be set to count
+    @param[in] equations Array of equations
+    @param[in] count Number of equations
+
+    @return BAD_EXIT if batch capacity is less than count, else GOOD_EXIT
+*/
+enum error batchFromEquations(quadraticBatch_t* batch, const quadraticEquation_t equations[], size_t count);
+
+
+/*!
+    @brief Copies answers from batch to array of equations (SoA -> AoS)
+
+    @param[in] batch Solved batch
+    @param[out] equations Array of at least batch->size equations
+
+    @return Enum with error code
+
+    Copies coefficients too, so equations can be filled from batch only
+*/
+enum error batchToEquations(const quadraticBatch_t* batch, quadraticEquation_t equations[]);
+
+#endif
@@ -0,0 +1,223 @@
+/// @file
+/// @brief Solver of quadratic equation for any floating type that also works at compile time
+
+#ifndef GENERIC_SOLVER_H
+#define GENERIC_SOLVER_H
+
+#include <limits>
+
+
+/*!
+    @brief Solution with roots of type T, same as solution_t for double
+
+    Roots that don't have practical sense are left as they were, so solution should be
+    initialized with BLANK_TYPED_SOLUTION
+*/
+template <typename T>
+struct typedSolution {
+    enum solutionCode code;     ///< enum with exit codes; in basic cases = number of roots
+    T x1;                       ///< first root
+    T x2;                       ///< second root
+};
+
+template <typename T>
+constexpr typedSolution<T> BLANK_TYPED_SOLUTION = {BLANK_ROOT, std::numeric_limits<T>::quiet_NaN(),
+                                                   std::numeric_limits<T>::quiet_NaN()};
+
+
+/// @brief Absolute value, -0 gives 0 like fabs()
+template <typename T>
+constexpr T constexprAbs(T x) {
+    return (x < 0) ? -x : x + T(0); //-0 + 0 is 0
+}
+
+
+/// @brief Same as isfinite(), NaN fails the comparison
+template <typename T>
+constexpr bool constexprIsFinite(T x) {
+    return constexprAbs(x) <= std::numeric_limits<T>::max();
+}
+
+
+/*!
+    @brief Square root, sqrt() at run time and Newton's method at compile time
+
+    Compile-time root can differ from sqrt() in the last bit, so results of compile-time
+    solver are compared with EPSILON, not by bits
+*/
+template <typename T>
+constexpr T constexprSqrt(T x) {
+    if (!__builtin_is_constant_evaluated())
+        return sqrt(x);
+
+    if (!(x > 0) || !constexprIsFinite(x)) return x;
+    //iterations start above the root and decrease until rounding stops them
+    T root = (x > 1) ? x : T(1);
+    while (true) {
+        const T next = (root + x / root) / 2;
+        if (!(next < root)) return root;
+        root = next;
+    }
+}
+
+
+/// @brief Absolute epsilon for type T: EPSILON_F for float, EPSILON for double and long double
+template <typename T>
+constexpr T epsilonFor() {
+    return T(EPSILON);
+}
+
+template <>
+constexpr float epsilonFor<float>() {
+    return EPSILON_F;
+}
+
+
+/// @brief Zero rule of solveEquation(): |x| < epsilonFor<T>(), tiny coefficients and roots are zeros
+struct absoluteEpsilonRule {
+    template <typename T>
+    static constexpr bool isZero(T x) {
+        return constexprAbs(x) < epsilonFor<T>();
+    }
+};
+
+/// @brief Only 0 and -0 are zeros
+struct exactZeroRule {
+    template <typename T>
+    static constexpr bool isZero(T x) {
+        return constexprAbs(x) <= T(0);
+    }
+};
+
+
+/*!
+    @brief Policy of solveQuadraticT()
+
+    @tparam CHECK If true, pointer is checked with MY_ASSERT, inf and NaN coefficients give BAD_INPUT
+                  and finite roots are asserted; else caller guarantees that coefficients are finite
+    @tparam ZERO_RULE absoluteEpsilonRule or exactZeroRule, used for a, b, c, discriminant and -0 in roots
+    @tparam COMPLEX If true, negative discriminant gives COMPLEX_ROOTS with real and imaginary parts, else ZERO_ROOTS
+*/
+template <bool CHECK, typename ZERO_RULE, bool COMPLEX = false>
+struct solverPolicy {
+    static constexpr bool CHECKED = CHECK;
+    static constexpr bool COMPLEX_ROOTS_FOUND = COMPLEX;
+
+    template <typename T>
+    static constexpr bool isZero(T x) {
+        return ZERO_RULE::isZero(x);
+    }
+};
+
+/// @brief Behaviour of solveEquation()
+typedef solverPolicy<true, absoluteEpsilonRule> checkedPolicy_t;
+
+/// @brief Same results as checkedPolicy_t for finite input, but without any checks
+typedef solverPolicy<false, absoluteEpsilonRule> uncheckedPolicy_t;
+
+/// @brief Behaviour of solveEquationComplex(): checkedPolicy_t, but complex roots are found
+typedef solverPolicy<true, absoluteEpsilonRule, true> complexPolicy_t;
+
+
+/*!
+    @brief Solves quadratic equation ax^2 + bx + c = 0 with numbers of type T
+
+    @tparam T float, double or long double
+    @tparam POLICY solverPolicy: checks and zero rule
+
+    @param[in] a, b, c Coefficients
+    @param[in, out] answer Solution, roots that aren't found are left as they were
+
+    @return Enum with error code, FAIL for inf or NaN input in checked policy
+
+    With checkedPolicy_t results are bit-identical to solveEquation() for double and to solveEquationF() for float,
+    they are built on this template <br>
+    Can be evaluated at compile time, failed assertion stops compilation
+*/
+template <typename T, typename POLICY = checkedPolicy_t>
+constexpr enum error solveQuadraticT(T a, T b, T c, typedSolution<T> *answer) {
+    if (POLICY::CHECKED) {
+        MY_ASSERT(answer, return FAIL);
+        if (!constexprIsFinite(a) || !constexprIsFinite(b) || !constexprIsFinite(c)) {
+            answer->code = BAD_INPUT;
+            return FAIL;
+        }
+    }
+
+    if (POLICY::isZero(a)) { //we divide only by a, so this check is essential
+        if (!POLICY::isZero(b)) {
+            answer->code = ONE_ROOT;
+            answer->x1 = -c / b;
+        } else
+            answer->code = POLICY::isZero(c) ? INF_ROOTS : ZERO_ROOTS;
+    } else {
+        const T D = b*b - 4*a*c;
+        if (POLICY::isZero(D)) {
+            answer->code = ONE_ROOT;
+            answer->x1 = -b / (2*a);
+        } else if (D < 0) {
+            if (POLICY::COMPLEX_ROOTS_FOUND) { //x1 +- i*x2, imaginary part is made positive
+                answer->code = COMPLEX_ROOTS;
+                answer->x1 = -b / (2*a);
+                answer->x2 = constexprAbs(constexprSqrt(-D) / (2*a));
+            } else
+                answer->code = ZERO_ROOTS;
+        } else { //NaN discriminant also gets here like in solveEquation()
+            answer->code = TWO_ROOTS;
+            const T D_sqrt = constexprSqrt(D);
+            answer->x1 = (-b - D_sqrt) / (2*a);
+            answer->x2 = (-b + D_sqrt) / (2*a);
+        }
+    }
+
+    //fix -0 case, zero rule decides which roots are zeros
+    if (POLICY::isZero(answer->x1)) answer->x1 = constexprAbs(answer->x1);
+    if (POLICY::isZero(answer->x2)) answer->x2 = constexprAbs(answer->x2);
+
+    if (POLICY::CHECKED) {
+        if (answer->code == ONE_ROOT || answer->code == TWO_ROOTS || answer->code == COMPLEX_ROOTS) {
+            MY_ASSERT(constexprIsFinite(answer->x1), return FAIL);
+        }
+        if (answer->code == TWO_ROOTS || answer->code == COMPLEX_ROOTS) {
+            MY_ASSERT(constexprIsFinite(answer->x2), return FAIL);
+        }
+    }
+    return GOOD_EXIT;
+}
+
+
+/*!
+    @brief Returns exit code that solveQuadraticT() gives to equation, but doesn't find roots
+
+    @tparam T float, double or long double
+    @tparam POLICY solverPolicy: checks and zero rule
+
+    @param[in] a, b, c Coefficients
+
+    @return Exit code, BAD_INPUT for inf or NaN input in checked policy
+
+    Comparisons are the same as in solveQuadraticT(), so code is always equal to code of full solver:
+    only discriminant and zero rule are computed, without sqrt and divisions
+*/
+template <typename T, typename POLICY = checkedPolicy_t>
+constexpr enum solutionCode classifyQuadraticT(T a, T b, T c) {
+    if (POLICY::CHECKED) {
+        if (!constexprIsFinite(a) || !constexprIsFinite(b) || !constexprIsFinite(c))
+            return BAD_INPUT;
+    }
+
+    if (POLICY::isZero(a)) {
+        if (!POLICY::isZero(b))
+            return ONE_ROOT;
+        return POLICY::isZero(c) ? INF_ROOTS : ZERO_ROOTS;
+    }
+
+    const T D = b*b - 4*a*c;
+    if (POLICY::isZero(D))
+        return ONE_ROOT;
+    if (D < 0)
+        return POLICY::COMPLEX_ROOTS_FOUND ? COMPLEX_ROOTS : ZERO_ROOTS;
+    return TWO_ROOTS; //NaN discriminant too
+}
+
+#endif
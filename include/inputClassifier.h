@@ -0,0 +1,44 @@
+/// @file
+/// @brief Classification of coefficient columns before batch kernel: bitmasks of rows with special input
+
+#ifndef INPUT_CLASSIFIER_H
+#define INPUT_CLASSIFIER_H
+
+#include <stdint.h>
+
+/// @brief Number of rows described by one word of mask
+const size_t MASK_WORD_ROWS = 64;
+
+
+/*!
+    @brief Bitmasks of rows that don't need general kernel
+
+    Bit i of word w describes row w * MASK_WORD_ROWS + i, bits after the last row are 0 <br>
+    Masks may overlap, nonFinite has the highest priority, then allZero
+*/
+typedef struct rowMasks {
+    uint64_t *nonFinite;    ///< a, b or c is inf or NaN, answer is BAD_INPUT
+    uint64_t *allZero;      ///< |a|, |b| and |c| are less than EPSILON, answer is INF_ROOTS
+    uint64_t *subnormal;    ///< Some coefficient is subnormal, arithmetic with it is very slow on x86
+} rowMasks_t;
+
+
+/*!
+    @brief Returns number of mask words for count rows
+*/
+size_t maskWords(size_t count);
+
+
+/*!
+    @brief Classifies rows of coefficient columns with bit operations
+
+    @param[in] count Number of rows
+    @param[in] a, b, c Columns with coefficients
+    @param[out] masks Masks with at least maskWords(count) words each
+
+    Doubles are compared as integers: |x| < y for non-negative y is (bits(x) & ~sign) < bits(y) <br>
+    With AVX-512 8 rows are classified at once, else compiler vectorizes plain loop
+*/
+void classifyColumns(size_t count, const double a[], const double b[], const double c[], const rowMasks_t *masks);
+
+#endif
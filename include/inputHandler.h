@@ -53,4 +53,65 @@ enum error flushScanfBuffer();
 */
 enum error flushScanfBufferHard();
 
+
+/*!
+    @brief Reads one number from text buffer that isn't null-terminated
+
+    @param[in, out] pos Pointer to current position in buffer, moved after number
+    @param[in] end Pointer to the end of buffer
+    @param[out] value Scanned number
+
+    @return GOOD_EXIT if number was read, BAD_EXIT if token isn't a number or line ended
+
+    Skips spaces and tabs before number, but never goes to the next line <br>
+    Number is converted with strtod, so it supports the same formats as scanf ("%lf")
+*/
+enum error scanDoubleFromBuffer(const char **pos, const char *end, double *value);
+
+
+/*!
+    @brief Reads coefficients a, b, c from one line of text buffer
+
+    @param[in, out] pos Pointer to the beginning of line, moved to the beginning of next line
+    @param[in] end Pointer to the end of buffer
+    @param[out] equation Pointer to struct where coefficients are written
+
+    @return GOOD_EXIT if line contains exactly 3 numbers, BAD_EXIT if it doesn't, BLANK if line is empty
+
+    Line is skipped completely even if it can't be read
+*/
+enum error scanLineFromBuffer(const char **pos, const char *end, quadraticEquation_t* equation);
+
+
+/*!
+    @brief Reads all numbers from one line of text buffer
+
+    @param[in, out] pos Pointer to the beginning of line, moved to the beginning of next line
+    @param[in] end Pointer to the end of buffer
+    @param[out] coeffs Array for numbers
+    @param[in] maxCount Size of coeffs array
+    @param[out] count Number of read numbers
+
+    @return GOOD_EXIT if line contains from 1 to maxCount numbers, BAD_EXIT if it doesn't, BLANK if line is empty
+
+    Line is skipped completely even if it can't be read, scanLineFromBuffer() is this function with 3 numbers
+*/
+enum error scanCoeffsFromBuffer(const char **pos, const char *end, double coeffs[], size_t maxCount, size_t *count);
+
+
+/*!
+    @brief Reads one word (sequence of non-space characters) from text buffer
+
+    @param[in, out] pos Pointer to current position in buffer, moved after word
+    @param[in] end Pointer to the end of buffer
+    @param[out] word Null-terminated copy of word
+    @param[in] maxLen Size of word array
+    @param[in, out] line Number of current line, increased for every skipped '\n'
+
+    @return GOOD_EXIT, BLANK if buffer ended before word or BAD_EXIT if word is longer than maxLen - 1
+
+    Unlike scanDoubleFromBuffer(), skips any whitespace including new lines
+*/
+enum error scanWordFromBuffer(const char **pos, const char *end, char word[], size_t maxLen, size_t *line);
+
 #endif
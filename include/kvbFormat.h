@@ -0,0 +1,124 @@
+/// @file
+/// @brief Binary columnar format .kvb for coefficients and results
+///
+/// File layout (all numbers are little-endian):
+///
+/// | Offset | Size | Field                                                        |
+/// |--------|------|--------------------------------------------------------------|
+/// | 0      | 4    | magic "KVB1"                                                 |
+/// | 4      | 4    | version, uint32 = 1                                          |
+/// | 8      | 8    | count, uint64 - number of equations                          |
+/// | 16     | 4    | flags, uint32 - set of kvbFlags                              |
+/// | 20     | 4    | headerSize, uint32 = 128                                     |
+/// | 24     | 48   | offsets of columns a, b, c, code, x1, x2, uint64 (0 = absent)|
+/// | 72     | 8    | offset of packed column of codes, uint64 (0 = absent)        |
+/// | 80     | 48   | reserved, zeros                                              |
+///
+/// Every column starts at offset that is multiple of 64. <br>
+/// a, b, c, x1, x2 are arrays of IEEE-754 doubles, code is array of int32 with values of solutionCode <br>
+/// Packed column has uint64 words with 21 codes by 3 bits, see packCodes()
+#ifndef KVB_FORMAT_H
+#define KVB_FORMAT_H
+
+#include <stdint.h>
+
+const char KVB_MAGIC[4] = {'K', 'V', 'B', '1'};
+const uint32_t KVB_VERSION = 1;
+const size_t KVB_ALIGNMENT = 64;
+
+/// @brief Columns that are present in file
+enum kvbFlags {
+    KVB_HAS_COEFFS  = 1 << 0,   ///< Columns a, b, c
+    KVB_HAS_RESULTS = 1 << 1,   ///< Columns code, x1, x2
+    KVB_HAS_PACKED  = 1 << 2    ///< Packed column of codes without roots, written in classify mode
+};
+
+/// @brief Indexes of columns in header offsets array
+enum kvbColumn {
+    KVB_COLUMN_A = 0,
+    KVB_COLUMN_B,
+    KVB_COLUMN_C,
+    KVB_COLUMN_CODE,
+    KVB_COLUMN_X1,
+    KVB_COLUMN_X2,
+    KVB_COLUMN_PACKED,
+    KVB_COLUMNS_COUNT
+};
+
+/// @brief Header in the beginning of .kvb file
+typedef struct kvbHeader {
+    char magic[4];                          ///< "KVB1"
+    uint32_t version;                       ///< KVB_VERSION
+    uint64_t count;                         ///< Number of equations
+    uint32_t flags;                         ///< Set of kvbFlags
+    uint32_t headerSize;                    ///< sizeof(kvbHeader_t)
+    uint64_t offsets[KVB_COLUMNS_COUNT];    ///< Offsets of columns from beginning of file, 0 if column is absent
+    uint8_t reserved[48];                   ///< Zeros
+} kvbHeader_t;
+
+static_assert(sizeof(kvbHeader_t) == 128, "kvb header must be 128 bytes");
+
+
+/// @brief Read-only columns of .kvb file, they point directly to file data
+typedef struct kvbView {
+    size_t count;                   ///< Number of equations
+    uint32_t flags;                 ///< Set of kvbFlags
+    const double *a, *b, *c;        ///< Coefficients, NULL if absent
+    const enum solutionCode *code;  ///< Exit codes, NULL if absent
+    const double *x1, *x2;          ///< Roots, NULL if absent
+    const uint64_t *packed;         ///< Packed exit codes, NULL if absent
+} kvbView_t;
+
+const kvbView_t BLANK_KVB_VIEW = {0, 0, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+
+
+/*!
+    @brief Checks if data starts with .kvb magic
+
+    @return 1 if data looks like .kvb file, else 0
+*/
+int isKvbData(const char *data, size_t size);
+
+
+/*!
+    @brief Checks .kvb header and makes view of columns
+
+    @param[in] data Contents of file, must be aligned at least as double (mapped and allocated files are)
+    @param[in] size Size of data
+    @param[out] view Columns that point to data
+
+    @return GOOD_EXIT or BAD_EXIT if file is damaged
+*/
+enum error kvbParse(const char *data, size_t size, kvbView_t *view);
+
+
+/*!
+    @brief Returns size of .kvb file with specified number of equations and columns
+*/
+size_t kvbFileSize(size_t count, uint32_t flags);
+
+
+/*!
+    @brief Writes header to buffer and sets column pointers
+
+    @param[out] data Buffer of kvbFileSize(count, flags) bytes aligned at least as double
+    @param[in] count Number of equations
+    @param[in] flags Set of kvbFlags
+    @param[out] columns Batch with pointers to columns in data, absent columns are NULL
+
+    @return Enum with error code
+*/
+enum error kvbCreate(char *data, size_t count, uint32_t flags, quadraticBatch_t *columns);
+
+
+/*!
+    @brief Returns packed column of codes in buffer that was filled by kvbCreate()
+
+    @param[in] data Buffer with header
+    @param[in] flags Flags that were given to kvbCreate()
+
+    @return Pointer to column or NULL if there is no KVB_HAS_PACKED in flags
+*/
+uint64_t *kvbPackedColumn(char *data, uint32_t flags);
+
+#endif
@@ -3,6 +3,30 @@
 #ifndef MAIN_H
 #define MAIN_H
 
+/*!
+    @brief Everything that main() does after reading arguments and starting tracing
+
+    @param[in] flags Array of flags
+
+    1. Prints welcome messages <br>
+    2. Runs unit tests based on flags
+    3. In server mode solves batches of socket clients until signal and exits <br>
+    4. In shared memory mode solves slots of client until signal and exits <br>
+    5. In stress mode solves random equations with known roots, prints report and exits <br>
+    6. In sweep mode solves equation for every value of one coefficient and exits <br>
+    7. In plane mode writes map of exit codes on a grid of two coefficients and exits <br>
+    8. In batch mode solves all equations from file or stdin and exits <br>
+    9. Tries to read coefficients from argv (they're first priority) and solve equation <br>
+    10. Runs loop, where <br>
+        1. Reads coefficients from console <br>
+        2. Solves equation and prints answer <br>
+        3. Asks if user want to solve it again <br>
+
+    @return Exit code of program
+*/
+int runProgram(argVal_t flags[]);
+
+
 /*!
     @brief Prints help message and basic info about program
 
@@ -40,4 +64,227 @@ enum error solveCmd(argVal_t flags[], enum error* scanResult, quadraticEquation_
 */
 enum error solveLoop(argVal_t flags[], enum error* scanResult, quadraticEquation_t* equation);
 
+
+/*!
+    @brief Returns style of numbers selected by flags
+
+    @param[in] flags Array of flags
+
+    @return PRETTY_NUMBERS with -g flag, else SHORTEST_NUMBERS
+*/
+enum numberStyle numberStyleFromFlags(argVal_t flags[]);
+
+
+/*!
+    @brief Solves equation with solver selected by flags
+
+    @param[in] flags Array of flags
+    @param[in, out] equation Pointer to equation
+
+    @return Result of solver
+
+    With -p flag uses solveEquationPrecise() and tells if equation took slow path,
+    with -z flag uses solveEquationComplex(), with -y flag uses classifyEquation(), else solveEquation()
+*/
+enum error solveWithFlags(argVal_t flags[], quadraticEquation_t* equation);
+
+
+/*!
+    @brief Prints answer of equation solved by solveWithFlags()
+
+    @param[in] flags Array of flags
+    @param[in] equation Pointer to solved equation
+
+    @return Enum with error code
+
+    With -y flag prints only number of roots with printRootsCount(), else roots with printAnswer()
+*/
+enum error printAnswerWithFlags(argVal_t flags[], const quadraticEquation_t* equation);
+
+
+/*!
+    @brief Fills batch settings that are selected by flags
+
+    @param[in] flags Array of flags
+    @param[in, out] options Settings, pointers to counters and cache aren't changed
+
+    @return BAD_EXIT if flags contradict each other
+*/
+enum error batchOptionsFromFlags(argVal_t flags[], batchOptions_t *options);
+
+
+/*!
+    @brief Prints counters of precise solver, deduplication and cache to stderr
+
+    @param[in] options Batch settings, counters are printed only for modes that are on
+*/
+void printBatchStats(const batchOptions_t *options);
+
+
+/*!
+    @brief Solves equations from file or stdin without any prompts
+
+    @param[in] flags Array of flags
+
+    Reads file specified with -f flag or stdin if there is no such flag, input format is detected by .kvb magic <br>
+    Results are printed to stdout or to file specified with -o flag, *.kvb output files are binary <br>
+    With --convert flag equations aren't solved, input is only converted to other format <br>
+    With -p flag equations are solved with adaptive-precision solver, number of slow path equations is printed to stderr <br>
+    With -m flag equations are solved through cache of given size, it's counters are printed to stderr <br>
+    With -d flag only unique equations of blocks are solved, share of unique equations is printed to stderr,
+    the flag needs -p or -m <br>
+    With -y flag only codes are found and printed, *.kvb output gets only packed column of codes <br>
+    With --io flag text files are read and written with selected backend
+*/
+enum error solveBatch(argVal_t flags[]);
+
+
+/*!
+    @brief Returns 1 if name of file ends with ".kvb"
+*/
+int isKvbFileName(const char name[]);
+
+
+/*!
+    @brief Solves or converts text input of batch mode
+
+    @param[in] input Mapped input file with lines "a b c"
+    @param[in] out Stream for text results
+    @param[in] kvbOutput Name of .kvb file for results or NULL if results are text
+    @param[in] convert Only convert coefficients to .kvb without solving
+    @param[in] options Batch settings
+
+    @return Enum with error code
+*/
+enum error solveBatchText(const mappedFile_t *input, FILE *out, const char *kvbOutput, int convert,
+                          const batchOptions_t *options);
+
+
+/*!
+    @brief Solves text input of batch mode with parser, solver and formatter in separate threads
+
+    @param[in] input Mapped input file with lines "a b c"
+    @param[in] out Stream for text results
+    @param[in] options Batch settings
+
+    @return Enum with error code
+
+    Unless options->silent is set, prints share of time that every stage was busy and the busiest stage
+*/
+enum error solveBatchPipelined(const mappedFile_t *input, FILE *out, const batchOptions_t *options);
+
+
+/*!
+    @brief Solves text file with I/O backend selected by options
+
+    @param[in] name Name of file with lines "a b c"
+    @param[in] out Stream for text results
+    @param[in] options Batch settings, options->io isn't IO_STDIO
+
+    @return Enum with error code
+
+    Unlike mapped input, next blocks of file are read while chunks are solved
+*/
+enum error solveBatchFile(const char name[], FILE *out, const batchOptions_t *options);
+
+
+/*!
+    @brief Solves or converts .kvb input of batch mode
+
+    @param[in] input Mapped .kvb file
+    @param[in] out Stream for text results
+    @param[in] kvbOutput Name of .kvb file for results or NULL if results are text
+    @param[in] convert Only print columns of input as text: results if they are present, else coefficients
+    @param[in] options Batch settings
+
+    @return Enum with error code
+
+    Equations are solved directly from mapped columns
+*/
+enum error solveBatchKvb(const mappedFile_t *input, FILE *out, const char *kvbOutput, int convert,
+                         const batchOptions_t *options);
+
+
+/*!
+    @brief Creates .kvb file with coefficients and optionally solves equations into it
+
+    @param[in] name Name of file
+    @param[in] count Number of equations
+    @param[in] a, b, c Columns with coefficients
+    @param[in] solve If not 0, result columns are written too
+    @param[in] options Batch settings
+
+    @return Enum with error code
+
+    File is mapped to memory, so results are written by solver straight to it <br>
+    If solve and options->classify are set, file has only packed column of codes: 3 bits per equation
+*/
+enum error writeKvbFile(const char name[], size_t count, const double a[], const double b[], const double c[],
+                        int solve, const batchOptions_t *options);
+
+
+/*!
+    @brief Runs solver daemon on socket specified with --serve flag
+
+    @param[in] flags Array of flags
+
+    Solver is selected by the same flags as in batch mode: -p, -m, -d, -t <br>
+    After SIGINT or SIGTERM prints counters and latencies to stderr and returns
+*/
+enum error serveSocket(argVal_t flags[]);
+
+
+/*!
+    @brief Runs solver worker on shared memory specified with --shm flag
+
+    @param[in] flags Array of flags
+
+    Solver is selected by the same flags as in batch mode: -p, -m, -d, -t <br>
+    After SIGINT or SIGTERM prints counters to stderr, removes shared memory and returns
+*/
+enum error serveShm(argVal_t flags[]);
+
+
+/*!
+    @brief Runs stress test specified with --stress flag
+
+    @param[in] flags Array of flags
+
+    @return GOOD_EXIT if all answers are right
+
+    Solver and threads are selected by the same flags as in batch mode: -p, -m, -d, -t, but all CPU cores
+    are used by default <br>
+    Prints throughput of solver and number of wrong answers for every family of equations to stdout
+*/
+enum error stressTest(argVal_t flags[]);
+
+
+/*!
+    @brief Runs sweep specified with --sweep flag
+
+    @param[in] flags Array of flags
+
+    @return Enum with error code
+
+    Base equation is given with -c, its varying coefficient is ignored <br>
+    Lines "value code x1 x2" are written to stdout or to text file specified with -o, with -y lines are "value code" <br>
+    -z gives complex roots and -g selects style of numbers like in batch mode
+*/
+enum error sweepEquation(argVal_t flags[]);
+
+
+/*!
+    @brief Writes map of exit codes specified with --plane flag
+
+    @param[in] flags Array of flags
+
+    @return Enum with error code
+
+    Base equation is given with -c, its varying coefficients are ignored <br>
+    Map is written to file -o: *.pgm and *.ppm are images, other names get one byte with code per point <br>
+    -z gives COMPLEX_ROOTS instead of ZERO_ROOTS, -t selects threads (all CPU cores by default) <br>
+    Size of plane, time and number of points with every code are printed to stdout
+*/
+enum error planeEquation(argVal_t flags[]);
+
 #endif
@@ -0,0 +1,79 @@
+/// @file
+/// @brief Read-only access to whole file through memory mapping
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+/*!
+    @brief File mapped to memory
+
+    On POSIX systems file is mapped with mmap, so pages are read only when they are accessed. <br>
+    On other systems whole file is read to allocated buffer
+*/
+typedef struct mappedFile {
+    const char *data;   ///< Contents of file, not null-terminated
+    size_t size;        ///< Size of file in bytes
+    int isMapped;       ///< 1 if data is mapped with mmap, 0 if it was allocated
+} mappedFile_t;
+
+const mappedFile_t BLANK_MAPPED_FILE = {NULL, 0, 0};
+
+
+/*!
+    @brief Maps file to memory for reading
+
+    @param[in] name Name of file
+    @param[out] file Pointer to struct that will hold mapping
+
+    @return GOOD_EXIT or FAIL if file can't be opened or mapped
+
+    Empty file is valid, then data is NULL and size is 0
+*/
+enum error mapFile(const char name[], mappedFile_t *file);
+
+
+/*!
+    @brief Unmaps file and sets struct to BLANK_MAPPED_FILE
+
+    @param[in, out] file Pointer to mapped file
+*/
+void unmapFile(mappedFile_t *file);
+
+
+/*!
+    @brief File of fixed size mapped to memory for writing
+
+    On systems without mmap data is allocated and written to file in unmapWritableFile()
+*/
+typedef struct writableFile {
+    char *data;         ///< Contents of file
+    size_t size;        ///< Size of file in bytes
+    int isMapped;       ///< 1 if data is mapped with mmap, 0 if it was allocated
+    FILE *stream;       ///< Opened file when data is allocated, else NULL
+} writableFile_t;
+
+const writableFile_t BLANK_WRITABLE_FILE = {NULL, 0, 0, NULL};
+
+
+/*!
+    @brief Creates (or truncates) file of specified size and maps it to memory for writing
+
+    @param[in] name Name of file
+    @param[in] size Size of file in bytes
+    @param[out] file Pointer to struct that will hold mapping
+
+    @return GOOD_EXIT or FAIL if file can't be created or mapped
+*/
+enum error mapFileForWriting(const char name[], size_t size, writableFile_t *file);
+
+
+/*!
+    @brief Flushes data to file, unmaps it and sets struct to BLANK_WRITABLE_FILE
+
+    @param[in, out] file Pointer to mapped file
+
+    @return GOOD_EXIT or FAIL if data can't be written
+*/
+enum error unmapWritableFile(writableFile_t *file);
+
+#endif
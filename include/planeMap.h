@@ -0,0 +1,109 @@
+/// @file
+/// @brief Maps of exit codes on a grid of two coefficients, written straight to image or matrix of bytes
+
+#ifndef PLANE_MAP_H
+#define PLANE_MAP_H
+
+/// @brief Rows of one tile of plane, tiles are units of work of threads
+const size_t PLANE_TILE_ROWS = 64;
+
+/// @brief Columns of one tile, scratch columns of a row of tile stay in L1 and L2 caches
+const size_t PLANE_TILE_COLUMNS = 1024;
+
+/// @brief Maximum number of points of plane
+const size_t PLANE_MAX_POINTS = (size_t) 1 << 40;
+
+/// @brief Number of different exit codes on a plane, BLANK_ROOT isn't possible
+const size_t PLANE_CODES = COMPLEX_ROOTS + 1;
+
+/// @brief Names of exit codes for statistics of plane
+const char *const PLANE_CODE_NAMES[PLANE_CODES] = {"no roots", "one root", "two roots", "infinite", "bad input",
+                                                   "three", "four", "complex"};
+
+
+/// @brief Format of map file
+enum planeFormat {
+    PLANE_RAW = 0,      ///< One byte with exit code per point, no header
+    PLANE_PGM,          ///< Binary grayscale PGM (P5), one gray level per exit code
+    PLANE_PPM           ///< Binary color PPM (P6), one color per exit code
+};
+
+
+/*!
+    @brief Grid of equations: columns are values of one coefficient, rows are values of another one
+
+    Every row is a sweep of column coefficient with row value in its base, so rows use sweep kernels. <br>
+    Must be filled with planeInit()
+*/
+typedef struct plane {
+    sweep_t columns;        ///< Sweep along a row, its count is width of plane
+    sweep_t rows;           ///< Values of row coefficient, its count is height of plane; it isn't solved
+} plane_t;
+
+const plane_t BLANK_PLANE = {BLANK_SWEEP, BLANK_SWEEP};
+
+
+/// @brief Results of writePlaneMap()
+typedef struct planeStats {
+    size_t codes[PLANE_CODES];  ///< Number of points with every exit code
+    size_t threads;             ///< Number of threads that classified tiles
+    double wallTime;            ///< Seconds of classification and writing
+} planeStats_t;
+
+const planeStats_t BLANK_PLANE_STATS = {{}, 0, 0};
+
+
+/*!
+    @brief Parses description of plane "b:start:stop:step,c:start:stop:step" and fills plane
+
+    @param[out] plane Pointer to plane
+    @param[in] equation Base equation, varying coefficients are ignored
+    @param[in] description Column range, comma and row range, each is the same as range of sweep
+    @param[in] complex Points with D < 0 get COMPLEX_ROOTS
+
+    @return GOOD_EXIT or BAD_EXIT if description is wrong, coefficients are the same or plane is too big
+*/
+enum error planeInit(plane_t *plane, const quadraticEquation_t *equation, const char description[], int complex);
+
+
+/// @brief Returns PLANE_PGM for *.pgm, PLANE_PPM for *.ppm and PLANE_RAW for other names
+enum planeFormat planeFormatFromName(const char name[]);
+
+
+/*!
+    @brief Finds exit codes of points [column, column + count) in one row of plane
+
+    @param[in] plane Plane filled by planeInit()
+    @param[in] type Type of sweep and batch kernels
+    @param[in] row Number of row
+    @param[in] column Number of the first column
+    @param[in] count Number of points, column + count can't be greater than width of plane
+    @param[out] scratch Batch with capacity of count: codes go to code, values of column coefficient to a
+
+    @return Enum with error code, BAD_EXIT if kernel of this type isn't supported
+
+    Codes are the same as solveEquation() (or solveEquationComplex()) gives for every point
+*/
+enum error classifyPlaneRowByType(const plane_t *plane, enum kernelType type, size_t row, size_t column, size_t count,
+                                  quadraticBatch_t *scratch);
+
+
+/*!
+    @brief Classifies all points of plane by tiles in thread pool and writes them to mapped file
+
+    @param[in] name Name of map file
+    @param[in] plane Plane filled by planeInit()
+    @param[in] format Format of map file
+    @param[in] threads Number of threads, 0 or 1 means calling thread
+    @param[out] stats Number of points with every exit code and time
+
+    @return Enum with error code
+
+    The first row of file is the first value of row coefficient, so descending range turns image upside down. <br>
+    Every thread keeps only scratch columns of one tile row, points are never stored as numbers or text,
+    so memory doesn't depend on size of plane
+*/
+enum error writePlaneMap(const char name[], const plane_t *plane, enum planeFormat format, size_t threads,
+                         planeStats_t *stats);
+
+#endif
@@ -0,0 +1,93 @@
+/// @file
+/// @brief Real roots of cubic and quartic polynomials in closed form, one by one and by columns
+
+#ifndef POLYNOMIAL_SOLVER_H
+#define POLYNOMIAL_SOLVER_H
+
+/*!
+    @brief Roots closer than this (relative to max(1, |x|)) are merged into one
+
+    Multiple roots come from discriminants that are only near zero, so they are split by about sqrt of rounding error
+*/
+const double POLY_ROOT_MERGE = 1e-7;
+
+/*!
+    @brief Discriminants and coefficients of depressed polynomials are zero if they are this small relative to their terms
+
+    Relative check works for polynomials of any scale, isZero() would see a multiple root in every small one
+*/
+const double POLY_ZERO_TOLERANCE = 1e-10;
+
+/// @brief Maximum number of Newton steps that polish every root, closed-form roots need one or two
+const int POLY_NEWTON_STEPS = 3;
+
+
+/*!
+    @brief Columns of polynomials with the same degree and their roots
+
+    Must be allocated with polyBatchAlloc() and freed with polyBatchFree()
+*/
+typedef struct polynomialBatch {
+    int degree;                         ///< Degree of all polynomials, 3 or 4
+    size_t size;                        ///< Number of polynomials in batch
+    size_t capacity;                    ///< Number of allocated rows
+    double *coeffs[MAX_DEGREE + 1];     ///< Columns of coefficients from the highest power, degree + 1 are allocated
+    enum solutionCode *code;            ///< Column with exit codes
+    double *roots[MAX_DEGREE];          ///< Columns with roots in ascending order, degree are allocated
+} polynomialBatch_t;
+
+const polynomialBatch_t BLANK_POLY_BATCH = {0, 0, 0, {NULL, NULL, NULL, NULL, NULL}, NULL, {NULL, NULL, NULL, NULL}};
+
+
+/*!
+    @brief Solves polynomial equation of degree 2, 3 or 4
+
+    @param[in, out] poly Pointer to struct with degree, coefficients and answer
+
+    @return Enum with error code, FAIL for inf or NaN coefficients or unsupported degree
+
+    Degree 2 is solved with solveEquation() <br>
+    Degree 3 is solved with Cardano's formula if it has one root and with trigonometric one if it has three <br>
+    Degree 4 is solved with Ferrari's method: roots of resolvent cubic give two quadratics <br>
+    Closed forms are applied to polynomial with x scaled by power of 2, so roots are about 1 in modulus <br>
+    The biggest root is divided out and polynomial that is left gives small roots again,
+    degree 4 divides out the bigger quadratic factor of Ferrari's method too <br>
+    Leading coefficient that is zero lowers degree and zero free term gives root 0 and lower degree,
+    so cubic and quadratic solvers are used as sub-steps <br>
+    Every root is polished with Newton steps on original polynomial while they make residual smaller,
+    candidates whose residual is bigger than rounding noise (POLY_ZERO_TOLERANCE of terms) are dropped
+*/
+enum error solvePolynomial(polynomial_t* poly);
+
+
+/*!
+    @brief Allocates columns of batch
+
+    @param[out] batch Pointer to batch
+    @param[in] degree Degree of polynomials, 3 or 4
+    @param[in] capacity Number of rows
+
+    @return Enum with error code
+*/
+enum error polyBatchAlloc(polynomialBatch_t* batch, int degree, size_t capacity);
+
+
+/*!
+    @brief Frees columns of batch and sets it to BLANK_POLY_BATCH
+*/
+void polyBatchFree(polynomialBatch_t* batch);
+
+
+/*!
+    @brief Solves all polynomials of batch
+
+    @param[in, out] batch Batch with coefficients, code and roots are written
+
+    @return Enum with error code
+
+    Degree is checked once, then every row goes through the same closed-form kernel as solvePolynomial()
+    without dispatch, rows with inf or NaN get BAD_INPUT
+*/
+enum error solvePolynomialColumns(polynomialBatch_t* batch);
+
+#endif
@@ -0,0 +1,53 @@
+/// @file
+/// @brief Adaptive-precision solver: fast double path with double-double fallback for ill-conditioned equations
+
+#ifndef PRECISE_SOLVER_H
+#define PRECISE_SOLVER_H
+
+/*!
+    @brief Discriminant is recomputed in double-double if it is less than CANCELLATION_RATIO * max(b^2, |4ac|)
+
+    Error of D is about ulp(b^2), so relative error of roots is about 2^-54 * sqrt(b^2 / D). <br>
+    With 2^-6 fast path loses at most 3 bits, more ill-conditioned equations take slow path
+*/
+const double CANCELLATION_RATIO = 1.0 / 64;
+
+
+/// @brief Counters of adaptive solver
+typedef struct precisionStats {
+    size_t equations;   ///< Number of solved equations
+    size_t slowPath;    ///< Number of equations that were solved in double-double
+} precisionStats_t;
+
+const precisionStats_t BLANK_PRECISION_STATS = {0, 0};
+
+
+/*!
+    @brief Solves quadratic equation with adaptive precision
+
+    @param[in, out] equation Pointer to struct that holds coeffs and answers
+    @param[in, out] stats Counters that are incremented, can be NULL
+
+    @return Enum with error code, FAIL only if input is NaN or inf
+
+    Exit codes are chosen like in solveEquation(), but roots are computed with stable formulas: <br>
+    q = -(b + sign(b) * sqrt(D)) / 2, roots are q / a and c / q, so -b +- sqrt(D) never cancels out. <br>
+    Equations where b^2 - 4ac loses most of it's bits or can overflow/underflow take slow path: <br>
+    coefficients and x are scaled by powers of 2, discriminant is computed exactly with fma in double-double,
+    then roots are polished with one Newton step
+*/
+enum error solveEquationPrecise(quadraticEquation_t* equation, precisionStats_t* stats);
+
+
+/*!
+    @brief Solves equations stored in columns with solveEquationPrecise()
+
+    @param[in] count Number of equations
+    @param[in] a, b, c Columns with coefficients
+    @param[out] code, x1, x2 Columns for results, roots that don't have sense are NAN
+    @param[in, out] stats Counters that are incremented, can be NULL
+*/
+void solveColumnsPrecise(size_t count, const double a[], const double b[], const double c[],
+                         enum solutionCode code[], double x1[], double x2[], precisionStats_t* stats);
+
+#endif
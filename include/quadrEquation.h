@@ -14,6 +14,9 @@ enum solutionCode {
     TWO_ROOTS,          ///< 2 roots
     INF_ROOTS,          ///< infinity roots, 0 = 0
     BAD_INPUT,          ///< When input is inf of Nan
+    THREE_ROOTS,        ///< 3 roots, only for polynomial_t
+    FOUR_ROOTS,         ///< 4 roots, only for polynomial_t
+    COMPLEX_ROOTS,      ///< 2 complex roots x1 ± i*x2, only in complex mode: x1 is real part, x2 > 0 is imaginary part
     BLANK_ROOT = -1     ///< This code is used when solution_t is initialized
 };
 
@@ -27,7 +30,7 @@ typedef struct solution{
     double x2;              ///< second root
 } solution_t;
 
-const solution_t BLANK_SOLUTION = {BLANK_ROOT, NAN, NAN};
+constexpr solution_t BLANK_SOLUTION = {BLANK_ROOT, NAN, NAN};
 
 
 /// @brief Struct that stores coeffs and answers of quadratic equation
@@ -36,6 +39,52 @@ typedef struct quadraticEquation {
     solution_t answer;  ///< structure with exit code and answers
 } quadraticEquation_t;
 
-const quadraticEquation_t BLANK_QUADRATIC_EQUATION = {NAN, NAN, NAN, BLANK_SOLUTION};
+constexpr quadraticEquation_t BLANK_QUADRATIC_EQUATION = {NAN, NAN, NAN, BLANK_SOLUTION};
+
+
+/// @brief solution_t with single-precision roots
+typedef struct solutionF {
+    enum solutionCode code; ///< enum with exit codes; in basic cases = number of roots
+    float x1;               ///< first root
+    float x2;               ///< second root
+} solutionF_t;
+
+constexpr solutionF_t BLANK_SOLUTION_F = {BLANK_ROOT, NAN, NAN};
+
+
+/// @brief quadraticEquation_t with single-precision coefficients and roots
+typedef struct quadraticEquationF {
+    float a, b, c;      ///< Coefficients of quadratic polynomial
+    solutionF_t answer; ///< structure with exit code and answers
+} quadraticEquationF_t;
+
+constexpr quadraticEquationF_t BLANK_QUADRATIC_EQUATION_F = {NAN, NAN, NAN, BLANK_SOLUTION_F};
+
+
+/// @brief Maximum degree of polynomial_t
+const int MAX_DEGREE = 4;
+
+
+/*!
+    @brief Real roots of polynomial
+
+    Roots are different and go in ascending order, unused ones are NaN
+*/
+typedef struct polySolution {
+    enum solutionCode code;     ///< Number of roots (ONE_ROOT ... FOUR_ROOTS), ZERO_ROOTS, INF_ROOTS or BAD_INPUT
+    double roots[MAX_DEGREE];   ///< Roots
+} polySolution_t;
+
+constexpr polySolution_t BLANK_POLY_SOLUTION = {BLANK_ROOT, {NAN, NAN, NAN, NAN}};
+
+
+/// @brief Polynomial equation of degree 2, 3 or 4, generalization of quadraticEquation_t
+typedef struct polynomial {
+    int degree;                         ///< Degree of polynomial, number of coefficients is degree + 1
+    double coeffs[MAX_DEGREE + 1];      ///< Coefficients from the highest power: coeffs[0] * x^degree + ... + coeffs[degree]
+    polySolution_t answer;              ///< structure with exit code and roots
+} polynomial_t;
+
+constexpr polynomial_t BLANK_POLYNOMIAL = {0, {NAN, NAN, NAN, NAN, NAN}, BLANK_POLY_SOLUTION};
 
 #endif
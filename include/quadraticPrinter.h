@@ -4,10 +4,76 @@
 #ifndef QUADRATIC_PRINTER_H
 #define QUADRATIC_PRINTER_H
 
+/// @brief How numbers are rendered to text
+enum numberStyle {
+    SHORTEST_NUMBERS,   ///< Shortest string that is read back to the same double
+    PRETTY_NUMBERS      ///< Like "%g": 6 significant digits, easy to read, but not exact
+};
+
+
+/// @brief Maximum length of one formatted number, "-2.2250738585072014e-308" has 24 characters
+const size_t MAX_NUMBER_LEN = 32;
+
+/// @brief Maximum length of equation formatted by formatKvadr()
+const size_t MAX_EQUATION_LEN = 3 * MAX_NUMBER_LEN + 32;
+
+/// @brief Maximum length of answer formatted by formatAnswer()
+const size_t MAX_ANSWER_LEN = 4 * MAX_NUMBER_LEN + 32; //complex roots print real and imaginary parts twice
+
+
+/*!
+    @brief Writes number to buffer without null-terminator
+
+    @param[out] out Buffer of at least MAX_NUMBER_LEN bytes
+    @param[in] num Number
+    @param[in] style SHORTEST_NUMBERS or PRETTY_NUMBERS
+
+    @return Number of written characters
+
+    Uses std::to_chars, so result doesn't depend on locale <br>
+    Shortest style is round-trip exact: strtod() of output gives the same double
+*/
+size_t formatNumber(char *out, double num, enum numberStyle style);
+
+
+/*!
+    @brief Same as formatNumber(), but shortest style is exact for float: strtof() of output gives the same float
+
+    Roots of single-precision solver printed with formatNumber() would get digits that float doesn't have
+*/
+size_t formatNumberF(char *out, float num, enum numberStyle style);
+
+
+/*!
+    @brief Formats quadratic equation like printKvadr(), but without colors
+
+    @param[out] out Buffer of at least MAX_EQUATION_LEN bytes, result is null-terminated
+    @param[in] equation Pointer to struct with coeffs
+    @param[in] style Style of coefficients
+
+    @return Number of written characters without null-terminator
+*/
+size_t formatKvadr(char *out, const quadraticEquation_t* equation, enum numberStyle style);
+
+
+/*!
+    @brief Formats roots of solved equation like printAnswer()
+
+    @param[out] out Buffer of at least MAX_ANSWER_LEN bytes, result is null-terminated
+    @param[out] length Number of written characters without null-terminator
+    @param[in] equation Pointer to struct that holds coeffs and answers
+    @param[in] style Style of roots
+
+    @return Enum with error code, BAD_EXIT if code of answer is unknown
+*/
+enum error formatAnswer(char *out, size_t *length, const quadraticEquation_t* equation, enum numberStyle style);
+
+
 /*!
     @brief Prints quadratic equation in nice format
 
     @param[in] equation Pointer to struct with coeffs
+    @param[in] style Style of coefficients
 
     @returns Enum with error code <br>
     In current implementation return is always GOOD_EXIT
@@ -16,7 +82,7 @@
     Example: 0 1 -5 <br>
     => x - 5 = 0
 */
-enum error printKvadr(const quadraticEquation_t* equation);
+enum error printKvadr(const quadraticEquation_t* equation, enum numberStyle style);
 
 
 
@@ -24,8 +90,21 @@ enum error printKvadr(const quadraticEquation_t* equation);
     @brief Prints roots of solved equation
 
     @param[in] equation Pointer to struct that holds coeffs and answers
+    @param[in] style Style of roots
 
     @return Enum with error code
 */
-enum error printAnswer(const quadraticEquation_t* equation);
+enum error printAnswer(const quadraticEquation_t* equation, enum numberStyle style);
+
+
+/*!
+    @brief Prints number of roots of equation classified by classifyEquation()
+
+    @param[in] equation Pointer to struct that holds coeffs and code of answer
+
+    @return Enum with error code, BAD_EXIT if code is unknown
+
+    Codes without roots are printed like in printAnswer()
+*/
+enum error printRootsCount(const quadraticEquation_t* equation);
 #endif
@@ -14,8 +14,47 @@
  *  In current implementation returns fail only if input is nan of inf
  *
  *  Solves quadratic equation in form ax^2 + bx + c = 0 <br>
- *  Fixes -0 in answer
+ *  Fixes -0 in answer <br>
+ *  Same as solveQuadraticT() with double and checkedPolicy_t
 */
 enum error solveEquation(quadraticEquation_t* equation);
 
+
+/*!
+ *  @brief solves quadratic equation, negative discriminant gives complex roots
+ *
+ *  @param[in, out] equation Pointer to struct that holds coeffs and answers
+ *
+ *  @returns Enum with error code
+ *
+ *  Same as solveEquation(), but instead of ZERO_ROOTS quadratic equation with D < 0 gets COMPLEX_ROOTS:
+ *  x1 = -b / 2a is real part and x2 = sqrt(-D) / |2a| is imaginary part of roots x1 ± i*x2
+*/
+enum error solveEquationComplex(quadraticEquation_t* equation);
+
+
+/*!
+ *  @brief finds only number of real roots of quadratic equation
+ *
+ *  @param[in, out] equation Pointer to struct that holds coeffs and answers
+ *
+ *  @returns Enum with error code, fail if input is nan or inf
+ *
+ *  Sets only equation->answer.code, it's always the same as code of solveEquation(), roots are left as they were <br>
+ *  Discriminant and isZero() checks are enough for it, so sqrt and divisions aren't computed
+*/
+enum error classifyEquation(quadraticEquation_t* equation);
+
+
+/*!
+ *  @brief solves quadratic equation in single precision
+ *
+ *  @param[in, out] equation Pointer to struct that holds coeffs and answers
+ *
+ *  @returns Enum with error code
+ *
+ *  Same as solveEquation(), but numbers are float and zeros are compared with EPSILON_F
+*/
+enum error solveEquationF(quadraticEquationF_t* equation);
+
 #endif
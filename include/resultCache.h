@@ -0,0 +1,92 @@
+/// @file
+/// @brief Concurrent cache of solutions keyed on bit patterns of coefficients
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+/// @brief Number of entries in one set of cache, replacement is done inside set
+const size_t CACHE_WAYS = 8;
+
+/// @brief Number of shards if resultCacheCreate() is asked for 0 shards
+const size_t DEFAULT_CACHE_SHARDS = 64;
+
+
+/// @brief Opaque cache, created with resultCacheCreate()
+typedef struct resultCache resultCache_t;
+
+
+/// @brief Counters of cache, summed over all shards
+typedef struct cacheStats {
+    size_t hits;        ///< Lookups that found solution
+    size_t misses;      ///< Lookups that had to call solver
+    size_t evictions;   ///< Entries replaced by newer ones
+} cacheStats_t;
+
+const cacheStats_t BLANK_CACHE_STATS = {0, 0, 0};
+
+
+/*!
+    @brief Creates empty cache
+
+    @param[in] capacity Maximum number of cached solutions, rounded up to whole sets
+    @param[in] shards Number of independently locked parts, rounded up to power of 2, 0 means DEFAULT_CACHE_SHARDS
+
+    @return Pointer to cache or NULL if it can't be created
+
+    All memory is allocated here, cache never grows. <br>
+    Every shard is a set-associative table with CACHE_WAYS entries per set, evicted entry is chosen by CLOCK
+*/
+resultCache_t *resultCacheCreate(size_t capacity, size_t shards);
+
+
+/*!
+    @brief Frees cache
+
+    @param[in] cache Pointer to cache, can be NULL
+*/
+void resultCacheDestroy(resultCache_t *cache);
+
+
+/*!
+    @brief Solves equation with solveEquation() or takes it's solution from cache
+
+    @param[in] cache Pointer to cache
+    @param[in, out] equation Pointer to struct that holds coeffs and answers
+
+    @return Result of solveEquation()
+
+    Key is bit patterns of a, b and c, so 0 and -0 or NaNs with different payloads are different keys. <br>
+    Cached answer is the one solveEquation() gives for equation with BLANK_SOLUTION. <br>
+    Can be called from many threads at once, solver is called outside of shard lock
+*/
+enum error solveEquationCached(resultCache_t *cache, quadraticEquation_t* equation);
+
+
+/*!
+    @brief Solves equations stored in columns with solveEquationCached()
+
+    @param[in] cache Pointer to cache
+    @param[in] count Number of equations
+    @param[in] a, b, c Columns with coefficients
+    @param[out] code, x1, x2 Columns for results, the same as solveEquationColumns() gives
+*/
+void solveColumnsCached(resultCache_t *cache, size_t count, const double a[], const double b[], const double c[],
+                        enum solutionCode code[], double x1[], double x2[]);
+
+
+/*!
+    @brief Returns counters of cache
+
+    @param[in] cache Pointer to cache
+
+    @return Sum of counters of all shards, BLANK_CACHE_STATS if cache is NULL
+*/
+cacheStats_t resultCacheStats(resultCache_t *cache);
+
+
+/*!
+    @brief Returns maximum number of solutions that cache can hold
+*/
+size_t resultCacheCapacity(const resultCache_t *cache);
+
+#endif
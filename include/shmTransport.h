@@ -0,0 +1,179 @@
+/// @file
+/// @brief Layout of shared memory segment that worker (--shm) and client library use to exchange batches
+///
+/// Segment is POSIX shared memory object, it starts with shmHeader_t, then go two rings of slot indices
+/// and slots (all offsets are in header):
+///
+/// | Part          | Size                      | Written by                                   |
+/// |---------------|---------------------------|----------------------------------------------|
+/// | shmHeader_t   | sizeof(shmHeader_t)       | worker at start, indices by their owners     |
+/// | request ring  | 4 * slots                 | client: indices of filled slots              |
+/// | response ring | 4 * slots                 | worker: indices of solved slots              |
+/// | slots         | slotSize * slots          | client: a, b, c; worker: code, x1, x2        |
+///
+/// Every slot is shmSlotHeader_t and columns a, b, c, x1, x2 of doubles and code of int32 with values
+/// of solutionCode, each column has slotEquations items and starts at multiple of SHM_ALIGNMENT. <br>
+/// Client owns slots that aren't in rings: it fills a, b, c, count and id of free slot and pushes it's index
+/// to request ring, worker solves columns in place and pushes the same index to response ring. <br>
+/// Both rings have one producer and one consumer, so segment serves one client at a time. <br>
+/// Sleeping side sets it's waiting flag and waits on futex of index that the other side moves,
+/// the other side calls futex wake only if the flag is set
+#ifndef SHM_TRANSPORT_H
+#define SHM_TRANSPORT_H
+
+#include <stdint.h>
+#include <atomic>
+
+/// @brief "KSHM" in little-endian, written to header after segment is ready
+const uint32_t SHM_MAGIC = 0x4D48534B;
+
+/// @brief Version of layout, client refuses segment with other version
+const uint32_t SHM_VERSION = 1;
+
+/// @brief Alignment of header parts, slots and columns, every index written by other side is in it's own cache line
+const size_t SHM_ALIGNMENT = 64;
+
+/// @brief Number of slots of segment created by worker, power of 2
+const uint32_t SHM_DEFAULT_SLOTS = 64;
+
+/// @brief Capacity of one slot in equations
+const uint32_t SHM_DEFAULT_SLOT_EQUATIONS = 4096;
+
+/// @brief Number of failed checks of ring that are spinning before side goes to sleep on futex
+const size_t SHM_SPIN_LIMIT = 256;
+
+/// @brief Time of one futex wait in ms, sleeping side checks state of the other one after it
+const long SHM_WAIT_MS = 100;
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "indices in shared memory must be lock-free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex waits on index itself");
+
+
+/// @brief States of worker
+enum shmState {
+    SHM_STARTING = 0,   ///< Segment is created, but not initialized
+    SHM_RUNNING,        ///< Worker takes requests
+    SHM_STOPPED         ///< Worker exited, requests won't be answered
+};
+
+/// @brief Statuses of solved slots
+enum shmStatus {
+    SHM_OK = 0,
+    SHM_BAD_SIZE,           ///< Count of slot is greater than slotEquations
+    SHM_SOLVER_FAILED       ///< Solver couldn't allocate memory
+};
+
+
+/*!
+    @brief Index of ring in it's own cache line
+
+    Rings are never full: client has only slots number of slots, so heads aren't waited on
+*/
+typedef struct alignas(SHM_ALIGNMENT) shmIndex {
+    std::atomic<uint32_t> value;        ///< Number of pushed (tail) or taken (head) items, wraps around
+    std::atomic<uint32_t> waiting;      ///< Consumer of ring sleeps on futex of value of tail
+} shmIndex_t;
+
+
+/// @brief The beginning of segment
+typedef struct alignas(SHM_ALIGNMENT) shmHeader {
+    std::atomic<uint32_t> magic;        ///< SHM_MAGIC, it's stored last with release order
+    uint32_t version;                   ///< SHM_VERSION
+    uint32_t slots;                     ///< Number of slots and size of both rings, power of 2
+    uint32_t slotEquations;             ///< Capacity of one slot
+    uint64_t slotSize;                  ///< Bytes of one slot with header and columns
+    uint64_t requestRingOffset;         ///< Offset of request ring from the beginning of segment
+    uint64_t responseRingOffset;        ///< Offset of response ring
+    uint64_t slotsOffset;               ///< Offset of the first slot
+    uint64_t segmentSize;               ///< Size of whole segment
+    std::atomic<uint32_t> state;        ///< One of shmState
+    std::atomic<uint32_t> clientPid;    ///< Process of attached client, 0 if segment is free
+    uint32_t workerPid;                 ///< Process of worker, new worker replaces segment only if it's dead
+    shmIndex_t requestTail;             ///< Moved by client, worker sleeps on it
+    shmIndex_t requestHead;             ///< Moved by worker
+    shmIndex_t responseTail;            ///< Moved by worker, client sleeps on it
+    shmIndex_t responseHead;            ///< Moved by client
+} shmHeader_t;
+
+
+/// @brief The beginning of slot
+typedef struct alignas(SHM_ALIGNMENT) shmSlotHeader {
+    uint64_t id;                        ///< Chosen by client, isn't changed by worker
+    uint32_t count;                     ///< Number of equations in slot
+    uint32_t status;                    ///< One of shmStatus, written by worker
+} shmSlotHeader_t;
+
+
+/// @brief Returns size rounded up to multiple of SHM_ALIGNMENT
+inline uint64_t shmAlign(uint64_t size) {
+    return (size + SHM_ALIGNMENT - 1) / SHM_ALIGNMENT * SHM_ALIGNMENT;
+}
+
+
+/// @brief Returns size of one slot with capacity of equations
+inline uint64_t shmSlotSize(uint32_t equations) {
+    return sizeof(shmSlotHeader_t) + 5 * shmAlign(equations * sizeof(double)) + shmAlign(equations * sizeof(int32_t));
+}
+
+
+/// @brief Returns the first byte of column number column (a, b, c, x1, x2, code) of slot
+inline char *shmSlotColumn(shmSlotHeader_t *slot, uint32_t equations, int column) {
+    return (char*) slot + sizeof(shmSlotHeader_t) + (uint64_t) column * shmAlign(equations * sizeof(double));
+}
+
+
+/// @brief Returns slot number index of segment by layout in header, worker uses it's own copy of layout instead
+inline shmSlotHeader_t *shmSlot(shmHeader_t *header, uint32_t index) {
+    return (shmSlotHeader_t*) ((char*) header + header->slotsOffset + (uint64_t) index * header->slotSize);
+}
+
+
+#ifdef __linux__
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+/*!
+    @brief Waits until tail of ring moves from seen value: spins, then sleeps on futex
+
+    @param[in] tail Tail of ring that the other side moves
+    @param[in] seen Value of tail that consumer has already processed
+
+    @return 1 if tail moved, 0 after SHM_WAIT_MS without it, so caller can check state of the other side
+
+    Flag is set before the last check and index is stored before flag is read (both sequentially consistent),
+    so wake can't be lost between them
+*/
+inline int shmWaitIndex(shmIndex_t *tail, uint32_t seen) {
+    for (size_t spin = 0; spin < SHM_SPIN_LIMIT; spin++) {
+        if (tail->value.load(std::memory_order_acquire) != seen) return 1;
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+    tail->waiting.store(1);
+    if (tail->value.load() == seen) {
+        struct timespec timeout = {0, SHM_WAIT_MS * 1000000};
+        syscall(SYS_futex, (uint32_t*) &tail->value, FUTEX_WAIT, seen, &timeout, NULL, 0);
+    }
+    tail->waiting.store(0, std::memory_order_relaxed);
+    return tail->value.load(std::memory_order_acquire) != seen;
+}
+
+
+/*!
+    @brief Moves tail of ring and wakes consumer if it sleeps
+
+    @param[in] tail Tail of ring, only caller moves it
+    @param[in] value New value of tail
+*/
+inline void shmPublishIndex(shmIndex_t *tail, uint32_t value) {
+    tail->value.store(value);
+    if (tail->waiting.load())
+        syscall(SYS_futex, (uint32_t*) &tail->value, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+#endif
+
+#endif
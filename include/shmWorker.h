@@ -0,0 +1,38 @@
+/// @file
+/// @brief Worker that solves batches of co-located client in shared memory, layout of segment is in shmTransport.h
+
+#ifndef SHM_WORKER_H
+#define SHM_WORKER_H
+
+/// @brief Number of solved slots after which worker checks signals even if requests don't stop
+const uint64_t SHM_SIGNAL_CHECK_PERIOD = 1024;
+
+
+/// @brief Counters of worker
+typedef struct shmStats {
+    uint64_t requests;      ///< Answered slots
+    uint64_t equations;     ///< Solved equations
+    uint64_t failed;        ///< Slots answered with status other than SHM_OK
+} shmStats_t;
+
+const shmStats_t BLANK_SHM_STATS = {0, 0, 0};
+
+
+/*!
+    @brief Creates shared memory segment and solves slots of it's client until SIGINT or SIGTERM
+
+    @param[in] name Name of POSIX shared memory object, like "/kvadratka"
+    @param[in] options Batch settings, they select solver for every slot
+    @param[out] stats Counters at shutdown, can be NULL
+
+    @return GOOD_EXIT after signal or FAIL if segment can't be created or is served by live worker
+
+    Segment has SHM_DEFAULT_SLOTS slots of SHM_DEFAULT_SLOT_EQUATIONS equations, results are written to the same slot,
+    so equations aren't copied. <br>
+    Worker spins SHM_SPIN_LIMIT times on empty ring and then sleeps on futex, client wakes it only if it sleeps. <br>
+    Segment is removed at exit, attached client sees SHM_STOPPED. <br>
+    Works only on Linux
+*/
+enum error serveSharedMemory(const char name[], const batchOptions_t *options, shmStats_t *stats);
+
+#endif
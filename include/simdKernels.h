@@ -0,0 +1,184 @@
+/// @file
+/// @brief SIMD kernels for batch solver and runtime selection of the best one
+
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+/// @brief Signature of function that solves equations stored in columns
+typedef void (*batchKernel_t)(size_t count, const double a[], const double b[], const double c[],
+                              enum solutionCode code[], double x1[], double x2[]);
+
+/// @brief Signature of single-precision kernel, vector of the same width holds twice more equations
+typedef void (*batchKernelF_t)(size_t count, const float a[], const float b[], const float c[],
+                               enum solutionCode code[], float x1[], float x2[]);
+
+/// @brief Signature of function that finds only exit codes of equations stored in columns
+typedef void (*classifyKernel_t)(size_t count, const double a[], const double b[], const double c[],
+                                 enum solutionCode code[]);
+
+
+/*!
+    @brief Parts of equations of sweep that don't depend on point, computed once by sweepInit()
+
+    Sweep kernels are used only if a is fixed, finite and isn't zero, so b or c varies:
+    value of point i is start + i * step
+*/
+typedef struct sweepInvariants {
+    double start;       ///< Value of varying coefficient in point 0
+    double step;        ///< Difference between values of neighbour points
+    double fixedTerm;   ///< b*b if c varies, 4ac if b varies; rounded like in solveEquation()
+    double fourA;       ///< 4a, multiplier of varying c
+    double negB;        ///< -b if c varies
+    double vertex;      ///< -b / 2a if c varies: double root and real part of complex roots
+    double invTwoA;     ///< 1 / 2a, roots are multiplied by it instead of division
+} sweepInvariants_t;
+
+/*!
+    @brief Signature of function that solves points [first, first + count) of sweep
+
+    Values of varying coefficient are generated in registers and written to value column with results
+*/
+typedef void (*sweepKernel_t)(size_t first, size_t count, const sweepInvariants_t *sweep,
+                              double value[], enum solutionCode code[], double x1[], double x2[]);
+
+
+/// @brief Instruction sets that have their own batch kernel
+enum kernelType {
+    KERNEL_PORTABLE = 0,    ///< Plain C++ loop, compiler decides how to vectorize it
+    KERNEL_SSE2,            ///< 2 equations per iteration, 4 in single precision
+    KERNEL_AVX2,            ///< 4 equations per iteration, 8 in single precision
+    KERNEL_AVX512,          ///< 8 equations per iteration, 16 in single precision
+    KERNEL_TYPES_COUNT      ///< Number of kernel types
+};
+
+
+/*!
+    @brief Plain C++ kernel, used on all platforms and for tails of SIMD kernels
+
+    Results are bit-identical to solveEquation() applied to equation initialized with BLANK_SOLUTION
+*/
+void solveColumnsPortable(size_t count, const double a[], const double b[], const double c[],
+                          enum solutionCode code[], double x1[], double x2[]);
+
+
+/*!
+    @brief Single-precision version of solveColumnsPortable()
+
+    Results are bit-identical to solveEquationF() applied to equation initialized with BLANK_SOLUTION_F
+*/
+void solveColumnsPortableF(size_t count, const float a[], const float b[], const float c[],
+                           enum solutionCode code[], float x1[], float x2[]);
+
+
+/*!
+    @brief Detects the best kernel supported by current CPU
+
+    @return Type of kernel
+
+    Uses cpuid to check instruction sets and xgetbv to check that OS saves wide registers,
+    result of the first call is reused, so *ByType() getters are cheap
+*/
+enum kernelType detectKernelType();
+
+
+/*!
+    @brief Returns kernel of specified type
+
+    @param[in] type Type of kernel
+
+    @return Pointer to kernel or NULL if kernel isn't compiled in or not supported by CPU
+*/
+batchKernel_t getKernelByType(enum kernelType type);
+
+
+/*!
+    @brief Returns the best kernel for current CPU
+
+    Kernel is selected on first call and cached
+*/
+batchKernel_t getBatchKernel();
+
+
+/*!
+    @brief Returns kernel of specified type that finds complex roots
+
+    @param[in] type Type of kernel
+
+    @return Pointer to kernel or NULL if kernel isn't compiled in or not supported by CPU
+
+    Results are bit-identical to solveEquationComplex() applied to equation initialized with BLANK_SOLUTION <br>
+    It's the same kernel as getKernelByType() gives, equations with D < 0 just keep -b / 2a and sqrt(|D|) / |2a|
+    that it computes anyway, so it costs one more division per vector
+*/
+batchKernel_t getComplexKernelByType(enum kernelType type);
+
+
+/*!
+    @brief Returns the best kernel for current CPU that finds complex roots
+
+    Kernel is selected on first call and cached
+*/
+batchKernel_t getBatchKernelComplex();
+
+
+/*!
+    @brief Returns classify kernel of specified type
+
+    @param[in] type Type of kernel
+
+    @return Pointer to kernel or NULL if kernel isn't compiled in or not supported by CPU
+
+    Codes are bit-identical to codes of getKernelByType() kernels and of solveEquation(), every row is handled
+    by kernel itself: it has only multiplications and comparisons, so special rows don't need separate paths
+*/
+classifyKernel_t getClassifyKernelByType(enum kernelType type);
+
+
+/*!
+    @brief Returns the best classify kernel for current CPU
+
+    Kernel is selected on first call and cached
+*/
+classifyKernel_t getClassifyKernel();
+
+
+/*!
+    @brief Returns sweep kernel of specified type
+
+    @param[in] type Type of kernel
+    @param[in] bVaries If not 0, b varies and c is fixed, else c varies and b is fixed
+    @param[in] complex If not 0, points with D < 0 get COMPLEX_ROOTS like in getComplexKernelByType()
+
+    @return Pointer to kernel or NULL if kernel isn't compiled in or not supported by CPU
+
+    Discriminant and codes are bit-identical to solveEquation() of the same point, only the varying term
+    of discriminant is computed for every point <br>
+    Roots are multiplied by 1 / 2a instead of division, so they can differ from solveEquation() in the last bit
+*/
+sweepKernel_t getSweepKernelByType(enum kernelType type, int bVaries, int complex);
+
+
+/*!
+    @brief Returns single-precision kernel of specified type
+
+    @return Pointer to kernel or NULL if kernel isn't compiled in or not supported by CPU
+*/
+batchKernelF_t getKernelFByType(enum kernelType type);
+
+
+/*!
+    @brief Returns the best single-precision kernel for current CPU
+*/
+batchKernelF_t getBatchKernelF();
+
+
+/*!
+    @brief Returns name of kernel type
+
+    @param[in] type Type of kernel
+
+    @return Constant string with name, for example "avx2"
+*/
+const char *kernelName(enum kernelType type);
+
+#endif
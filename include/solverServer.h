@@ -0,0 +1,100 @@
+/// @file
+/// @brief Daemon that solves batches of equations for local clients over Unix domain socket
+///
+/// Clients and server exchange frames, every frame is header and payload (all numbers are little-endian):
+///
+/// | Offset | Size | Field                                                      |
+/// |--------|------|------------------------------------------------------------|
+/// | 0      | 4    | size, uint32 - size of payload in bytes                    |
+/// | 4      | 2    | type, uint16 - one of serverFrameType                      |
+/// | 6      | 2    | status, uint16 - 0 in requests, one of serverStatus in replies |
+/// | 8      | 8    | id, uint64 - any number chosen by client, copied to reply  |
+///
+/// SERVER_SOLVE request: columns a[n], b[n], c[n] of doubles, n = size / 24 <br>
+/// SERVER_SOLVE reply: columns x1[n], x2[n] of doubles and code[n] of int32 with values of solutionCode,
+/// code is padded with zeros to multiple of 8 bytes, so n = size / 20 rounded down <br>
+/// SERVER_STATS request has empty payload, reply payload is serverStats_t <br>
+/// Reply with status other than SERVER_OK has empty payload
+///
+/// Client can send many requests without waiting for replies, they are answered in the same order
+#ifndef SOLVER_SERVER_H
+#define SOLVER_SERVER_H
+
+#include <stdint.h>
+
+/// @brief Maximum payload of request, bigger frames close connection
+const size_t SERVER_MAX_PAYLOAD = 24 << 20;
+
+/// @brief Server stops reading from client while it has this number of bytes of unsent replies
+const size_t SERVER_OUTPUT_LIMIT = 8 << 20;
+
+/// @brief Number of buckets in latency histogram
+const size_t LATENCY_BUCKETS = 128;
+
+/// @brief Types of frames, reply has the same type as request
+enum serverFrameType {
+    SERVER_SOLVE = 1,   ///< Solve batch of equations
+    SERVER_STATS = 2    ///< Get counters and latency histogram of server
+};
+
+/// @brief Statuses of replies
+enum serverStatus {
+    SERVER_OK = 0,
+    SERVER_BAD_TYPE,        ///< Unknown type of frame
+    SERVER_BAD_SIZE,        ///< Payload size doesn't match type
+    SERVER_SOLVER_FAILED    ///< Solver couldn't allocate memory
+};
+
+/// @brief Header of every frame
+typedef struct serverFrameHeader {
+    uint32_t size;      ///< Size of payload in bytes
+    uint16_t type;      ///< One of serverFrameType
+    uint16_t status;    ///< One of serverStatus
+    uint64_t id;        ///< Chosen by client, copied to reply
+} serverFrameHeader_t;
+
+static_assert(sizeof(serverFrameHeader_t) == 16, "frame header must be 16 bytes");
+
+
+/*!
+    @brief Payload of SERVER_STATS reply
+
+    Latency of request is time from receiving it's last byte to putting reply to send queue. <br>
+    Histogram is log-linear: buckets 0-3 hold latencies 0-3 ns, then every power of 2 is split
+    to 4 equal buckets, latencyBucketLow() gives lower bound of bucket
+*/
+typedef struct serverStats {
+    uint64_t requests;                  ///< Answered SERVER_SOLVE requests
+    uint64_t equations;                 ///< Solved equations
+    uint64_t clients;                   ///< Clients connected now
+    uint64_t p50;                       ///< Median latency in ns, upper bound of bucket
+    uint64_t p99;                       ///< 99th percentile of latency in ns, upper bound of bucket
+    uint64_t max;                       ///< Maximum latency in ns
+    uint64_t buckets[LATENCY_BUCKETS];  ///< Number of requests in every bucket
+} serverStats_t;
+
+static_assert(sizeof(serverStats_t) == 48 + 8 * LATENCY_BUCKETS, "stats must not have padding");
+
+
+/*!
+    @brief Returns the smallest latency in ns that goes to bucket
+*/
+uint64_t latencyBucketLow(size_t bucket);
+
+
+/*!
+    @brief Solves equations for clients of Unix domain socket until SIGINT or SIGTERM
+
+    @param[in] path Path of socket, stale socket with this path is removed
+    @param[in] options Batch settings, they select solver for every request
+    @param[out] stats Counters at shutdown, can be NULL
+
+    @return GOOD_EXIT after signal or FAIL if socket can't be created
+
+    One thread serves all clients with epoll, requests of client are processed in order they came. <br>
+    While client has more than SERVER_OUTPUT_LIMIT bytes of unsent replies, it's requests aren't read. <br>
+    Works only on Linux
+*/
+enum error serveSolver(const char path[], const batchOptions_t *options, serverStats_t *stats);
+
+#endif
@@ -0,0 +1,81 @@
+/// @file
+/// @brief Lock-free ring of pointers for one producer thread and one consumer thread
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+/// @brief Number of failed tries that are spinning before waiting thread goes to sleep
+const size_t SPSC_SPIN_LIMIT = 64;
+
+/// @brief Maximum time of one sleep, the other side wakes sleeping thread earlier when it moves it's index
+const long SPSC_WAIT_MS = 100;
+
+
+/// @brief Opaque ring, created with spscRingCreate()
+typedef struct spscRing spscRing_t;
+
+
+/*!
+    @brief Creates empty ring
+
+    @param[in] capacity Maximum number of items, rounded up to power of 2
+
+    @return Pointer to ring or NULL if memory can't be allocated
+
+    Indexes of producer and consumer are in different cache lines, every side also keeps
+    cached copy of the other index, so it reads the shared one only when ring looks full or empty <br>
+    Mutex and condition variable of ring are used only when one side sleeps in spscPush() or spscPop()
+*/
+spscRing_t *spscRingCreate(size_t capacity);
+
+
+/*!
+    @brief Frees ring, items aren't freed
+
+    @param[in] ring Pointer to ring, can be NULL
+*/
+void spscRingDestroy(spscRing_t *ring);
+
+
+/*!
+    @brief Adds item if ring isn't full, must be called only from producer thread
+
+    @return 1 if item is added, 0 if ring is full
+
+    Wakes consumer if it sleeps in spscPop()
+*/
+int spscTryPush(spscRing_t *ring, void *item);
+
+
+/*!
+    @brief Takes the oldest item if ring isn't empty, must be called only from consumer thread
+
+    @param[in] ring Pointer to ring
+    @param[out] item Taken item, NULL is valid item
+
+    @return 1 if item is taken, 0 if ring is empty
+
+    Wakes producer if it sleeps in spscPush()
+*/
+int spscTryPop(spscRing_t *ring, void **item);
+
+
+/*!
+    @brief Adds item, waits while ring is full
+
+    Waiting thread spins SPSC_SPIN_LIMIT times, then sleeps until consumer takes item,
+    so idle stage doesn't take a core when input is slow
+*/
+void spscPush(spscRing_t *ring, void *item);
+
+
+/*!
+    @brief Takes the oldest item, waits while ring is empty
+
+    @return Taken item
+
+    Waits like spscPush()
+*/
+void *spscPop(spscRing_t *ring);
+
+#endif
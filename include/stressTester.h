@@ -0,0 +1,85 @@
+/// @file
+/// @brief Stress testing of batch solver with random equations built from known roots
+
+#ifndef STRESS_TESTER_H
+#define STRESS_TESTER_H
+
+#include <stdint.h>
+
+/// @brief Number of equations that are generated, solved and checked at once, limits memory for big N
+const size_t STRESS_BLOCK = 1 << 20;
+
+/// @brief Number of failed equations that are printed, the rest are only counted
+const size_t STRESS_PRINTED_FAILURES = 10;
+
+/// @brief Seed of stress test when --seed isn't set
+const uint64_t STRESS_DEFAULT_SEED = 2024;
+
+
+/// @brief Families of generated equations, family of every equation is random
+enum stressFamily {
+    STRESS_TWO_ROOTS = 0,   ///< a(x - r1)(x - r2) with r1 != r2
+    STRESS_DOUBLE_ROOT,     ///< a(x - r)^2, discriminant is exactly 0
+    STRESS_NO_ROOTS,        ///< a(x - p)^2 + q, where q has the same sign as a
+    STRESS_LINEAR,          ///< b(x - r), a = 0
+    STRESS_DEGENERATE,      ///< a = b = 0, c = 0 gives INF_ROOTS and other c give ZERO_ROOTS
+    STRESS_RANDOM_ROOTS,    ///< a(x - r1)(x - r2) with continuous a, r1, r2, coefficients are rounded
+    STRESS_TINY_LEADING,    ///< |a| near EPSILON: below it equation is linear, above it D is below EPSILON
+    STRESS_NEAR_DOUBLE,     ///< |D| below EPSILON/4 gives one root, from 4 to 64 EPSILON gives two or none
+    STRESS_FAR_ROOTS,       ///< |x1| in [2^10, 2^16], |x2| in [2^-10, 1]
+    STRESS_FAMILIES         ///< Number of families
+};
+
+
+/// @brief Names of families for reports, indexed by enum stressFamily
+const char *const STRESS_FAMILY_NAMES[STRESS_FAMILIES] = {"two roots", "double root", "no roots", "linear", "degenerate",
+                                                          "random roots", "tiny a", "D near 0", "far roots"};
+
+
+/// @brief Counters of stress test
+typedef struct stressStats {
+    size_t equations;                       ///< Number of generated equations
+    size_t failed;                          ///< Number of equations with wrong answer
+    size_t familyEquations[STRESS_FAMILIES];///< Number of equations of every family
+    size_t familyFailed[STRESS_FAMILIES];   ///< Number of wrong answers of every family
+    double solveTime;                       ///< Seconds spent in solver only
+    double wallTime;                        ///< Seconds spent on generation, solving and checking
+} stressStats_t;
+
+const stressStats_t BLANK_STRESS_STATS = {0, 0, {}, {}, 0, 0};
+
+
+/*!
+    @brief Generates random equation with known solution
+
+    @param[in, out] state State of xorshift64* generator, must not be 0
+    @param[out] equation Coefficients, answer isn't touched
+    @param[out] expected Solution, roots of TWO_ROOTS are in ascending order,
+                         ZERO_ROOTS of STRESS_NO_ROOTS keeps real and imaginary parts of complex roots
+
+    @return Family of equation
+
+    In the first five families roots are multiples of 1/256 in [-128, 128] and a is multiple of 1/16 in [-16, 16],
+    so coefficients, discriminant and its root are exact in double: correct solver gives exactly the chosen roots. <br>
+    Other families are continuous and near-degenerate, their rounded coefficients move roots much less than EPSILON
+*/
+enum stressFamily generateStressEquation(uint64_t *state, quadraticEquation_t *equation, solution_t *expected);
+
+
+/*!
+    @brief Solves count random equations with solveColumnsParallel() and checks answers with answerMatches()
+
+    @param[in] count Number of equations
+    @param[in] seed Seed of generator, the same seed gives the same equations
+    @param[in] options Batch settings that select solver and threads, options->single isn't supported
+    @param[out] stats Counters of test
+
+    @return GOOD_EXIT if all answers are right, BAD_EXIT if some are wrong, FAIL if test can't run
+
+    Equations are processed by blocks of STRESS_BLOCK, only solving is timed for throughput <br>
+    With options->classify only codes are compared <br>
+    Unless options->silent is set, first STRESS_PRINTED_FAILURES wrong answers are printed to stderr
+*/
+enum error runStressTest(size_t count, uint64_t seed, const batchOptions_t *options, stressStats_t *stats);
+
+#endif
@@ -0,0 +1,137 @@
+/// @file
+/// @brief Sweeps of one coefficient of quadratic equation, parts that don't change are computed once
+
+#ifndef SWEEP_SOLVER_H
+#define SWEEP_SOLVER_H
+
+/// @brief Number of points that are solved and formatted at once by writeSweepText()
+const size_t SWEEP_CHUNK = 1 << 12;
+
+/// @brief Number of points in one block of sweep that isn't solved by sweep kernel, constant columns are on stack
+const size_t SWEEP_COLUMNS_BLOCK = 256;
+
+/// @brief Maximum number of points, their indices must be exact in double
+const size_t SWEEP_MAX_POINTS = (size_t) 1 << 52;
+
+/*!
+    @brief Relative tolerance of number of steps between start and stop
+
+    (stop - start) / step is rounded, so for example 0:1:0.1 would lose its last point without it
+*/
+const double SWEEP_STEP_TOLERANCE = 1e-9;
+
+
+/// @brief Coefficient that varies in sweep
+enum sweepCoefficient {
+    SWEEP_A = 0,    ///< a varies, b and c are fixed
+    SWEEP_B,        ///< b varies, a and c are fixed
+    SWEEP_C         ///< c varies, a and b are fixed
+};
+
+
+/*!
+    @brief Equation with one varying coefficient: value of point i is start + i * step
+
+    Must be filled with sweepInit()
+*/
+typedef struct sweep {
+    double a, b, c;                     ///< Base equation, varying coefficient is ignored
+    enum sweepCoefficient coefficient;  ///< Coefficient that varies
+    double start;                       ///< Value in the first point
+    double step;                        ///< Difference between neighbour points, negative for descending sweep
+    size_t count;                       ///< Number of points, the last one isn't further than stop
+    int complex;                        ///< Points with D < 0 get COMPLEX_ROOTS
+    int hoisted;                        ///< Points are solved by sweep kernel with invariants, else by batch kernel
+    sweepInvariants_t invariants;       ///< Parts of equation that don't depend on point, used if hoisted
+} sweep_t;
+
+const sweep_t BLANK_SWEEP = {NAN, NAN, NAN, SWEEP_C, NAN, NAN, 0, 0, 0, {NAN, NAN, NAN, NAN, NAN, NAN, NAN}};
+
+
+/*!
+    @brief Parses sweep description "c:start:stop:step"
+
+    @param[in] text Description, the first letter is a, b or c
+    @param[out] coefficient Varying coefficient
+    @param[out] start, stop, step Range of values
+
+    @return GOOD_EXIT or BAD_EXIT if description can't be read
+*/
+enum error parseSweep(const char text[], enum sweepCoefficient *coefficient, double *start, double *stop, double *step);
+
+
+/*!
+    @brief Checks range, counts points and computes invariants of sweep
+
+    @param[out] sweep Pointer to sweep
+    @param[in] equation Base equation, varying coefficient is ignored
+    @param[in] coefficient Varying coefficient
+    @param[in] start, stop, step Range of values, step moves start towards stop
+    @param[in] complex Points with D < 0 get COMPLEX_ROOTS
+
+    @return GOOD_EXIT or BAD_EXIT if range is wrong or has more than SWEEP_MAX_POINTS points
+
+    If b or c varies and a is finite and isn't zero, b*b (or 4ac), 4a, 1 / 2a and -b / 2a are computed here once,
+    so sweep kernel computes only varying term of discriminant and doesn't divide. <br>
+    Other sweeps (a varies, linear or non-finite base) are solved by batch kernel from generated columns
+*/
+enum error sweepInit(sweep_t *sweep, const quadraticEquation_t *equation, enum sweepCoefficient coefficient,
+                     double start, double stop, double step, int complex);
+
+
+/*!
+    @brief Changes fixed coefficients of sweep and recomputes its invariants, range and points are kept
+
+    @param[in, out] sweep Sweep filled by sweepInit()
+    @param[in] a, b, c New base equation, varying coefficient is ignored
+
+    Used for sweeps that are rows of a plane, so the range is checked only once
+*/
+void sweepRebase(sweep_t *sweep, double a, double b, double c);
+
+
+/// @brief Returns value of varying coefficient in point index, the same as sweep kernels compute
+double sweepValue(const sweep_t *sweep, size_t index);
+
+
+/*!
+    @brief Solves points [first, first + count) of sweep with kernels of specified type
+
+    @param[in] sweep Sweep filled by sweepInit()
+    @param[in] type Type of sweep and batch kernels
+    @param[in] first Index of the first point
+    @param[in] count Number of points, first + count can't be greater than sweep->count
+    @param[out] value Column for values of varying coefficient
+    @param[out] code, x1, x2 Columns for results
+
+    @return Enum with error code, BAD_EXIT if kernel of this type isn't supported
+
+    Values are computed from index, not accumulated, so any range of points can be solved separately <br>
+    Codes are the same as solveEquation() (or solveEquationComplex()) gives for every point
+*/
+enum error solveSweepByType(const sweep_t *sweep, enum kernelType type, size_t first, size_t count,
+                            double value[], enum solutionCode code[], double x1[], double x2[]);
+
+
+/*!
+    @brief Same as solveSweepByType() with the best kernels for current CPU
+*/
+enum error solveSweep(const sweep_t *sweep, size_t first, size_t count,
+                      double value[], enum solutionCode code[], double x1[], double x2[]);
+
+
+/*!
+    @brief Solves all points of sweep and writes lines "value code x1 x2" by chunks
+
+    @param[in] out Output stream
+    @param[in] sweep Sweep filled by sweepInit()
+    @param[in] style Style of values and roots
+    @param[in] codesOnly If not 0, lines are "value code"
+
+    @return Enum with error code
+
+    Only SWEEP_CHUNK points exist in memory at once, so sweep of any length doesn't need coefficient file
+*/
+enum error writeSweepText(FILE *out, const sweep_t *sweep, enum numberStyle style, int codesOnly);
+
+#endif
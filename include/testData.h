@@ -1,7 +1,7 @@
 #ifndef TEST_DATA_INCLUDED
 #define TEST_DATA_INCLUDED
 
-const unitTest_t internalTestData[] = {
+constexpr unitTest_t internalTestData[] = {
 /*
         {                                                 unitTest_T
             {a, b, c, BLANK_SOLUTION},                    quadraticEquation_t
@@ -44,4 +44,208 @@ const unitTest_t internalTestData[] = {
 
 const unsigned int internalTestSize = sizeof(internalTestData) / sizeof(unitTest_t);
 
+
+/// @brief Ill-conditioned equations that only adaptive-precision solver passes
+const unitTest_t preciseTestData[] = {
+        {
+            {1, 1e8, 1, BLANK_SOLUTION},            //-b + sqrt(D) cancels out
+            {TWO_ROOTS, -1e8, -1e-8}
+        },
+        {
+            {1e200, 1e200, -1e200, BLANK_SOLUTION}, //b^2 overflows
+            {TWO_ROOTS, -1.6180339887498949, 0.6180339887498949}
+        },
+        {
+            {1e200, 2e200, 1e200, BLANK_SOLUTION},  //b^2 - 4ac is inf - inf
+            {ONE_ROOT, -1, NAN}
+        },
+        {
+            {1, 2, 1, BLANK_SOLUTION},              //b^2 - 4ac cancels out completely
+            {ONE_ROOT, -1, NAN}
+        }
+};
+
+const unsigned int preciseTestSize = sizeof(preciseTestData) / sizeof(unitTest_t);
+
+
+/*!
+    @brief Equations for solveEquationComplex() and complex batch kernels
+
+    COMPLEX_ROOTS answer is {COMPLEX_ROOTS, real part, imaginary part}, other cases are the same as without complex mode <br>
+    There are more tests than lanes of the widest kernel, so vector loop gets all kinds of rows
+*/
+const unitTest_t complexTestData[] = {
+        {
+            {1, 2, 5, BLANK_SOLUTION},
+            {COMPLEX_ROOTS, -1, 2}
+        },
+        {
+            {1, 0, 1, BLANK_SOLUTION},              //real part is 0, not -0
+            {COMPLEX_ROOTS, 0, 1}
+        },
+        {
+            {-2, 4, -10, BLANK_SOLUTION},           //negative a, imaginary part is still positive
+            {COMPLEX_ROOTS, 1, 2}
+        },
+        {
+            {4, 4, 5, BLANK_SOLUTION},
+            {COMPLEX_ROOTS, -0.5, 1}
+        },
+        {
+            {1, -2, 1, BLANK_SOLUTION},
+            {ONE_ROOT, 1, NAN}
+        },
+        {
+            {1, -3, 2, BLANK_SOLUTION},
+            {TWO_ROOTS, 1, 2}
+        },
+        {
+            {0, 0, 1, BLANK_SOLUTION},              //linear equation has no complex roots
+            {ZERO_ROOTS, NAN, NAN}
+        },
+        {
+            {0, 2, 5, BLANK_SOLUTION},
+            {ONE_ROOT, -2.5, NAN}
+        },
+        {
+            {1e-3, 1e-3, 1, BLANK_SOLUTION},
+            {COMPLEX_ROOTS, -0.5, 31.618823507524755}
+        },
+        {
+            {NAN, 1, 1, BLANK_SOLUTION},
+            {BAD_INPUT, NAN, NAN}
+        },
+        {
+            {0, 0, 0, BLANK_SOLUTION},
+            {INF_ROOTS, NAN, NAN}
+        }
+};
+
+const unsigned int complexTestSize = sizeof(complexTestData) / sizeof(unitTest_t);
+
+
+/*!
+    @brief Cubic and quartic equations for solvePolynomial()
+
+    {degree, {coefficients from the highest power}, BLANK_POLY_SOLUTION}, {code, {roots in ascending order}}
+*/
+const polyTest_t polynomialTestData[] = {
+        {
+            {3, {1, -6, 11, -6, NAN}, BLANK_POLY_SOLUTION},     //trigonometric formula
+            {THREE_ROOTS, {1, 2, 3, NAN}}
+        },
+        {
+            {3, {2, -4, -22, 24, NAN}, BLANK_POLY_SOLUTION},
+            {THREE_ROOTS, {-3, 1, 4, NAN}}
+        },
+        {
+            {3, {1, -4, 5, -2, NAN}, BLANK_POLY_SOLUTION},      //(x - 1)^2 (x - 2), discriminant is zero
+            {TWO_ROOTS, {1, 2, NAN, NAN}}
+        },
+        {
+            {3, {1, -3, 3, -1, NAN}, BLANK_POLY_SOLUTION},      //triple root
+            {ONE_ROOT, {1, NAN, NAN, NAN}}
+        },
+        {
+            {3, {1, 0, 0, 1, NAN}, BLANK_POLY_SOLUTION},        //Cardano's formula
+            {ONE_ROOT, {-1, NAN, NAN, NAN}}
+        },
+        {
+            {3, {1, 2, -3, 0, NAN}, BLANK_POLY_SOLUTION},       //zero free term
+            {THREE_ROOTS, {-3, 0, 1, NAN}}
+        },
+        {                                                       //big shift B/3, precision of depressed cubic is lost
+            {3, {0.07131704788782815, 2454.2370975044164, -1.065553551695296, -35.95485919821106, NAN},
+             BLANK_POLY_SOLUTION},
+            {THREE_ROOTS, {-34413.04991056106, -0.12082098720265147, 0.12125473043647332, NAN}}
+        },
+        {
+            {3, {1, 1e10, 1, 1, NAN}, BLANK_POLY_SOLUTION},     //one real root, closed form adds false small ones
+            {ONE_ROOT, {-1e10, NAN, NAN, NAN}}
+        },
+        {
+            {3, {0, 1, -3, 2, NAN}, BLANK_POLY_SOLUTION},       //quadratic
+            {TWO_ROOTS, {1, 2, NAN, NAN}}
+        },
+        {
+            {4, {1, -10, 35, -50, 24}, BLANK_POLY_SOLUTION},    //Ferrari's method
+            {FOUR_ROOTS, {1, 2, 3, 4}}
+        },
+        {
+            {4, {1, 0, -5, 0, 4}, BLANK_POLY_SOLUTION},         //biquadratic
+            {FOUR_ROOTS, {-2, -1, 1, 2}}
+        },
+        {
+            {4, {1, -6, 11, -6, 0}, BLANK_POLY_SOLUTION},       //zero free term
+            {FOUR_ROOTS, {0, 1, 2, 3}}
+        },
+        {
+            {4, {1, 0, -2, 0, 1}, BLANK_POLY_SOLUTION},         //(x^2 - 1)^2
+            {TWO_ROOTS, {-1, 1, NAN, NAN}}
+        },
+        {
+            {4, {1, -2, 2, -2, 1}, BLANK_POLY_SOLUTION},        //(x - 1)^2 (x^2 + 1)
+            {ONE_ROOT, {1, NAN, NAN, NAN}}
+        },
+        {
+            {4, {1, 0, 0, 0, 1}, BLANK_POLY_SOLUTION},
+            {ZERO_ROOTS, {NAN, NAN, NAN, NAN}}
+        },
+        {
+            {4, {1, 1e100, 1, 1, 1}, BLANK_POLY_SOLUTION},      //x^4 overflows at the big root, small one is -4.6e-34
+            {TWO_ROOTS, {-1e100, 0, NAN, NAN}}
+        },
+        {                                                       //big complex roots, small real ones
+            {4, {0.00033824492755322067, -1.9644501239982814, 9511.677584874407, 58.78504914341253,
+                 -0.0020214165868819153}, BLANK_POLY_SOLUTION},
+            {TWO_ROOTS, {-0.006214492381513677, 3.4197352895327345e-05, NAN, NAN}}
+        },
+        {
+            {4, {0, 1, -6, 11, -6}, BLANK_POLY_SOLUTION},       //cubic
+            {THREE_ROOTS, {1, 2, 3, NAN}}
+        },
+        {
+            {4, {1, NAN, 0, 0, 1}, BLANK_POLY_SOLUTION},
+            {BAD_INPUT, {NAN, NAN, NAN, NAN}}
+        }
+};
+
+const unsigned int polynomialTestSize = sizeof(polynomialTestData) / sizeof(polyTest_t);
+
+
+/*!
+    @brief Sweeps for sweep solver: {base equation, "coefficient:start:stop:step", complex, number of points}
+
+    Ranges cross D = 0, a = 0 and b = 0, so every branch of sweep kernels and of batch kernel path is checked
+*/
+const sweepTest_t sweepTestData[] = {
+        {{1, 2, NAN, BLANK_SOLUTION},           "c:-2:3:0.25",      0, 21}, //D = 0 at c = 1
+        {{1, NAN, 1, BLANK_SOLUTION},           "b:-3:3:0.5",       0, 13}, //D = 0 at b = -2 and b = 2
+        {{-2, 1, NAN, BLANK_SOLUTION},          "c:5:-5:-0.5",      0, 21}, //descending sweep, a < 0
+        {{1, 0, NAN, BLANK_SOLUTION},           "c:0:1:0.1",        0, 11}, //stop isn't lost to rounding
+        {{1, 2, NAN, BLANK_SOLUTION},           "c:-2:3:0.25",      1, 21},
+        {{1, NAN, 1, BLANK_SOLUTION},           "b:-3:3:0.5",       1, 13},
+        {{NAN, 1, -2, BLANK_SOLUTION},          "a:-1:1:0.125",     0, 17}, //a varies, linear at a = 0
+        {{0, NAN, 1, BLANK_SOLUTION},           "b:-1:1:0.25",      0, 9},  //linear, no roots at b = 0
+        {{INFINITY, 1, NAN, BLANK_SOLUTION},    "c:0:1:0.5",        0, 3}
+};
+
+const unsigned int sweepTestSize = sizeof(sweepTestData) / sizeof(sweepTest_t);
+
+
+/*!
+    @brief Planes for plane maps: {base equation, "columns,rows", complex, width, height}
+
+    Rows of a cross a = 0 and columns of a aren't hoisted, so both paths of rows are checked
+*/
+const planeTest_t planeTestData[] = {
+        {{1, NAN, NAN, BLANK_SOLUTION},         "b:-3:3:0.5,c:-3:3:0.5",        0, 13, 13}, //parabola b*b = 4c
+        {{-1, NAN, NAN, BLANK_SOLUTION},        "c:-2:2:0.5,b:3:-3:-0.75",      0, 9, 9},   //descending rows
+        {{NAN, NAN, 1, BLANK_SOLUTION},         "b:-2:2:0.5,a:-1:1:0.25",       0, 9, 9},   //linear row at a = 0
+        {{NAN, 0, NAN, BLANK_SOLUTION},         "a:-1:1:0.5,c:-1:1:0.25",       0, 5, 9},
+        {{1, NAN, NAN, BLANK_SOLUTION},         "b:-3:3:0.5,c:-3:3:0.5",        1, 13, 13}
+};
+
+const unsigned int planeTestSize = sizeof(planeTestData) / sizeof(planeTest_t);
+
 #endif
@@ -0,0 +1,91 @@
+/// @file
+/// @brief Thread pool with work-stealing task queues
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/// @brief Function that is executed by worker thread
+typedef void (*taskFunction_t)(void *arg);
+
+/// @brief Function that processes range [begin, end) of some array
+typedef void (*rangeFunction_t)(size_t begin, size_t end, void *arg);
+
+/// @brief Opaque thread pool, created with threadPoolCreate()
+typedef struct threadPool threadPool_t;
+
+
+/*!
+    @brief Creates pool and starts worker threads
+
+    @param[in] threads Number of worker threads, 0 means number of CPU cores
+
+    @return Pointer to pool or NULL if it can't be created
+
+    Every worker has it's own task queue. <br>
+    When it is empty, worker steals tasks from queues of other workers <br>
+    Workers block all signals, so they are delivered to threads outside of pool
+*/
+threadPool_t *threadPoolCreate(size_t threads);
+
+
+/*!
+    @brief Waits until all submitted tasks are finished, stops workers and frees pool
+
+    @param[in] pool Pointer to pool, can be NULL
+*/
+void threadPoolDestroy(threadPool_t *pool);
+
+
+/*!
+    @brief Adds task to one of worker queues
+
+    @param[in] pool Pointer to pool
+    @param[in] function Function to execute
+    @param[in] arg Argument of function
+
+    @return GOOD_EXIT or FAIL if pool is NULL
+
+    Tasks are distributed between queues in round-robin order. <br>
+    Task can be submitted from another task, then it goes to queue of current worker
+*/
+enum error threadPoolSubmit(threadPool_t *pool, taskFunction_t function, void *arg);
+
+
+/*!
+    @brief Waits until all submitted tasks are finished
+
+    @param[in] pool Pointer to pool
+
+    Must not be called from worker thread
+*/
+void threadPoolWait(threadPool_t *pool);
+
+
+/*!
+    @brief Splits range [0, count) to pieces and processes them in pool
+
+    @param[in] pool Pointer to pool, if NULL whole range is processed in calling thread
+    @param[in] count Size of range
+    @param[in] grain Minimal size of one piece
+    @param[in] function Function that processes piece
+    @param[in] arg Argument of function
+
+    @return GOOD_EXIT or FAIL if memory can't be allocated
+
+    Returns when all pieces are processed. Uses threadPoolWait(), so pool must not run other tasks at the same time
+*/
+enum error threadPoolParallelFor(threadPool_t *pool, size_t count, size_t grain, rangeFunction_t function, void *arg);
+
+
+/*!
+    @brief Returns number of worker threads in pool
+*/
+size_t threadPoolSize(const threadPool_t *pool);
+
+
+/*!
+    @brief Returns number of threads that hardware can run concurrently, at least 1
+*/
+size_t hardwareThreads();
+
+#endif
@@ -0,0 +1,82 @@
+/// @file
+/// @brief Spans of work in every thread, dumped as Chrome trace-event JSON
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <stdint.h>
+
+/// @brief Number of spans that buffer of thread gets at first, it doubles when it's full
+const size_t TRACE_INITIAL_EVENTS = 1 << 10;
+
+/// @brief Maximum number of spans in one thread, the next ones are dropped and counted
+const size_t TRACE_MAX_EVENTS = 1 << 20;
+
+
+/*!
+    @brief Returns current timestamp in ticks: TSC on x86, nanoseconds of steady clock on other CPUs
+
+    Ticks are converted to microseconds only in traceDump()
+*/
+uint64_t traceNow();
+
+
+/*!
+    @brief Adds span to buffer of calling thread if tracing is enabled
+
+    @param[in] name Name of span, must be string literal or live until traceDump()
+    @param[in] start Timestamp from traceNow() at the beginning of span, the end is now
+
+    Buffer of thread is created on the first span, only then global lock is taken
+*/
+void traceRecord(const char *name, uint64_t start);
+
+
+/*!
+    @brief Sets name of calling thread in trace, for example "solver"
+
+    @param[in] name Name of thread, must be string literal
+*/
+void traceThreadName(const char *name);
+
+
+/*!
+    @brief Starts recording spans
+
+    @return GOOD_EXIT or BAD_EXIT if program is compiled without ENABLE_TRACING
+*/
+enum error traceEnable();
+
+
+/*!
+    @brief Stops recording, writes all spans to file and frees buffers
+
+    @param[in] name Name of JSON file, it can be opened in chrome://tracing or ui.perfetto.dev
+
+    @return Enum with error code
+
+    Must be called after all threads that recorded spans are joined <br>
+    Every span is complete event ("ph": "X") with timestamp and duration in microseconds,
+    ticks are converted with rate measured between traceEnable() and traceDump()
+*/
+enum error traceDump(const char name[]);
+
+
+/*!
+    @brief Macros that record spans, activated by defining ENABLE_TRACING
+
+    TRACE_BEGIN(span) declares variable with start of span, TRACE_END(span, "name") records it <br>
+    Without ENABLE_TRACING they are empty, so spans cost nothing
+*/
+//#define ENABLE_TRACING
+#ifdef ENABLE_TRACING
+#define TRACE_BEGIN(span) const uint64_t span = traceNow()
+#define TRACE_END(span, name) traceRecord(name, span)
+#define TRACE_THREAD_NAME(name) traceThreadName(name)
+#else
+#define TRACE_BEGIN(span)
+#define TRACE_END(span, name)
+#define TRACE_THREAD_NAME(name)
+#endif
+
+#endif
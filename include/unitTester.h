@@ -13,6 +13,32 @@ typedef struct unitTest {
 const unitTest_t BLANK_TEST = {BLANK_QUADRATIC_EQUATION, BLANK_SOLUTION}; /// Empty initializer for unitTest_t
 
 
+/// @brief Unit test of polynomial solver
+typedef struct polyTest {
+    polynomial_t inputData;         ///< Struct with degree and test coefficients
+    polySolution_t expectedData;    ///< Struct with expected roots in ascending order
+} polyTest_t;
+
+
+/// @brief Unit test of sweep solver, every point is compared with solveEquation() of the same equation
+typedef struct sweepTest {
+    quadraticEquation_t base;       ///< Base equation, varying coefficient is ignored
+    const char *range;              ///< Sweep description for parseSweep(), for example "c:-1:1:0.5"
+    int complex;                    ///< Points are compared with solveEquationComplex()
+    size_t count;                   ///< Expected number of points
+} sweepTest_t;
+
+
+/// @brief Unit test of plane map, every point is compared with solveEquation() of the same equation
+typedef struct planeTest {
+    quadraticEquation_t base;       ///< Base equation, varying coefficients are ignored
+    const char *description;        ///< Plane description for planeInit(), for example "b:-1:1:0.5,c:-1:1:0.5"
+    int complex;                    ///< Points are compared with solveEquationComplex()
+    size_t width;                   ///< Expected number of columns
+    size_t height;                  ///< Expected number of rows
+} planeTest_t;
+
+
 /*!
     @brief Runs internal unit testing, if testData.h is included
 
@@ -38,8 +64,8 @@ enum error unitTestingInternal(int silent);
 
     @return Enum with error code
 
-    Opens file with specified name. <br>
-    Then it allocates memory for array and reads unit tests from file to it. <br>
+    Maps file with specified name to memory. <br>
+    Then it parses unit tests from mapped pages to allocated array with parseUnitTests(). <br>
     Runs unitTesting() and frees allocated memory. <br>
     If something goes wrong, it will print warning message and return FAIL or BAD_EXIT. <br>
     In other cases it will return GOOD_EXIT.
@@ -47,6 +73,23 @@ enum error unitTestingInternal(int silent);
 enum error unitTestingFile(const char name[], int silent);
 
 
+/*!
+    @brief Parses unit tests from text buffer
+
+    @param[in] text Contents of file with unit tests, doesn't need to be null-terminated
+    @param[in] size Size of text
+    @param[out] tests Pointer to allocated array of tests, must be freed by caller
+    @param[out] testCount Number of tests in array
+
+    @return Enum with error code
+
+    Format is the same as for readUnitTest(), but the first number is number of tests. <br>
+    Doesn't use stdio, errors are reported with number of test and line. <br>
+    If something goes wrong, memory is freed and *tests is set to NULL
+*/
+enum error parseUnitTests(const char *text, size_t size, unitTest_t **tests, int *testCount);
+
+
 /*!
     @brief Runs unit testing; reads them from file on fly
 
@@ -92,6 +135,19 @@ enum error readUnitTest(FILE* testsF, unitTest_t* test);
 enum error parseSolutionCode(const char solutionStr[], enum solutionCode* code);
 
 
+/*!
+    @brief Compares solution with expected one like runTest() does
+
+    @param[in] result Solution given by solver
+    @param[in] expected Expected solution, for TWO_ROOTS x1 must be less than x2
+
+    @return 1 if codes are equal and meaningful roots are equal within EPSILON (cmpDouble()), else 0
+
+    Roots of result are compared in ascending order, so order of roots given by solver doesn't matter
+*/
+int answerMatches(solution_t result, solution_t expected);
+
+
 /*!
     @brief Runs exactly one test
 
@@ -107,4 +163,64 @@ enum error parseSolutionCode(const char solutionStr[], enum solutionCode* code);
 */
 enum error runTest(unitTest_t test);
 
+
+/*!
+    @brief Runs exactly one test with adaptive-precision solver
+
+    @param[in] test Struct with test data and expected data
+
+    @return Enum with error code
+
+    Same as runTest(), but equation is solved with solveEquationPrecise()
+*/
+enum error runTestPrecise(unitTest_t test);
+
+
+/*!
+    @brief Runs exactly one test with cached solver
+
+    @param[in] test Struct with test data and expected data
+
+    @return Enum with error code
+
+    Same as runTest(), but equation is solved with solveEquationCached(), cache is created by unitTestingInternal()
+*/
+enum error runTestCached(unitTest_t test);
+
+
+/*!
+    @brief Runs exactly one test with complex roots
+
+    @param[in] test Struct with test data and expected data
+
+    @return Enum with error code
+
+    Same as runTest(), but equation is solved with solveEquationComplex()
+*/
+enum error runTestComplex(unitTest_t test);
+
+
+/*!
+    @brief Runs exactly one test of classify mode
+
+    @param[in] test Struct with test data and expected data
+
+    @return Enum with error code
+
+    Equation is classified with classifyEquation(), only exit code is compared
+*/
+enum error runTestClassify(unitTest_t test);
+
+
+/*!
+    @brief Runs exactly one test of polynomial solver
+
+    @param[in] test Struct with test data and expected data
+
+    @return Enum with error code
+
+    Solves polynomial with solvePolynomial(), compares code and then every root with cmpDouble()
+*/
+enum error runPolyTest(polyTest_t test);
+
 #endif
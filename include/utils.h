@@ -4,6 +4,8 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <stdint.h>
+
 
 /*!
     @brief Macro that swaps two numbers of specified type
@@ -20,7 +22,10 @@
             }while(0)
 
 
-const double EPSILON = 1e-9; //constant for comparing floats
+constexpr double EPSILON = 1e-9; //constant for comparing floats, constexpr for genericSolver.h
+
+//EPSILON is about sqrt(DBL_EPSILON) / 15, this is the same for float: sqrt(FLT_EPSILON) / 15 is 2.3e-5
+constexpr float EPSILON_F = 1e-5f; //EPSILON for single-precision solver and kernels
 
 
 /*!
@@ -59,7 +64,7 @@ int isZero(const double a);
 
     @return 1 if number is NaN, 0 else
 
-    Uses bit operations and casts number to unsigned long long
+    Uses bit operations on number copied to uint64_t
 */
 int myIsNan(double a);
 
@@ -69,11 +74,23 @@ int myIsNan(double a);
 
     @return 1 if number is +-INFINITY, 0 else
 
-    Uses bit operations and casts number to unsigned long long
+    Uses bit operations on number copied to uint64_t
 */
 int myIsInf(double a);
 
 
+/*!
+    @brief Mixes bit patterns of three doubles to 64-bit hash
+
+    @param[in] a, b, c Numbers, usually coefficients of equation
+
+    @return Hash, equal bit patterns give equal hashes
+
+    Numbers are compared by bits, so 0 and -0 or NaNs with different payloads are different
+*/
+uint64_t hashCoeffBits(double a, double b, double c);
+
+
 /*!
     @brief Swaps two variables of any type
 
@@ -87,4 +104,26 @@ int myIsInf(double a);
     Under the hood it swaps values byte by byte
 */
 void swap(void *a, void *b, size_t size);
+
+
+/*!
+    @brief Allocates zeroed memory aligned to specified boundary
+
+    @param[in] alignment Alignment in bytes, must be power of 2
+    @param[in] size Size of memory block in bytes
+
+    @return Pointer to memory or NULL if allocation failed
+
+    Memory must be freed with alignedFree() <br>
+    Used for columns that are processed with SIMD instructions
+*/
+void *alignedCalloc(size_t alignment, size_t size);
+
+
+/*!
+    @brief Frees memory allocated with alignedCalloc()
+
+    @param[in] ptr Pointer to memory, can be NULL
+*/
+void alignedFree(void *ptr);
 #endif
@@ -0,0 +1,516 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+#include "asyncIO.h"
+#include "tracer.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#define IO_URING_BACKEND
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+
+#ifndef _WIN32
+
+/// @brief Number of submission queue entries, every block of reader can be in flight at once
+const unsigned URING_ENTRIES = 2 * ASYNC_DEPTH;
+
+
+/// @brief States of block
+enum blockState {
+    BLOCK_IDLE,         ///< Read block isn't used after the end of input, write block is being filled
+    BLOCK_IN_FLIGHT,    ///< Request is submitted, kernel owns data
+    BLOCK_READY         ///< Read block holds data that isn't consumed yet
+};
+
+
+/// @brief Buffer of one read or write request
+typedef struct ioBlock {
+    char *data;                 ///< ASYNC_BLOCK_SIZE bytes
+    size_t size;                ///< Bytes that were read or that will be written
+    size_t pos;                 ///< Bytes of read block that are already consumed
+    uint64_t offset;            ///< Offset of block in file
+    enum blockState state;
+    int isWrite;
+} ioBlock_t;
+
+
+#ifdef IO_URING_BACKEND
+/// @brief Rings of io_uring instance mapped to memory
+typedef struct uringQueue {
+    int fd;
+    void *sqRing, *cqRing;
+    size_t sqRingSize, cqRingSize;
+    struct io_uring_sqe *sqes;
+    size_t sqesSize;
+
+    unsigned *sqTail, *sqMask, *sqArray;
+    unsigned *cqHead, *cqTail, *cqMask;
+    struct io_uring_cqe *cqes;
+} uringQueue_t;
+
+const uringQueue_t BLANK_URING_QUEUE = {-1, MAP_FAILED, MAP_FAILED, 0, 0, (struct io_uring_sqe*) MAP_FAILED, 0,
+                                        NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+#endif
+
+
+struct asyncIO {
+    enum ioBackend backend;
+    int inFd, outFd;
+    int failed;                     ///< Some request has failed, error is already printed
+
+    ioBlock_t reads[ASYNC_DEPTH];   ///< Blocks are consumed in order of their offsets, starting from readIndex
+    size_t readIndex;
+    uint64_t readOffset;            ///< Offset of the next submitted read
+    uint64_t inputPos;              ///< Offset of the first byte that isn't consumed
+    int readsEnded;                 ///< Some read has reached the end of file, no more reads are submitted
+    int inputEnded;                 ///< The last block is consumed
+
+    ioBlock_t writes[ASYNC_DEPTH];  ///< Block writeIndex is being filled, the others can be in flight
+    size_t writeIndex;
+    uint64_t writeOffset;           ///< Offset of the next submitted write
+
+#ifdef IO_URING_BACKEND
+    uringQueue_t uring;
+#endif
+};
+
+
+/// @brief Allocates data of blocks, returns FAIL if memory can't be allocated
+static enum error allocBlocks(ioBlock_t blocks[], int isWrite);
+
+
+/*!
+    @brief Submits read or write of block
+
+    With IO_PREAD request is done here, so block is completed before return
+*/
+static void submitBlock(asyncIO_t *io, ioBlock_t *block);
+
+
+/// @brief Submits read of the next block of file
+static void submitRead(asyncIO_t *io, ioBlock_t *block);
+
+
+/// @brief Submits write of filled part of block
+static void submitWrite(asyncIO_t *io, ioBlock_t *block);
+
+
+/*!
+    @brief Finishes request of block with result of read or write
+
+    Short read or write is finished with pread() or pwrite(), so only the last read block of file is short
+*/
+static void completeBlock(asyncIO_t *io, ioBlock_t *block, long long result);
+
+
+/*!
+    @brief Waits until block isn't in flight
+
+    @return GOOD_EXIT or FAIL if completions can't be waited, then io->failed is set and block stays in flight
+*/
+static enum error waitBlock(asyncIO_t *io, ioBlock_t *block);
+
+
+#ifdef IO_URING_BACKEND
+/// @brief Creates io_uring instance and maps it's rings, returns FAIL if kernel doesn't allow it
+static enum error uringInit(uringQueue_t *uring, unsigned entries);
+
+
+/// @brief Unmaps rings and closes instance
+static void uringFree(uringQueue_t *uring);
+
+
+/// @brief Puts request to submission queue and submits it
+static enum error uringSubmit(uringQueue_t *uring, ioBlock_t *block, int fd, unsigned size);
+
+
+/// @brief Waits for at least one completion and completes blocks of all completions
+static enum error uringReap(asyncIO_t *io);
+#endif
+
+
+static enum error allocBlocks(ioBlock_t blocks[], int isWrite) {
+    for (size_t i = 0; i < ASYNC_DEPTH; i++) {
+        blocks[i].data = (char*) malloc(ASYNC_BLOCK_SIZE);
+        blocks[i].isWrite = isWrite;
+        if (!blocks[i].data) {
+            fprintf(stderr, RED "Can't allocate memory for I/O blocks\n" RESET_C);
+            return FAIL;
+        }
+    }
+    return GOOD_EXIT;
+}
+
+
+static void submitRead(asyncIO_t *io, ioBlock_t *block) {
+    block->offset = io->readOffset;
+    block->size = block->pos = 0;
+    io->readOffset += ASYNC_BLOCK_SIZE;
+    submitBlock(io, block);
+}
+
+
+static void submitWrite(asyncIO_t *io, ioBlock_t *block) {
+    block->offset = io->writeOffset;
+    io->writeOffset += block->size;
+    submitBlock(io, block);
+}
+
+
+static void submitBlock(asyncIO_t *io, ioBlock_t *block) {
+    const int fd = block->isWrite ? io->outFd : io->inFd;
+    const size_t size = block->isWrite ? block->size : ASYNC_BLOCK_SIZE;
+    block->state = BLOCK_IN_FLIGHT;
+
+#ifdef IO_URING_BACKEND
+    if (io->backend == IO_URING) {
+        if (uringSubmit(&io->uring, block, fd, (unsigned) size) != GOOD_EXIT)
+            completeBlock(io, block, -(errno ? errno : EIO));
+        return;
+    }
+#endif
+    TRACE_BEGIN(ioSpan);
+    const ssize_t result = block->isWrite ? pwrite(fd, block->data, size, (off_t) block->offset)
+                                          : pread(fd, block->data, size, (off_t) block->offset);
+    TRACE_END(ioSpan, block->isWrite ? "pwrite" : "pread");
+    completeBlock(io, block, (result < 0) ? -errno : result);
+}
+
+
+static void completeBlock(asyncIO_t *io, ioBlock_t *block, long long result) {
+    const int fd = block->isWrite ? io->outFd : io->inFd;
+    const size_t size = block->isWrite ? block->size : ASYNC_BLOCK_SIZE;
+
+    //interrupted requests are finished synchronously, the rest of block is usually small
+    size_t done = (result > 0) ? (size_t) result : 0;
+    while (result > 0 && done < size) {
+        const off_t offset = (off_t) (block->offset + done);
+        const ssize_t more = block->isWrite ? pwrite(fd, block->data + done, size - done, offset)
+                                            : pread(fd, block->data + done, size - done, offset);
+        if (more < 0 && errno == EINTR) continue;
+        result = (more < 0) ? -errno : more;
+        if (more > 0) done += (size_t) more;
+    }
+
+    if (block->isWrite && result >= 0 && done < size) result = -EIO;
+    if (result < 0 && !io->failed) {
+        fprintf(stderr, RED "Can't %s file: %s\n" RESET_C, block->isWrite ? "write" : "read", strerror((int) -result));
+        io->failed = 1;
+    }
+    if (block->isWrite) {
+        block->size = 0;
+        block->state = BLOCK_IDLE;
+    } else {
+        block->size = done;
+        block->state = BLOCK_READY;
+        if (done < size) io->readsEnded = 1;
+    }
+}
+
+
+static enum error waitBlock(asyncIO_t *io, ioBlock_t *block) {
+#ifdef IO_URING_BACKEND
+    if (block->state != BLOCK_IN_FLIGHT) return GOOD_EXIT;
+    TRACE_BEGIN(waitSpan);
+    while (block->state == BLOCK_IN_FLIGHT) {
+        if (uringReap(io) != GOOD_EXIT) {
+            //requests can't be completed, so data of blocks can't be trusted anymore
+            if (!io->failed) fprintf(stderr, RED "Can't wait for I/O: %s\n" RESET_C, strerror(errno));
+            io->failed = 1;
+            return FAIL;
+        }
+    }
+    TRACE_END(waitSpan, block->isWrite ? "uring wait write" : "uring wait read");
+#else
+    (void) io;
+    (void) block;
+#endif
+    return GOOD_EXIT;
+}
+
+
+#ifdef IO_URING_BACKEND
+
+static enum error uringInit(uringQueue_t *uring, unsigned entries) {
+    *uring = BLANK_URING_QUEUE;
+    struct io_uring_params params = {};
+    uring->fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+    if (uring->fd < 0) return FAIL;
+
+    uring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    uring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    const int singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap && uring->cqRingSize > uring->sqRingSize) uring->sqRingSize = uring->cqRingSize;
+
+    uring->sqRing = mmap(NULL, uring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         uring->fd, IORING_OFF_SQ_RING);
+    uring->cqRing = singleMap ? uring->sqRing : mmap(NULL, uring->cqRingSize, PROT_READ | PROT_WRITE,
+                                                     MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_CQ_RING);
+    uring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    uring->sqes = (struct io_uring_sqe*) mmap(NULL, uring->sqesSize, PROT_READ | PROT_WRITE,
+                                              MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQES);
+    if (singleMap) uring->cqRingSize = 0; //one mapping is unmapped once
+    if (uring->sqRing == MAP_FAILED || uring->cqRing == MAP_FAILED || uring->sqes == MAP_FAILED) {
+        uringFree(uring);
+        return FAIL;
+    }
+
+    char *sq = (char*) uring->sqRing, *cq = (char*) uring->cqRing;
+    uring->sqTail  = (unsigned*) (sq + params.sq_off.tail);
+    uring->sqMask  = (unsigned*) (sq + params.sq_off.ring_mask);
+    uring->sqArray = (unsigned*) (sq + params.sq_off.array);
+    uring->cqHead  = (unsigned*) (cq + params.cq_off.head);
+    uring->cqTail  = (unsigned*) (cq + params.cq_off.tail);
+    uring->cqMask  = (unsigned*) (cq + params.cq_off.ring_mask);
+    uring->cqes    = (struct io_uring_cqe*) (cq + params.cq_off.cqes);
+    return GOOD_EXIT;
+}
+
+
+static void uringFree(uringQueue_t *uring) {
+    if (uring->sqes != MAP_FAILED) munmap(uring->sqes, uring->sqesSize);
+    if (uring->cqRing != MAP_FAILED && uring->cqRing != uring->sqRing) munmap(uring->cqRing, uring->cqRingSize);
+    if (uring->sqRing != MAP_FAILED) munmap(uring->sqRing, uring->sqRingSize);
+    if (uring->fd >= 0) close(uring->fd);
+    *uring = BLANK_URING_QUEUE;
+}
+
+
+static enum error uringSubmit(uringQueue_t *uring, ioBlock_t *block, int fd, unsigned size) {
+    //reader is the only producer, so tail is read without synchronization
+    const unsigned tail = *uring->sqTail;
+    const unsigned index = tail & *uring->sqMask;
+
+    struct io_uring_sqe *sqe = &uring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = (uint8_t) (block->isWrite ? IORING_OP_WRITE : IORING_OP_READ);
+    sqe->fd = fd;
+    sqe->addr = (uint64_t) (uintptr_t) block->data;
+    sqe->len = size;
+    sqe->off = block->offset;
+    sqe->user_data = (uint64_t) (uintptr_t) block;
+    uring->sqArray[index] = index;
+    __atomic_store_n(uring->sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    long submitted = 0;
+    do {
+        submitted = syscall(__NR_io_uring_enter, uring->fd, 1, 0, 0, NULL, 0);
+    } while (submitted < 0 && errno == EINTR);
+    return (submitted == 1) ? GOOD_EXIT : FAIL;
+}
+
+
+static enum error uringReap(asyncIO_t *io) {
+    uringQueue_t *uring = &io->uring;
+    const long waited = syscall(__NR_io_uring_enter, uring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+    if (waited < 0 && errno != EINTR) return FAIL;
+
+    unsigned head = *uring->cqHead;
+    const unsigned tail = __atomic_load_n(uring->cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+        const struct io_uring_cqe *cqe = &uring->cqes[head & *uring->cqMask];
+        completeBlock(io, (ioBlock_t*) (uintptr_t) cqe->user_data, cqe->res);
+    }
+    __atomic_store_n(uring->cqHead, head, __ATOMIC_RELEASE);
+    return GOOD_EXIT;
+}
+
+#endif
+
+
+asyncIO_t *asyncIOCreate(int inFd, int outFd, enum ioBackend backend) {
+    MY_ASSERT(backend == IO_PREAD || backend == IO_URING, return NULL);
+
+    asyncIO_t *io = (asyncIO_t*) calloc(1, sizeof(asyncIO_t));
+    if (!io) {
+        fprintf(stderr, RED "Can't allocate memory for I/O blocks\n" RESET_C);
+        return NULL;
+    }
+    io->inFd = inFd;
+    io->outFd = outFd;
+    io->backend = IO_PREAD;
+#ifdef IO_URING_BACKEND
+    io->uring = BLANK_URING_QUEUE;
+    if (backend == IO_URING && uringInit(&io->uring, URING_ENTRIES) == GOOD_EXIT)
+        io->backend = IO_URING;
+#endif
+
+    if ((inFd >= 0 && allocBlocks(io->reads, 0) != GOOD_EXIT)
+        || (outFd >= 0 && allocBlocks(io->writes, 1) != GOOD_EXIT)) {
+        asyncIODestroy(io);
+        return NULL;
+    }
+
+    //positions are kept, so data before them isn't touched
+    if (inFd >= 0) {
+        const off_t position = lseek(inFd, 0, SEEK_CUR);
+        io->readOffset = io->inputPos = (position > 0) ? (uint64_t) position : 0;
+        for (size_t i = 0; i < ASYNC_DEPTH && !io->readsEnded; i++)
+            submitRead(io, &io->reads[i]);
+    }
+    if (outFd >= 0) {
+        const off_t position = lseek(outFd, 0, SEEK_CUR);
+        io->writeOffset = (position > 0) ? (uint64_t) position : 0;
+    }
+    return io;
+}
+
+
+enum error asyncIODestroy(asyncIO_t *io) {
+    if (!io) return GOOD_EXIT;
+
+    if (io->outFd >= 0 && io->writes[io->writeIndex].data && io->writes[io->writeIndex].size > 0)
+        submitWrite(io, &io->writes[io->writeIndex]);
+    //kernel can write to blocks until their requests are completed
+    //block that is still in flight is leaked: freed memory could be overwritten
+    for (size_t i = 0; i < ASYNC_DEPTH; i++) {
+        if (waitBlock(io, &io->reads[i]) == GOOD_EXIT) free(io->reads[i].data);
+        if (waitBlock(io, &io->writes[i]) == GOOD_EXIT) free(io->writes[i].data);
+    }
+#ifdef IO_URING_BACKEND
+    uringFree(&io->uring);
+#endif
+
+    if (io->inFd >= 0) lseek(io->inFd, (off_t) io->inputPos, SEEK_SET);
+    if (io->outFd >= 0) lseek(io->outFd, (off_t) io->writeOffset, SEEK_SET);
+    const enum error result = io->failed ? FAIL : GOOD_EXIT;
+    free(io);
+    return result;
+}
+
+
+enum ioBackend asyncIOBackend(const asyncIO_t *io) {
+    MY_ASSERT(io, return IO_STDIO);
+    return io->backend;
+}
+
+
+int isAsyncFile(int fd) {
+    struct stat info = {};
+    if (fd < 0 || fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) return 0;
+    //appending ignores offsets, so writes in flight could be reordered
+    const int flags = fcntl(fd, F_GETFL);
+    return flags >= 0 && !(flags & O_APPEND);
+}
+
+
+size_t asyncRead(asyncIO_t *io, char *buffer, size_t size) {
+    MY_ASSERT(io && io->inFd >= 0, return 0);
+    MY_ASSERT(buffer || size == 0, return 0);
+
+    size_t copied = 0;
+    while (copied < size && !io->inputEnded && !io->failed) {
+        ioBlock_t *block = &io->reads[io->readIndex];
+        if (waitBlock(io, block) != GOOD_EXIT) break;
+
+        const size_t part = (size - copied < block->size - block->pos) ? size - copied : block->size - block->pos;
+        memcpy(buffer + copied, block->data + block->pos, part);
+        copied += part;
+        block->pos += part;
+        io->inputPos += part;
+        if (block->pos < block->size) break;
+
+        //only the last block of file is short
+        if (block->size < ASYNC_BLOCK_SIZE) {
+            io->inputEnded = 1;
+            break;
+        }
+        block->state = BLOCK_IDLE;
+        if (!io->readsEnded) submitRead(io, block);
+        io->readIndex = (io->readIndex + 1) % ASYNC_DEPTH;
+    }
+    return copied;
+}
+
+
+enum error asyncWrite(asyncIO_t *io, const char *data, size_t size) {
+    MY_ASSERT(io && io->outFd >= 0, return FAIL);
+    MY_ASSERT(data || size == 0, return FAIL);
+
+    while (size > 0 && !io->failed) {
+        ioBlock_t *block = &io->writes[io->writeIndex];
+        PROPAGATE_ERROR(waitBlock(io, block));
+
+        const size_t part = (size < ASYNC_BLOCK_SIZE - block->size) ? size : ASYNC_BLOCK_SIZE - block->size;
+        memcpy(block->data + block->size, data, part);
+        block->size += part;
+        data += part;
+        size -= part;
+        if (block->size == ASYNC_BLOCK_SIZE) {
+            submitWrite(io, block);
+            io->writeIndex = (io->writeIndex + 1) % ASYNC_DEPTH;
+        }
+    }
+    return io->failed ? FAIL : GOOD_EXIT;
+}
+
+
+int asyncIOFailed(const asyncIO_t *io) {
+    MY_ASSERT(io, return 1);
+    return io->failed;
+}
+
+#else
+
+asyncIO_t *asyncIOCreate(int inFd, int outFd, enum ioBackend backend) {
+    (void) inFd;
+    (void) outFd;
+    (void) backend;
+    fprintf(stderr, "Asynchronous I/O is supported only on POSIX systems\n");
+    return NULL;
+}
+
+
+enum error asyncIODestroy(asyncIO_t *io) {
+    (void) io;
+    return GOOD_EXIT;
+}
+
+
+enum ioBackend asyncIOBackend(const asyncIO_t *io) {
+    (void) io;
+    return IO_STDIO;
+}
+
+
+int isAsyncFile(int fd) {
+    (void) fd;
+    return 0;
+}
+
+
+size_t asyncRead(asyncIO_t *io, char *buffer, size_t size) {
+    (void) io;
+    (void) buffer;
+    (void) size;
+    return 0;
+}
+
+
+enum error asyncWrite(asyncIO_t *io, const char *data, size_t size) {
+    (void) io;
+    (void) data;
+    (void) size;
+    return FAIL;
+}
+
+
+int asyncIOFailed(const asyncIO_t *io) {
+    (void) io;
+    return 1;
+}
+
+#endif
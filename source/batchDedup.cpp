@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "batchSolver.h"
+#include "batchDedup.h"
+#include "utils.h"
+
+
+/// @brief Table has at least TABLE_LOAD_DIVIDER slots per row, so probe sequences stay short
+const size_t TABLE_LOAD_DIVIDER = 2;
+
+/// @brief Slot of row that is this number of rows ahead is prefetched while current row is probed
+const size_t DEDUP_PREFETCH_DISTANCE = 16;
+
+/// @brief Low half of table slot is unique row + 1
+const uint64_t SLOT_ROW_MASK = 0xFFFFFFFFULL;
+
+
+/// @brief Returns the smallest power of 2 that is not less than TABLE_LOAD_DIVIDER * rows
+static size_t tableSizeFor(size_t rows);
+
+
+/// @brief Checks that two doubles have the same bits, unlike == it distinguishes 0 and -0 and matches NaNs
+static inline int sameBits(double first, double second);
+
+
+/*!
+    @brief Deduplicates and solves one block
+
+    @return Number of unique rows of block
+
+    Duplicates are counted after the whole block is deduplicated, so auto-off decision is exact for it
+*/
+static size_t solveBlockDedup(size_t count, const double a[], const double b[], const double c[],
+                              enum solutionCode code[], double x1[], double x2[],
+                              columnsSolver_t solver, void *solverArg, dedupBuffer_t *buffer);
+
+
+static size_t tableSizeFor(size_t rows) {
+    size_t size = 1;
+    while (size < TABLE_LOAD_DIVIDER * rows) size *= 2;
+    return size;
+}
+
+
+static inline int sameBits(double first, double second) {
+    uint64_t firstBits = 0, secondBits = 0;
+    memcpy(&firstBits, &first, sizeof(firstBits));
+    memcpy(&secondBits, &second, sizeof(secondBits));
+    return firstBits == secondBits;
+}
+
+
+enum error dedupReserve(dedupBuffer_t *buffer, size_t rows) {
+    MY_ASSERT(buffer, return FAIL);
+    if (rows > DEDUP_BLOCK_ROWS) rows = DEDUP_BLOCK_ROWS;
+    if (buffer->unique.capacity >= rows) return GOOD_EXIT;
+
+    //state of auto-off survives reallocation
+    const size_t skipBlocks = buffer->skipBlocks, backoff = buffer->backoff;
+    dedupFree(buffer);
+    buffer->skipBlocks = skipBlocks;
+    buffer->backoff = backoff;
+
+    PROPAGATE_ERROR(batchAlloc(&buffer->unique, rows));
+    buffer->tableCapacity = tableSizeFor(rows);
+    buffer->index  = (uint32_t*) calloc(rows, sizeof(uint32_t));
+    buffer->hashes = (uint64_t*) calloc(rows, sizeof(uint64_t));
+    buffer->table  = (uint64_t*) calloc(buffer->tableCapacity, sizeof(uint64_t));
+    if (!buffer->index || !buffer->hashes || !buffer->table) {
+        fprintf(stderr, RED "Can't allocate memory for deduplication of %zu equations\n" RESET_C, rows);
+        dedupFree(buffer);
+        return FAIL;
+    }
+    return GOOD_EXIT;
+}
+
+
+void dedupFree(dedupBuffer_t *buffer) {
+    MY_ASSERT(buffer, return);
+    batchFree(&buffer->unique);
+    free(buffer->index);
+    free(buffer->hashes);
+    free(buffer->table);
+    *buffer = BLANK_DEDUP_BUFFER;
+}
+
+
+size_t dedupColumns(size_t count, const double a[], const double b[], const double c[], dedupBuffer_t *buffer) {
+    MY_ASSERT(buffer, return 0);
+    MY_ASSERT(count <= buffer->unique.capacity, return 0);
+    if (count == 0) return 0;
+    MY_ASSERT(a && b && c, return 0);
+
+    //small blocks use only part of table, so it stays in cache and clearing is cheap
+    const size_t tableMask = tableSizeFor(count) - 1;
+    uint64_t *table = buffer->table;
+    memset(table, 0, (tableMask + 1) * sizeof(uint64_t));
+
+    //hashes are computed first, so slots of next rows can be prefetched
+    uint64_t *hashes = buffer->hashes;
+    for (size_t row = 0; row < count; row++)
+        hashes[row] = hashCoeffBits(a[row], b[row], c[row]);
+
+    quadraticBatch_t *unique = &buffer->unique;
+    size_t uniqueCount = 0;
+    for (size_t row = 0; row < count; row++) {
+        if (row + DEDUP_PREFETCH_DISTANCE < count)
+            __builtin_prefetch(&table[hashes[row + DEDUP_PREFETCH_DISTANCE] & tableMask]);
+
+        //coefficients are compared only if high halves of hashes are equal
+        const uint64_t tag = hashes[row] & ~SLOT_ROW_MASK;
+        size_t slot = hashes[row] & tableMask;
+        while (table[slot]) {
+            if ((table[slot] & ~SLOT_ROW_MASK) == tag) {
+                const size_t candidate = (table[slot] & SLOT_ROW_MASK) - 1;
+                if (sameBits(unique->a[candidate], a[row]) && sameBits(unique->b[candidate], b[row])
+                    && sameBits(unique->c[candidate], c[row]))
+                    break;
+            }
+            slot = (slot + 1) & tableMask;
+        }
+        if (!table[slot]) {
+            unique->a[uniqueCount] = a[row];
+            unique->b[uniqueCount] = b[row];
+            unique->c[uniqueCount] = c[row];
+            table[slot] = tag | ++uniqueCount;
+        }
+        buffer->index[row] = (uint32_t) ((table[slot] & SLOT_ROW_MASK) - 1);
+    }
+    unique->size = uniqueCount;
+    return uniqueCount;
+}
+
+
+void scatterResults(size_t count, const dedupBuffer_t *buffer, enum solutionCode code[], double x1[], double x2[]) {
+    MY_ASSERT(buffer, return);
+    if (count == 0) return;
+    MY_ASSERT(code && x1 && x2, return);
+
+    const quadraticBatch_t *unique = &buffer->unique;
+    for (size_t row = 0; row < count; row++) {
+        const uint32_t source = buffer->index[row];
+        code[row] = unique->code[source];
+        x1[row] = unique->x1[source];
+        x2[row] = unique->x2[source];
+    }
+}
+
+
+static size_t solveBlockDedup(size_t count, const double a[], const double b[], const double c[],
+                              enum solutionCode code[], double x1[], double x2[],
+                              columnsSolver_t solver, void *solverArg, dedupBuffer_t *buffer) {
+    const size_t uniqueCount = dedupColumns(count, a, b, c, buffer);
+    const quadraticBatch_t *unique = &buffer->unique;
+    solver(uniqueCount, unique->a, unique->b, unique->c, unique->code, unique->x1, unique->x2, solverArg);
+    scatterResults(count, buffer, code, x1, x2);
+    return uniqueCount;
+}
+
+
+enum error solveColumnsDedup(size_t count, const double a[], const double b[], const double c[],
+                             enum solutionCode code[], double x1[], double x2[],
+                             columnsSolver_t solver, void *solverArg, double solverCost,
+                             dedupBuffer_t *buffer, dedupStats_t *stats) {
+    MY_ASSERT(solver, return FAIL);
+    MY_ASSERT(buffer, return FAIL);
+    if (count == 0) return GOOD_EXIT;
+    MY_ASSERT(a && b && c, return FAIL);
+    MY_ASSERT(code && x1 && x2, return FAIL);
+
+    //even if all rows are duplicates, cheap solver is faster than hashing them
+    const int worthTrying = solverCost > DEDUP_ROW_COST && count >= DEDUP_MIN_ROWS;
+    if (worthTrying)
+        PROPAGATE_ERROR(dedupReserve(buffer, count));
+
+    dedupStats_t blockStats = BLANK_DEDUP_STATS;
+    for (size_t begin = 0; begin < count; begin += DEDUP_BLOCK_ROWS) {
+        const size_t blockSize = (count - begin > DEDUP_BLOCK_ROWS) ? DEDUP_BLOCK_ROWS : count - begin;
+        const double *blockA = a + begin, *blockB = b + begin, *blockC = c + begin;
+
+        if (!worthTrying || blockSize < DEDUP_MIN_ROWS || buffer->skipBlocks > 0) {
+            if (worthTrying && blockSize >= DEDUP_MIN_ROWS) buffer->skipBlocks--;
+            solver(blockSize, blockA, blockB, blockC, code + begin, x1 + begin, x2 + begin, solverArg);
+            continue;
+        }
+
+        const size_t uniqueCount = solveBlockDedup(blockSize, blockA, blockB, blockC,
+                                                   code + begin, x1 + begin, x2 + begin, solver, solverArg, buffer);
+        blockStats.dedupRows += blockSize;
+        blockStats.uniqueRows += uniqueCount;
+
+        //doesn't pay off: skip the next blocks, twice more after every failed try
+        if ((double) (blockSize - uniqueCount) * solverCost < (double) blockSize * DEDUP_ROW_COST) {
+            buffer->skipBlocks = buffer->backoff;
+            buffer->backoff = (buffer->backoff * 2 > DEDUP_MAX_BACKOFF) ? DEDUP_MAX_BACKOFF : buffer->backoff * 2;
+        } else
+            buffer->backoff = 1;
+    }
+
+    if (stats) {
+        stats->rows += count;
+        stats->dedupRows += blockStats.dedupRows;
+        stats->uniqueRows += blockStats.uniqueRows;
+    }
+    return GOOD_EXIT;
+}
@@ -0,0 +1,321 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "quadraticPrinter.h"
+#include "batchSolver.h"
+#include "preciseSolver.h"
+#include "resultCache.h"
+#include "batchDedup.h"
+#include "asyncIO.h"
+#include "polynomialSolver.h"
+#include "batchProcessor.h"
+#include "inputHandler.h"
+#include "spscRing.h"
+#include "batchPipeline.h"
+#include "tracer.h"
+
+
+/// @brief Equations of chunk, result of solver stage is passed to formatter with them
+typedef struct pipelineChunk {
+    quadraticBatch_t batch;     ///< Columns for PIPELINE_CHUNK_ROWS quadratic equations
+    polynomialBatch_t cubics;   ///< Lines with 4 coefficients, allocated by the first such line
+    polynomialBatch_t quartics; ///< Lines with 5 coefficients, allocated by the first such line
+    unsigned char *degrees;     ///< Degree of every line, results of three batches are merged in input order by it
+    enum error result;          ///< Result of solver, formatter doesn't print chunks that weren't solved
+} pipelineChunk_t;
+
+
+/// @brief State shared by stages, every field except failed is written by one stage only
+typedef struct pipeline {
+    spscRing_t *toSolve = NULL;         ///< Parsed chunks, parser -> solver
+    spscRing_t *toFormat = NULL;        ///< Solved chunks, solver -> formatter
+    spscRing_t *freeChunks = NULL;      ///< Printed chunks, formatter -> parser
+
+    pipelineChunk_t chunks[PIPELINE_CHUNKS] = {};
+    char *output = NULL;                ///< Formatted lines of one chunk, PIPELINE_CHUNK_ROWS polynomial lines fit in it
+    FILE *out = NULL;
+    batchOptions_t options = DEFAULT_BATCH_OPTIONS;
+
+    std::atomic<int> failed {0};        ///< Set by any stage, parser stops and the rest only pass chunks further
+    double busyTime[PIPELINE_STAGES] = {};
+    size_t printedChunks = 0;
+} pipeline_t;
+
+
+/// @brief End of input, every stage passes it further and stops
+static void *const END_OF_CHUNKS = NULL;
+
+
+/*!
+    @brief Allocates rings, chunks and output buffer, all chunks are put to free ring
+
+    @return GOOD_EXIT or FAIL if memory can't be allocated
+*/
+static enum error pipelineInit(pipeline_t *pipe);
+
+
+/// @brief Frees everything allocated by pipelineInit()
+static void pipelineFree(pipeline_t *pipe);
+
+
+/*!
+    @brief Reads lines to chunk until it has PIPELINE_CHUNK_ROWS equations or text ends
+
+    @param[in, out] pos Current position in text
+    @param[in] end End of text
+    @param[in, out] line Number of line at pos, used in warnings
+    @param[out] chunk Chunk for coefficients and degrees of lines
+    @param[in] silent Don't print warnings about bad lines
+
+    @return GOOD_EXIT or FAIL if columns for polynomials can't be allocated
+
+    Lines with 3, 4 or 5 numbers go to batch of their degree like in processChunk(), empty lines are skipped,
+    lines that can't be read get NaN coefficients of quadratic equation
+*/
+static enum error parseChunk(const char **pos, const char *end, size_t *line, pipelineChunk_t *chunk, int silent);
+
+
+/// @brief Solver stage, runs in it's own thread
+static void solveStage(pipeline_t *pipe);
+
+
+/// @brief Formatter stage, runs in it's own thread
+static void formatStage(pipeline_t *pipe);
+
+
+/*!
+    @brief Writes results of all lines of chunk to out in input order
+
+    @return Number of written bytes
+
+    If chunk has only quadratic lines, batch is formatted with one plain loop
+*/
+static size_t formatChunkLines(const pipelineChunk_t *chunk, char *out, enum numberStyle style);
+
+
+/// @brief Returns seconds between two points of time
+static double secondsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+
+static double secondsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double>(end - start).count();
+}
+
+
+static enum error pipelineInit(pipeline_t *pipe) {
+    pipe->toSolve = spscRingCreate(PIPELINE_CHUNKS);
+    pipe->toFormat = spscRingCreate(PIPELINE_CHUNKS);
+    pipe->freeChunks = spscRingCreate(PIPELINE_CHUNKS);
+    if (!pipe->toSolve || !pipe->toFormat || !pipe->freeChunks) return FAIL;
+
+    pipe->output = (char*) malloc(PIPELINE_CHUNK_ROWS * MAX_POLY_LINE_LEN);
+    if (!pipe->output) {
+        fprintf(stderr, RED "Can't allocate memory for output\n" RESET_C);
+        return FAIL;
+    }
+    for (size_t i = 0; i < PIPELINE_CHUNKS; i++) {
+        PROPAGATE_ERROR(batchAlloc(&pipe->chunks[i].batch, PIPELINE_CHUNK_ROWS));
+        pipe->chunks[i].degrees = (unsigned char*) malloc(PIPELINE_CHUNK_ROWS);
+        if (!pipe->chunks[i].degrees) {
+            fprintf(stderr, RED "Can't allocate memory for degrees of lines\n" RESET_C);
+            return FAIL;
+        }
+        spscPush(pipe->freeChunks, &pipe->chunks[i]);
+    }
+    return GOOD_EXIT;
+}
+
+
+static void pipelineFree(pipeline_t *pipe) {
+    spscRingDestroy(pipe->toSolve);
+    spscRingDestroy(pipe->toFormat);
+    spscRingDestroy(pipe->freeChunks);
+    for (size_t i = 0; i < PIPELINE_CHUNKS; i++) {
+        batchFree(&pipe->chunks[i].batch);
+        polyBatchFree(&pipe->chunks[i].cubics);
+        polyBatchFree(&pipe->chunks[i].quartics);
+        free(pipe->chunks[i].degrees);
+    }
+    free(pipe->output);
+}
+
+
+static enum error parseChunk(const char **pos, const char *end, size_t *line, pipelineChunk_t *chunk, int silent) {
+    quadraticBatch_t *batch = &chunk->batch;
+    batch->size = 0;
+    chunk->cubics.size = 0;
+    chunk->quartics.size = 0;
+    for (size_t rows = 0; *pos < end && rows < PIPELINE_CHUNK_ROWS; (*line)++) {
+        double coeffs[MAX_DEGREE + 1] = {NAN, NAN, NAN, NAN, NAN};
+        size_t count = 0;
+        enum error scanResult = scanCoeffsFromBuffer(pos, end, coeffs, MAX_DEGREE + 1, &count);
+        if (scanResult == BLANK) continue;
+        if (scanResult != GOOD_EXIT || count < 3) {
+            if (!silent)
+                fprintf(stderr, "Can't read coefficients on line %zu\n", *line);
+            coeffs[0] = coeffs[1] = coeffs[2] = NAN;
+            count = 3;
+        }
+
+        const int degree = (int) count - 1;
+        chunk->degrees[rows++] = (unsigned char) degree;
+        if (degree == 2) {
+            batch->a[batch->size] = coeffs[0];
+            batch->b[batch->size] = coeffs[1];
+            batch->c[batch->size] = coeffs[2];
+            batch->size++;
+            continue;
+        }
+        polynomialBatch_t *poly = (degree == 3) ? &chunk->cubics : &chunk->quartics;
+        if (poly->capacity == 0)
+            PROPAGATE_ERROR(polyBatchAlloc(poly, degree, PIPELINE_CHUNK_ROWS));
+        for (int i = 0; i <= degree; i++)
+            poly->coeffs[i][poly->size] = coeffs[i];
+        poly->size++;
+    }
+    return GOOD_EXIT;
+}
+
+
+static void solveStage(pipeline_t *pipe) {
+    TRACE_THREAD_NAME("solver");
+    while (true) {
+        pipelineChunk_t *chunk = (pipelineChunk_t*) spscPop(pipe->toSolve);
+        if (chunk == END_OF_CHUNKS) break;
+
+        TRACE_BEGIN(solveSpan);
+        const auto start = std::chrono::steady_clock::now();
+        quadraticBatch_t *batch = &chunk->batch;
+        enum error result = pipe->failed ? FAIL : solveColumnsParallel(batch->size, batch->a, batch->b, batch->c,
+                                                                      batch->code, batch->x1, batch->x2, &pipe->options);
+        if (result == GOOD_EXIT && chunk->cubics.size > 0) result = solvePolynomialColumns(&chunk->cubics);
+        if (result == GOOD_EXIT && chunk->quartics.size > 0) result = solvePolynomialColumns(&chunk->quartics);
+        chunk->result = result;
+        pipe->busyTime[STAGE_SOLVE] += secondsBetween(start, std::chrono::steady_clock::now());
+        TRACE_END(solveSpan, "solve chunk");
+
+        spscPush(pipe->toFormat, chunk);
+    }
+    spscPush(pipe->toFormat, END_OF_CHUNKS);
+}
+
+
+static void formatStage(pipeline_t *pipe) {
+    TRACE_THREAD_NAME("formatter");
+    while (true) {
+        pipelineChunk_t *chunk = (pipelineChunk_t*) spscPop(pipe->toFormat);
+        if (chunk == END_OF_CHUNKS) break;
+
+        TRACE_BEGIN(formatSpan);
+        const auto start = std::chrono::steady_clock::now();
+        if (chunk->result != GOOD_EXIT) pipe->failed = 1;
+        if (!pipe->failed) {
+            const size_t outputSize = formatChunkLines(chunk, pipe->output, pipe->options.style);
+            if (fwrite(pipe->output, 1, outputSize, pipe->out) != outputSize) {
+                fprintf(stderr, RED "Can't write results\n" RESET_C);
+                pipe->failed = 1;
+            }
+            pipe->printedChunks++;
+        }
+        pipe->busyTime[STAGE_FORMAT] += secondsBetween(start, std::chrono::steady_clock::now());
+        TRACE_END(formatSpan, "format and write chunk");
+
+        spscPush(pipe->freeChunks, chunk);
+    }
+}
+
+
+static size_t formatChunkLines(const pipelineChunk_t *chunk, char *out, enum numberStyle style) {
+    const quadraticBatch_t *batch = &chunk->batch;
+    char *pos = out;
+    if (chunk->cubics.size == 0 && chunk->quartics.size == 0) {
+        for (size_t i = 0; i < batch->size; i++)
+            pos += formatResultLine(pos, batch->code[i], batch->x1[i], batch->x2[i], style);
+        return (size_t) (pos - out);
+    }
+
+    const size_t lines = batch->size + chunk->cubics.size + chunk->quartics.size;
+    size_t next[MAX_DEGREE + 1] = {};
+    for (size_t line = 0; line < lines; line++) {
+        const int degree = chunk->degrees[line];
+        const size_t i = next[degree]++;
+        if (degree == 2) {
+            pos += formatResultLine(pos, batch->code[i], batch->x1[i], batch->x2[i], style);
+            continue;
+        }
+        const polynomialBatch_t *poly = (degree == 3) ? &chunk->cubics : &chunk->quartics;
+        double roots[MAX_DEGREE] = {};
+        for (int j = 0; j < degree; j++)
+            roots[j] = poly->roots[j][i];
+        pos += formatPolynomialLine(pos, poly->code[i], roots, degree, style);
+    }
+    return (size_t) (pos - out);
+}
+
+
+enum error solveBatchPipeline(const char *text, size_t size, FILE* out, const batchOptions_t* options,
+                              pipelineStats_t* stats) {
+    MY_ASSERT(text || size == 0, return FAIL);
+    MY_ASSERT(out, return FAIL);
+    MY_ASSERT(options, return FAIL);
+
+    pipeline_t pipe = {};
+    if (pipelineInit(&pipe) != GOOD_EXIT) {
+        pipelineFree(&pipe);
+        return FAIL;
+    }
+    pipe.out = out;
+    pipe.options = *options;
+    pipe.options.threads = 1; //every stage has one thread, chunks are too small to split them
+    pipe.options.pool = NULL;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread solver(solveStage, &pipe);
+    std::thread formatter(formatStage, &pipe);
+
+    const char *pos = text, *end = text + size;
+    size_t line = 1;
+    while (pos < end && !pipe.failed) {
+        pipelineChunk_t *chunk = (pipelineChunk_t*) spscPop(pipe.freeChunks);
+
+        TRACE_BEGIN(parseSpan);
+        const auto parseStart = std::chrono::steady_clock::now();
+        if (parseChunk(&pos, end, &line, chunk, options->silent) != GOOD_EXIT)
+            pipe.failed = 1;
+        pipe.busyTime[STAGE_PARSE] += secondsBetween(parseStart, std::chrono::steady_clock::now());
+        TRACE_END(parseSpan, "parse chunk");
+
+        spscPush(pipe.toSolve, chunk);
+    }
+    spscPush(pipe.toSolve, END_OF_CHUNKS);
+
+    solver.join();
+    formatter.join();
+
+    if (stats) {
+        stats->chunks = pipe.printedChunks;
+        stats->wallTime = secondsBetween(start, std::chrono::steady_clock::now());
+        for (size_t stage = 0; stage < PIPELINE_STAGES; stage++)
+            stats->busyTime[stage] = pipe.busyTime[stage];
+    }
+    const enum error result = pipe.failed ? FAIL : GOOD_EXIT;
+    pipelineFree(&pipe);
+    return result;
+}
+
+
+enum pipelineStage pipelineBottleneck(const pipelineStats_t* stats) {
+    MY_ASSERT(stats, return STAGE_PARSE);
+    size_t bottleneck = STAGE_PARSE;
+    for (size_t stage = 1; stage < PIPELINE_STAGES; stage++) {
+        if (stats->busyTime[stage] > stats->busyTime[bottleneck]) bottleneck = stage;
+    }
+    return (enum pipelineStage) bottleneck;
+}
@@ -0,0 +1,1034 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "quadraticPrinter.h"
+#include "batchSolver.h"
+#include "preciseSolver.h"
+#include "resultCache.h"
+#include "batchDedup.h"
+#include "asyncIO.h"
+#include "polynomialSolver.h"
+#include "batchProcessor.h"
+#include "inputHandler.h"
+#include "threadPool.h"
+#include "tracer.h"
+
+
+/// @brief Number of chunks in flight per worker thread, limits memory used by reorder buffer
+const size_t CHUNKS_PER_THREAD = 4;
+
+
+/// @brief Minimal number of equations that are solved by one task of solveColumnsParallel()
+const size_t COLUMNS_GRAIN = 1 << 14;
+
+
+/// @brief Number of lines that are formatted before they are written to stream
+const size_t WRITE_BLOCK_LINES = 1 << 14;
+
+
+/// @brief Maximum length of one line "a b c" written by writeCoeffsText()
+const size_t MAX_COEFFS_LINE_LEN = 3 * MAX_NUMBER_LEN + 4;
+
+
+/// @brief Columns for solveColumnsParallel(), argument of solveColumnsRange()
+typedef struct columnsTask {
+    const double *a, *b, *c;
+    enum solutionCode *code;
+    double *x1, *x2;
+    const batchOptions_t *options;      ///< Selects solver
+    std::atomic<size_t> slowPath;       ///< Sum of slowPath counters of all ranges
+    std::atomic<size_t> dedupRows;      ///< Sum of dedupRows counters of all ranges
+    std::atomic<size_t> uniqueRows;     ///< Sum of uniqueRows counters of all ranges
+    std::atomic<int> failed;            ///< Some range couldn't allocate memory
+
+    std::mutex dedupLock;               ///< Protects dedup and freeDedup
+    dedupBuffer_t *dedup;               ///< Free buffers of deduplication, one per thread, so they are allocated once
+    size_t freeDedup;                   ///< Number of buffers in dedup that no range has taken
+} columnsTask_t;
+
+
+/// @brief Columns for classifyPackedParallel(), argument of classifyPackedRange()
+typedef struct packedTask {
+    size_t count;                       ///< Number of equations
+    const double *a, *b, *c;
+    uint64_t *packed;
+} packedTask_t;
+
+
+/// @brief Argument of solveSelected()
+typedef struct solverCall {
+    const batchOptions_t *options;      ///< Selects solver
+    precisionStats_t *stats;            ///< Counters of precise solver
+} solverCall_t;
+
+
+/// @brief Chunk with it's own input buffer and state in reorder buffer
+typedef struct chunkSlot {
+    batchChunk_t chunk;             ///< Chunk, it's text points to buffer
+    char *buffer;                   ///< Input text of chunk and the rest of line for the next chunk
+    size_t bufferCapacity;          ///< Size of buffer
+
+    int busy;                       ///< Chunk is read but it's results aren't written yet
+    int done;                       ///< Chunk is processed, protected by reorder lock
+    enum error result;              ///< Result of processChunk()
+
+    const batchOptions_t *options;  ///< Batch settings
+    struct reorderBuffer *reorder;  ///< Buffer that owns slot
+} chunkSlot_t;
+
+
+/*!
+    @brief Ring of chunks that restores input order of results
+
+    Chunk with sequence number i lives in slot i % windowSize. <br>
+    Before slot is reused, results of it's previous chunk are written, so output is always in input order
+*/
+typedef struct reorderBuffer {
+    chunkSlot_t *slots;             ///< Array of windowSize slots
+    size_t windowSize;              ///< Maximum number of chunks in flight
+    size_t sequence;                ///< Sequence number of the next chunk
+    FILE *out;                      ///< Output stream
+    asyncIO_t *io;                  ///< If not NULL, results are written with asyncWrite() instead of out
+    threadPool_t *pool;             ///< Pool of options that processes chunks, NULL if they are processed in place
+
+    std::mutex lock;                ///< Protects done field of slots
+    std::condition_variable chunkDone;
+} reorderBuffer_t;
+
+
+/// @brief Takes thread pool of options and allocates slots
+static enum error reorderInit(reorderBuffer_t *reorder, FILE *out, const batchOptions_t *options);
+
+
+/// @brief Returns slot for the next chunk, writes results of the previous chunk in this slot
+static enum error reorderNextSlot(reorderBuffer_t *reorder, chunkSlot_t **slot);
+
+
+/// @brief Sends chunk to thread pool or processes and writes it in place
+static enum error reorderSubmit(reorderBuffer_t *reorder, chunkSlot_t *slot);
+
+
+/*!
+    @brief Writes results of all chunks in flight, waits for thread pool and frees slots
+
+    @param[in, out] reorder Pointer to reorder buffer
+    @param[in] result Result of reading loop
+
+    @return result if it isn't GOOD_EXIT, else result of writing
+*/
+static enum error reorderFinish(reorderBuffer_t *reorder, enum error result);
+
+
+/// @brief Processes chunk of slot and marks it done, can be run in thread pool
+static void processSlotTask(void *slotPtr);
+
+
+/// @brief Waits until chunk of slot is processed and writes it's results
+static enum error emitChunk(reorderBuffer_t *reorder, chunkSlot_t *slot);
+
+
+/*!
+    @brief Reads next piece of input to slot buffer
+
+    @param[in] in Input stream
+    @param[in] io If not NULL, input is read with asyncRead() instead of in
+    @param[in, out] slot Slot with buffer
+    @param[in] leftover Rest of line from previous chunk, it is copied to the beginning of buffer
+    @param[in] leftoverSize Size of leftover
+    @param[out] filled Number of bytes in buffer
+    @param[out] inputEnded Set to 1 if stream ended
+
+    @return GOOD_EXIT or FAIL if memory can't be allocated
+
+    Reads until buffer contains at least one whole line or stream ends
+*/
+static enum error readChunkText(FILE *in, asyncIO_t *io, chunkSlot_t *slot, const char *leftover, size_t leftoverSize,
+                                size_t *filled, int *inputEnded);
+
+
+/*!
+    @brief Makes sure that chunk batch, degrees and output can hold specified number of lines
+
+    @return GOOD_EXIT or FAIL if memory can't be allocated
+*/
+static enum error chunkReserve(batchChunk_t* chunk, size_t lines, int single);
+
+
+/*!
+    @brief Makes sure that output of chunk has specified number of bytes
+
+    @return GOOD_EXIT or FAIL if memory can't be allocated
+*/
+static enum error chunkReserveOutput(batchChunk_t* chunk, size_t bytes);
+
+
+/*!
+    @brief Makes sure that batch of polynomials can hold specified number of lines
+
+    @return GOOD_EXIT or FAIL if memory can't be allocated
+*/
+static enum error polyBatchReserve(polynomialBatch_t* batch, int degree, size_t lines);
+
+
+/*!
+    @brief Adds parsed line to batch of it's degree
+
+    @param[in, out] chunk Chunk, degree of line is recorded in it
+    @param[in] coeffs Coefficients from the highest power
+    @param[in] degree Degree of equation from 2 to MAX_DEGREE
+    @param[in] lines Number of lines in chunk, capacity of polynomial batch if it is allocated
+
+    @return GOOD_EXIT or FAIL if memory can't be allocated
+*/
+static enum error chunkAddLine(batchChunk_t* chunk, const double coeffs[], int degree, size_t lines);
+
+
+/*!
+    @brief Writes results of all lines to chunk output in input order
+
+    If chunk has only quadratic lines, batch is formatted with one plain loop
+*/
+static void formatChunk(batchChunk_t* chunk, const batchOptions_t* options);
+
+
+/*!
+    @brief Counts lines in text, last line may not end with '\n'
+*/
+static size_t countLines(const char *text, size_t size);
+
+
+/*!
+    @brief Solves quadratic lines of chunk for options->single: rounds parsed columns to float and solves them
+
+    @param[in, out] chunk Chunk with parsed double columns, batchF is reserved
+
+    @return Enum with error code
+*/
+static enum error solveChunkSingle(batchChunk_t* chunk);
+
+
+/// @brief Solves rows [begin, end) of columnsTask_t, used by threadPoolParallelFor()
+static void solveColumnsRange(size_t begin, size_t end, void *task);
+
+
+/// @brief Classifies rows of packed words [begin, end) of packedTask_t, used by threadPoolParallelFor()
+static void classifyPackedRange(size_t begin, size_t end, void *task);
+
+
+/// @brief Solves columns with solver selected by options of solverCall_t, it is columnsSolver_t
+static void solveSelected(size_t count, const double a[], const double b[], const double c[],
+                          enum solutionCode code[], double x1[], double x2[], void *call);
+
+
+/// @brief Returns cost of one row for solver selected by options, used to decide if deduplication pays off
+static double selectedSolverCost(const batchOptions_t *options);
+
+
+/*!
+    @brief Solves columns with solver selected by options, deduplicates them if options->dedup is set
+
+    @param[in, out] stats Counters of precise solver
+    @param[in, out] dedup Buffer for deduplication
+    @param[in, out] dedupStats Counters of deduplication
+
+    @return GOOD_EXIT or FAIL if memory for deduplication can't be allocated
+*/
+static enum error solveColumnsSelected(size_t count, const double a[], const double b[], const double c[],
+                                       enum solutionCode code[], double x1[], double x2[],
+                                       const batchOptions_t *options, precisionStats_t *stats,
+                                       dedupBuffer_t *dedup, dedupStats_t *dedupStats);
+
+
+static size_t countLines(const char *text, size_t size) {
+    size_t lines = 0;
+    const char *end = text + size;
+    while (text < end) {
+        const char *newLine = (const char*) memchr(text, '\n', (size_t) (end - text));
+        lines++;
+        if (!newLine) break;
+        text = newLine + 1;
+    }
+    return lines;
+}
+
+
+static enum error chunkReserve(batchChunk_t* chunk, size_t lines, int single) {
+    if (chunk->batch.capacity < lines) {
+        batchFree(&chunk->batch);
+        free(chunk->degrees);
+        chunk->degrees = NULL;
+        PROPAGATE_ERROR(batchAlloc(&chunk->batch, lines));
+        chunk->degrees = (unsigned char*) calloc(lines, sizeof(unsigned char));
+        if (!chunk->degrees) {
+            fprintf(stderr, RED "Can't allocate memory for degrees of lines\n" RESET_C);
+            return FAIL;
+        }
+    }
+    if (single && chunk->batchF.capacity < lines) {
+        batchFreeF(&chunk->batchF);
+        PROPAGATE_ERROR(batchAllocF(&chunk->batchF, lines));
+    }
+    return chunkReserveOutput(chunk, lines * MAX_RESULT_LINE_LEN);
+}
+
+
+static enum error chunkReserveOutput(batchChunk_t* chunk, size_t bytes) {
+    if (chunk->outputCapacity < bytes) {
+        char *newOutput = (char*) realloc(chunk->output, bytes);
+        if (!newOutput) {
+            fprintf(stderr, RED "Can't allocate memory for output\n" RESET_C);
+            return FAIL;
+        }
+        chunk->output = newOutput;
+        chunk->outputCapacity = bytes;
+    }
+    return GOOD_EXIT;
+}
+
+
+static enum error polyBatchReserve(polynomialBatch_t* batch, int degree, size_t lines) {
+    if (batch->capacity >= lines) return GOOD_EXIT;
+    polyBatchFree(batch);
+    return polyBatchAlloc(batch, degree, lines);
+}
+
+
+static enum error chunkAddLine(batchChunk_t* chunk, const double coeffs[], int degree, size_t lines) {
+    const size_t row = chunk->batch.size + chunk->cubics.size + chunk->quartics.size;
+    chunk->degrees[row] = (unsigned char) degree;
+    if (degree == 2) {
+        quadraticBatch_t *batch = &chunk->batch;
+        batch->a[batch->size] = coeffs[0];
+        batch->b[batch->size] = coeffs[1];
+        batch->c[batch->size] = coeffs[2];
+        batch->size++;
+        return GOOD_EXIT;
+    }
+
+    polynomialBatch_t *batch = (degree == 3) ? &chunk->cubics : &chunk->quartics;
+    if (batch->size == 0)
+        PROPAGATE_ERROR(polyBatchReserve(batch, degree, lines));
+    for (int i = 0; i <= degree; i++)
+        batch->coeffs[i][batch->size] = coeffs[i];
+    batch->size++;
+    return GOOD_EXIT;
+}
+
+
+size_t formatPolynomialLine(char *out, enum solutionCode code, const double roots[], int degree,
+                            enum numberStyle style) {
+    char *pos = out;
+    if (code < 0) *pos++ = '-';
+    *pos++ = (char) ('0' + abs(code));
+    for (int i = 0; i < degree; i++) {
+        *pos++ = ' ';
+        pos += formatNumber(pos, roots[i], style);
+    }
+    *pos++ = '\n';
+    return (size_t) (pos - out);
+}
+
+
+static void formatChunk(batchChunk_t* chunk, const batchOptions_t* options) {
+    const quadraticBatch_t *batch = &chunk->batch;
+    const quadraticBatchF_t *batchF = &chunk->batchF;
+    char *out = chunk->output;
+
+    if (chunk->cubics.size == 0 && chunk->quartics.size == 0) {
+        if (options->classify) {
+            for (size_t i = 0; i < batch->size; i++)
+                out += formatCodeLine(out, batch->code[i]);
+        } else if (options->single) {
+            for (size_t i = 0; i < batchF->size; i++)
+                out += formatResultLineF(out, batchF->code[i], batchF->x1[i], batchF->x2[i], options->style);
+        } else {
+            for (size_t i = 0; i < batch->size; i++)
+                out += formatResultLine(out, batch->code[i], batch->x1[i], batch->x2[i], options->style);
+        }
+        chunk->outputSize = (size_t) (out - chunk->output);
+        return;
+    }
+
+    const size_t lines = batch->size + chunk->cubics.size + chunk->quartics.size;
+    size_t next[MAX_DEGREE + 1] = {};
+    for (size_t line = 0; line < lines; line++) {
+        const int degree = chunk->degrees[line];
+        const size_t i = next[degree]++;
+        if (degree == 2 && options->classify) {
+            out += formatCodeLine(out, batch->code[i]);
+            continue;
+        }
+        if (degree == 2) {
+            out += options->single ? formatResultLineF(out, batchF->code[i], batchF->x1[i], batchF->x2[i], options->style)
+                                   : formatResultLine(out, batch->code[i], batch->x1[i], batch->x2[i], options->style);
+            continue;
+        }
+
+        const polynomialBatch_t *poly = (degree == 3) ? &chunk->cubics : &chunk->quartics;
+        if (options->classify) {
+            out += formatCodeLine(out, poly->code[i]);
+            continue;
+        }
+        double roots[MAX_DEGREE] = {};
+        for (int j = 0; j < degree; j++)
+            roots[j] = poly->roots[j][i];
+        out += formatPolynomialLine(out, poly->code[i], roots, degree, options->style);
+    }
+    chunk->outputSize = (size_t) (out - chunk->output);
+}
+
+
+size_t formatResultLineF(char *out, enum solutionCode code, float x1, float x2, enum numberStyle style) {
+    char *pos = out;
+    if (code < 0) *pos++ = '-';
+    *pos++ = (char) ('0' + abs(code));
+    *pos++ = ' ';
+    pos += formatNumberF(pos, x1, style);
+    *pos++ = ' ';
+    pos += formatNumberF(pos, x2, style);
+    *pos++ = '\n';
+    return (size_t) (pos - out);
+}
+
+
+static enum error solveChunkSingle(batchChunk_t* chunk) {
+    const quadraticBatch_t *batch = &chunk->batch;
+    quadraticBatchF_t *batchF = &chunk->batchF;
+    for (size_t i = 0; i < batch->size; i++) {
+        batchF->a[i] = (float) batch->a[i];
+        batchF->b[i] = (float) batch->b[i];
+        batchF->c[i] = (float) batch->c[i];
+    }
+    batchF->size = batch->size;
+    TRACE_BEGIN(solveSpan);
+    PROPAGATE_ERROR(solveEquationColumnsF(batchF->size, batchF->a, batchF->b, batchF->c,
+                                          batchF->code, batchF->x1, batchF->x2));
+    TRACE_END(solveSpan, "solve chunk");
+    return GOOD_EXIT;
+}
+
+
+size_t formatCodeLine(char *out, enum solutionCode code) {
+    char *pos = out;
+    if (code < 0) *pos++ = '-';
+    *pos++ = (char) ('0' + abs(code));
+    *pos++ = '\n';
+    return (size_t) (pos - out);
+}
+
+
+size_t formatResultLine(char *out, enum solutionCode code, double x1, double x2, enum numberStyle style) {
+    //all codes are one digit, so printf isn't needed
+    char *pos = out;
+    if (code < 0) *pos++ = '-';
+    *pos++ = (char) ('0' + abs(code));
+    *pos++ = ' ';
+    pos += formatNumber(pos, x1, style);
+    *pos++ = ' ';
+    pos += formatNumber(pos, x2, style);
+    *pos++ = '\n';
+    return (size_t) (pos - out);
+}
+
+
+enum error processChunk(batchChunk_t* chunk, const batchOptions_t* options) {
+    MY_ASSERT(chunk, return FAIL);
+    MY_ASSERT(options, return FAIL);
+
+    TRACE_BEGIN(parseSpan);
+    const size_t lines = countLines(chunk->text, chunk->textSize);
+    PROPAGATE_ERROR(chunkReserve(chunk, lines, options->single));
+
+    quadraticBatch_t *batch = &chunk->batch;
+    batch->size = 0;
+    chunk->cubics.size = 0;
+    chunk->quartics.size = 0;
+    chunk->badLines = 0;
+
+    const char *pos = chunk->text, *end = chunk->text + chunk->textSize;
+    for (size_t line = chunk->firstLine; pos < end; line++) {
+        double coeffs[MAX_DEGREE + 1] = {NAN, NAN, NAN, NAN, NAN};
+        size_t count = 0;
+        enum error scanResult = scanCoeffsFromBuffer(&pos, end, coeffs, MAX_DEGREE + 1, &count);
+        if (scanResult == BLANK) continue;
+        if (scanResult != GOOD_EXIT || count < 3) {
+            //NaN coefficients give BAD_INPUT, so every line still has it's result
+            chunk->badLines++;
+            if (!options->silent)
+                fprintf(stderr, "Can't read coefficients on line %zu\n", line);
+            coeffs[0] = coeffs[1] = coeffs[2] = NAN;
+            count = 3;
+        }
+        PROPAGATE_ERROR(chunkAddLine(chunk, coeffs, (int) count - 1, lines));
+    }
+    TRACE_END(parseSpan, "parse chunk");
+
+    const size_t polyLines = chunk->cubics.size + chunk->quartics.size;
+    if (polyLines > 0)
+        PROPAGATE_ERROR(chunkReserveOutput(chunk, batch->size * MAX_RESULT_LINE_LEN + polyLines * MAX_POLY_LINE_LEN));
+
+    chunk->stats = BLANK_PRECISION_STATS;
+    chunk->dedupStats = BLANK_DEDUP_STATS;
+    if (options->single) {
+        PROPAGATE_ERROR(solveChunkSingle(chunk));
+    } else {
+        TRACE_BEGIN(solveSpan);
+        PROPAGATE_ERROR(solveColumnsSelected(batch->size, batch->a, batch->b, batch->c,
+                                             batch->code, batch->x1, batch->x2,
+                                             options, &chunk->stats, &chunk->dedup, &chunk->dedupStats));
+        TRACE_END(solveSpan, "solve chunk");
+    }
+    if (polyLines > 0) {
+        TRACE_BEGIN(polySpan);
+        if (chunk->cubics.size > 0) PROPAGATE_ERROR(solvePolynomialColumns(&chunk->cubics));
+        if (chunk->quartics.size > 0) PROPAGATE_ERROR(solvePolynomialColumns(&chunk->quartics));
+        TRACE_END(polySpan, "solve polynomials");
+    }
+
+    TRACE_BEGIN(formatSpan);
+    formatChunk(chunk, options);
+    TRACE_END(formatSpan, "format chunk");
+    return GOOD_EXIT;
+}
+
+
+static void processSlotTask(void *slotPtr) {
+    chunkSlot_t *slot = (chunkSlot_t*) slotPtr;
+    enum error result = processChunk(&slot->chunk, slot->options);
+
+    std::lock_guard<std::mutex> guard(slot->reorder->lock);
+    slot->result = result;
+    slot->done = 1;
+    slot->reorder->chunkDone.notify_all();
+}
+
+
+static enum error emitChunk(reorderBuffer_t *reorder, chunkSlot_t *slot) {
+    TRACE_BEGIN(waitSpan);
+    {
+        std::unique_lock<std::mutex> guard(reorder->lock);
+        reorder->chunkDone.wait(guard, [slot] { return slot->done != 0; });
+    }
+    TRACE_END(waitSpan, "wait chunk");
+    slot->busy = 0;
+    if (slot->result != GOOD_EXIT) return slot->result;
+
+    //chunks are emitted by one thread, so counters don't need locks
+    if (slot->options->stats) {
+        slot->options->stats->equations += slot->chunk.stats.equations;
+        slot->options->stats->slowPath += slot->chunk.stats.slowPath;
+    }
+    if (slot->options->dedupStats) {
+        slot->options->dedupStats->rows += slot->chunk.dedupStats.rows;
+        slot->options->dedupStats->dedupRows += slot->chunk.dedupStats.dedupRows;
+        slot->options->dedupStats->uniqueRows += slot->chunk.dedupStats.uniqueRows;
+    }
+
+    TRACE_BEGIN(writeSpan);
+    enum error result = GOOD_EXIT;
+    if (reorder->io)
+        result = asyncWrite(reorder->io, slot->chunk.output, slot->chunk.outputSize);
+    else if (fwrite(slot->chunk.output, 1, slot->chunk.outputSize, reorder->out) != slot->chunk.outputSize) {
+        fprintf(stderr, RED "Can't write results\n" RESET_C);
+        result = FAIL;
+    }
+    TRACE_END(writeSpan, "write chunk");
+    return result;
+}
+
+
+static enum error readChunkText(FILE *in, asyncIO_t *io, chunkSlot_t *slot, const char *leftover, size_t leftoverSize,
+                                size_t *filled, int *inputEnded) {
+    size_t size = 0;
+    while (true) {
+        const size_t needed = ((size == 0) ? leftoverSize : size) + BATCH_READ_SIZE;
+        if (slot->bufferCapacity < needed) { //line is longer than buffer
+            char *newBuffer = (char*) realloc(slot->buffer, needed);
+            if (!newBuffer) {
+                fprintf(stderr, RED "Can't allocate memory for input buffer\n" RESET_C);
+                return FAIL;
+            }
+            slot->buffer = newBuffer;
+            slot->bufferCapacity = needed;
+        }
+        if (size == 0 && leftoverSize > 0) {
+            memcpy(slot->buffer, leftover, leftoverSize);
+            size = leftoverSize;
+        }
+
+        TRACE_BEGIN(readSpan);
+        const size_t readBytes = io ? asyncRead(io, slot->buffer + size, slot->bufferCapacity - size)
+                                    : fread(slot->buffer + size, 1, slot->bufferCapacity - size, in);
+        TRACE_END(readSpan, "read");
+        const char *newLine = (const char*) memchr(slot->buffer + size, '\n', readBytes);
+        size += readBytes;
+        if (readBytes == 0) {
+            *inputEnded = 1;
+            break;
+        }
+        if (newLine) break;
+    }
+    *filled = size;
+    return GOOD_EXIT;
+}
+
+
+void chunkFree(batchChunk_t* chunk) {
+    MY_ASSERT(chunk, return);
+    batchFree(&chunk->batch);
+    batchFreeF(&chunk->batchF);
+    polyBatchFree(&chunk->cubics);
+    polyBatchFree(&chunk->quartics);
+    free(chunk->degrees);
+    dedupFree(&chunk->dedup);
+    free(chunk->output);
+    *chunk = BLANK_CHUNK;
+}
+
+
+enum error solveBatchStream(FILE* in, FILE* out, const batchOptions_t* options) {
+    MY_ASSERT(in && out, return FAIL);
+    MY_ASSERT(options, return FAIL);
+
+    //sides that aren't regular files stay on stdio
+    asyncIO_t *io = NULL;
+    const int inFd = (options->io != IO_STDIO && isAsyncFile(fileno(in))) ? fileno(in) : -1;
+    const int outFd = (options->io != IO_STDIO && isAsyncFile(fileno(out))) ? fileno(out) : -1;
+    if (!options->silent && options->io != IO_STDIO && inFd < 0)
+        fprintf(stderr, "Input isn't a regular file, it's read with stdio instead of selected I/O backend\n");
+    if (inFd >= 0 || outFd >= 0) {
+        fflush(out);
+        io = asyncIOCreate(inFd, outFd, options->io);
+        if (!io) return FAIL;
+        if (!options->silent && options->io == IO_URING && asyncIOBackend(io) != IO_URING)
+            fprintf(stderr, "io_uring isn't available, files are read and written with pread and pwrite\n");
+    }
+    asyncIO_t *reader = (inFd >= 0) ? io : NULL;
+
+    reorderBuffer_t reorder = {};
+    if (reorderInit(&reorder, out, options) != GOOD_EXIT) {
+        asyncIODestroy(io);
+        return FAIL;
+    }
+    reorder.io = (outFd >= 0) ? io : NULL;
+
+    enum error result = GOOD_EXIT;
+    size_t line = 1;
+    const char *leftover = NULL;
+    size_t leftoverSize = 0;
+    int inputEnded = 0;
+
+    while (!inputEnded && result == GOOD_EXIT) {
+        chunkSlot_t *slot = NULL;
+        if ((result = reorderNextSlot(&reorder, &slot)) != GOOD_EXIT)
+            break;
+
+        size_t filled = 0;
+        if ((result = readChunkText(in, reader, slot, leftover, leftoverSize, &filled, &inputEnded)) != GOOD_EXIT)
+            break;
+
+        //only whole lines go to chunk, the rest waits for the next one
+        size_t chunkSize = filled;
+        if (!inputEnded) {
+            while (chunkSize > 0 && slot->buffer[chunkSize - 1] != '\n') chunkSize--;
+        }
+        leftover = slot->buffer + chunkSize;
+        leftoverSize = filled - chunkSize;
+        if (chunkSize == 0) break;
+
+        slot->chunk.text = slot->buffer;
+        slot->chunk.textSize = chunkSize;
+        slot->chunk.firstLine = line;
+        line += countLines(slot->buffer, chunkSize);
+        result = reorderSubmit(&reorder, slot);
+    }
+
+    if (reader ? asyncIOFailed(reader) : ferror(in)) {
+        fprintf(stderr, RED "Error while reading input\n" RESET_C);
+        result = FAIL;
+    }
+    result = reorderFinish(&reorder, result);
+    if (asyncIODestroy(io) != GOOD_EXIT) result = FAIL;
+    return result;
+}
+
+
+enum error solveBatchBuffer(const char *text, size_t size, FILE* out, const batchOptions_t* options) {
+    MY_ASSERT(text || size == 0, return FAIL);
+    MY_ASSERT(out, return FAIL);
+    MY_ASSERT(options, return FAIL);
+
+    reorderBuffer_t reorder = {};
+    PROPAGATE_ERROR(reorderInit(&reorder, out, options));
+
+    enum error result = GOOD_EXIT;
+    size_t line = 1, offset = 0;
+    while (offset < size && result == GOOD_EXIT) {
+        chunkSlot_t *slot = NULL;
+        if ((result = reorderNextSlot(&reorder, &slot)) != GOOD_EXIT)
+            break;
+
+        //chunk is extended to the end of line, text is used without copying
+        size_t chunkEnd = (size - offset > BATCH_READ_SIZE) ? offset + BATCH_READ_SIZE : size;
+        const char *newLine = (const char*) memchr(text + chunkEnd - 1, '\n', size - chunkEnd + 1);
+        chunkEnd = newLine ? (size_t) (newLine - text) + 1 : size;
+
+        slot->chunk.text = text + offset;
+        slot->chunk.textSize = chunkEnd - offset;
+        slot->chunk.firstLine = line;
+        line += countLines(slot->chunk.text, slot->chunk.textSize);
+        offset = chunkEnd;
+        result = reorderSubmit(&reorder, slot);
+    }
+    return reorderFinish(&reorder, result);
+}
+
+
+enum error loadCoeffsFromBuffer(const char *text, size_t size, quadraticBatch_t* batch, int silent) {
+    MY_ASSERT(text || size == 0, return FAIL);
+    MY_ASSERT(batch, return FAIL);
+
+    PROPAGATE_ERROR(batchAlloc(batch, countLines(text, size)));
+
+    const char *pos = text, *end = text + size;
+    for (size_t line = 1; pos < end; line++) {
+        quadraticEquation_t equation = BLANK_QUADRATIC_EQUATION;
+        enum error scanResult = scanLineFromBuffer(&pos, end, &equation);
+        if (scanResult == BLANK) continue;
+        if (scanResult != GOOD_EXIT && !silent)
+            fprintf(stderr, "Can't read coefficients on line %zu\n", line);
+
+        batch->a[batch->size] = equation.a;
+        batch->b[batch->size] = equation.b;
+        batch->c[batch->size] = equation.c;
+        batch->size++;
+    }
+    return GOOD_EXIT;
+}
+
+
+static void solveSelected(size_t count, const double a[], const double b[], const double c[],
+                          enum solutionCode code[], double x1[], double x2[], void *call) {
+    const solverCall_t *solverCall = (const solverCall_t*) call;
+    const batchOptions_t *options = solverCall->options;
+    if (options->precise)
+        solveColumnsPrecise(count, a, b, c, code, x1, x2, solverCall->stats);
+    else if (options->cache)
+        solveColumnsCached(options->cache, count, a, b, c, code, x1, x2);
+    else if (options->classify)
+        classifyEquationColumns(count, a, b, c, code);
+    else if (options->complex)
+        solveEquationColumnsComplex(count, a, b, c, code, x1, x2);
+    else
+        solveEquationColumns(count, a, b, c, code, x1, x2);
+}
+
+
+static double selectedSolverCost(const batchOptions_t *options) {
+    if (options->precise) return PRECISE_ROW_COST;
+    if (options->cache) return CACHED_ROW_COST;
+    return KERNEL_ROW_COST;
+}
+
+
+static enum error solveColumnsSelected(size_t count, const double a[], const double b[], const double c[],
+                                       enum solutionCode code[], double x1[], double x2[],
+                                       const batchOptions_t *options, precisionStats_t *stats,
+                                       dedupBuffer_t *dedup, dedupStats_t *dedupStats) {
+    solverCall_t call = {options, stats};
+    if (!options->dedup) {
+        solveSelected(count, a, b, c, code, x1, x2, &call);
+        return GOOD_EXIT;
+    }
+    return solveColumnsDedup(count, a, b, c, code, x1, x2, solveSelected, &call, selectedSolverCost(options),
+                             dedup, dedupStats);
+}
+
+
+static void solveColumnsRange(size_t begin, size_t end, void *task) {
+    columnsTask_t *columns = (columnsTask_t*) task;
+    precisionStats_t stats = BLANK_PRECISION_STATS;
+    dedupBuffer_t dedup = BLANK_DEDUP_BUFFER;
+    dedupStats_t dedupStats = BLANK_DEDUP_STATS;
+
+    //buffer is taken by value and put back with it's memory and state of auto-off
+    if (columns->dedup) {
+        std::lock_guard<std::mutex> guard(columns->dedupLock);
+        MY_ASSERT(columns->freeDedup > 0, columns->failed = 1; return);
+        dedup = columns->dedup[--columns->freeDedup];
+    }
+
+    TRACE_BEGIN(rangeSpan);
+    if (solveColumnsSelected(end - begin, columns->a + begin, columns->b + begin, columns->c + begin,
+                             columns->code + begin, columns->x1 + begin, columns->x2 + begin,
+                             columns->options, &stats, &dedup, &dedupStats) != GOOD_EXIT)
+        columns->failed = 1;
+    TRACE_END(rangeSpan, "solve range");
+
+    if (columns->dedup) {
+        std::lock_guard<std::mutex> guard(columns->dedupLock);
+        columns->dedup[columns->freeDedup++] = dedup;
+    }
+
+    columns->slowPath += stats.slowPath;
+    columns->dedupRows += dedupStats.dedupRows;
+    columns->uniqueRows += dedupStats.uniqueRows;
+}
+
+
+enum error solveColumnsParallel(size_t count, const double a[], const double b[], const double c[],
+                                enum solutionCode code[], double x1[], double x2[], const batchOptions_t* options) {
+    MY_ASSERT(options, return FAIL);
+    if (count == 0) return GOOD_EXIT;
+    MY_ASSERT(a && b && c && code && x1 && x2, return FAIL);
+
+    columnsTask_t task = {a, b, c, code, x1, x2, options, {0}, {0}, {0}, {0}, {}, NULL, 0};
+    const int parallel = options->pool && count > COLUMNS_GRAIN;
+    if (options->dedup) {
+        const size_t buffers = parallel ? threadPoolSize(options->pool) : 1;
+        task.dedup = (dedupBuffer_t*) calloc(buffers, sizeof(dedupBuffer_t));
+        if (!task.dedup) {
+            fprintf(stderr, RED "Can't allocate memory for deduplication\n" RESET_C);
+            return FAIL;
+        }
+        for (size_t i = 0; i < buffers; i++)
+            task.dedup[i] = BLANK_DEDUP_BUFFER;
+        task.freeDedup = buffers;
+    }
+
+    enum error result = GOOD_EXIT;
+    if (!parallel)
+        solveColumnsRange(0, count, &task);
+    else
+        result = threadPoolParallelFor(options->pool, count, COLUMNS_GRAIN, solveColumnsRange, &task);
+    for (size_t i = 0; i < task.freeDedup; i++)
+        dedupFree(&task.dedup[i]);
+    free(task.dedup);
+
+    if (task.failed) result = FAIL;
+    if (options->precise && options->stats && result == GOOD_EXIT) {
+        //like in text mode, equations of precise solver are only the ones it has solved
+        options->stats->equations += count - (task.dedupRows - task.uniqueRows);
+        options->stats->slowPath += task.slowPath;
+    }
+    if (options->dedup && options->dedupStats && result == GOOD_EXIT) {
+        options->dedupStats->rows += count;
+        options->dedupStats->dedupRows += task.dedupRows;
+        options->dedupStats->uniqueRows += task.uniqueRows;
+    }
+    return result;
+}
+
+
+enum error batchPoolStart(batchOptions_t *options) {
+    MY_ASSERT(options, return FAIL);
+    MY_ASSERT(!options->pool, return FAIL);
+    if (options->threads <= 1) return GOOD_EXIT;
+
+    options->pool = threadPoolCreate(options->threads);
+    return options->pool ? GOOD_EXIT : FAIL;
+}
+
+
+void batchPoolStop(batchOptions_t *options) {
+    if (!options) return;
+    threadPoolDestroy(options->pool);
+    options->pool = NULL;
+}
+
+
+static void classifyPackedRange(size_t begin, size_t end, void *task) {
+    const packedTask_t *columns = (const packedTask_t*) task;
+    const size_t first = begin * PACKED_CODES_PER_WORD;
+    const size_t last = (end * PACKED_CODES_PER_WORD < columns->count) ? end * PACKED_CODES_PER_WORD : columns->count;
+
+    TRACE_BEGIN(rangeSpan);
+    classifyEquationsPacked(last - first, columns->a + first, columns->b + first, columns->c + first,
+                            columns->packed + begin);
+    TRACE_END(rangeSpan, "classify range");
+}
+
+
+enum error classifyPackedParallel(size_t count, const double a[], const double b[], const double c[],
+                                  uint64_t packed[], const batchOptions_t* options) {
+    MY_ASSERT(options, return FAIL);
+    if (count == 0) return GOOD_EXIT;
+    MY_ASSERT(a && b && c && packed, return FAIL);
+
+    //ranges are made of whole words, so threads never write to the same word
+    packedTask_t task = {count, a, b, c, packed};
+    const size_t words = packedCodeWords(count);
+    if (!options->pool || count <= COLUMNS_GRAIN) {
+        classifyPackedRange(0, words, &task);
+        return GOOD_EXIT;
+    }
+    return threadPoolParallelFor(options->pool, words, COLUMNS_GRAIN / PACKED_CODES_PER_WORD,
+                                 classifyPackedRange, &task);
+}
+
+
+enum error writeResultsText(FILE* out, size_t count, const enum solutionCode code[], const double x1[], const double x2[],
+                            enum numberStyle style) {
+    MY_ASSERT(out, return FAIL);
+    if (count == 0) return GOOD_EXIT;
+    MY_ASSERT(code && x1 && x2, return FAIL);
+
+    char *buffer = (char*) malloc(WRITE_BLOCK_LINES * MAX_RESULT_LINE_LEN);
+    if (!buffer) {
+        fprintf(stderr, RED "Can't allocate memory for output\n" RESET_C);
+        return FAIL;
+    }
+    enum error result = GOOD_EXIT;
+    for (size_t begin = 0; begin < count && result == GOOD_EXIT; begin += WRITE_BLOCK_LINES) {
+        const size_t end = (count - begin > WRITE_BLOCK_LINES) ? begin + WRITE_BLOCK_LINES : count;
+        char *pos = buffer;
+        for (size_t i = begin; i < end; i++)
+            pos += formatResultLine(pos, code[i], x1[i], x2[i], style);
+
+        const size_t size = (size_t) (pos - buffer);
+        if (fwrite(buffer, 1, size, out) != size) {
+            fprintf(stderr, RED "Can't write results\n" RESET_C);
+            result = FAIL;
+        }
+    }
+    free(buffer);
+    return result;
+}
+
+
+enum error writeCodesText(FILE* out, size_t count, const enum solutionCode code[], const uint64_t packed[]) {
+    MY_ASSERT(out, return FAIL);
+    if (count == 0) return GOOD_EXIT;
+    MY_ASSERT(code || packed, return FAIL);
+
+    char *buffer = (char*) malloc(WRITE_BLOCK_LINES * MAX_CODE_LINE_LEN);
+    if (!buffer) {
+        fprintf(stderr, RED "Can't allocate memory for output\n" RESET_C);
+        return FAIL;
+    }
+    enum error result = GOOD_EXIT;
+    for (size_t begin = 0; begin < count && result == GOOD_EXIT; begin += WRITE_BLOCK_LINES) {
+        const size_t end = (count - begin > WRITE_BLOCK_LINES) ? begin + WRITE_BLOCK_LINES : count;
+        char *pos = buffer;
+        for (size_t i = begin; i < end; i++)
+            pos += formatCodeLine(pos, code ? code[i] : unpackCode(packed, i));
+
+        const size_t size = (size_t) (pos - buffer);
+        if (fwrite(buffer, 1, size, out) != size) {
+            fprintf(stderr, RED "Can't write results\n" RESET_C);
+            result = FAIL;
+        }
+    }
+    free(buffer);
+    return result;
+}
+
+
+enum error writeCoeffsText(FILE* out, size_t count, const double a[], const double b[], const double c[]) {
+    MY_ASSERT(out, return FAIL);
+    if (count == 0) return GOOD_EXIT;
+    MY_ASSERT(a && b && c, return FAIL);
+
+    char *buffer = (char*) malloc(WRITE_BLOCK_LINES * MAX_COEFFS_LINE_LEN);
+    if (!buffer) {
+        fprintf(stderr, RED "Can't allocate memory for output\n" RESET_C);
+        return FAIL;
+    }
+    enum error result = GOOD_EXIT;
+    for (size_t begin = 0; begin < count && result == GOOD_EXIT; begin += WRITE_BLOCK_LINES) {
+        const size_t end = (count - begin > WRITE_BLOCK_LINES) ? begin + WRITE_BLOCK_LINES : count;
+        char *pos = buffer;
+        for (size_t i = begin; i < end; i++) {
+            pos += formatNumber(pos, a[i], SHORTEST_NUMBERS);
+            *pos++ = ' ';
+            pos += formatNumber(pos, b[i], SHORTEST_NUMBERS);
+            *pos++ = ' ';
+            pos += formatNumber(pos, c[i], SHORTEST_NUMBERS);
+            *pos++ = '\n';
+        }
+
+        const size_t size = (size_t) (pos - buffer);
+        if (fwrite(buffer, 1, size, out) != size) {
+            fprintf(stderr, RED "Can't write coefficients\n" RESET_C);
+            result = FAIL;
+        }
+    }
+    free(buffer);
+    return result;
+}
+
+
+static enum error reorderInit(reorderBuffer_t *reorder, FILE *out, const batchOptions_t *options) {
+    reorder->pool = options->pool;
+    reorder->sequence = 0;
+    reorder->out = out;
+    reorder->io = NULL;
+    if (reorder->pool)
+        reorder->windowSize = CHUNKS_PER_THREAD * threadPoolSize(reorder->pool);
+    else
+        reorder->windowSize = 2; //previous chunk holds the rest of line that is being read
+
+    reorder->slots = (chunkSlot_t*) calloc(reorder->windowSize, sizeof(chunkSlot_t));
+    if (!reorder->slots) {
+        fprintf(stderr, RED "Can't allocate memory for chunks\n" RESET_C);
+        return FAIL;
+    }
+    for (size_t i = 0; i < reorder->windowSize; i++) {
+        reorder->slots[i].chunk = BLANK_CHUNK;
+        reorder->slots[i].options = options;
+        reorder->slots[i].reorder = reorder;
+    }
+    return GOOD_EXIT;
+}
+
+
+static enum error reorderNextSlot(reorderBuffer_t *reorder, chunkSlot_t **slot) {
+    *slot = &reorder->slots[reorder->sequence % reorder->windowSize];
+    if ((*slot)->busy)
+        return emitChunk(reorder, *slot);
+    return GOOD_EXIT;
+}
+
+
+static enum error reorderSubmit(reorderBuffer_t *reorder, chunkSlot_t *slot) {
+    slot->busy = 1;
+    slot->done = 0;
+    reorder->sequence++;
+    if (reorder->pool)
+        return threadPoolSubmit(reorder->pool, processSlotTask, slot);
+
+    processSlotTask(slot);
+    return emitChunk(reorder, slot);
+}
+
+
+static enum error reorderFinish(reorderBuffer_t *reorder, enum error result) {
+    //chunks that are still in flight are written in the order they were read
+    const size_t sequence = reorder->sequence;
+    const size_t firstPending = (sequence > reorder->windowSize) ? sequence - reorder->windowSize : 0;
+    for (size_t pending = firstPending; pending < sequence; pending++) {
+        chunkSlot_t *slot = &reorder->slots[pending % reorder->windowSize];
+        if (!slot->busy) continue;
+        enum error emitResult = emitChunk(reorder, slot);
+        if (result == GOOD_EXIT) result = emitResult;
+    }
+    //pool belongs to options, tasks are waited so they don't touch slots after they are freed
+    if (reorder->pool) threadPoolWait(reorder->pool);
+    reorder->pool = NULL;
+
+    for (size_t i = 0; i < reorder->windowSize; i++) {
+        chunkFree(&reorder->slots[i].chunk);
+        free(reorder->slots[i].buffer);
+    }
+    free(reorder->slots);
+    reorder->slots = NULL;
+    fflush(reorder->out);
+    return result;
+}
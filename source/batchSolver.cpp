@@ -0,0 +1,416 @@
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "batchSolver.h"
+#include "simdKernels.h"
+#include "inputClassifier.h"
+#include "utils.h"
+
+
+/// @brief Number of rows classified at once, masks of block live on stack
+const size_t CLASSIFY_BLOCK = 1024;
+
+/// @brief Number of mask words for one block
+const size_t CLASSIFY_BLOCK_WORDS = CLASSIFY_BLOCK / MASK_WORD_ROWS;
+
+/// @brief If block has more special rows than count / SPARSE_DIVIDER, clean rows are gathered instead of
+///        solving runs between special rows in place, gather costs about as much as kernel itself
+const size_t SPARSE_DIVIDER = 16;
+
+/// @brief Maximum number of blocks that kernel solves without classification after clean block,
+///        kernel gives right answers for special rows too, classification only makes them cheaper
+const size_t CLASSIFY_MAX_BACKOFF = 16;
+
+/// @brief Number of rows classified by classifyEquationsPacked() before they are packed, whole number of words
+const size_t PACK_BLOCK = 48 * PACKED_CODES_PER_WORD;
+
+/// @brief Mask of one packed code
+const uint64_t PACKED_CODE_MASK = (1u << PACKED_CODE_BITS) - 1;
+
+
+/*!
+    @brief Solves columns by classified blocks with given kernel, body of solveEquationColumns()
+
+    @param[in] kernel Kernel for real or complex roots, special rows don't depend on it
+
+    Clean data doesn't need classification, so after clean block the next blocks go straight to kernel,
+    twice more after every next clean block, like auto-off of deduplication
+*/
+static void solveColumnsWithKernel(size_t count, const double a[], const double b[], const double c[],
+                                   enum solutionCode code[], double x1[], double x2[], batchKernel_t kernel);
+
+
+/*!
+    @brief Classifies block of rows and solves it so kernel sees only rows of one kind
+
+    @param[in] count Number of rows, not more than CLASSIFY_BLOCK
+    @param[in, out] scratch Columns for compacted rows, allocated on first block with special rows
+
+    @return 1 if block has special rows, else 0
+
+    If block is clean, kernel solves it in place <br>
+    If special rows are rare, kernel solves runs of clean rows between them in place,
+    else clean rows are gathered to scratch and solved by one kernel call <br>
+    Rows with subnormal coefficients are gathered and solved separately:
+    one subnormal lane makes the whole vector instruction slow, so they are packed together <br>
+    BAD_INPUT and INF_ROOTS rows are filled without computations
+*/
+static int solveClassifiedBlock(size_t count, const double a[], const double b[], const double c[],
+                                enum solutionCode code[], double x1[], double x2[],
+                                batchKernel_t kernel, quadraticBatch_t* scratch);
+
+
+/*!
+    @brief Copies rows marked in mask to scratch, solves them with kernel and copies answers back
+
+    @param[in] rows Mask of rows
+*/
+static void solveGathered(const uint64_t rows[], const double a[], const double b[], const double c[],
+                          enum solutionCode code[], double x1[], double x2[],
+                          batchKernel_t kernel, quadraticBatch_t* scratch);
+
+
+/// @brief Solves runs of rows that are not marked in mask in place
+static void solveBetween(const uint64_t marked[], size_t count, const double a[], const double b[], const double c[],
+                         enum solutionCode code[], double x1[], double x2[], batchKernel_t kernel);
+
+
+/// @brief Returns index of the first set bit that is not less than from, or count if there is no such bit
+static size_t nextSetBit(const uint64_t words[], size_t from, size_t count);
+
+
+/// @brief Sets code and NAN roots for rows marked in mask
+static void fillRows(const uint64_t rows[], enum solutionCode value, enum solutionCode code[], double x1[], double x2[]);
+
+
+enum error batchAlloc(quadraticBatch_t* batch, size_t capacity) {
+    MY_ASSERT(batch, return FAIL);
+
+    *batch = BLANK_BATCH;
+    const size_t doubleSize = capacity * sizeof(double);
+    batch->a    = (double*) alignedCalloc(BATCH_ALIGNMENT, doubleSize);
+    batch->b    = (double*) alignedCalloc(BATCH_ALIGNMENT, doubleSize);
+    batch->c    = (double*) alignedCalloc(BATCH_ALIGNMENT, doubleSize);
+    batch->x1   = (double*) alignedCalloc(BATCH_ALIGNMENT, doubleSize);
+    batch->x2   = (double*) alignedCalloc(BATCH_ALIGNMENT, doubleSize);
+    batch->code = (enum solutionCode*) alignedCalloc(BATCH_ALIGNMENT, capacity * sizeof(enum solutionCode));
+
+    if (!batch->a || !batch->b || !batch->c || !batch->x1 || !batch->x2 || !batch->code) {
+        fprintf(stderr, RED "Can't allocate memory for batch of %zu equations\n" RESET_C, capacity);
+        batchFree(batch);
+        return FAIL;
+    }
+    batch->capacity = capacity;
+    return GOOD_EXIT;
+}
+
+
+void batchFree(quadraticBatch_t* batch) {
+    MY_ASSERT(batch, return);
+    alignedFree(batch->a);
+    alignedFree(batch->b);
+    alignedFree(batch->c);
+    alignedFree(batch->code);
+    alignedFree(batch->x1);
+    alignedFree(batch->x2);
+    *batch = BLANK_BATCH;
+}
+
+
+enum error batchAllocF(quadraticBatchF_t* batch, size_t capacity) {
+    MY_ASSERT(batch, return FAIL);
+
+    *batch = BLANK_BATCH_F;
+    const size_t floatSize = capacity * sizeof(float);
+    batch->a    = (float*) alignedCalloc(BATCH_ALIGNMENT, floatSize);
+    batch->b    = (float*) alignedCalloc(BATCH_ALIGNMENT, floatSize);
+    batch->c    = (float*) alignedCalloc(BATCH_ALIGNMENT, floatSize);
+    batch->x1   = (float*) alignedCalloc(BATCH_ALIGNMENT, floatSize);
+    batch->x2   = (float*) alignedCalloc(BATCH_ALIGNMENT, floatSize);
+    batch->code = (enum solutionCode*) alignedCalloc(BATCH_ALIGNMENT, capacity * sizeof(enum solutionCode));
+
+    if (!batch->a || !batch->b || !batch->c || !batch->x1 || !batch->x2 || !batch->code) {
+        fprintf(stderr, RED "Can't allocate memory for batch of %zu equations\n" RESET_C, capacity);
+        batchFreeF(batch);
+        return FAIL;
+    }
+    batch->capacity = capacity;
+    return GOOD_EXIT;
+}
+
+
+void batchFreeF(quadraticBatchF_t* batch) {
+    MY_ASSERT(batch, return);
+    alignedFree(batch->a);
+    alignedFree(batch->b);
+    alignedFree(batch->c);
+    alignedFree(batch->code);
+    alignedFree(batch->x1);
+    alignedFree(batch->x2);
+    *batch = BLANK_BATCH_F;
+}
+
+
+enum error solveEquationColumns(size_t count, const double a[], const double b[], const double c[],
+                                enum solutionCode code[], double x1[], double x2[]) {
+    if (count == 0) return GOOD_EXIT;
+    MY_ASSERT(a && b && c, return FAIL);
+    MY_ASSERT(code && x1 && x2, return FAIL);
+
+    solveColumnsWithKernel(count, a, b, c, code, x1, x2, getBatchKernel());
+    return GOOD_EXIT;
+}
+
+
+enum error solveEquationColumnsComplex(size_t count, const double a[], const double b[], const double c[],
+                                       enum solutionCode code[], double x1[], double x2[]) {
+    if (count == 0) return GOOD_EXIT;
+    MY_ASSERT(a && b && c, return FAIL);
+    MY_ASSERT(code && x1 && x2, return FAIL);
+
+    solveColumnsWithKernel(count, a, b, c, code, x1, x2, getBatchKernelComplex());
+    return GOOD_EXIT;
+}
+
+
+enum error classifyEquationColumns(size_t count, const double a[], const double b[], const double c[],
+                                   enum solutionCode code[]) {
+    if (count == 0) return GOOD_EXIT;
+    MY_ASSERT(a && b && c, return FAIL);
+    MY_ASSERT(code, return FAIL);
+
+    getClassifyKernel()(count, a, b, c, code);
+    return GOOD_EXIT;
+}
+
+
+size_t packedCodeWords(size_t count) {
+    return (count + PACKED_CODES_PER_WORD - 1) / PACKED_CODES_PER_WORD;
+}
+
+
+void packCodes(size_t count, const enum solutionCode code[], uint64_t packed[]) {
+    MY_ASSERT(count == 0 || (code && packed), return);
+
+    for (size_t begin = 0; begin < count; begin += PACKED_CODES_PER_WORD) {
+        const size_t end = (count - begin > PACKED_CODES_PER_WORD) ? begin + PACKED_CODES_PER_WORD : count;
+        uint64_t word = 0;
+        for (size_t i = end; i-- > begin;)
+            word = (word << PACKED_CODE_BITS) | ((uint64_t) code[i] & PACKED_CODE_MASK);
+        packed[begin / PACKED_CODES_PER_WORD] = word;
+    }
+}
+
+
+enum solutionCode unpackCode(const uint64_t packed[], size_t index) {
+    MY_ASSERT(packed, return BLANK_ROOT);
+
+    const uint64_t word = packed[index / PACKED_CODES_PER_WORD];
+    return (enum solutionCode) ((word >> (index % PACKED_CODES_PER_WORD * PACKED_CODE_BITS)) & PACKED_CODE_MASK);
+}
+
+
+enum error classifyEquationsPacked(size_t count, const double a[], const double b[], const double c[],
+                                   uint64_t packed[]) {
+    if (count == 0) return GOOD_EXIT;
+    MY_ASSERT(a && b && c, return FAIL);
+    MY_ASSERT(packed, return FAIL);
+
+    const classifyKernel_t kernel = getClassifyKernel();
+    enum solutionCode code[PACK_BLOCK] = {};
+    for (size_t begin = 0; begin < count; begin += PACK_BLOCK) {
+        const size_t blockSize = (count - begin > PACK_BLOCK) ? PACK_BLOCK : count - begin;
+        kernel(blockSize, a + begin, b + begin, c + begin, code);
+        packCodes(blockSize, code, packed + begin / PACKED_CODES_PER_WORD);
+    }
+    return GOOD_EXIT;
+}
+
+
+static void solveColumnsWithKernel(size_t count, const double a[], const double b[], const double c[],
+                                   enum solutionCode code[], double x1[], double x2[], batchKernel_t kernel) {
+    quadraticBatch_t scratch = BLANK_BATCH;
+    size_t skipBlocks = 0, backoff = 1;
+    for (size_t begin = 0; begin < count; begin += CLASSIFY_BLOCK) {
+        const size_t blockSize = (count - begin > CLASSIFY_BLOCK) ? CLASSIFY_BLOCK : count - begin;
+        if (skipBlocks > 0) {
+            skipBlocks--;
+            kernel(blockSize, a + begin, b + begin, c + begin, code + begin, x1 + begin, x2 + begin);
+            continue;
+        }
+
+        if (solveClassifiedBlock(blockSize, a + begin, b + begin, c + begin, code + begin, x1 + begin, x2 + begin,
+                                 kernel, &scratch))
+            backoff = 1;
+        else {
+            skipBlocks = backoff;
+            backoff = (backoff * 2 > CLASSIFY_MAX_BACKOFF) ? CLASSIFY_MAX_BACKOFF : backoff * 2;
+        }
+    }
+    batchFree(&scratch);
+}
+
+
+static int solveClassifiedBlock(size_t count, const double a[], const double b[], const double c[],
+                                enum solutionCode code[], double x1[], double x2[],
+                                batchKernel_t kernel, quadraticBatch_t* scratch) {
+    uint64_t nonFinite[CLASSIFY_BLOCK_WORDS] = {}, allZero[CLASSIFY_BLOCK_WORDS] = {},
+             subnormal[CLASSIFY_BLOCK_WORDS] = {};
+    const rowMasks_t masks = {nonFinite, allZero, subnormal};
+    classifyColumns(count, a, b, c, &masks);
+
+    uint64_t anySpecial = 0;
+    for (size_t word = 0; word < CLASSIFY_BLOCK_WORDS; word++)
+        anySpecial |= nonFinite[word] | allZero[word] | subnormal[word];
+
+    //without scratch kernel still gives right answers, just slower
+    if (!anySpecial || (!scratch->capacity && batchAlloc(scratch, CLASSIFY_BLOCK) != GOOD_EXIT)) {
+        kernel(count, a, b, c, code, x1, x2);
+        return anySpecial != 0;
+    }
+
+    //masks overlap, row belongs to the first matching class: non-finite, all zero, subnormal, clean
+    uint64_t clean[CLASSIFY_BLOCK_WORDS] = {}, special[CLASSIFY_BLOCK_WORDS] = {};
+    size_t specialCount = 0;
+    const size_t words = maskWords(count);
+    for (size_t word = 0; word < words; word++) {
+        const size_t rowsInWord = (count - word * MASK_WORD_ROWS < MASK_WORD_ROWS) ? count - word * MASK_WORD_ROWS
+                                                                                   : MASK_WORD_ROWS;
+        const uint64_t present = (rowsInWord == MASK_WORD_ROWS) ? ~0ULL : (1ULL << rowsInWord) - 1;
+        allZero[word]   &= ~nonFinite[word];
+        subnormal[word] &= ~(nonFinite[word] | allZero[word]);
+        special[word] = nonFinite[word] | allZero[word] | subnormal[word];
+        clean[word] = present & ~special[word];
+        specialCount += (size_t) __builtin_popcountll(special[word]);
+    }
+
+    if (specialCount * SPARSE_DIVIDER < count)
+        solveBetween(special, count, a, b, c, code, x1, x2, kernel);
+    else
+        solveGathered(clean, a, b, c, code, x1, x2, kernel, scratch);
+    solveGathered(subnormal, a, b, c, code, x1, x2, kernel, scratch);
+    fillRows(nonFinite, BAD_INPUT, code, x1, x2);
+    fillRows(allZero, INF_ROOTS, code, x1, x2);
+    return 1;
+}
+
+
+static void solveGathered(const uint64_t rows[], const double a[], const double b[], const double c[],
+                          enum solutionCode code[], double x1[], double x2[],
+                          batchKernel_t kernel, quadraticBatch_t* scratch) {
+    size_t size = 0;
+    for (size_t word = 0; word < CLASSIFY_BLOCK_WORDS; word++) {
+        for (uint64_t bits = rows[word]; bits; bits &= bits - 1) {
+            const size_t row = word * MASK_WORD_ROWS + (size_t) __builtin_ctzll(bits);
+            scratch->a[size] = a[row];
+            scratch->b[size] = b[row];
+            scratch->c[size] = c[row];
+            size++;
+        }
+    }
+    if (size == 0) return;
+
+    kernel(size, scratch->a, scratch->b, scratch->c, scratch->code, scratch->x1, scratch->x2);
+
+    size = 0;
+    for (size_t word = 0; word < CLASSIFY_BLOCK_WORDS; word++) {
+        for (uint64_t bits = rows[word]; bits; bits &= bits - 1) {
+            const size_t row = word * MASK_WORD_ROWS + (size_t) __builtin_ctzll(bits);
+            code[row] = scratch->code[size];
+            x1[row] = scratch->x1[size];
+            x2[row] = scratch->x2[size];
+            size++;
+        }
+    }
+}
+
+
+static void solveBetween(const uint64_t marked[], size_t count, const double a[], const double b[], const double c[],
+                         enum solutionCode code[], double x1[], double x2[], batchKernel_t kernel) {
+    size_t row = 0;
+    while (row < count) {
+        const size_t next = nextSetBit(marked, row, count);
+        if (next > row)
+            kernel(next - row, a + row, b + row, c + row, code + row, x1 + row, x2 + row);
+        row = next + 1;
+    }
+}
+
+
+static size_t nextSetBit(const uint64_t words[], size_t from, size_t count) {
+    size_t word = from / MASK_WORD_ROWS;
+    uint64_t bits = words[word] & (~0ULL << (from % MASK_WORD_ROWS));
+    while (!bits) {
+        word++;
+        if (word * MASK_WORD_ROWS >= count) return count;
+        bits = words[word];
+    }
+    const size_t bit = word * MASK_WORD_ROWS + (size_t) __builtin_ctzll(bits);
+    return (bit < count) ? bit : count;
+}
+
+
+static void fillRows(const uint64_t rows[], enum solutionCode value, enum solutionCode code[], double x1[], double x2[]) {
+    for (size_t word = 0; word < CLASSIFY_BLOCK_WORDS; word++) {
+        for (uint64_t bits = rows[word]; bits; bits &= bits - 1) {
+            const size_t row = word * MASK_WORD_ROWS + (size_t) __builtin_ctzll(bits);
+            code[row] = value;
+            x1[row] = x2[row] = NAN;
+        }
+    }
+}
+
+
+enum error solveEquationBatch(quadraticBatch_t* batch) {
+    MY_ASSERT(batch, return FAIL);
+    return solveEquationColumns(batch->size, batch->a, batch->b, batch->c, batch->code, batch->x1, batch->x2);
+}
+
+
+enum error solveEquationColumnsF(size_t count, const float a[], const float b[], const float c[],
+                                 enum solutionCode code[], float x1[], float x2[]) {
+    if (count == 0) return GOOD_EXIT;
+    MY_ASSERT(a && b && c, return FAIL);
+    MY_ASSERT(code && x1 && x2, return FAIL);
+
+    getBatchKernelF()(count, a, b, c, code, x1, x2);
+    return GOOD_EXIT;
+}
+
+
+enum error batchFromEquations(quadraticBatch_t* batch, const quadraticEquation_t equations[], size_t count) {
+    MY_ASSERT(batch, return FAIL);
+    MY_ASSERT(equations || count == 0, return FAIL);
+
+    if (batch->capacity < count) {
+        fprintf(stderr, "Batch capacity %zu is less than %zu equations\n", batch->capacity, count);
+        return BAD_EXIT;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        batch->a[i] = equations[i].a;
+        batch->b[i] = equations[i].b;
+        batch->c[i] = equations[i].c;
+    }
+    batch->size = count;
+    return GOOD_EXIT;
+}
+
+
+enum error batchToEquations(const quadraticBatch_t* batch, quadraticEquation_t equations[]) {
+    MY_ASSERT(batch, return FAIL);
+    MY_ASSERT(equations || batch->size == 0, return FAIL);
+
+    for (size_t i = 0; i < batch->size; i++) {
+        equations[i].a = batch->a[i];
+        equations[i].b = batch->b[i];
+        equations[i].c = batch->c[i];
+        equations[i].answer.code = batch->code[i];
+        equations[i].answer.x1   = batch->x1[i];
+        equations[i].answer.x2   = batch->x2[i];
+    }
+    return GOOD_EXIT;
+}
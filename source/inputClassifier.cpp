@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "simdKernels.h"
+#include "inputClassifier.h"
+#include "utils.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define X86_CLASSIFIER
+#include <immintrin.h>
+#endif
+
+
+const uint64_t SIGN_BITS       = 0x8000000000000000ULL; ///< Sign bit of double
+const uint64_t EXPONENT_BITS   = 0x7FF0000000000000ULL; ///< inf, abs of NaN is greater
+const uint64_t MIN_NORMAL_BITS = 0x0010000000000000ULL; ///< DBL_MIN, abs of subnormal is less
+
+
+/// @brief Bits of EPSILON, positive doubles are ordered like their bits
+static inline uint64_t epsilonBits();
+
+
+/// @brief Returns bits of double without sign
+static inline uint64_t absBits(double num);
+
+
+/// @brief Classifies rows [begin, end) that belong to one mask word and writes this word
+static void classifyRowsPortable(size_t begin, size_t end, const double a[], const double b[], const double c[],
+                                 const rowMasks_t *masks);
+
+
+#ifdef X86_CLASSIFIER
+/// @brief Classifies whole words of rows 8 at a time, returns number of classified rows
+static size_t classifyColumnsAVX512(size_t count, const double a[], const double b[], const double c[],
+                                    const rowMasks_t *masks);
+#endif
+
+
+static inline uint64_t epsilonBits() {
+    uint64_t bits = 0;
+    memcpy(&bits, &EPSILON, sizeof(bits));
+    return bits;
+}
+
+
+static inline uint64_t absBits(double num) {
+    uint64_t bits = 0;
+    memcpy(&bits, &num, sizeof(bits));
+    return bits & ~SIGN_BITS;
+}
+
+
+size_t maskWords(size_t count) {
+    return (count + MASK_WORD_ROWS - 1) / MASK_WORD_ROWS;
+}
+
+
+void classifyColumns(size_t count, const double a[], const double b[], const double c[], const rowMasks_t *masks) {
+    MY_ASSERT(masks, return);
+    MY_ASSERT(masks->nonFinite && masks->allZero && masks->subnormal, return);
+    if (count == 0) return;
+    MY_ASSERT(a && b && c, return);
+
+    size_t done = 0;
+#ifdef X86_CLASSIFIER
+    static const int hasAVX512 = (detectKernelType() >= KERNEL_AVX512);
+    if (hasAVX512)
+        done = classifyColumnsAVX512(count, a, b, c, masks);
+#endif
+    for (size_t begin = done; begin < count; begin += MASK_WORD_ROWS) {
+        const size_t end = (count - begin > MASK_WORD_ROWS) ? begin + MASK_WORD_ROWS : count;
+        classifyRowsPortable(begin, end, a, b, c, masks);
+    }
+}
+
+
+static void classifyRowsPortable(size_t begin, size_t end, const double a[], const double b[], const double c[],
+                                 const rowMasks_t *masks) {
+    const uint64_t eps = epsilonBits();
+    uint64_t nonFinite = 0, allZero = 0, subnormal = 0;
+
+    for (size_t row = begin; row < end; row++) {
+        const uint64_t absA = absBits(a[row]), absB = absBits(b[row]), absC = absBits(c[row]);
+        const uint64_t bit = 1ULL << (row % MASK_WORD_ROWS);
+
+        //x - 1 < MIN_NORMAL - 1 is 0 < x < MIN_NORMAL, because 0 - 1 overflows to max
+        const uint64_t maxAbs = (absA > absB) ? ((absA > absC) ? absA : absC) : ((absB > absC) ? absB : absC);
+        const uint64_t lessA = absA - 1, lessB = absB - 1, lessC = absC - 1;
+        const uint64_t minAbsLess = (lessA < lessB) ? ((lessA < lessC) ? lessA : lessC) : ((lessB < lessC) ? lessB : lessC);
+
+        const int rowNonFinite = maxAbs >= EXPONENT_BITS;
+        const int rowAllZero   = maxAbs < eps;
+        const int rowSubnormal = minAbsLess < MIN_NORMAL_BITS - 1;
+
+        nonFinite |= rowNonFinite ? bit : 0;
+        allZero   |= rowAllZero   ? bit : 0;
+        subnormal |= rowSubnormal ? bit : 0;
+    }
+
+    const size_t word = begin / MASK_WORD_ROWS;
+    masks->nonFinite[word] = nonFinite;
+    masks->allZero[word]   = allZero;
+    masks->subnormal[word] = subnormal;
+}
+
+
+#ifdef X86_CLASSIFIER
+
+__attribute__((target("avx512f")))
+static size_t classifyColumnsAVX512(size_t count, const double a[], const double b[], const double c[],
+                                    const rowMasks_t *masks) {
+    const __m512i absMask   = _mm512_set1_epi64((long long) ~SIGN_BITS);
+    const __m512i exponent  = _mm512_set1_epi64((long long) EXPONENT_BITS);
+    const __m512i eps       = _mm512_set1_epi64((long long) epsilonBits());
+    const __m512i one       = _mm512_set1_epi64(1);
+    const __m512i minNormal = _mm512_set1_epi64((long long) (MIN_NORMAL_BITS - 1));
+
+    const size_t words = count / MASK_WORD_ROWS;
+    for (size_t word = 0; word < words; word++) {
+        uint64_t nonFinite = 0, allZero = 0, subnormal = 0;
+
+        for (size_t lane = 0; lane < MASK_WORD_ROWS; lane += 8) {
+            const size_t row = word * MASK_WORD_ROWS + lane;
+            const __m512i absA = _mm512_and_si512(_mm512_loadu_si512(a + row), absMask),
+                          absB = _mm512_and_si512(_mm512_loadu_si512(b + row), absMask),
+                          absC = _mm512_and_si512(_mm512_loadu_si512(c + row), absMask);
+
+            //one coefficient is enough for non-finite and subnormal rows, all three must be small for zero row
+            //masked forms with defined source, unmasked ones use undefined register that gcc reports as uninitialized
+            const __m512i zero = _mm512_setzero_si512();
+            const __m512i maxAbs = _mm512_mask_max_epu64(zero, 0xFF, absA, _mm512_mask_max_epu64(zero, 0xFF, absB, absC));
+            const __m512i minAbsLess = _mm512_mask_min_epu64(zero, 0xFF, _mm512_sub_epi64(absA, one),
+                                       _mm512_mask_min_epu64(zero, 0xFF, _mm512_sub_epi64(absB, one),
+                                                             _mm512_sub_epi64(absC, one)));
+
+            const __mmask8 groupNonFinite = _mm512_cmpge_epu64_mask(maxAbs, exponent);
+            const __mmask8 groupAllZero   = _mm512_cmplt_epu64_mask(maxAbs, eps);
+            const __mmask8 groupSubnormal = _mm512_cmplt_epu64_mask(minAbsLess, minNormal);
+
+            nonFinite |= (uint64_t) groupNonFinite << lane;
+            allZero   |= (uint64_t) groupAllZero   << lane;
+            subnormal |= (uint64_t) groupSubnormal << lane;
+        }
+        masks->nonFinite[word] = nonFinite;
+        masks->allZero[word]   = allZero;
+        masks->subnormal[word] = subnormal;
+    }
+    return words * MASK_WORD_ROWS;
+}
+
+#endif
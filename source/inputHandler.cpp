@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <string.h>
+#include <stdlib.h>
 
 //#define DEBUG_PRINTS
 
@@ -73,3 +74,95 @@ enum error scanFromCmdArgs(quadraticEquation_t* equation, char *argv[]) {
     }
     return GOOD_EXIT;
 }
+
+
+enum error scanDoubleFromBuffer(const char **pos, const char *end, double *value) {
+    MY_ASSERT(pos && *pos && end, return FAIL);
+    MY_ASSERT(value, return FAIL);
+
+    const char *cur = *pos;
+    while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\r')) cur++;
+
+    const char *tokenStart = cur;
+    while (cur < end && !isspace((unsigned char) *cur)) cur++;
+
+    //buffer can end right after the token, so strtod can't be used on it directly
+    const size_t MAX_TOKEN_LEN = 64;
+    const size_t tokenLen = (size_t) (cur - tokenStart);
+    if (tokenLen == 0 || tokenLen >= MAX_TOKEN_LEN) return BAD_EXIT;
+
+    char token[MAX_TOKEN_LEN] = {};
+    memcpy(token, tokenStart, tokenLen);
+    char *tokenEnd = NULL;
+    *value = strtod(token, &tokenEnd);
+    if (tokenEnd != token + tokenLen) return BAD_EXIT;
+
+    *pos = cur;
+    return GOOD_EXIT;
+}
+
+
+enum error scanLineFromBuffer(const char **pos, const char *end, quadraticEquation_t* equation) {
+    MY_ASSERT(equation, return FAIL);
+
+    double coeffs[3] = {NAN, NAN, NAN};
+    size_t count = 0;
+    const enum error result = scanCoeffsFromBuffer(pos, end, coeffs, 3, &count);
+    if (result != GOOD_EXIT) return result;
+    if (count != 3) return BAD_EXIT;
+
+    equation->a = coeffs[0];
+    equation->b = coeffs[1];
+    equation->c = coeffs[2];
+    return GOOD_EXIT;
+}
+
+
+enum error scanCoeffsFromBuffer(const char **pos, const char *end, double coeffs[], size_t maxCount, size_t *count) {
+    MY_ASSERT(pos && *pos && end, return FAIL);
+    MY_ASSERT(coeffs && count, return FAIL);
+
+    const char *lineEnd = (const char*) memchr(*pos, '\n', (size_t) (end - *pos));
+    if (!lineEnd) lineEnd = end;
+
+    const char *cur = *pos;
+    *pos = (lineEnd < end) ? lineEnd + 1 : end;
+    *count = 0;
+
+    while (cur < lineEnd && isspace((unsigned char) *cur)) cur++;
+    if (cur == lineEnd) return BLANK;
+
+    while (cur < lineEnd) {
+        if (*count == maxCount || scanDoubleFromBuffer(&cur, lineEnd, &coeffs[*count]) != GOOD_EXIT)
+            return BAD_EXIT;
+        (*count)++;
+        while (cur < lineEnd && isspace((unsigned char) *cur)) cur++;
+    }
+    return GOOD_EXIT;
+}
+
+
+enum error scanWordFromBuffer(const char **pos, const char *end, char word[], size_t maxLen, size_t *line) {
+    MY_ASSERT(pos && *pos && end, return FAIL);
+    MY_ASSERT(word && maxLen > 0, return FAIL);
+    MY_ASSERT(line, return FAIL);
+
+    const char *cur = *pos;
+    for (; cur < end && isspace((unsigned char) *cur); cur++) {
+        if (*cur == '\n') (*line)++;
+    }
+    if (cur == end) {
+        *pos = cur;
+        return BLANK;
+    }
+
+    const char *wordStart = cur;
+    while (cur < end && !isspace((unsigned char) *cur)) cur++;
+    *pos = cur;
+
+    const size_t wordLen = (size_t) (cur - wordStart);
+    if (wordLen >= maxLen) return BAD_EXIT;
+    memcpy(word, wordStart, wordLen);
+    word[wordLen] = '\0';
+    return GOOD_EXIT;
+}
@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "batchSolver.h"
+#include "kvbFormat.h"
+
+static_assert(sizeof(enum solutionCode) == sizeof(int32_t), "code column stores solutionCode as int32");
+
+
+/// @brief Rounds size up to multiple of KVB_ALIGNMENT
+static size_t alignUp(size_t size);
+
+
+/// @brief Returns size of one element of column
+static size_t columnElementSize(enum kvbColumn column);
+
+
+/// @brief Returns number of elements in column of file with count equations
+static size_t columnElements(enum kvbColumn column, size_t count);
+
+
+/// @brief Returns 1 if column is present in file with these flags
+static int hasColumn(uint32_t flags, enum kvbColumn column);
+
+
+/*!
+    @brief Computes offsets of all columns
+
+    @param[in] count Number of equations
+    @param[in] flags Set of kvbFlags
+    @param[out] offsets Offsets of columns, 0 for absent ones
+
+    @return Size of whole file
+*/
+static size_t kvbLayout(size_t count, uint32_t flags, uint64_t offsets[KVB_COLUMNS_COUNT]);
+
+
+static size_t alignUp(size_t size) {
+    return (size + KVB_ALIGNMENT - 1) / KVB_ALIGNMENT * KVB_ALIGNMENT;
+}
+
+
+static size_t columnElementSize(enum kvbColumn column) {
+    switch (column) {
+        case KVB_COLUMN_CODE:   return sizeof(int32_t);
+        case KVB_COLUMN_PACKED: return sizeof(uint64_t);
+        case KVB_COLUMN_A:
+        case KVB_COLUMN_B:
+        case KVB_COLUMN_C:
+        case KVB_COLUMN_X1:
+        case KVB_COLUMN_X2:
+        case KVB_COLUMNS_COUNT:
+        default:                return sizeof(double);
+    }
+}
+
+
+static size_t columnElements(enum kvbColumn column, size_t count) {
+    return (column == KVB_COLUMN_PACKED) ? packedCodeWords(count) : count;
+}
+
+
+static int hasColumn(uint32_t flags, enum kvbColumn column) {
+    if (column <= KVB_COLUMN_C)
+        return (flags & KVB_HAS_COEFFS) != 0;
+    if (column == KVB_COLUMN_PACKED)
+        return (flags & KVB_HAS_PACKED) != 0;
+    return (flags & KVB_HAS_RESULTS) != 0;
+}
+
+
+static size_t kvbLayout(size_t count, uint32_t flags, uint64_t offsets[KVB_COLUMNS_COUNT]) {
+    size_t offset = alignUp(sizeof(kvbHeader_t));
+    for (int column = 0; column < KVB_COLUMNS_COUNT; column++) {
+        offsets[column] = 0;
+        if (!hasColumn(flags, (enum kvbColumn) column)) continue;
+
+        offsets[column] = offset;
+        offset = alignUp(offset + columnElements((enum kvbColumn) column, count)
+                                  * columnElementSize((enum kvbColumn) column));
+    }
+    return offset;
+}
+
+
+size_t kvbFileSize(size_t count, uint32_t flags) {
+    uint64_t offsets[KVB_COLUMNS_COUNT] = {};
+    return kvbLayout(count, flags, offsets);
+}
+
+
+int isKvbData(const char *data, size_t size) {
+    return data && size >= sizeof(KVB_MAGIC) && memcmp(data, KVB_MAGIC, sizeof(KVB_MAGIC)) == 0;
+}
+
+
+enum error kvbParse(const char *data, size_t size, kvbView_t *view) {
+    MY_ASSERT(view, return FAIL);
+    *view = BLANK_KVB_VIEW;
+
+    if (!isKvbData(data, size) || size < sizeof(kvbHeader_t)) {
+        fprintf(stderr, RED "File is not in .kvb format\n" RESET_C);
+        return BAD_EXIT;
+    }
+    MY_ASSERT(((uintptr_t) data & (alignof(double) - 1)) == 0, return FAIL);
+
+    kvbHeader_t header = {};
+    memcpy(&header, data, sizeof(header));
+    if (header.version != KVB_VERSION || header.headerSize != sizeof(kvbHeader_t)) {
+        fprintf(stderr, RED ".kvb version %u is not supported\n" RESET_C, header.version);
+        return BAD_EXIT;
+    }
+    if (header.flags & ~(uint32_t) (KVB_HAS_COEFFS | KVB_HAS_RESULTS | KVB_HAS_PACKED)) {
+        fprintf(stderr, RED ".kvb file has unknown flags %#x\n" RESET_C, header.flags);
+        return BAD_EXIT;
+    }
+
+    //every present column must be aligned and lie inside file
+    for (int column = 0; column < KVB_COLUMNS_COUNT; column++) {
+        const uint64_t offset = header.offsets[column];
+        if (!hasColumn(header.flags, (enum kvbColumn) column)) {
+            if (offset != 0) {
+                fprintf(stderr, RED ".kvb file has column #%d that isn't marked in flags\n" RESET_C, column);
+                return BAD_EXIT;
+            }
+            continue;
+        }
+        const size_t elementSize = columnElementSize((enum kvbColumn) column);
+        //every word of packed column holds PACKED_CODES_PER_WORD equations
+        const size_t rowsPerElement = (column == KVB_COLUMN_PACKED) ? PACKED_CODES_PER_WORD : 1;
+        if (offset % KVB_ALIGNMENT != 0 || offset < sizeof(kvbHeader_t) || offset > size ||
+            header.count > (size - offset) / elementSize * rowsPerElement) {
+            fprintf(stderr, RED ".kvb file is damaged: column #%d is out of file\n" RESET_C, column);
+            return BAD_EXIT;
+        }
+    }
+
+    view->count = (size_t) header.count;
+    view->flags = header.flags;
+    if (header.flags & KVB_HAS_COEFFS) {
+        view->a = (const double*) (const void*) (data + header.offsets[KVB_COLUMN_A]);
+        view->b = (const double*) (const void*) (data + header.offsets[KVB_COLUMN_B]);
+        view->c = (const double*) (const void*) (data + header.offsets[KVB_COLUMN_C]);
+    }
+    if (header.flags & KVB_HAS_RESULTS) {
+        view->code = (const enum solutionCode*) (const void*) (data + header.offsets[KVB_COLUMN_CODE]);
+        view->x1   = (const double*) (const void*) (data + header.offsets[KVB_COLUMN_X1]);
+        view->x2   = (const double*) (const void*) (data + header.offsets[KVB_COLUMN_X2]);
+    }
+    if (header.flags & KVB_HAS_PACKED)
+        view->packed = (const uint64_t*) (const void*) (data + header.offsets[KVB_COLUMN_PACKED]);
+    return GOOD_EXIT;
+}
+
+
+enum error kvbCreate(char *data, size_t count, uint32_t flags, quadraticBatch_t *columns) {
+    MY_ASSERT(data, return FAIL);
+    MY_ASSERT(columns, return FAIL);
+    MY_ASSERT(((uintptr_t) data & (alignof(double) - 1)) == 0, return FAIL);
+
+    kvbHeader_t header = {};
+    memcpy(header.magic, KVB_MAGIC, sizeof(KVB_MAGIC));
+    header.version = KVB_VERSION;
+    header.count = count;
+    header.flags = flags;
+    header.headerSize = sizeof(kvbHeader_t);
+    kvbLayout(count, flags, header.offsets);
+    memcpy(data, &header, sizeof(header));
+
+    *columns = BLANK_BATCH;
+    columns->size = columns->capacity = count;
+    if (flags & KVB_HAS_COEFFS) {
+        columns->a = (double*) (void*) (data + header.offsets[KVB_COLUMN_A]);
+        columns->b = (double*) (void*) (data + header.offsets[KVB_COLUMN_B]);
+        columns->c = (double*) (void*) (data + header.offsets[KVB_COLUMN_C]);
+    }
+    if (flags & KVB_HAS_RESULTS) {
+        columns->code = (enum solutionCode*) (void*) (data + header.offsets[KVB_COLUMN_CODE]);
+        columns->x1   = (double*) (void*) (data + header.offsets[KVB_COLUMN_X1]);
+        columns->x2   = (double*) (void*) (data + header.offsets[KVB_COLUMN_X2]);
+    }
+    return GOOD_EXIT;
+}
+
+
+uint64_t *kvbPackedColumn(char *data, uint32_t flags) {
+    MY_ASSERT(data, return NULL);
+    if (!(flags & KVB_HAS_PACKED)) return NULL;
+
+    kvbHeader_t header = {};
+    memcpy(&header, data, sizeof(header));
+    return (uint64_t*) (void*) (data + header.offsets[KVB_COLUMN_PACKED]);
+}
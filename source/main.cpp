@@ -17,33 +17,80 @@
 #include "inputHandler.h"
 #include "argvProcessor.h"
 #include "utils.h"
+#include "batchSolver.h"
+#include "preciseSolver.h"
+#include "resultCache.h"
+#include "batchDedup.h"
+#include "asyncIO.h"
+#include "polynomialSolver.h"
+#include "batchProcessor.h"
+#include "threadPool.h"
+#include "mappedFile.h"
+#include "kvbFormat.h"
+#include "solverServer.h"
+#include "shmTransport.h"
+#include "shmWorker.h"
+#include "batchPipeline.h"
+#include "stressTester.h"
+#include "simdKernels.h"
+#include "sweepSolver.h"
+#include "planeMap.h"
+#include "tracer.h"
 #include "main.h"
 
 
 /*!
     @brief Main function
 
-    1. Reads arguments from argv to flags variable<br>
-    2. Prints welcome messages <br>
-    3. Runs unit tests based on flags
-    4. Tries to read coefficients from argv (they're first priority) and solve equation <br>
-    5. Runs loop, where <br>
-        1. Reads coefficients from console <br>
-        2. Solves equation and prints answer <br>
-        3. Asks if user want to solve it again <br>
+    1. Reads arguments from argv to flags variable, starts tracing if --trace is set <br>
+    2. Runs the rest with runProgram() <br>
+    3. Writes trace to file specified with --trace
 */
 int main(int argc, char *argv[]) {
+    TRACE_BEGIN(argsSpan);
     argVal_t flags[argsSize] = {};
     initFlags(flags);
     if (processArgs(flags, argc, argv) == BAD_EXIT) { //parsing flags from console args
         printf("Can't read cmd args\n");
         initFlags(flags);
     }
+    if (flags[TRACE].set && (!flags[TRACE].val._string || traceEnable() != GOOD_EXIT)) {
+        if (!flags[TRACE].val._string)
+            fprintf(stderr, "Name of trace file is missing\n");
+        flags[TRACE].set = 0;
+    }
+    TRACE_END(argsSpan, "processArgs");
+
+    const int exitCode = runProgram(flags);
+    if (flags[TRACE].set && traceDump(flags[TRACE].val._string) != GOOD_EXIT)
+        return 1;
+    return exitCode;
+}
 
+
+int runProgram(argVal_t flags[]) {
     initPrint(flags); //prints messages on start
     if (unitTester(flags) != GOOD_EXIT) //manages unit tests
         return 0;
 
+    if (flags[SERVE].set)
+        return (serveSocket(flags) == GOOD_EXIT) ? 0 : 1;
+
+    if (flags[SHM].set)
+        return (serveShm(flags) == GOOD_EXIT) ? 0 : 1;
+
+    if (flags[STRESS].set)
+        return (stressTest(flags) == GOOD_EXIT) ? 0 : 1;
+
+    if (flags[SWEEP].set)
+        return (sweepEquation(flags) == GOOD_EXIT) ? 0 : 1;
+
+    if (flags[PLANE].set)
+        return (planeEquation(flags) == GOOD_EXIT) ? 0 : 1;
+
+    if (flags[BATCH].set)
+        return (solveBatch(flags) == GOOD_EXIT) ? 0 : 1;
+
     quadraticEquation_t equation = BLANK_QUADRATIC_EQUATION;
     enum error scanResult = BLANK;
 
@@ -63,7 +110,8 @@ void initPrint(argVal_t flags[]) {
         return;
     }
 
-    if (!flags[SILENT].set) { //if not silent mode
+    if (!flags[SILENT].set && !flags[BATCH].set && !flags[SERVE].set && !flags[STRESS].set && !flags[SWEEP].set
+        && !flags[PLANE].set && !flags[SHM].set) { //if not silent mode; batch output must contain only results
         printf(CYAN "# Quadratic equation solver\n# orientiered 2024" RESET_C "\n");
     }
 }
@@ -87,16 +135,22 @@ enum error unitTester(argVal_t flags[]) {
 
 enum error solveCmd(argVal_t flags[], enum error* scanResult, quadraticEquation_t* equation) {
     if (flags[COEFFS].set) { //scanning from cmd args
+        TRACE_BEGIN(scanSpan);
         *scanResult = scanFromCmdArgs(equation, flags[COEFFS].val._arrayPtr);
+        TRACE_END(scanSpan, "scanFromCmdArgs");
         if (*scanResult != GOOD_EXIT) { //in this case we don't want to read again
             if (!flags[SILENT].set)
                 printf(RED_BKG "Wrong input format" RESET_C "\n");
             return BAD_EXIT;
         }
         if (!flags[SILENT].set)
-            printKvadr(equation);
-        solveEquation(equation);
-        printAnswer(equation);
+            printKvadr(equation, numberStyleFromFlags(flags));
+        TRACE_BEGIN(solveSpan);
+        solveWithFlags(flags, equation);
+        TRACE_END(solveSpan, "solve");
+        TRACE_BEGIN(printSpan);
+        printAnswerWithFlags(flags, equation);
+        TRACE_END(printSpan, "printAnswer");
     }
     return GOOD_EXIT;
 }
@@ -119,9 +173,9 @@ enum error solveLoop(argVal_t flags[], enum error* scanResult, quadraticEquation
         }
 
         if (!flags[SILENT].set)
-            printKvadr(equation);
-        solveEquation(equation);
-        printAnswer(equation);
+            printKvadr(equation, numberStyleFromFlags(flags));
+        solveWithFlags(flags, equation);
+        printAnswerWithFlags(flags, equation);
 
         flushScanfBufferHard();
         printf(CYAN_BKG "Would you like to solve another equation?" RESET_C "\n"
@@ -136,3 +190,519 @@ enum error solveLoop(argVal_t flags[], enum error* scanResult, quadraticEquation
     }
     return GOOD_EXIT;
 }
+
+
+/// @brief Number of equations from .kvb file that are solved before their results are printed as text
+const size_t KVB_TEXT_BLOCK = 1 << 18;
+
+
+enum numberStyle numberStyleFromFlags(argVal_t flags[]) {
+    return flags[PRETTY].set ? PRETTY_NUMBERS : SHORTEST_NUMBERS;
+}
+
+
+enum error solveWithFlags(argVal_t flags[], quadraticEquation_t* equation) {
+    if (flags[COMPLEX].set && flags[PRECISE].set) {
+        fprintf(stderr, "Complex roots can't be found with precise solver\n");
+        return BAD_EXIT;
+    }
+    if (flags[CLASSIFY].set && (flags[PRECISE].set || flags[COMPLEX].set)) {
+        fprintf(stderr, "Classify mode can't be used with precise solver or complex roots\n");
+        return BAD_EXIT;
+    }
+    if (flags[CLASSIFY].set)
+        return classifyEquation(equation);
+    if (flags[COMPLEX].set)
+        return solveEquationComplex(equation);
+    if (!flags[PRECISE].set)
+        return solveEquation(equation);
+
+    precisionStats_t stats = BLANK_PRECISION_STATS;
+    enum error result = solveEquationPrecise(equation, &stats);
+    if (stats.slowPath && !flags[SILENT].set)
+        printf(YELLOW "Equation is ill-conditioned, it was solved with extended precision" RESET_C "\n");
+    return result;
+}
+
+
+enum error printAnswerWithFlags(argVal_t flags[], const quadraticEquation_t* equation) {
+    if (flags[CLASSIFY].set)
+        return printRootsCount(equation);
+    return printAnswer(equation, numberStyleFromFlags(flags));
+}
+
+
+enum error batchOptionsFromFlags(argVal_t flags[], batchOptions_t *options) {
+    options->silent = flags[SILENT].set;
+    options->precise = flags[PRECISE].set;
+    options->style = numberStyleFromFlags(flags);
+    options->dedup = flags[DEDUP].set;
+    options->single = flags[SINGLE].set;
+    options->complex = flags[COMPLEX].set;
+    options->classify = flags[CLASSIFY].set;
+    if (flags[THREADS].set) {
+        if (flags[THREADS].val._int < 0) {
+            fprintf(stderr, "Number of threads can't be negative\n");
+            return BAD_EXIT;
+        }
+        options->threads = (flags[THREADS].val._int == 0) ? hardwareThreads() : (size_t) flags[THREADS].val._int;
+    }
+    if (flags[CACHE].set && flags[CACHE].val._int <= 0) {
+        fprintf(stderr, "Size of cache must be positive\n");
+        return BAD_EXIT;
+    }
+    if (flags[CACHE].set && options->precise) {
+        fprintf(stderr, "Cache can't be used with precise solver\n");
+        return BAD_EXIT;
+    }
+    if (options->single && (options->precise || flags[CACHE].set || options->dedup)) {
+        fprintf(stderr, "Single precision can't be used with precise solver, cache or dedup\n");
+        return BAD_EXIT;
+    }
+    if (options->complex && (options->precise || flags[CACHE].set || options->single)) {
+        fprintf(stderr, "Complex roots can't be found with precise solver, cache or single precision\n");
+        return BAD_EXIT;
+    }
+    if (options->classify && (options->precise || flags[CACHE].set || options->dedup || options->single ||
+                              options->complex)) {
+        fprintf(stderr, "Classify mode can't be used with precise solver, cache, dedup, single precision or complex roots\n");
+        return BAD_EXIT;
+    }
+    if (options->dedup && !options->precise && !flags[CACHE].set) {
+        fprintf(stderr, "Dedup can be used only with precise solver or cache, SIMD solver is cheaper than it\n");
+        return BAD_EXIT;
+    }
+    if (flags[IO].set) {
+        const char *backend = flags[IO].val._string;
+        if (backend && strcmp(backend, "stdio") == 0)      options->io = IO_STDIO;
+        else if (backend && strcmp(backend, "pread") == 0) options->io = IO_PREAD;
+        else if (backend && strcmp(backend, "uring") == 0) options->io = IO_URING;
+        else {
+            fprintf(stderr, "I/O backend must be stdio, pread or uring\n");
+            return BAD_EXIT;
+        }
+    }
+    return GOOD_EXIT;
+}
+
+
+void printBatchStats(const batchOptions_t *options) {
+    MY_ASSERT(options, return);
+    if (options->precise && options->stats)
+        fprintf(stderr, "Precise mode: %zu of %zu equations took slow path\n",
+                options->stats->slowPath, options->stats->equations);
+    if (options->dedup && options->dedupStats)
+        fprintf(stderr, "Dedup: %zu of %zu equations were in deduplicated blocks, %zu of them were unique\n",
+                options->dedupStats->dedupRows, options->dedupStats->rows, options->dedupStats->uniqueRows);
+    if (options->cache) {
+        const cacheStats_t cacheStats = resultCacheStats(options->cache);
+        fprintf(stderr, "Cache: %zu hits, %zu misses, %zu evictions\n",
+                cacheStats.hits, cacheStats.misses, cacheStats.evictions);
+    }
+}
+
+
+enum error solveBatch(argVal_t flags[]) {
+    precisionStats_t stats = BLANK_PRECISION_STATS;
+    dedupStats_t dedupStats = BLANK_DEDUP_STATS;
+    batchOptions_t options = DEFAULT_BATCH_OPTIONS;
+    PROPAGATE_ERROR(batchOptionsFromFlags(flags, &options));
+    options.stats = &stats;
+    options.dedupStats = &dedupStats;
+
+    const char *outputName = flags[OUTPUT].set ? flags[OUTPUT].val._string : NULL;
+    if (flags[OUTPUT].set && !outputName) {
+        fprintf(stderr, "Name of output file is missing\n");
+        return BAD_EXIT;
+    }
+    const char *kvbOutput = (outputName && isKvbFileName(outputName)) ? outputName : NULL;
+
+    if (!flags[FILENAME].set && (kvbOutput || flags[CONVERT].set)) {
+        fprintf(stderr, ".kvb output and conversion need input file (-f)\n");
+        return BAD_EXIT;
+    }
+    if (flags[PIPELINE].set && (!flags[FILENAME].set || kvbOutput || flags[CONVERT].set)) {
+        fprintf(stderr, "Pipeline needs text input file (-f) and text output\n");
+        return BAD_EXIT;
+    }
+    if (options.classify && flags[PIPELINE].set) {
+        fprintf(stderr, "Pipeline prints roots, classify mode can't be used with it\n");
+        return BAD_EXIT;
+    }
+    if (options.single && (kvbOutput || flags[CONVERT].set || flags[PIPELINE].set)) {
+        fprintf(stderr, "Single precision works only with text input and output, without pipeline\n");
+        return BAD_EXIT;
+    }
+
+    FILE *out = stdout;
+    if (outputName && !kvbOutput) {
+        out = fopen(outputName, "wb");
+        if (!out) {
+            fprintf(stderr, "Can't create file \"%s\"\n", outputName);
+            return FAIL;
+        }
+    }
+    if (flags[CACHE].set) {
+        options.cache = resultCacheCreate((size_t) flags[CACHE].val._int, 0);
+        if (!options.cache) {
+            if (out != stdout) fclose(out);
+            return FAIL;
+        }
+    }
+
+    enum error result = batchPoolStart(&options);
+    if (result == GOOD_EXIT && !flags[FILENAME].set)
+        result = solveBatchStream(stdin, out, &options);
+    else if (result == GOOD_EXIT) {
+        mappedFile_t input = BLANK_MAPPED_FILE;
+        result = mapFile(flags[FILENAME].val._string, &input);
+        if (result == GOOD_EXIT) {
+            if (isKvbData(input.data, input.size) && options.single) {
+                fprintf(stderr, "Single precision works only with text input and output, without pipeline\n");
+                result = BAD_EXIT;
+            } else if (isKvbData(input.data, input.size))
+                result = solveBatchKvb(&input, out, kvbOutput, flags[CONVERT].set, &options);
+            else if (flags[PIPELINE].set)
+                result = solveBatchPipelined(&input, out, &options);
+            else if (options.io != IO_STDIO && !kvbOutput && !flags[CONVERT].set)
+                result = solveBatchFile(flags[FILENAME].val._string, out, &options);
+            else
+                result = solveBatchText(&input, out, kvbOutput, flags[CONVERT].set, &options);
+            unmapFile(&input);
+        }
+    }
+    batchPoolStop(&options);
+
+    if (out != stdout && fclose(out) != 0) {
+        fprintf(stderr, "Can't write file \"%s\"\n", outputName);
+        result = FAIL;
+    }
+    if (!options.silent && result == GOOD_EXIT)
+        printBatchStats(&options);
+    resultCacheDestroy(options.cache);
+    return result;
+}
+
+
+int isKvbFileName(const char name[]) {
+    const size_t length = strlen(name), extLength = strlen(".kvb");
+    return length >= extLength && strcmp(name + length - extLength, ".kvb") == 0;
+}
+
+
+enum error solveBatchText(const mappedFile_t *input, FILE *out, const char *kvbOutput, int convert,
+                          const batchOptions_t *options) {
+    if (!kvbOutput) {
+        if (convert) {
+            fprintf(stderr, "Input and output are already text, nothing to convert\n");
+            return BAD_EXIT;
+        }
+        return solveBatchBuffer(input->data, input->size, out, options);
+    }
+
+    quadraticBatch_t coeffs = BLANK_BATCH;
+    PROPAGATE_ERROR(loadCoeffsFromBuffer(input->data, input->size, &coeffs, options->silent));
+    enum error result = writeKvbFile(kvbOutput, coeffs.size, coeffs.a, coeffs.b, coeffs.c, !convert, options);
+    batchFree(&coeffs);
+    return result;
+}
+
+
+enum error solveBatchPipelined(const mappedFile_t *input, FILE *out, const batchOptions_t *options) {
+    pipelineStats_t stats = BLANK_PIPELINE_STATS;
+    PROPAGATE_ERROR(solveBatchPipeline(input->data, input->size, out, options, &stats));
+    if (!options->silent && stats.wallTime > 0) {
+        fprintf(stderr, "Pipeline: %zu chunks in %.3f s, busy", stats.chunks, stats.wallTime);
+        for (size_t stage = 0; stage < PIPELINE_STAGES; stage++)
+            fprintf(stderr, " %s %.0f%%", PIPELINE_STAGE_NAMES[stage], 100 * stats.busyTime[stage] / stats.wallTime);
+        fprintf(stderr, ", bottleneck is %s\n", PIPELINE_STAGE_NAMES[pipelineBottleneck(&stats)]);
+    }
+    return GOOD_EXIT;
+}
+
+
+enum error solveBatchFile(const char name[], FILE *out, const batchOptions_t *options) {
+    FILE *in = fopen(name, "rb");
+    if (!in) {
+        fprintf(stderr, "Can't read file \"%s\"\n", name);
+        return FAIL;
+    }
+    const enum error result = solveBatchStream(in, out, options);
+    fclose(in);
+    return result;
+}
+
+
+enum error solveBatchKvb(const mappedFile_t *input, FILE *out, const char *kvbOutput, int convert,
+                         const batchOptions_t *options) {
+    kvbView_t view = BLANK_KVB_VIEW;
+    PROPAGATE_ERROR(kvbParse(input->data, input->size, &view));
+
+    if (convert) {
+        if (kvbOutput) {
+            fprintf(stderr, "Input and output are already .kvb, nothing to convert\n");
+            return BAD_EXIT;
+        }
+        if (view.flags & KVB_HAS_RESULTS)
+            return writeResultsText(out, view.count, view.code, view.x1, view.x2, options->style);
+        if (view.flags & KVB_HAS_PACKED)
+            return writeCodesText(out, view.count, NULL, view.packed);
+        return writeCoeffsText(out, view.count, view.a, view.b, view.c);
+    }
+
+    if (!(view.flags & KVB_HAS_COEFFS)) {
+        fprintf(stderr, ".kvb file doesn't have coefficients\n");
+        return BAD_EXIT;
+    }
+    if (kvbOutput)
+        return writeKvbFile(kvbOutput, view.count, view.a, view.b, view.c, 1, options);
+
+    //results are solved by blocks straight from mapped columns and printed
+    quadraticBatch_t results = BLANK_BATCH;
+    PROPAGATE_ERROR(batchAlloc(&results, (view.count < KVB_TEXT_BLOCK) ? view.count : KVB_TEXT_BLOCK));
+    enum error result = GOOD_EXIT;
+    for (size_t begin = 0; begin < view.count && result == GOOD_EXIT; begin += KVB_TEXT_BLOCK) {
+        const size_t count = (view.count - begin > KVB_TEXT_BLOCK) ? KVB_TEXT_BLOCK : view.count - begin;
+        result = solveColumnsParallel(count, view.a + begin, view.b + begin, view.c + begin,
+                                      results.code, results.x1, results.x2, options);
+        if (result == GOOD_EXIT && options->classify)
+            result = writeCodesText(out, count, results.code, NULL);
+        else if (result == GOOD_EXIT)
+            result = writeResultsText(out, count, results.code, results.x1, results.x2, options->style);
+    }
+    batchFree(&results);
+    return result;
+}
+
+
+enum error writeKvbFile(const char name[], size_t count, const double a[], const double b[], const double c[],
+                        int solve, const batchOptions_t *options) {
+    const int packed = solve && options->classify;
+    const uint32_t kvbFlags = packed ? KVB_HAS_PACKED : KVB_HAS_COEFFS | (solve ? KVB_HAS_RESULTS : 0);
+    writableFile_t file = BLANK_WRITABLE_FILE;
+    PROPAGATE_ERROR(mapFileForWriting(name, kvbFileSize(count, kvbFlags), &file));
+
+    quadraticBatch_t columns = BLANK_BATCH;
+    enum error result = kvbCreate(file.data, count, kvbFlags, &columns);
+    if (result == GOOD_EXIT && count > 0 && packed)
+        result = classifyPackedParallel(count, a, b, c, kvbPackedColumn(file.data, kvbFlags), options);
+    else if (result == GOOD_EXIT && count > 0) {
+        memcpy(columns.a, a, count * sizeof(double));
+        memcpy(columns.b, b, count * sizeof(double));
+        memcpy(columns.c, c, count * sizeof(double));
+        if (solve) //solver reads source columns, so mapped input isn't copied before solving
+            result = solveColumnsParallel(count, a, b, c, columns.code, columns.x1, columns.x2, options);
+    }
+
+    enum error unmapResult = unmapWritableFile(&file);
+    return (result == GOOD_EXIT) ? unmapResult : result;
+}
+
+
+enum error serveSocket(argVal_t flags[]) {
+    precisionStats_t stats = BLANK_PRECISION_STATS;
+    dedupStats_t dedupStats = BLANK_DEDUP_STATS;
+    batchOptions_t options = DEFAULT_BATCH_OPTIONS;
+    PROPAGATE_ERROR(batchOptionsFromFlags(flags, &options));
+    options.stats = &stats;
+    options.dedupStats = &dedupStats;
+
+    const char *path = flags[SERVE].val._string;
+    if (!path) {
+        fprintf(stderr, "Path of socket is missing\n");
+        return BAD_EXIT;
+    }
+    if (options.single) {
+        fprintf(stderr, "Protocol of server has only double columns, single precision can't be used\n");
+        return BAD_EXIT;
+    }
+    if (options.classify) {
+        fprintf(stderr, "Protocol of server sends roots, classify mode can't be used\n");
+        return BAD_EXIT;
+    }
+    if (flags[CACHE].set) {
+        options.cache = resultCacheCreate((size_t) flags[CACHE].val._int, 0);
+        if (!options.cache) return FAIL;
+    }
+
+    serverStats_t serverStats = {};
+    enum error result = batchPoolStart(&options);
+    if (result == GOOD_EXIT)
+        result = serveSolver(path, &options, &serverStats);
+    batchPoolStop(&options);
+    if (!options.silent && result == GOOD_EXIT) {
+        fprintf(stderr, "Server: %llu requests, %llu equations, latency p50 %.1f us, p99 %.1f us, max %.1f us\n",
+                (unsigned long long) serverStats.requests, (unsigned long long) serverStats.equations,
+                (double) serverStats.p50 / 1000, (double) serverStats.p99 / 1000, (double) serverStats.max / 1000);
+        printBatchStats(&options);
+    }
+    resultCacheDestroy(options.cache);
+    return result;
+}
+
+
+enum error serveShm(argVal_t flags[]) {
+    precisionStats_t stats = BLANK_PRECISION_STATS;
+    dedupStats_t dedupStats = BLANK_DEDUP_STATS;
+    batchOptions_t options = DEFAULT_BATCH_OPTIONS;
+    PROPAGATE_ERROR(batchOptionsFromFlags(flags, &options));
+    options.stats = &stats;
+    options.dedupStats = &dedupStats;
+
+    const char *name = flags[SHM].val._string;
+    if (!name) {
+        fprintf(stderr, "Name of shared memory is missing\n");
+        return BAD_EXIT;
+    }
+    if (options.single) {
+        fprintf(stderr, "Slots of shared memory have only double columns, single precision can't be used\n");
+        return BAD_EXIT;
+    }
+    if (options.classify) {
+        fprintf(stderr, "Slots of shared memory get roots, classify mode can't be used\n");
+        return BAD_EXIT;
+    }
+    if (flags[CACHE].set) {
+        options.cache = resultCacheCreate((size_t) flags[CACHE].val._int, 0);
+        if (!options.cache) return FAIL;
+    }
+
+    shmStats_t shmStats = BLANK_SHM_STATS;
+    enum error result = batchPoolStart(&options);
+    if (result == GOOD_EXIT)
+        result = serveSharedMemory(name, &options, &shmStats);
+    batchPoolStop(&options);
+    if (!options.silent && result == GOOD_EXIT) {
+        fprintf(stderr, "Shared memory: %llu slots, %llu equations, %llu failed slots\n",
+                (unsigned long long) shmStats.requests, (unsigned long long) shmStats.equations,
+                (unsigned long long) shmStats.failed);
+        printBatchStats(&options);
+    }
+    resultCacheDestroy(options.cache);
+    return result;
+}
+
+
+enum error stressTest(argVal_t flags[]) {
+    batchOptions_t options = DEFAULT_BATCH_OPTIONS;
+    PROPAGATE_ERROR(batchOptionsFromFlags(flags, &options));
+    if (!flags[THREADS].set)
+        options.threads = hardwareThreads();
+
+    if (flags[STRESS].val._int <= 0) {
+        fprintf(stderr, "Number of stress equations must be positive\n");
+        return BAD_EXIT;
+    }
+    const uint64_t seed = flags[SEED].set ? (uint64_t) (unsigned) flags[SEED].val._int : STRESS_DEFAULT_SEED;
+    if (flags[CACHE].set) {
+        options.cache = resultCacheCreate((size_t) flags[CACHE].val._int, 0);
+        if (!options.cache) return FAIL;
+    }
+
+    stressStats_t stats = BLANK_STRESS_STATS;
+    enum error result = batchPoolStart(&options);
+    if (result == GOOD_EXIT)
+        result = runStressTest((size_t) flags[STRESS].val._int, seed, &options, &stats);
+    batchPoolStop(&options);
+    resultCacheDestroy(options.cache);
+    if (stats.equations == 0) return result;
+
+    printf("Stress: %zu equations, seed %llu, %zu threads\n", stats.equations, (unsigned long long) seed, options.threads);
+    printf("Solved in %.3f s, %.1f M equations/s (%.3f s with generation and checks)\n",
+           stats.solveTime, (stats.solveTime > 0) ? (double) stats.equations / stats.solveTime / 1e6 : 0.0, stats.wallTime);
+    for (size_t family = 0; family < STRESS_FAMILIES; family++)
+        printf("    %-12s %10zu equations, %zu failed\n", STRESS_FAMILY_NAMES[family],
+               stats.familyEquations[family], stats.familyFailed[family]);
+    if (stats.failed)
+        printf(RED "%zu of %zu failed" RESET_C "\n", stats.failed, stats.equations);
+    else
+        printf("All %zu answers are right\n", stats.equations);
+    return result;
+}
+
+
+enum error sweepEquation(argVal_t flags[]) {
+    batchOptions_t options = DEFAULT_BATCH_OPTIONS;
+    PROPAGATE_ERROR(batchOptionsFromFlags(flags, &options));
+    if (options.precise || flags[CACHE].set || options.dedup || options.single) {
+        fprintf(stderr, "Sweep has its own kernels, it can't be used with precise solver, cache, dedup or single precision\n");
+        return BAD_EXIT;
+    }
+
+    enum sweepCoefficient coefficient = SWEEP_C;
+    double start = 0, stop = 0, step = 0;
+    if (parseSweep(flags[SWEEP].val._string, &coefficient, &start, &stop, &step) != GOOD_EXIT) {
+        fprintf(stderr, "Sweep must be \"c:start:stop:step\", varying coefficient is a, b or c\n");
+        return BAD_EXIT;
+    }
+    quadraticEquation_t equation = BLANK_QUADRATIC_EQUATION;
+    if (!flags[COEFFS].set || scanFromCmdArgs(&equation, flags[COEFFS].val._arrayPtr) != GOOD_EXIT) {
+        fprintf(stderr, "Sweep needs base equation: -c a b c, varying coefficient can be any number\n");
+        return BAD_EXIT;
+    }
+    sweep_t sweep = BLANK_SWEEP;
+    if (sweepInit(&sweep, &equation, coefficient, start, stop, step, options.complex) != GOOD_EXIT)
+        return BAD_EXIT;
+
+    const char *outputName = flags[OUTPUT].set ? flags[OUTPUT].val._string : NULL;
+    if (flags[OUTPUT].set && (!outputName || isKvbFileName(outputName))) {
+        fprintf(stderr, "Sweep writes text, name of output file is missing or ends with .kvb\n");
+        return BAD_EXIT;
+    }
+    FILE *out = stdout;
+    if (outputName) {
+        out = fopen(outputName, "wb");
+        if (!out) {
+            fprintf(stderr, "Can't create file \"%s\"\n", outputName);
+            return FAIL;
+        }
+    }
+
+    enum error result = writeSweepText(out, &sweep, options.style, options.classify);
+    if (out != stdout && fclose(out) != 0) {
+        fprintf(stderr, "Can't write file \"%s\"\n", outputName);
+        result = FAIL;
+    }
+    return result;
+}
+
+
+enum error planeEquation(argVal_t flags[]) {
+    batchOptions_t options = DEFAULT_BATCH_OPTIONS;
+    PROPAGATE_ERROR(batchOptionsFromFlags(flags, &options));
+    if (!flags[THREADS].set)
+        options.threads = hardwareThreads();
+    if (options.precise || flags[CACHE].set || options.dedup || options.single) {
+        fprintf(stderr, "Plane has its own kernels, it can't be used with precise solver, cache, dedup or single precision\n");
+        return BAD_EXIT;
+    }
+
+    quadraticEquation_t equation = BLANK_QUADRATIC_EQUATION;
+    if (!flags[COEFFS].set || scanFromCmdArgs(&equation, flags[COEFFS].val._arrayPtr) != GOOD_EXIT) {
+        fprintf(stderr, "Plane needs base equation: -c a b c, varying coefficients can be any numbers\n");
+        return BAD_EXIT;
+    }
+    plane_t plane = BLANK_PLANE;
+    if (planeInit(&plane, &equation, flags[PLANE].val._string, options.complex) != GOOD_EXIT)
+        return BAD_EXIT;
+
+    const char *outputName = flags[OUTPUT].set ? flags[OUTPUT].val._string : NULL;
+    if (!outputName || isKvbFileName(outputName)) {
+        fprintf(stderr, "Plane is written only to file: -o map.pgm, map.ppm or other name for raw bytes\n");
+        return BAD_EXIT;
+    }
+
+    planeStats_t stats = BLANK_PLANE_STATS;
+    const size_t width = plane.columns.count, height = plane.rows.count;
+    const enum error result = writePlaneMap(outputName, &plane, planeFormatFromName(outputName), options.threads, &stats);
+    if (result != GOOD_EXIT) return result;
+
+    printf("Plane: %zu x %zu points, %zu threads\n", width, height, stats.threads);
+    printf("Written in %.3f s, %.1f M points/s\n", stats.wallTime,
+           (stats.wallTime > 0) ? (double) (width * height) / stats.wallTime / 1e6 : 0.0);
+    for (size_t code = 0; code < PLANE_CODES; code++) {
+        if (stats.codes[code])
+            printf("    %d %-10s %12zu points\n", (int) code, PLANE_CODE_NAMES[code], stats.codes[code]);
+    }
+    return result;
+}
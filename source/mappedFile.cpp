@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "error.h"
+#include "mappedFile.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+/*!
+    @brief Reads whole file to allocated buffer, used when mmap isn't available
+
+    @param[in] name Name of file
+    @param[out] file Pointer to struct that will hold buffer
+
+    @return Enum with error code
+*/
+static enum error readWholeFile(const char name[], mappedFile_t *file);
+
+
+static enum error readWholeFile(const char name[], mappedFile_t *file) {
+    FILE *input = fopen(name, "rb");
+    if (!input) {
+        fprintf(stderr, "Can't read file \"%s\"\n", name);
+        return FAIL;
+    }
+
+    size_t capacity = 1 << 20, size = 0;
+    char *data = (char*) malloc(capacity);
+    while (data) {
+        size += fread(data + size, 1, capacity - size, input);
+        if (size < capacity) break;
+
+        char *newData = (char*) realloc(data, capacity * 2);
+        if (!newData) {
+            free(data);
+            data = NULL;
+            break;
+        }
+        data = newData;
+        capacity *= 2;
+    }
+
+    const int readFailed = ferror(input);
+    fclose(input);
+    if (!data || readFailed) {
+        fprintf(stderr, RED "Can't read file \"%s\" to memory\n" RESET_C, name);
+        free(data);
+        return FAIL;
+    }
+
+    file->data = data;
+    file->size = size;
+    file->isMapped = 0;
+    return GOOD_EXIT;
+}
+
+
+enum error mapFile(const char name[], mappedFile_t *file) {
+    MY_ASSERT(name, return FAIL);
+    MY_ASSERT(file, return FAIL);
+    *file = BLANK_MAPPED_FILE;
+
+#ifdef _WIN32
+    return readWholeFile(name, file);
+#else
+    const int fd = open(name, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Can't read file \"%s\"\n", name);
+        return FAIL;
+    }
+
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) != 0) {
+        fprintf(stderr, "Can't get size of file \"%s\"\n", name);
+        close(fd);
+        return FAIL;
+    }
+    if (!S_ISREG(fileStat.st_mode)) { //pipes and devices can't be mapped
+        close(fd);
+        return readWholeFile(name, file);
+    }
+    if (fileStat.st_size == 0) {
+        close(fd);
+        return GOOD_EXIT;
+    }
+
+    const size_t size = (size_t) fileStat.st_size;
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); //mapping holds it's own reference to file
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Can't map file \"%s\", reading it to memory\n", name);
+        return readWholeFile(name, file);
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    file->data = (const char*) data;
+    file->size = size;
+    file->isMapped = 1;
+    return GOOD_EXIT;
+#endif
+}
+
+
+void unmapFile(mappedFile_t *file) {
+    MY_ASSERT(file, return);
+#ifndef _WIN32
+    if (file->isMapped)
+        munmap(const_cast<char*>(file->data), file->size);
+    else
+#endif
+        free(const_cast<char*>(file->data));
+    *file = BLANK_MAPPED_FILE;
+}
+
+
+enum error mapFileForWriting(const char name[], size_t size, writableFile_t *file) {
+    MY_ASSERT(name, return FAIL);
+    MY_ASSERT(file, return FAIL);
+    *file = BLANK_WRITABLE_FILE;
+
+#ifndef _WIN32
+    const int fd = open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Can't create file \"%s\"\n", name);
+        return FAIL;
+    }
+    if (ftruncate(fd, (off_t) size) != 0) {
+        fprintf(stderr, "Can't resize file \"%s\"\n", name);
+        close(fd);
+        return FAIL;
+    }
+    if (size > 0) {
+        void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) {
+            close(fd);
+            file->data = (char*) data;
+            file->size = size;
+            file->isMapped = 1;
+            return GOOD_EXIT;
+        }
+    }
+    close(fd);
+#endif
+
+    //fallback: buffer in memory that is written in unmapWritableFile()
+    file->stream = fopen(name, "wb");
+    if (!file->stream) {
+        fprintf(stderr, "Can't create file \"%s\"\n", name);
+        return FAIL;
+    }
+    file->data = (char*) calloc(size ? size : 1, 1);
+    if (!file->data) {
+        fprintf(stderr, RED "Can't allocate memory for file \"%s\"\n" RESET_C, name);
+        fclose(file->stream);
+        *file = BLANK_WRITABLE_FILE;
+        return FAIL;
+    }
+    file->size = size;
+    return GOOD_EXIT;
+}
+
+
+enum error unmapWritableFile(writableFile_t *file) {
+    MY_ASSERT(file, return FAIL);
+
+    enum error result = GOOD_EXIT;
+#ifndef _WIN32
+    if (file->isMapped) {
+        if (munmap(file->data, file->size) != 0)
+            result = FAIL;
+        *file = BLANK_WRITABLE_FILE;
+        return result;
+    }
+#endif
+    if (file->stream) {
+        if (fwrite(file->data, 1, file->size, file->stream) != file->size)
+            result = FAIL;
+        if (fclose(file->stream) != 0)
+            result = FAIL;
+    }
+    free(file->data);
+    if (result != GOOD_EXIT)
+        fprintf(stderr, RED "Can't write file\n" RESET_C);
+    *file = BLANK_WRITABLE_FILE;
+    return result;
+}
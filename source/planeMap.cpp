@@ -0,0 +1,315 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <atomic>
+#include <chrono>
+#ifdef _WIN32
+#include <mutex>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "colors.h"
+#include "quadraticPrinter.h"
+#include "batchSolver.h"
+#include "simdKernels.h"
+#include "threadPool.h"
+#include "sweepSolver.h"
+#include "planeMap.h"
+#include "tracer.h"
+
+
+/// @brief Maximum length of description of one axis "c:start:stop:step"
+const size_t MAX_PLANE_AXIS_LEN = 256;
+
+/// @brief Maximum length of PGM or PPM header
+const size_t MAX_PLANE_HEADER_LEN = 64;
+
+/// @brief Gray levels of exit codes in PGM: the more real roots, the lighter
+const unsigned char PLANE_GRAY[PLANE_CODES] = {0, 128, 255, 64, 32, 192, 224, 96};
+
+/// @brief Colors of exit codes in PPM
+const unsigned char PLANE_COLORS[PLANE_CODES][3] = {
+    { 24,  24,  24},    // ZERO_ROOTS
+    {255, 255, 255},    // ONE_ROOT
+    { 40, 120, 220},    // TWO_ROOTS
+    {200,   0, 200},    // INF_ROOTS
+    {220,  30,  30},    // BAD_INPUT
+    { 40, 180,  80},    // THREE_ROOTS
+    {240, 200,  40},    // FOUR_ROOTS
+    {240, 130,  20}     // COMPLEX_ROOTS
+};
+
+
+/// @brief Plane and opened map file, argument of classifyTiles()
+typedef struct planeTask {
+    const plane_t *plane;
+    enum planeFormat format;
+    enum kernelType type;               ///< Type of kernels, the best for current CPU
+    size_t headerSize;                  ///< Offset of the first pixel in file
+    size_t tileColumns;                 ///< Number of tiles in one row of tiles
+#ifdef _WIN32
+    FILE *file;                         ///< Map file, rows of tiles are written with fseek and fwrite
+    std::mutex lock;                    ///< Protects position of file
+#else
+    int fd;                             ///< Map file, rows of tiles are written with pwrite
+#endif
+    std::atomic<size_t> codes[PLANE_CODES]; ///< Sums of counters of all ranges
+    std::atomic<int> failed;            ///< Some range couldn't allocate memory, classify or write
+} planeTask_t;
+
+
+/// @brief Returns number of bytes of one point in file of format
+static size_t planeChannels(enum planeFormat format);
+
+
+/*!
+    @brief Writes header of map file
+
+    @param[out] header Buffer of MAX_PLANE_HEADER_LEN bytes
+    @param[in] plane Plane
+    @param[in] format Format of file
+
+    @return Length of header, 0 for PLANE_RAW
+*/
+static size_t planeHeader(char header[], const plane_t *plane, enum planeFormat format);
+
+
+/*!
+    @brief Writes bytes to map file at offset, can be called from several threads
+
+    @return GOOD_EXIT or FAIL if bytes can't be written
+*/
+static enum error writePlaneBytes(planeTask_t *task, size_t offset, const unsigned char data[], size_t size);
+
+
+/// @brief Classifies tiles [begin, end) of planeTask_t and writes their pixels, used by threadPoolParallelFor()
+static void classifyTiles(size_t begin, size_t end, void *task);
+
+
+enum error planeInit(plane_t *plane, const quadraticEquation_t *equation, const char description[], int complex) {
+    MY_ASSERT(plane, return FAIL);
+    MY_ASSERT(equation, return FAIL);
+    *plane = BLANK_PLANE;
+
+    const char *comma = description ? strchr(description, ',') : NULL;
+    if (!comma || (size_t) (comma - description) >= MAX_PLANE_AXIS_LEN) {
+        fprintf(stderr, "Plane must be \"b:start:stop:step,c:start:stop:step\", coefficients are a, b or c\n");
+        return BAD_EXIT;
+    }
+    char columnText[MAX_PLANE_AXIS_LEN] = "";
+    memcpy(columnText, description, (size_t) (comma - description));
+
+    enum sweepCoefficient columnCoefficient = SWEEP_B, rowCoefficient = SWEEP_C;
+    double columnRange[3] = {}, rowRange[3] = {};
+    if (parseSweep(columnText, &columnCoefficient, &columnRange[0], &columnRange[1], &columnRange[2]) != GOOD_EXIT
+        || parseSweep(comma + 1, &rowCoefficient, &rowRange[0], &rowRange[1], &rowRange[2]) != GOOD_EXIT) {
+        fprintf(stderr, "Plane must be \"b:start:stop:step,c:start:stop:step\", coefficients are a, b or c\n");
+        return BAD_EXIT;
+    }
+    if (columnCoefficient == rowCoefficient) {
+        fprintf(stderr, "Columns and rows of plane must be different coefficients\n");
+        return BAD_EXIT;
+    }
+
+    if (sweepInit(&plane->columns, equation, columnCoefficient, columnRange[0], columnRange[1], columnRange[2], complex)
+        != GOOD_EXIT || sweepInit(&plane->rows, equation, rowCoefficient, rowRange[0], rowRange[1], rowRange[2], complex)
+        != GOOD_EXIT)
+        return BAD_EXIT;
+    if ((double) plane->columns.count * (double) plane->rows.count > (double) PLANE_MAX_POINTS) {
+        fprintf(stderr, "Plane can't have more than 2^40 points\n");
+        return BAD_EXIT;
+    }
+    return GOOD_EXIT;
+}
+
+
+enum planeFormat planeFormatFromName(const char name[]) {
+    MY_ASSERT(name, return PLANE_RAW);
+    const size_t length = strlen(name), extLength = strlen(".pgm");
+    if (length < extLength) return PLANE_RAW;
+    if (strcmp(name + length - extLength, ".pgm") == 0) return PLANE_PGM;
+    if (strcmp(name + length - extLength, ".ppm") == 0) return PLANE_PPM;
+    return PLANE_RAW;
+}
+
+
+enum error classifyPlaneRowByType(const plane_t *plane, enum kernelType type, size_t row, size_t column, size_t count,
+                                  quadraticBatch_t *scratch) {
+    MY_ASSERT(plane, return FAIL);
+    MY_ASSERT(scratch && scratch->capacity >= count, return FAIL);
+    MY_ASSERT(row < plane->rows.count, return FAIL);
+
+    //row value replaces row coefficient in base, invariants of the row are computed once for all its points
+    sweep_t line = plane->columns;
+    const double value = sweepValue(&plane->rows, row);
+    const enum sweepCoefficient rowCoefficient = plane->rows.coefficient;
+    sweepRebase(&line, (rowCoefficient == SWEEP_A) ? value : line.a, (rowCoefficient == SWEEP_B) ? value : line.b,
+                       (rowCoefficient == SWEEP_C) ? value : line.c);
+    return solveSweepByType(&line, type, column, count, scratch->a, scratch->code, scratch->x1, scratch->x2);
+}
+
+
+static size_t planeChannels(enum planeFormat format) {
+    return (format == PLANE_PPM) ? 3 : 1;
+}
+
+
+static size_t planeHeader(char header[], const plane_t *plane, enum planeFormat format) {
+    switch (format) {
+        case PLANE_PGM:
+            return (size_t) snprintf(header, MAX_PLANE_HEADER_LEN, "P5\n%zu %zu\n255\n", plane->columns.count, plane->rows.count);
+        case PLANE_PPM:
+            return (size_t) snprintf(header, MAX_PLANE_HEADER_LEN, "P6\n%zu %zu\n255\n", plane->columns.count, plane->rows.count);
+        case PLANE_RAW:
+        default:
+            header[0] = '\0';
+            return 0;
+    }
+}
+
+
+static enum error writePlaneBytes(planeTask_t *task, size_t offset, const unsigned char data[], size_t size) {
+#ifdef _WIN32
+    std::lock_guard<std::mutex> guard(task->lock);
+    if (_fseeki64(task->file, (long long) offset, SEEK_SET) != 0 || fwrite(data, 1, size, task->file) != size)
+        return FAIL;
+    return GOOD_EXIT;
+#else
+    while (size > 0) {
+        const ssize_t written = pwrite(task->fd, data, size, (off_t) offset);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return FAIL;
+        data += written;
+        offset += (size_t) written;
+        size -= (size_t) written;
+    }
+    return GOOD_EXIT;
+#endif
+}
+
+
+static void classifyTiles(size_t begin, size_t end, void *task) {
+    planeTask_t *tiles = (planeTask_t*) task;
+    const plane_t *plane = tiles->plane;
+    const size_t width = plane->columns.count, height = plane->rows.count, channels = planeChannels(tiles->format);
+
+    //pixels of one tile are kept until its rows are written, so memory doesn't depend on size of plane
+    quadraticBatch_t scratch = BLANK_BATCH;
+    unsigned char *pixels = (unsigned char*) malloc(PLANE_TILE_ROWS * PLANE_TILE_COLUMNS * channels);
+    if (!pixels || batchAlloc(&scratch, PLANE_TILE_COLUMNS) != GOOD_EXIT) {
+        free(pixels);
+        tiles->failed = 1;
+        return;
+    }
+
+    size_t codes[PLANE_CODES] = {};
+    for (size_t tile = begin; tile < end && !tiles->failed; tile++) {
+        const size_t firstRow = (tile / tiles->tileColumns) * PLANE_TILE_ROWS;
+        const size_t firstColumn = (tile % tiles->tileColumns) * PLANE_TILE_COLUMNS;
+        const size_t rows = (height - firstRow > PLANE_TILE_ROWS) ? PLANE_TILE_ROWS : height - firstRow;
+        const size_t columns = (width - firstColumn > PLANE_TILE_COLUMNS) ? PLANE_TILE_COLUMNS : width - firstColumn;
+        const size_t rowSize = columns * channels;
+
+        TRACE_BEGIN(tileSpan);
+        for (size_t row = 0; row < rows; row++) {
+            if (classifyPlaneRowByType(plane, tiles->type, firstRow + row, firstColumn, columns, &scratch) != GOOD_EXIT) {
+                tiles->failed = 1;
+                break;
+            }
+            unsigned char *pixel = pixels + row * rowSize;
+            for (size_t i = 0; i < columns; i++) {
+                const enum solutionCode code = scratch.code[i];
+                codes[code]++;
+                switch (tiles->format) {
+                    case PLANE_PGM:
+                        pixel[i] = PLANE_GRAY[code];
+                        break;
+                    case PLANE_PPM:
+                        memcpy(pixel + 3 * i, PLANE_COLORS[code], 3);
+                        break;
+                    case PLANE_RAW:
+                    default:
+                        pixel[i] = (unsigned char) code;
+                        break;
+                }
+            }
+        }
+        TRACE_END(tileSpan, "classify tile");
+
+        TRACE_BEGIN(writeSpan);
+        for (size_t row = 0; row < rows && !tiles->failed; row++) {
+            const size_t offset = tiles->headerSize + ((firstRow + row) * width + firstColumn) * channels;
+            if (writePlaneBytes(tiles, offset, pixels + row * rowSize, rowSize) != GOOD_EXIT)
+                tiles->failed = 1;
+        }
+        TRACE_END(writeSpan, "write tile");
+    }
+    free(pixels);
+    batchFree(&scratch);
+
+    for (size_t code = 0; code < PLANE_CODES; code++)
+        tiles->codes[code] += codes[code];
+}
+
+
+enum error writePlaneMap(const char name[], const plane_t *plane, enum planeFormat format, size_t threads,
+                         planeStats_t *stats) {
+    MY_ASSERT(name, return FAIL);
+    MY_ASSERT(plane, return FAIL);
+    MY_ASSERT(stats, return FAIL);
+    *stats = BLANK_PLANE_STATS;
+
+    const auto start = std::chrono::steady_clock::now();
+    char header[MAX_PLANE_HEADER_LEN] = "";
+    const size_t headerSize = planeHeader(header, plane, format);
+    const size_t width = plane->columns.count, height = plane->rows.count;
+
+    planeTask_t task = {};
+    task.plane = plane;
+    task.format = format;
+    task.type = detectKernelType();
+    task.headerSize = headerSize;
+    task.tileColumns = (width + PLANE_TILE_COLUMNS - 1) / PLANE_TILE_COLUMNS;
+#ifdef _WIN32
+    task.file = fopen(name, "wb");
+    if (!task.file) {
+#else
+    task.fd = open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (task.fd < 0) {
+#endif
+        fprintf(stderr, "Can't create file \"%s\"\n", name);
+        return FAIL;
+    }
+    enum error result = writePlaneBytes(&task, 0, (const unsigned char*) header, headerSize);
+
+    //tiles never share bytes of file, so threads don't need locks
+    const size_t tiles = task.tileColumns * ((height + PLANE_TILE_ROWS - 1) / PLANE_TILE_ROWS);
+    threadPool_t *pool = (threads > 1 && tiles > 1) ? threadPoolCreate(threads) : NULL;
+    if (threads > 1 && tiles > 1 && !pool) result = FAIL;
+    if (result == GOOD_EXIT) {
+        stats->threads = pool ? threadPoolSize(pool) : 1;
+        result = threadPoolParallelFor(pool, tiles, 1, classifyTiles, &task);
+    }
+    threadPoolDestroy(pool);
+    if (task.failed) result = FAIL;
+
+#ifdef _WIN32
+    if (fclose(task.file) != 0) result = FAIL;
+#else
+    if (close(task.fd) != 0) result = FAIL;
+#endif
+    if (result != GOOD_EXIT)
+        fprintf(stderr, "Can't write file \"%s\"\n", name);
+
+    for (size_t code = 0; code < PLANE_CODES; code++)
+        stats->codes[code] = task.codes[code];
+    stats->wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,708 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <cstdint>
+#include <math.h>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "colors.h"
+#include "quadraticSolver.h"
+#include "batchSolver.h"
+#include "polynomialSolver.h"
+#include "utils.h"
+
+
+/// @brief Code of solution with count different roots
+const enum solutionCode ROOTS_CODES[MAX_DEGREE + 1] = {ZERO_ROOTS, ONE_ROOT, TWO_ROOTS, THREE_ROOTS, FOUR_ROOTS};
+
+/// @brief Maximum number of candidate roots of quartic: 4 closed-form roots, 7 candidates of cubic left after division
+///        by the biggest root and 2 roots of quadratic left after division by the bigger quadratic factor
+const int MAX_CANDIDATES = 13;
+
+
+/*!
+    @brief Solves k[0]x^2 + k[1]x + k[2] = 0 with solveEquation(), roots are sorted but not polished
+
+    Used for degree 2 and as sub-step of cubic and quartic solvers
+*/
+static void solveQuadraticRoots(const double k[3], polySolution_t *answer);
+
+
+/// @brief Solves k[0]x^3 + k[1]x^2 + k[2]x + k[3] = 0, coefficients are finite
+static void solveCubicRoots(const double k[4], polySolution_t *answer);
+
+
+/// @brief Solves k[0]x^4 + k[1]x^3 + k[2]x^2 + k[3]x + k[4] = 0, coefficients are finite
+static void solveQuarticRoots(const double k[5], polySolution_t *answer);
+
+
+/*!
+    @brief Writes candidate roots of cubic with k[0] that isn't zero, they aren't polished
+
+    @return Number of candidates, not more than 7
+
+    Closed-form roots are found for scaled polynomial, so big shift B/3 doesn't overflow,
+    then the biggest one is polished and divided out and quadratic that is left gives small roots
+    without cancellation against the shift
+*/
+static int cubicCandidates(const double k[4], double roots[]);
+
+
+/*!
+    @brief Same as cubicCandidates() for quartic: Ferrari's roots and candidates of cubic left after the biggest one
+
+    Big complex roots make division by real root unstable, so Ferrari's quadratic factor with bigger roots
+    is divided out too and the quadratic left gives small roots
+*/
+static int quarticCandidates(const double k[5], double roots[]);
+
+
+/*!
+    @brief Returns exponent S that makes roots of polynomial divided by 2^S about 1 in modulus
+
+    S is the smallest one with |k[i] / k[0]| < 2^(iS) for every i, zero coefficients are skipped
+*/
+static int scaleExponent(const double k[], int degree);
+
+
+/// @brief Writes monic polynomial whose roots are roots of k divided by 2^exponent, powers of 2 keep it exact
+static void scalePolynomial(const double k[], int degree, int exponent, double scaled[]);
+
+
+/// @brief Same as ilogb() for finite x that isn't zero, normal numbers are read from bits without call to libm
+static int binaryExponent(double x);
+
+
+/*!
+    @brief Same as ldexp(x, exponent), 2^exponent that is normal number is made from bits
+
+    Product with power of 2 is rounded only if it's subnormal, like result of ldexp()
+*/
+static double timesPowerOf2(double x, int exponent);
+
+
+/*!
+    @brief Divides polynomial by x - root starting from the free term, quotient has degree - 1
+
+    Division from the free term is stable when root has the biggest modulus,
+    leading coefficient of quotient is k[0]
+*/
+static void deflateRoot(const double k[], int degree, double root, double quotient[]);
+
+
+/// @brief Same as deflateRoot() for quartic and factor x^2 + 2bx + c, quotient is quadratic
+static void deflateFactor(const double k[5], double b, double c, double quotient[3]);
+
+
+/// @brief Adds real roots of k[0]x^2 + k[1]x + k[2] = 0 to candidates, polynomial is scaled before addMonicRoots()
+static void addQuadraticRoots(const double k[3], double roots[], int *count);
+
+
+/*!
+    @brief Polishes candidate with the biggest modulus by Newton steps and returns it's index
+
+    @return Index of the biggest candidate or -1 if count is zero
+*/
+static int polishBiggest(const double k[], int degree, double roots[], int count);
+
+
+/*!
+    @brief Applies Newton steps to root while they make residual smaller and are shorter than limit
+
+    @param[out] residual relativeResidual() of returned root
+*/
+static double polishRoot(const double k[], int degree, double root, double limit, double *residual);
+
+
+/// @brief Returns half of distance from roots[index] to the nearest candidate that isn't merged with it
+static double stepLimit(const double roots[], int count, int index);
+
+
+/*!
+    @brief Adds real roots of x^2 + 2bx + c = 0 to candidates
+
+    Double root is added once, discriminant is compared with POLY_ZERO_TOLERANCE relative to b^2 and c,
+    because rounding can make it slightly negative
+*/
+static void addMonicRoots(double b, double c, double roots[], int *count);
+
+
+/// @brief Returns 1 if value is zero relative to scale, that is sum of moduli of terms that gave it
+static int nearZero(double value, double scale);
+
+
+/*!
+    @brief Makes answer from candidate roots of polynomial
+
+    @param[in] k Coefficients of polynomial from the highest power
+    @param[in] degree Degree of polynomial
+    @param[in] roots Candidate roots, they are changed
+    @param[in] count Number of candidates, not more than MAX_CANDIDATES
+    @param[out] answer Solution
+
+    Every root is polished with Newton steps while they make residual of evalTerms() smaller,
+    candidates whose residual isn't rounding noise are dropped, then roots are sorted, close ones are merged
+    and -0 is fixed
+*/
+static void finishRoots(const double k[], int degree, double roots[], int count, polySolution_t *answer);
+
+
+/// @brief Returns |value| of polynomial at x divided by scale of evalTerms(), NaN if x isn't finite
+static double relativeResidual(const double k[], int degree, double x);
+
+
+/*!
+    @brief Returns 1 if candidates are the same root of polynomial, left isn't bigger than right
+
+    They are merged if they are closer than POLY_ROOT_MERGE relative to max(1, |x|) or
+    polynomial is only rounding noise between them
+*/
+static int rootsMerged(const double k[], int degree, double left, double right);
+
+
+/*!
+    @brief Returns value of polynomial at x divided by power of 2 that makes the biggest term k[i]x^(degree-i) about 1
+
+    @param[out] scale Sum of moduli of the same terms, rounding error of value is proportional to it
+    @param[out] slope x times derivative, divided by the same power of 2
+
+    Horner's method is used while terms neither overflow nor underflow, otherwise they are summed
+    from mantissas and exponents, so roots about 1e100 and 1e-34 of one polynomial are evaluated too,
+    x * value / slope is Newton's step
+*/
+static double evalTerms(const double k[], int degree, double x, double *scale, double *slope);
+
+
+/// @brief Returns 1 if first count numbers are finite
+static int allFinite(const double k[], int count);
+
+
+/// @brief Writes solution to row of result columns of batch
+static void storeRow(polynomialBatch_t *batch, size_t row, const polySolution_t *answer);
+
+
+static double evalTerms(const double k[], int degree, double x, double *scale, double *slope) {
+    double value = k[0], derivative = 0;
+    *scale = fabs(k[0]);
+    for (int i = 1; i <= degree; i++) {
+        derivative = derivative * x + value;
+        value = value * x + k[i];
+        *scale = *scale * fabs(x) + fabs(k[i]);
+    }
+    //terms that underflow are smaller than rounding error of such scale
+    if (isfinite(*scale) && *scale > DBL_MIN / DBL_EPSILON) {
+        *slope = x * derivative;
+        return value;
+    }
+
+    value = 0;
+    *scale = 0;
+    *slope = 0;
+    if (!(fabs(x) > 0)) { //only free term is left
+        *scale = fabs(k[degree]);
+        return k[degree];
+    }
+
+    //term k[i]x^(degree-i) is mantissa of k[i] times mantissa of x to the power, times 2^exponents[i]
+    const int xExponent = ilogb(x);
+    const double xMantissa = ldexp(x, -xExponent);
+    int exponents[MAX_DEGREE + 1] = {};
+    int biggest = INT_MIN;
+    for (int i = 0; i <= degree; i++) {
+        if (!(fabs(k[i]) > 0)) continue;
+        exponents[i] = ilogb(k[i]) + (degree - i) * xExponent;
+        if (exponents[i] > biggest) biggest = exponents[i];
+    }
+
+    double power = 1;
+    for (int i = degree; i >= 0; i--) {
+        if (fabs(k[i]) > 0) {
+            const double term = ldexp(ldexp(k[i], -ilogb(k[i])) * power, exponents[i] - biggest);
+            value += term;
+            *scale += fabs(term);
+            *slope += (degree - i) * term;
+        }
+        power *= xMantissa;
+    }
+    return value;
+}
+
+
+static int allFinite(const double k[], int count) {
+    for (int i = 0; i < count; i++) {
+        if (!isfinite(k[i])) return 0;
+    }
+    return 1;
+}
+
+
+static int nearZero(double value, double scale) {
+    return fabs(value) <= POLY_ZERO_TOLERANCE * scale;
+}
+
+
+static void addMonicRoots(double b, double c, double roots[], int *count) {
+    const double disc = b * b - c;
+    if (nearZero(disc, b * b + fabs(c))) {
+        roots[(*count)++] = -b;
+    } else if (disc > 0) { //root with bigger modulus first, then Vieta's formula, so there is no cancellation
+        const double x1 = -b - copysign(sqrt(disc), b);
+        roots[(*count)++] = x1;
+        roots[(*count)++] = c / x1;
+    }
+}
+
+
+static void finishRoots(const double k[], int degree, double roots[], int count, polySolution_t *answer) {
+    double residuals[MAX_CANDIDATES] = {};
+    for (int i = 0; i < count; i++)
+        roots[i] = polishRoot(k, degree, roots[i], stepLimit(roots, count, i), &residuals[i]);
+
+    //closed forms and quotients give spurious candidates when precision is lost, true root has only rounding noise
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        if (residuals[i] <= POLY_ZERO_TOLERANCE)
+            roots[kept++] = roots[i];
+    }
+    count = kept;
+
+    for (int i = 1; i < count; i++) { //insertion sort, there are at most MAX_CANDIDATES roots
+        for (int j = i; j > 0 && roots[j - 1] > roots[j]; j--)
+            swap(&roots[j - 1], &roots[j], sizeof(double));
+    }
+
+    *answer = BLANK_POLY_SOLUTION;
+    int unique = 0;
+    for (int i = 0; i < count && unique < degree;) {
+        //group of merged candidates gives it's median: near multiple root residual is zero in the whole group
+        //and candidates of closed forms lie on both sides of it
+        const int first = i;
+        for (i++; i < count && rootsMerged(k, degree, roots[first], roots[i]); i++) {}
+        const double root = roots[first + (i - first - 1) / 2];
+        answer->roots[unique++] = isZero(root) ? fabs(root) : root;
+    }
+    answer->code = ROOTS_CODES[unique];
+}
+
+
+static double relativeResidual(const double k[], int degree, double x) {
+    if (!isfinite(x)) return NAN;
+    double scale = 0, slope = 0;
+    const double value = evalTerms(k, degree, x, &scale, &slope);
+    if (!(fabs(value) > 0)) return 0;
+    return fabs(value) / scale;
+}
+
+
+static int rootsMerged(const double k[], int degree, double left, double right) {
+    const double middle = left / 2 + right / 2;
+    return right - left <= POLY_ROOT_MERGE * fmax(1, fabs(right))
+           || relativeResidual(k, degree, middle) <= POLY_ZERO_TOLERANCE;
+}
+
+
+static int scaleExponent(const double k[], int degree) {
+    int exponent = INT_MIN;
+    for (int i = 1; i <= degree; i++) {
+        if (!(fabs(k[i]) > 0)) continue;
+        //|k[i] / k[0]| < 2^ratio, ratio / i is rounded up
+        const int ratio = binaryExponent(k[i]) - binaryExponent(k[0]) + 1;
+        const int needed = (ratio > 0) ? (ratio + i - 1) / i : -(-ratio / i);
+        if (needed > exponent) exponent = needed;
+    }
+    return (exponent == INT_MIN) ? 0 : exponent;
+}
+
+
+static void scalePolynomial(const double k[], int degree, int exponent, double scaled[]) {
+    scaled[0] = 1;
+    for (int i = 1; i <= degree; i++)
+        scaled[i] = timesPowerOf2(k[i], -i * exponent) / k[0];
+}
+
+
+static int binaryExponent(double x) {
+    uint64_t bits = 0;
+    memcpy(&bits, &x, sizeof(bits));
+    const int biased = (int) ((bits >> (DBL_MANT_DIG - 1)) & 0x7ff); //11 bits of exponent after 52 bits of mantissa
+    return (biased == 0) ? ilogb(x) : biased - (DBL_MAX_EXP - 1);   //subnormal numbers have no implicit 1
+}
+
+
+static double timesPowerOf2(double x, int exponent) {
+    if (exponent < DBL_MIN_EXP - 1 || exponent > DBL_MAX_EXP - 1)
+        return ldexp(x, exponent);
+    const uint64_t bits = (uint64_t) (exponent + DBL_MAX_EXP - 1) << (DBL_MANT_DIG - 1);
+    double power = 0;
+    memcpy(&power, &bits, sizeof(power));
+    return x * power;
+}
+
+
+static void deflateRoot(const double k[], int degree, double root, double quotient[]) {
+    //k = (x - root) * quotient, so k[degree] = -root * quotient[degree - 1] and k[i] = quotient[i] - root * quotient[i - 1]
+    quotient[0] = k[0];
+    quotient[degree - 1] = -k[degree] / root;
+    for (int i = degree - 1; i > 1; i--)
+        quotient[i - 1] = (quotient[i] - k[i]) / root;
+}
+
+
+static void deflateFactor(const double k[5], double b, double c, double quotient[3]) {
+    //k = (x^2 + 2bx + c) * quotient, so k[4] = c * quotient[2] and k[3] = c * quotient[1] + 2b * quotient[2]
+    quotient[0] = k[0];
+    quotient[2] = k[4] / c;
+    quotient[1] = (k[3] - 2 * b * quotient[2]) / c;
+}
+
+
+static void addQuadraticRoots(const double k[3], double roots[], int *count) {
+    if (isZero(k[0])) { //quotient of cubic with tiny leading coefficient, solveEquation() drops it too
+        polySolution_t lower = BLANK_POLY_SOLUTION;
+        solveQuadraticRoots(k, &lower);
+        for (int i = 0; i < 2 && !isnan(lower.roots[i]); i++)
+            roots[(*count)++] = lower.roots[i];
+        return;
+    }
+    const int exponent = scaleExponent(k, 2);
+    double scaled[3] = {};
+    scalePolynomial(k, 2, exponent, scaled);
+    const int first = *count;
+    addMonicRoots(scaled[1] / 2, scaled[2], roots, count);
+    for (int i = first; i < *count; i++)
+        roots[i] = timesPowerOf2(roots[i], exponent);
+}
+
+
+static int polishBiggest(const double k[], int degree, double roots[], int count) {
+    int biggest = -1;
+    for (int i = 0; i < count; i++) {
+        if (biggest < 0 || fabs(roots[i]) > fabs(roots[biggest])) biggest = i;
+    }
+    double residual = 0;
+    if (biggest >= 0)
+        roots[biggest] = polishRoot(k, degree, roots[biggest], stepLimit(roots, count, biggest), &residual);
+    return biggest;
+}
+
+
+static double polishRoot(const double k[], int degree, double root, double limit, double *residual) {
+    *residual = NAN;
+    if (!isfinite(root)) return root;
+
+    double scale = 0, slope = 0;
+    double value = evalTerms(k, degree, root, &scale, &slope);
+    *residual = (fabs(value) > 0) ? fabs(value) / scale : 0;
+    for (int iteration = 0; iteration < POLY_NEWTON_STEPS && *residual > 0; iteration++) {
+        //slope is x times derivative, so step from 0 is taken from the last two coefficients
+        const double polished = (fabs(root) > 0) ? root - root * (value / slope) : -k[degree] / k[degree - 1];
+        //step that is lost in rounding of root can't make residual smaller
+        if (!(fabs(polished - root) < limit) || !(fabs(polished - root) > 0)) break;
+
+        //values at different points are divided by different powers of 2, so residuals are compared
+        double polishedScale = 0, polishedSlope = 0;
+        const double polishedValue = evalTerms(k, degree, polished, &polishedScale, &polishedSlope);
+        const double polishedResidual = (fabs(polishedValue) > 0) ? fabs(polishedValue) / polishedScale : 0;
+        if (!(polishedResidual < *residual)) break;
+        root = polished;
+        value = polishedValue;
+        slope = polishedSlope;
+        *residual = polishedResidual;
+    }
+    return root;
+}
+
+
+static double stepLimit(const double roots[], int count, int index) {
+    //near multiple root slope is almost zero and step can jump to another root,
+    //copies of the same root from different formulas don't limit each other
+    double limit = INFINITY;
+    for (int j = 0; j < count; j++) {
+        const double distance = fabs(roots[j] - roots[index]);
+        if (j != index && distance > POLY_ROOT_MERGE * fmax(1, fabs(roots[index])))
+            limit = fmin(limit, distance / 2);
+    }
+    return limit;
+}
+
+
+static void solveQuadraticRoots(const double k[3], polySolution_t *answer) {
+    quadraticEquation_t equation = {k[0], k[1], k[2], BLANK_SOLUTION};
+    solveEquation(&equation);
+
+    *answer = BLANK_POLY_SOLUTION;
+    answer->code = equation.answer.code;
+    if (equation.answer.code == ONE_ROOT)
+        answer->roots[0] = equation.answer.x1;
+    else if (equation.answer.code == TWO_ROOTS) {
+        answer->roots[0] = fmin(equation.answer.x1, equation.answer.x2);
+        answer->roots[1] = fmax(equation.answer.x1, equation.answer.x2);
+    }
+}
+
+
+static void solveCubicRoots(const double k[4], polySolution_t *answer) {
+    if (isZero(k[0])) {
+        solveQuadraticRoots(k + 1, answer);
+        return;
+    }
+
+    double roots[MAX_CANDIDATES] = {};
+    const int count = cubicCandidates(k, roots);
+    finishRoots(k, 3, roots, count, answer);
+}
+
+
+static int cubicCandidates(const double k[4], double roots[]) {
+    int count = 0;
+    if (!(fabs(k[3]) > 0)) { //x(ax^2 + bx + c), isZero() isn't used because small coefficients are fine here
+        roots[count++] = 0;
+        addQuadraticRoots(k, roots, &count);
+        return count;
+    }
+
+    const int exponent = scaleExponent(k, 3);
+    double scaled[4] = {};
+    scalePolynomial(k, 3, exponent, scaled);
+
+    //x = t - shift gives depressed cubic t^3 + pt + q
+    const double B = scaled[1], C = scaled[2], D = scaled[3];
+    const double shift = B / 3;
+    const double p = C - B * shift;
+    const double q = shift * (2 * shift * shift - C) + D;
+    const double disc = q * q / 4 + p * p * p / 27;
+    //p, q and disc are compared with sizes of terms they are computed from, their rounding errors are proportional to them
+    const double pScale = fabs(C) + B * shift;
+    const double qScale = fabs(shift) * (2 * shift * shift + fabs(C)) + fabs(D);
+    const double discScale = fabs(q) * qScale / 2 + p * p * pScale / 9;
+
+    if (nearZero(p, pScale) && nearZero(q, qScale)) { //triple root
+        roots[count++] = 0;
+    } else {
+        if (nearZero(disc, discScale)) { //simple and double root, p isn't zero here
+            roots[count++] = 3 * q / p;
+            roots[count++] = -3 * q / (2 * p);
+        }
+        //disc near zero can be three close roots too, so formula of it's sign adds candidates anyway
+        if (disc > 0) { //Cardano, the bigger cube root is taken to avoid cancellation
+            const double u = cbrt(-q / 2 - copysign(sqrt(disc), q));
+            roots[count++] = u - p / (3 * u);
+        } else { //three roots, trigonometric formula
+            const double r = sqrt(-p / 3);
+            const double phi = acos(fmax(-1, fmin(1, 3 * q / (2 * p) / r))) / 3;
+            for (int i = 0; i < 3; i++)
+                roots[count++] = 2 * r * cos(phi - 2 * M_PI * i / 3);
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+        roots[i] -= shift;
+    const int biggest = polishBiggest(scaled, 3, roots, count);
+    for (int i = 0; i < count; i++)
+        roots[i] = timesPowerOf2(roots[i], exponent);
+
+    if (fabs(roots[biggest]) > 0) {
+        double quotient[3] = {};
+        deflateRoot(k, 3, roots[biggest], quotient);
+        addQuadraticRoots(quotient, roots, &count);
+    }
+    return count;
+}
+
+
+static void solveQuarticRoots(const double k[5], polySolution_t *answer) {
+    if (isZero(k[0])) {
+        solveCubicRoots(k + 1, answer);
+        return;
+    }
+
+    double roots[MAX_CANDIDATES] = {};
+    const int count = quarticCandidates(k, roots);
+    finishRoots(k, 4, roots, count, answer);
+}
+
+
+static int quarticCandidates(const double k[5], double roots[]) {
+    int count = 0;
+    if (!(fabs(k[4]) > 0)) { //x(ax^3 + bx^2 + cx + d)
+        roots[count++] = 0;
+        return count + cubicCandidates(k, roots + count);
+    }
+
+    const int exponent = scaleExponent(k, 4);
+    double scaled[5] = {};
+    scalePolynomial(k, 4, exponent, scaled);
+
+    //x = y - shift gives depressed quartic y^4 + py^2 + qy + r
+    const double B = scaled[1], C = scaled[2], D = scaled[3], E = scaled[4];
+    const double shift = B / 4;
+    const double p = C - 6 * shift * shift;
+    const double q = D - 2 * C * shift + 8 * shift * shift * shift;
+    const double r = E - D * shift + C * shift * shift - 3 * shift * shift * shift * shift;
+    const double pScale = fabs(C) + 6 * shift * shift;
+    const double qScale = fabs(D) + fabs(2 * C * shift) + fabs(8 * shift * shift * shift);
+    const double rScale = fabs(E) + fabs(D * shift) + (fabs(C) + 3 * shift * shift) * shift * shift;
+
+    //Ferrari: (y^2 + p/2 + m)^2 = 2m(y - q/4m)^2, where m is root of resolvent cubic
+    double m = 0;
+    if (!nearZero(q, qScale)) {
+        const double resolvent[4] = {1, p, p * p / 4 - r, -q * q / 8};
+        polySolution_t lower = BLANK_POLY_SOLUTION;
+        solveCubicRoots(resolvent, &lower);
+        for (int i = 0; i < 3 && !isnan(lower.roots[i]); i++)
+            m = fmax(m, lower.roots[i]);
+    }
+
+    //quadratic factors y^2 + 2by + c
+    double factorB[2] = {}, factorC[2] = {};
+    int factors = 0;
+    if (nearZero(p, pScale) && nearZero(q, qScale) && nearZero(r, rScale)) { //quadruple root
+        roots[count++] = 0;
+    } else if (m > 0) {
+        const double s = sqrt(2 * m);
+        factorB[0] = -s / 2;
+        factorC[0] = p / 2 + m + q / (2 * s);
+        factorB[1] = s / 2;
+        factorC[1] = p / 2 + m - q / (2 * s);
+        factors = 2;
+        for (int i = 0; i < factors; i++)
+            addMonicRoots(factorB[i], factorC[i], roots, &count);
+    } else { //q is zero, biquadratic: z^2 + pz + r with z = y^2
+        double squares[2] = {};
+        int squaresCount = 0;
+        addMonicRoots(p / 2, r, squares, &squaresCount);
+        if (squaresCount == 0) //q that is only near zero can turn double z into complex pair, it's real part is added
+            squares[squaresCount++] = -p / 2;
+        for (int i = 0; i < squaresCount; i++) {
+            factorC[factors++] = -squares[i];
+            if (nearZero(squares[i], fabs(p) + sqrt(fabs(r))))
+                roots[count++] = 0;
+            else if (squares[i] > 0) {
+                roots[count++] = -sqrt(squares[i]);
+                roots[count++] = sqrt(squares[i]);
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+        roots[i] -= shift;
+    const int biggest = polishBiggest(scaled, 4, roots, count);
+    for (int i = 0; i < count; i++)
+        roots[i] = timesPowerOf2(roots[i], exponent);
+
+    if (biggest >= 0 && fabs(roots[biggest]) > 0) {
+        double quotient[4] = {};
+        deflateRoot(k, 4, roots[biggest], quotient);
+        count += cubicCandidates(quotient, roots + count);
+    }
+
+    if (factors > 0) {
+        const int big = (factors > 1 && fabs(factorB[1]) + sqrt(fabs(factorC[1]))
+                                        > fabs(factorB[0]) + sqrt(fabs(factorC[0]))) ? 1 : 0;
+        //y = x + shift in scaled units, then x is scaled back
+        const double b = factorB[big] + shift;
+        const double c = (shift + 2 * factorB[big]) * shift + factorC[big];
+        if (fabs(c) > 0 && b * b < c) {
+            double quotient[3] = {};
+            deflateFactor(k, timesPowerOf2(b, exponent), timesPowerOf2(c, 2 * exponent), quotient);
+            addQuadraticRoots(quotient, roots, &count);
+        }
+    }
+    return count;
+}
+
+
+enum error solvePolynomial(polynomial_t* poly) {
+    MY_ASSERT(poly, return FAIL);
+    MY_ASSERT(poly->degree >= 2 && poly->degree <= MAX_DEGREE, return FAIL);
+
+    if (!allFinite(poly->coeffs, poly->degree + 1)) {
+        poly->answer = BLANK_POLY_SOLUTION;
+        poly->answer.code = BAD_INPUT;
+        return FAIL;
+    }
+    if (poly->degree == 2)
+        solveQuadraticRoots(poly->coeffs, &poly->answer);
+    else if (poly->degree == 3)
+        solveCubicRoots(poly->coeffs, &poly->answer);
+    else
+        solveQuarticRoots(poly->coeffs, &poly->answer);
+    return GOOD_EXIT;
+}
+
+
+enum error polyBatchAlloc(polynomialBatch_t* batch, int degree, size_t capacity) {
+    MY_ASSERT(batch, return FAIL);
+    MY_ASSERT(degree == 3 || degree == 4, return FAIL);
+
+    *batch = BLANK_POLY_BATCH;
+    batch->degree = degree;
+    int allocated = 1;
+    for (int i = 0; i <= degree; i++) {
+        batch->coeffs[i] = (double*) alignedCalloc(BATCH_ALIGNMENT, capacity * sizeof(double));
+        allocated = allocated && batch->coeffs[i];
+    }
+    for (int i = 0; i < degree; i++) {
+        batch->roots[i] = (double*) alignedCalloc(BATCH_ALIGNMENT, capacity * sizeof(double));
+        allocated = allocated && batch->roots[i];
+    }
+    batch->code = (enum solutionCode*) alignedCalloc(BATCH_ALIGNMENT, capacity * sizeof(enum solutionCode));
+
+    if (!allocated || !batch->code) {
+        fprintf(stderr, RED "Can't allocate memory for batch of %zu polynomials\n" RESET_C, capacity);
+        polyBatchFree(batch);
+        return FAIL;
+    }
+    batch->capacity = capacity;
+    return GOOD_EXIT;
+}
+
+
+void polyBatchFree(polynomialBatch_t* batch) {
+    MY_ASSERT(batch, return);
+    for (int i = 0; i <= MAX_DEGREE; i++)
+        alignedFree(batch->coeffs[i]);
+    for (int i = 0; i < MAX_DEGREE; i++)
+        alignedFree(batch->roots[i]);
+    alignedFree(batch->code);
+    *batch = BLANK_POLY_BATCH;
+}
+
+
+static void storeRow(polynomialBatch_t *batch, size_t row, const polySolution_t *answer) {
+    batch->code[row] = answer->code;
+    for (int i = 0; i < batch->degree; i++)
+        batch->roots[i][row] = answer->roots[i];
+}
+
+
+enum error solvePolynomialColumns(polynomialBatch_t* batch) {
+    MY_ASSERT(batch, return FAIL);
+    MY_ASSERT(batch->degree == 3 || batch->degree == 4, return FAIL);
+
+    polySolution_t badInput = BLANK_POLY_SOLUTION;
+    badInput.code = BAD_INPUT;
+
+    //degree is checked once, so loops don't dispatch on every row
+    if (batch->degree == 3) {
+        for (size_t row = 0; row < batch->size; row++) {
+            const double k[4] = {batch->coeffs[0][row], batch->coeffs[1][row], batch->coeffs[2][row],
+                                 batch->coeffs[3][row]};
+            polySolution_t answer = badInput;
+            if (allFinite(k, 4)) solveCubicRoots(k, &answer);
+            storeRow(batch, row, &answer);
+        }
+    } else {
+        for (size_t row = 0; row < batch->size; row++) {
+            const double k[5] = {batch->coeffs[0][row], batch->coeffs[1][row], batch->coeffs[2][row],
+                                 batch->coeffs[3][row], batch->coeffs[4][row]};
+            polySolution_t answer = badInput;
+            if (allFinite(k, 5)) solveQuarticRoots(k, &answer);
+            storeRow(batch, row, &answer);
+        }
+    }
+    return GOOD_EXIT;
+}
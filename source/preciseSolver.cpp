@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "preciseSolver.h"
+#include "utils.h"
+
+
+/// @brief Products below this value may be subnormal and lose precision
+const double UNDERFLOW_LIMIT = DBL_MIN * 0x1p54;
+
+
+/// @brief Unevaluated sum hi + lo, |lo| <= ulp(hi) / 2
+typedef struct doubleDouble {
+    double hi, lo;
+} doubleDouble_t;
+
+
+/// @brief Checks that number is exactly +-0, unlike isZero() doesn't use EPSILON
+static inline int isExactZero(double num);
+
+
+/// @brief Exact sum of two doubles (Knuth's TwoSum)
+static inline doubleDouble_t twoSum(double a, double b);
+
+
+/// @brief Exact product of two doubles, error term is computed with fma
+static inline doubleDouble_t twoProduct(double a, double b);
+
+
+/*!
+    @brief Solves equation with a != 0 in double, returns 0 if result can't be trusted
+
+    @param[in, out] equation Pointer to equation, answer isn't changed if 0 is returned
+
+    @return 1 if equation is solved, 0 if it must take slow path
+*/
+static int solveQuadraticFast(quadraticEquation_t* equation);
+
+
+/*!
+    @brief Solves equation with a != 0 in double-double on scaled coefficients
+
+    @param[in, out] equation Pointer to equation
+*/
+static void solveQuadraticSlow(quadraticEquation_t* equation);
+
+
+/*!
+    @brief Makes one Newton step for root y of ay^2 + by + c, keeps y if step doesn't reduce residual
+
+    @return Polished root
+
+    Polynomial is evaluated with compensated Horner scheme, so residual is accurate even near root
+*/
+static double newtonPolish(double a, double b, double c, double y);
+
+
+/// @brief Value of ay^2 + by + c computed with compensated Horner scheme
+static double evalCompensated(double a, double b, double c, double y);
+
+
+/// @brief Same as solveLinear() in quadraticSolver.cpp
+static void solveLinearPrecise(quadraticEquation_t* equation);
+
+
+static inline int isExactZero(double num) {
+    return fpclassify(num) == FP_ZERO;
+}
+
+
+static inline doubleDouble_t twoSum(double a, double b) {
+    const double sum = a + b;
+    const double bVirtual = sum - a;
+    const double aVirtual = sum - bVirtual;
+    return {sum, (a - aVirtual) + (b - bVirtual)};
+}
+
+
+static inline doubleDouble_t twoProduct(double a, double b) {
+    const double product = a * b;
+    return {product, fma(a, b, -product)};
+}
+
+
+enum error solveEquationPrecise(quadraticEquation_t* equation, precisionStats_t* stats) {
+    MY_ASSERT(equation, return FAIL);
+
+    if (stats) stats->equations++;
+    if (!isfinite(equation->a) || !isfinite(equation->b) || !isfinite(equation->c)) {
+        equation->answer.code = BAD_INPUT;
+        return FAIL;
+    }
+
+    if (isZero(equation->a))
+        solveLinearPrecise(equation);
+    else if (!solveQuadraticFast(equation)) {
+        if (stats) stats->slowPath++;
+        solveQuadraticSlow(equation);
+    }
+
+    //fixMinusZero() would also drop sign of tiny roots, here only -0 itself is fixed
+    if (isExactZero(equation->answer.x1)) equation->answer.x1 = 0;
+    if (isExactZero(equation->answer.x2)) equation->answer.x2 = 0;
+    return GOOD_EXIT;
+}
+
+
+void solveColumnsPrecise(size_t count, const double a[], const double b[], const double c[],
+                         enum solutionCode code[], double x1[], double x2[], precisionStats_t* stats) {
+    MY_ASSERT(a && b && c, return);
+    MY_ASSERT(code && x1 && x2, return);
+
+    for (size_t i = 0; i < count; i++) {
+        quadraticEquation_t equation = {a[i], b[i], c[i], BLANK_SOLUTION};
+        solveEquationPrecise(&equation, stats);
+        code[i] = equation.answer.code;
+        x1[i] = equation.answer.x1;
+        x2[i] = equation.answer.x2;
+    }
+}
+
+
+static void solveLinearPrecise(quadraticEquation_t* equation) {
+    if (isZero(equation->b))
+        equation->answer.code = isZero(equation->c) ? INF_ROOTS : ZERO_ROOTS;
+    else {
+        equation->answer.code = ONE_ROOT;
+        equation->answer.x1 = -(equation->c)/(equation->b);
+    }
+}
+
+
+static int solveQuadraticFast(quadraticEquation_t* equation) {
+    const double a = equation->a, b = equation->b, c = equation->c;
+
+    const double bSquare = b*b, ac4 = 4*a*c;
+    const double maxTerm = fmax(bSquare, fabs(ac4));
+    if (!isfinite(maxTerm) || (maxTerm < UNDERFLOW_LIMIT && maxTerm > 0))
+        return 0;
+
+    const double D = bSquare - ac4;
+    if (fabs(D) < CANCELLATION_RATIO * maxTerm)
+        return 0;
+
+    if (isZero(D)) {
+        equation->answer.code = ONE_ROOT;
+        equation->answer.x1 = -b / (2*a);
+    } else if (D < 0) {
+        equation->answer.code = ZERO_ROOTS;
+    } else {
+        //-b and sqrt(D) have the same sign in q, so they never cancel out
+        equation->answer.code = TWO_ROOTS;
+        const double q = -0.5 * (b + copysign(sqrt(D), b));
+        const double first = q / a, second = c / q;
+        equation->answer.x1 = signbit(b) ? second : first;
+        equation->answer.x2 = signbit(b) ? first : second;
+    }
+    return 1;
+}
+
+
+static void solveQuadraticSlow(quadraticEquation_t* equation) {
+    const double a = equation->a, b = equation->b, c = equation->c;
+
+    //x = 2^k * y makes |a'| close to |c|, then all coefficients are divided by 2^m, so they are <= 2
+    //powers of 2 are exact, so roots of scaled equation are the same up to 2^k
+    const int expA = ilogb(a);
+    const int expC = !isExactZero(c) ? ilogb(c) : expA;
+    const int k = (expC - expA) / 2;
+    int m = expA + 2*k;
+    if (!isExactZero(c) && expC > m) m = expC;
+    if (!isExactZero(b) && ilogb(b) + k > m) m = ilogb(b) + k;
+
+    const double as = ldexp(a, 2*k - m), bs = ldexp(b, k - m), cs = ldexp(c, -m);
+    //D of scaled equation is D * 2^(2k - 2m), so EPSILON is scaled too to keep the same exit codes
+    const double epsilonScaled = ldexp(EPSILON, 2*k - 2*m);
+
+    const doubleDouble_t bSquare = twoProduct(bs, bs), ac = twoProduct(as, cs);
+    const doubleDouble_t diff = twoSum(bSquare.hi, -4*ac.hi);
+    const doubleDouble_t D = twoSum(diff.hi, diff.lo + (bSquare.lo - 4*ac.lo));
+
+    if (fabs(D.hi) < epsilonScaled || isExactZero(D.hi)) {
+        equation->answer.code = ONE_ROOT;
+        equation->answer.x1 = ldexp(-bs / (2*as), k);
+        return;
+    }
+    if (D.hi < 0) {
+        equation->answer.code = ZERO_ROOTS;
+        return;
+    }
+
+    //sqrt in double-double: s + (D - s^2) / 2s
+    const double s = sqrt(D.hi);
+    const double sLow = (fma(-s, s, D.hi) + D.lo) / (2*s);
+
+    //q = -(b + sign(b) * sqrt(D)) / 2 in double-double
+    const doubleDouble_t t = twoSum(fabs(bs), s);
+    const doubleDouble_t q = twoSum(-copysign(0.5, bs) * t.hi, -copysign(0.5, bs) * (t.lo + sLow));
+
+    //q / a and c / q with correction for low part of q
+    double first = q.hi / as;
+    first += (fma(-first, as, q.hi) + q.lo) / as;
+    double second = cs / q.hi;
+    second += (fma(-second, q.hi, cs) - second * q.lo) / q.hi;
+
+    first  = newtonPolish(as, bs, cs, first);
+    second = newtonPolish(as, bs, cs, second);
+
+    equation->answer.code = TWO_ROOTS;
+    equation->answer.x1 = ldexp(signbit(bs) ? second : first, k);
+    equation->answer.x2 = ldexp(signbit(bs) ? first : second, k);
+}
+
+
+static double evalCompensated(double a, double b, double c, double y) {
+    //Horner scheme with error terms of every product and sum (Graillat, Langlois, Louvet)
+    const doubleDouble_t p1 = twoProduct(a, y);
+    const doubleDouble_t s1 = twoSum(p1.hi, b);
+    const doubleDouble_t p2 = twoProduct(s1.hi, y);
+    const doubleDouble_t s2 = twoSum(p2.hi, c);
+    const double error = (p1.lo + s1.lo) * y + (p2.lo + s2.lo);
+    return s2.hi + error;
+}
+
+
+static double newtonPolish(double a, double b, double c, double y) {
+    const double residual = evalCompensated(a, b, c, y);
+    const double derivative = fma(2*a, y, b);
+    if (isExactZero(residual) || isExactZero(derivative) || !isfinite(residual))
+        return y;
+
+    const double polished = y - residual / derivative;
+    return (fabs(evalCompensated(a, b, c, polished)) < fabs(residual)) ? polished : y;
+}
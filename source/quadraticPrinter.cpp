@@ -1,5 +1,8 @@
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
+
+#include <charconv>
 
 #include "error.h"
 #include "quadrEquation.h"
@@ -7,9 +10,48 @@
 #include "quadraticPrinter.h"
 #include "utils.h"
 
-enum error printKvadr(const quadraticEquation_t* equation) {
-    MY_ASSERT(equation, return FAIL);
-    printf(YELLOW);
+
+/// @brief Number of significant digits in PRETTY_NUMBERS style, the same as "%g"
+const int PRETTY_PRECISION = 6;
+
+
+/// @brief Copies string literal to buffer, returns position after it
+static inline char *appendString(char *out, const char str[]);
+
+
+static inline char *appendString(char *out, const char str[]) {
+    const size_t length = strlen(str);
+    memcpy(out, str, length);
+    return out + length;
+}
+
+
+size_t formatNumber(char *out, double num, enum numberStyle style) {
+    MY_ASSERT(out, return 0);
+
+    std::to_chars_result result = (style == PRETTY_NUMBERS)
+        ? std::to_chars(out, out + MAX_NUMBER_LEN, num, std::chars_format::general, PRETTY_PRECISION)
+        : std::to_chars(out, out + MAX_NUMBER_LEN, num);
+    MY_ASSERT(result.ec == std::errc(), return 0);
+    return (size_t) (result.ptr - out);
+}
+
+
+size_t formatNumberF(char *out, float num, enum numberStyle style) {
+    MY_ASSERT(out, return 0);
+
+    std::to_chars_result result = (style == PRETTY_NUMBERS)
+        ? std::to_chars(out, out + MAX_NUMBER_LEN, num, std::chars_format::general, PRETTY_PRECISION)
+        : std::to_chars(out, out + MAX_NUMBER_LEN, num);
+    MY_ASSERT(result.ec == std::errc(), return 0);
+    return (size_t) (result.ptr - out);
+}
+
+
+size_t formatKvadr(char *out, const quadraticEquation_t* equation, enum numberStyle style) {
+    MY_ASSERT(out, return 0);
+    MY_ASSERT(equation, return 0);
+    char *pos = out;
     int printedBefore = 0; //remembering if we printed something to put signs correctly
 
     double  a = equation->a,
@@ -17,55 +59,130 @@ enum error printKvadr(const quadraticEquation_t* equation) {
             c = equation->c;
 
     if (!isZero(a)) { //if not zero
-        if (a < 0) printf("-"); //sign
-        if (cmpDouble(fabs(a), 1)) printf("%g", fabs(a)); //1x^2 is the same as x^2
-        printf("x^2 ");
+        if (a < 0) *pos++ = '-'; //sign
+        if (cmpDouble(fabs(a), 1)) pos += formatNumber(pos, fabs(a), style); //1x^2 is the same as x^2
+        pos = appendString(pos, "x^2 ");
         printedBefore = 1;
     }
 
     if (!isZero(b)) {
-        if (printedBefore) printf((b < 0) ? "- " : "+ ");
-        if (cmpDouble(fabs(b), 1)) printf("%g", printedBefore ? fabs(b) : b);
+        if (printedBefore) pos = appendString(pos, (b < 0) ? "- " : "+ ");
+        if (cmpDouble(fabs(b), 1)) pos += formatNumber(pos, printedBefore ? fabs(b) : b, style);
         //if a == 0 => we should print -b, not "- b"
-        printf("x ");
+        pos = appendString(pos, "x ");
         printedBefore = 1;
     }
 
     if (!(printedBefore && isZero(c))) { //x + 0 <=> x
-        if (printedBefore) printf((c < 0) ? "- %g " : "+ %g ", fabs(c));
-        else printf("%g ", c);
+        if (printedBefore) {
+            pos = appendString(pos, (c < 0) ? "- " : "+ ");
+            pos += formatNumber(pos, fabs(c), style);
+        } else
+            pos += formatNumber(pos, c, style);
+        *pos++ = ' ';
     }
-    printf("= 0\n" RESET_C);
-    return GOOD_EXIT;
+    pos = appendString(pos, "= 0\n");
+    *pos = '\0';
+    return (size_t) (pos - out);
 }
 
 
-enum error printAnswer(const quadraticEquation_t* equation) {
+enum error formatAnswer(char *out, size_t *length, const quadraticEquation_t* equation, enum numberStyle style) {
+    MY_ASSERT(out && length, return BAD_EXIT);
     MY_ASSERT(equation, return BAD_EXIT);
+    char *pos = out;
+    enum error result = GOOD_EXIT;
 
     switch(equation->answer.code) {
         case BLANK_ROOT:
-            printf("Something went wrong\n");
+            pos = appendString(pos, "Something went wrong\n");
             break;
         case ZERO_ROOTS:
-            printf("There is no roots\n");
+            pos = appendString(pos, "There is no roots\n");
             break;
         case ONE_ROOT:
-            printf("x = %lg\n", equation->answer.x1);
+            pos = appendString(pos, "x = ");
+            pos += formatNumber(pos, equation->answer.x1, style);
+            *pos++ = '\n';
             break;
         case TWO_ROOTS:
-            printf("x1 = %lg\nx2 = %lg\n", equation->answer.x1, equation->answer.x2);
+            pos = appendString(pos, "x1 = ");
+            pos += formatNumber(pos, equation->answer.x1, style);
+            pos = appendString(pos, "\nx2 = ");
+            pos += formatNumber(pos, equation->answer.x2, style);
+            *pos++ = '\n';
+            break;
+        case COMPLEX_ROOTS: //x1 is real part, x2 is positive imaginary part
+            pos = appendString(pos, "x1 = ");
+            pos += formatNumber(pos, equation->answer.x1, style);
+            pos = appendString(pos, " - ");
+            pos += formatNumber(pos, equation->answer.x2, style);
+            pos = appendString(pos, "i\nx2 = ");
+            pos += formatNumber(pos, equation->answer.x1, style);
+            pos = appendString(pos, " + ");
+            pos += formatNumber(pos, equation->answer.x2, style);
+            pos = appendString(pos, "i\n");
             break;
         case INF_ROOTS:
-            printf("x is any number\n");
+            pos = appendString(pos, "x is any number\n");
             break;
         case BAD_INPUT:
-            printf("Please check your input\n");
+            pos = appendString(pos, "Please check your input\n");
             break;
+        case THREE_ROOTS: //quadratic equation can't have them
+        case FOUR_ROOTS:
         default:
-            printf("That's really bad :(\n");
-            return BAD_EXIT;
+            pos = appendString(pos, "That's really bad :(\n");
+            result = BAD_EXIT;
             break;
     }
+    *pos = '\0';
+    *length = (size_t) (pos - out);
+    return result;
+}
+
+
+enum error printKvadr(const quadraticEquation_t* equation, enum numberStyle style) {
+    MY_ASSERT(equation, return FAIL);
+
+    char buffer[MAX_EQUATION_LEN] = "";
+    const size_t length = formatKvadr(buffer, equation, style);
+    fputs(YELLOW, stdout);
+    fwrite(buffer, 1, length, stdout);
+    fputs(RESET_C, stdout);
     return GOOD_EXIT;
 }
+
+
+enum error printAnswer(const quadraticEquation_t* equation, enum numberStyle style) {
+    MY_ASSERT(equation, return BAD_EXIT);
+
+    char buffer[MAX_ANSWER_LEN] = "";
+    size_t length = 0;
+    enum error result = formatAnswer(buffer, &length, equation, style);
+    fwrite(buffer, 1, length, stdout);
+    return result;
+}
+
+
+enum error printRootsCount(const quadraticEquation_t* equation) {
+    MY_ASSERT(equation, return BAD_EXIT);
+
+    switch (equation->answer.code) {
+        case ONE_ROOT:
+            printf("One root\n");
+            return GOOD_EXIT;
+        case TWO_ROOTS:
+            printf("Two roots\n");
+            return GOOD_EXIT;
+        case BLANK_ROOT:
+        case ZERO_ROOTS:
+        case INF_ROOTS:
+        case BAD_INPUT:
+        case THREE_ROOTS:
+        case FOUR_ROOTS:
+        case COMPLEX_ROOTS:
+        default:
+            return printAnswer(equation, SHORTEST_NUMBERS);
+    }
+}
@@ -9,94 +9,52 @@
 #include "quadraticSolver.h"
 #include "colors.h"
 #include "utils.h"
-
-
-/*!
-    @brief solves linear equation
-
-    @param[in, out] equation Pointer to struct that holds coeffs and answers
-
-    @return Enum with error code
-*/
-static enum error solveLinear(quadraticEquation_t* equation);
-
-
-/*!
-    @brief solves quadratic equation (a != 0)
-
-    Note: function doesn't check a == o
-    @param[in, out] equation Pointer to struct that holds coeffs and answers
-
-    @return Enum with error code
-*/
-static enum error solveQuadratic(quadraticEquation_t* equation);
+#include "genericSolver.h"
 
 
 enum error solveEquation(quadraticEquation_t* equation) {
     MY_ASSERT(equation, return FAIL);//return BAEXIT
 
-    double  a = equation->a,
-            b = equation->b,
-            c = equation->c;
-
-    if (!isfinite(a) || !isfinite(b) || !isfinite(c)) { //checking input for NaNs
-        equation->answer.code = BAD_INPUT;
-        return FAIL;
-    }
+    //roots that aren't found keep values from equation->answer
+    typedSolution<double> answer = {equation->answer.code, equation->answer.x1, equation->answer.x2};
+    const enum error result = solveQuadraticT<double, checkedPolicy_t>(equation->a, equation->b, equation->c, &answer);
 
+    equation->answer.code = answer.code;
+    equation->answer.x1 = answer.x1;
+    equation->answer.x2 = answer.x2;
+    return result;
+}
 
-    if (isZero(a)) { // we divide only by a, so this check is essential
-        solveLinear(equation);
-    } else
-        solveQuadratic(equation);
 
-    //fix -0 case
-    equation->answer.x1 = fixMinusZero(equation->answer.x1);
-    equation->answer.x2 = fixMinusZero(equation->answer.x2);
+enum error solveEquationComplex(quadraticEquation_t* equation) {
+    MY_ASSERT(equation, return FAIL);
 
-    if (equation->answer.code == ONE_ROOT || equation->answer.code == TWO_ROOTS )
-        MY_ASSERT(isfinite(equation->answer.x1), return FAIL);
-    if (equation->answer.code == TWO_ROOTS)
-        MY_ASSERT(isfinite(equation->answer.x2), return FAIL);
+    typedSolution<double> answer = {equation->answer.code, equation->answer.x1, equation->answer.x2};
+    const enum error result = solveQuadraticT<double, complexPolicy_t>(equation->a, equation->b, equation->c, &answer);
 
-    return GOOD_EXIT;
+    equation->answer.code = answer.code;
+    equation->answer.x1 = answer.x1;
+    equation->answer.x2 = answer.x2;
+    return result;
 }
 
 
-static enum error solveLinear(quadraticEquation_t* equation) {
-    if (isZero(equation->b)) { //checking for zeros in coefficients;
-        //b = 0
-        if (isZero(equation->c)) { // 0 = 0
-            equation->answer.code = INF_ROOTS;
-        } else {
-            //printf("Equation can't be solved\n");
-            equation->answer.code = ZERO_ROOTS;
-        }
-    } else {
-        equation->answer.code = ONE_ROOT;
-        equation->answer.x1 = -(equation->c)/(equation->b);
-    }
-    return GOOD_EXIT;
+enum error classifyEquation(quadraticEquation_t* equation) {
+    MY_ASSERT(equation, return FAIL);
+
+    equation->answer.code = classifyQuadraticT<double, checkedPolicy_t>(equation->a, equation->b, equation->c);
+    return (equation->answer.code == BAD_INPUT) ? FAIL : GOOD_EXIT;
 }
 
 
-static enum error solveQuadratic(quadraticEquation_t* equation) {
-    double  a = equation->a,
-            b = equation->b,
-            c = equation->c;
-
-    const double D = b*b - 4*a*c; //calculating discriminant
-    if (isZero(D)) {            //D = 0
-        equation->answer.code = ONE_ROOT;
-        equation->answer.x1 = -b / (2*a);
-    } else if (cmpDouble(D, 0) == -1) {
-        equation->answer.code = ZERO_ROOTS;              //D < 0
-        //printf("Equation can't be solved in R: D = %g < 0\n", D);
-    } else {                            //D > 0
-        equation->answer.code = TWO_ROOTS;
-        const double D_sqrt = sqrt(D);
-        equation->answer.x1 = (-b - D_sqrt)/(2*a);
-        equation->answer.x2 = (-b + D_sqrt)/(2*a);
-    }
-    return GOOD_EXIT;
+enum error solveEquationF(quadraticEquationF_t* equation) {
+    MY_ASSERT(equation, return FAIL);
+
+    typedSolution<float> answer = {equation->answer.code, equation->answer.x1, equation->answer.x2};
+    const enum error result = solveQuadraticT<float, checkedPolicy_t>(equation->a, equation->b, equation->c, &answer);
+
+    equation->answer.code = answer.code;
+    equation->answer.x1 = answer.x1;
+    equation->answer.x2 = answer.x2;
+    return result;
 }
@@ -0,0 +1,255 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "quadraticSolver.h"
+#include "resultCache.h"
+#include "utils.h"
+
+
+/// @brief Size of cache line, shards are aligned to it so their locks don't share lines
+const size_t CACHE_LINE_SIZE = 64;
+
+/// @brief solveColumnsCached() prefetches set of row that is this number of rows ahead
+const size_t CACHE_PREFETCH_DISTANCE = 8;
+
+
+/// @brief Cached solution with bits of coefficients it belongs to
+typedef struct cacheEntry {
+    uint64_t key[3];        ///< Bits of a, b, c
+    solution_t answer;      ///< Answer of solveEquation()
+    enum error result;      ///< Return value of solveEquation()
+} cacheEntry_t;
+
+
+/*!
+    @brief CACHE_WAYS entries that can hold the same keys, bit i of masks describes entry i
+
+    Tags are high bits of hash of keys, they are in the same cache line as masks, so lookup reads
+    whole keys only of entries with matching tag
+*/
+typedef struct cacheSet {
+    uint32_t tags[CACHE_WAYS];
+    uint8_t used;           ///< Entries that hold solution
+    uint8_t referenced;     ///< Entries that were hit since CLOCK hand passed them
+    uint8_t hand;           ///< Next entry that CLOCK checks for eviction
+    cacheEntry_t entries[CACHE_WAYS];
+} cacheSet_t;
+
+const cacheSet_t BLANK_CACHE_SET = {};
+
+
+/// @brief Independently locked part of cache
+typedef struct alignas(CACHE_LINE_SIZE) cacheShard {
+    std::mutex lock {};                 ///< Protects sets and counters
+    std::vector<cacheSet_t> sets {};
+    cacheStats_t stats = BLANK_CACHE_STATS;
+} cacheShard_t;
+
+
+struct resultCache {
+    std::vector<cacheShard_t> shards {};
+    size_t shardMask = 0;               ///< Number of shards - 1, number of shards is power of 2
+    size_t setsPerShard = 0;
+};
+
+
+/// @brief Place of key in cache
+typedef struct cacheSlot {
+    cacheShard_t *shard;
+    cacheSet_t *set;
+    uint32_t tag;
+} cacheSlot_t;
+
+
+/// @brief Copies bits of coefficients to key
+static inline void makeKey(double a, double b, double c, uint64_t key[3]);
+
+
+/// @brief Finds shard, set and tag of coefficients
+static inline cacheSlot_t locateKey(resultCache_t *cache, double a, double b, double c);
+
+
+/// @brief Returns way of set that holds key with tag or CACHE_WAYS if there is no such way
+static inline size_t findWay(const cacheSet_t *set, const uint64_t key[3], uint32_t tag);
+
+
+/*!
+    @brief Puts solution to set
+
+    @param[in, out] shard Shard of set, it's lock must be held
+    @param[in, out] set Set for key
+    @param[in] entry Key and solution
+    @param[in] tag Tag of key
+
+    Free entry is taken if there is one, else CLOCK hand skips referenced entries clearing their bits
+    and replaces the first entry that wasn't referenced
+*/
+static void insertEntry(cacheShard_t *shard, cacheSet_t *set, const cacheEntry_t *entry, uint32_t tag);
+
+
+static inline void makeKey(double a, double b, double c, uint64_t key[3]) {
+    memcpy(&key[0], &a, sizeof(key[0]));
+    memcpy(&key[1], &b, sizeof(key[1]));
+    memcpy(&key[2], &c, sizeof(key[2]));
+}
+
+
+static inline cacheSlot_t locateKey(resultCache_t *cache, double a, double b, double c) {
+    const uint64_t hash = hashCoeffBits(a, b, c);
+
+    //low bits choose shard, the rest of low half chooses set, high half is tag
+    cacheShard_t *shard = &cache->shards[hash & cache->shardMask];
+    cacheSet_t *set = &shard->sets[(size_t) ((uint32_t) hash * (uint64_t) cache->setsPerShard >> 32)];
+    const cacheSlot_t slot = {shard, set, (uint32_t) (hash >> 32)};
+    return slot;
+}
+
+
+static inline size_t findWay(const cacheSet_t *set, const uint64_t key[3], uint32_t tag) {
+    for (size_t way = 0; way < CACHE_WAYS; way++) {
+        if (set->tags[way] != tag || !(set->used >> way & 1)) continue;
+        const cacheEntry_t *entry = &set->entries[way];
+        if (entry->key[0] == key[0] && entry->key[1] == key[1] && entry->key[2] == key[2])
+            return way;
+    }
+    return CACHE_WAYS;
+}
+
+
+static void insertEntry(cacheShard_t *shard, cacheSet_t *set, const cacheEntry_t *entry, uint32_t tag) {
+    //other thread could solve the same equation while lock was released
+    if (findWay(set, entry->key, tag) != CACHE_WAYS) return;
+
+    size_t way = 0;
+    while (way < CACHE_WAYS && (set->used >> way & 1)) way++;
+
+    if (way == CACHE_WAYS) {
+        while (set->referenced >> set->hand & 1) {
+            set->referenced &= (uint8_t) ~(1u << set->hand);
+            set->hand = (uint8_t) ((set->hand + 1) % CACHE_WAYS);
+        }
+        way = set->hand;
+        set->hand = (uint8_t) ((set->hand + 1) % CACHE_WAYS);
+        shard->stats.evictions++;
+    }
+
+    set->entries[way] = *entry;
+    set->tags[way] = tag;
+    set->used |= (uint8_t) (1u << way);
+    set->referenced &= (uint8_t) ~(1u << way);
+}
+
+
+resultCache_t *resultCacheCreate(size_t capacity, size_t shards) {
+    if (shards == 0) shards = DEFAULT_CACHE_SHARDS;
+    size_t shardCount = 1;
+    while (shardCount < shards) shardCount *= 2;
+
+    const size_t sets = (capacity + CACHE_WAYS - 1) / CACHE_WAYS;
+    const size_t setsPerShard = (sets + shardCount - 1) / shardCount;
+
+    resultCache_t *cache = new (std::nothrow) resultCache_t;
+    if (!cache) {
+        fprintf(stderr, RED "Can't allocate memory for cache\n" RESET_C);
+        return NULL;
+    }
+    try {
+        cache->shards = std::vector<cacheShard_t>(shardCount);
+        for (cacheShard_t &shard : cache->shards)
+            shard.sets.assign(setsPerShard ? setsPerShard : 1, BLANK_CACHE_SET);
+    } catch (...) {
+        fprintf(stderr, RED "Can't allocate memory for cache\n" RESET_C);
+        delete cache;
+        return NULL;
+    }
+    cache->shardMask = shardCount - 1;
+    cache->setsPerShard = setsPerShard ? setsPerShard : 1;
+    return cache;
+}
+
+
+void resultCacheDestroy(resultCache_t *cache) {
+    delete cache;
+}
+
+
+enum error solveEquationCached(resultCache_t *cache, quadraticEquation_t* equation) {
+    MY_ASSERT(cache, return FAIL);
+    MY_ASSERT(equation, return FAIL);
+
+    cacheEntry_t entry = {};
+    makeKey(equation->a, equation->b, equation->c, entry.key);
+    const cacheSlot_t slot = locateKey(cache, equation->a, equation->b, equation->c);
+    cacheShard_t *shard = slot.shard;
+    cacheSet_t *set = slot.set;
+    const uint32_t tag = slot.tag;
+
+    {
+        std::lock_guard<std::mutex> guard(shard->lock);
+        const size_t way = findWay(set, entry.key, tag);
+        if (way != CACHE_WAYS) {
+            set->referenced |= (uint8_t) (1u << way);
+            shard->stats.hits++;
+            equation->answer = set->entries[way].answer;
+            return set->entries[way].result;
+        }
+        shard->stats.misses++;
+    }
+
+    quadraticEquation_t solved = {equation->a, equation->b, equation->c, BLANK_SOLUTION};
+    entry.result = solveEquation(&solved);
+    entry.answer = solved.answer;
+    equation->answer = solved.answer;
+
+    std::lock_guard<std::mutex> guard(shard->lock);
+    insertEntry(shard, set, &entry, tag);
+    return entry.result;
+}
+
+
+void solveColumnsCached(resultCache_t *cache, size_t count, const double a[], const double b[], const double c[],
+                        enum solutionCode code[], double x1[], double x2[]) {
+    MY_ASSERT(cache, return);
+    MY_ASSERT(a && b && c, return);
+    MY_ASSERT(code && x1 && x2, return);
+
+    for (size_t i = 0; i < count; i++) {
+        //big cache doesn't fit in CPU caches, so tags of next rows are loaded while this row is looked up
+        if (i + CACHE_PREFETCH_DISTANCE < count) {
+            const size_t next = i + CACHE_PREFETCH_DISTANCE;
+            __builtin_prefetch(locateKey(cache, a[next], b[next], c[next]).set);
+        }
+        quadraticEquation_t equation = {a[i], b[i], c[i], BLANK_SOLUTION};
+        solveEquationCached(cache, &equation);
+        code[i] = equation.answer.code;
+        x1[i] = equation.answer.x1;
+        x2[i] = equation.answer.x2;
+    }
+}
+
+
+cacheStats_t resultCacheStats(resultCache_t *cache) {
+    cacheStats_t stats = BLANK_CACHE_STATS;
+    if (!cache) return stats;
+
+    for (cacheShard_t &shard : cache->shards) {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        stats.hits += shard.stats.hits;
+        stats.misses += shard.stats.misses;
+        stats.evictions += shard.stats.evictions;
+    }
+    return stats;
+}
+
+
+size_t resultCacheCapacity(const resultCache_t *cache) {
+    MY_ASSERT(cache, return 0);
+    return cache->shards.size() * cache->setsPerShard * CACHE_WAYS;
+}
@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "colors.h"
+#include "quadraticPrinter.h"
+#include "batchSolver.h"
+#include "preciseSolver.h"
+#include "resultCache.h"
+#include "batchDedup.h"
+#include "asyncIO.h"
+#include "polynomialSolver.h"
+#include "batchProcessor.h"
+#include "shmTransport.h"
+#include "shmWorker.h"
+#include "tracer.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <sys/stat.h>
+
+
+static_assert(sizeof(enum solutionCode) == sizeof(int32_t), "code column is array of int32");
+
+
+/*!
+    @brief Layout of segment that worker has computed
+
+    Client can write anything to header, so worker never reads sizes and offsets back from it
+*/
+typedef struct shmLayout {
+    shmHeader_t *header;            ///< Mapped segment
+    uint32_t slots;                 ///< Number of slots, power of 2
+    uint32_t slotEquations;         ///< Capacity of one slot
+    uint64_t slotSize;              ///< Bytes of one slot
+    uint64_t requestRingOffset;
+    uint64_t responseRingOffset;
+    uint64_t slotsOffset;
+    uint64_t segmentSize;           ///< Bytes of mapping
+} shmLayout_t;
+
+const shmLayout_t BLANK_SHM_LAYOUT = {NULL, 0, 0, 0, 0, 0, 0, 0};
+
+
+/*!
+    @brief Removes stale segment with this name, keeps segment of live worker
+
+    @return GOOD_EXIT if name is free now, BAD_EXIT if it's served
+*/
+static enum error removeStaleSegment(const char name[]);
+
+
+/*!
+    @brief Creates segment, lays out rings and slots and marks it running
+
+    @param[in] name Name of shared memory
+    @param[out] layout Mapped segment and it's layout, copy of it is published in header for client
+
+    @return GOOD_EXIT or FAIL
+*/
+static enum error createSegment(const char name[], shmLayout_t *layout);
+
+
+/// @brief Returns slot number index, index must be less than layout->slots
+static shmSlotHeader_t *layoutSlot(const shmLayout_t *layout, uint32_t index);
+
+
+/// @brief Solves slot number index in place and sets it's status
+static void solveSlot(const shmLayout_t *layout, uint32_t index, const batchOptions_t *options, shmStats_t *stats);
+
+
+/// @brief Returns 1 if SIGINT or SIGTERM came to signalfd, signal is taken from queue
+static int signalCame(int signals);
+
+
+static enum error removeStaleSegment(const char name[]) {
+    const int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return GOOD_EXIT;
+
+    //segment is served if it's worker is running and still exists
+    struct stat info = {};
+    int alive = 0;
+    if (fstat(fd, &info) == 0 && (size_t) info.st_size >= sizeof(shmHeader_t)) {
+        shmHeader_t *header = (shmHeader_t*) mmap(NULL, sizeof(shmHeader_t), PROT_READ, MAP_SHARED, fd, 0);
+        if (header != MAP_FAILED) {
+            alive = header->magic.load(std::memory_order_acquire) == SHM_MAGIC && header->state.load() == SHM_RUNNING
+                    && header->workerPid != 0 && kill((pid_t) header->workerPid, 0) == 0;
+            munmap(header, sizeof(shmHeader_t));
+        }
+    }
+    close(fd);
+
+    if (alive) {
+        fprintf(stderr, RED "Shared memory \"%s\" is already served\n" RESET_C, name);
+        return BAD_EXIT;
+    }
+    shm_unlink(name);
+    return GOOD_EXIT;
+}
+
+
+static enum error createSegment(const char name[], shmLayout_t *layout) {
+    if (removeStaleSegment(name) != GOOD_EXIT) return FAIL;
+
+    shmLayout_t computed = BLANK_SHM_LAYOUT;
+    computed.slots = SHM_DEFAULT_SLOTS;
+    computed.slotEquations = SHM_DEFAULT_SLOT_EQUATIONS;
+    computed.slotSize = shmSlotSize(SHM_DEFAULT_SLOT_EQUATIONS);
+    const uint64_t ringSize = shmAlign(computed.slots * sizeof(uint32_t));
+    computed.requestRingOffset = shmAlign(sizeof(shmHeader_t));
+    computed.responseRingOffset = computed.requestRingOffset + ringSize;
+    computed.slotsOffset = computed.responseRingOffset + ringSize;
+    computed.segmentSize = computed.slotsOffset + computed.slots * computed.slotSize;
+
+    const int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        fprintf(stderr, RED "Can't create shared memory \"%s\": %s\n" RESET_C, name, strerror(errno));
+        return FAIL;
+    }
+    //pages are populated at start, so the first requests don't fault
+    void *segment = MAP_FAILED;
+    if (ftruncate(fd, (off_t) computed.segmentSize) == 0)
+        segment = mmap(NULL, computed.segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (segment == MAP_FAILED) {
+        fprintf(stderr, RED "Can't map shared memory \"%s\": %s\n" RESET_C, name, strerror(errno));
+        close(fd);
+        shm_unlink(name);
+        return FAIL;
+    }
+    close(fd);
+
+    //new object is filled with zeros, so indices and flags are already 0
+    shmHeader_t *header = (shmHeader_t*) segment;
+    computed.header = header;
+    header->version = SHM_VERSION;
+    header->slots = computed.slots;
+    header->slotEquations = computed.slotEquations;
+    header->slotSize = computed.slotSize;
+    header->requestRingOffset = computed.requestRingOffset;
+    header->responseRingOffset = computed.responseRingOffset;
+    header->slotsOffset = computed.slotsOffset;
+    header->segmentSize = computed.segmentSize;
+    header->workerPid = (uint32_t) getpid();
+    header->state.store(SHM_RUNNING);
+    header->magic.store(SHM_MAGIC, std::memory_order_release);
+    *layout = computed;
+    return GOOD_EXIT;
+}
+
+
+static shmSlotHeader_t *layoutSlot(const shmLayout_t *layout, uint32_t index) {
+    return (shmSlotHeader_t*) ((char*) layout->header + layout->slotsOffset + (uint64_t) index * layout->slotSize);
+}
+
+
+static void solveSlot(const shmLayout_t *layout, uint32_t index, const batchOptions_t *options, shmStats_t *stats) {
+    shmSlotHeader_t *slot = layoutSlot(layout, index);
+    const uint32_t equations = layout->slotEquations;
+    const uint32_t count = slot->count; //count is read once, client can't change it after the check
+    if (count > equations) {
+        slot->status = SHM_BAD_SIZE;
+        stats->failed++;
+        return;
+    }
+
+    const double *a  = (const double*) shmSlotColumn(slot, equations, 0);
+    const double *b  = (const double*) shmSlotColumn(slot, equations, 1);
+    const double *c  = (const double*) shmSlotColumn(slot, equations, 2);
+    double *x1 = (double*) shmSlotColumn(slot, equations, 3);
+    double *x2 = (double*) shmSlotColumn(slot, equations, 4);
+    enum solutionCode *code = (enum solutionCode*) shmSlotColumn(slot, equations, 5);
+
+    TRACE_BEGIN(solveSpan);
+    const enum error solved = solveColumnsParallel(count, a, b, c, code, x1, x2, options);
+    TRACE_END(solveSpan, "solve slot");
+    if (solved == GOOD_EXIT) {
+        slot->status = SHM_OK;
+        stats->requests++;
+        stats->equations += count;
+    } else {
+        slot->status = SHM_SOLVER_FAILED;
+        stats->failed++;
+    }
+}
+
+
+static int signalCame(int signals) {
+    //signal is taken from queue, so it isn't delivered when mask is restored
+    struct signalfd_siginfo info = {};
+    return read(signals, &info, sizeof(info)) == (ssize_t) sizeof(info);
+}
+
+
+enum error serveSharedMemory(const char name[], const batchOptions_t *options, shmStats_t *stats) {
+    MY_ASSERT(name, return FAIL);
+    MY_ASSERT(options, return FAIL);
+
+    sigset_t signalSet = {}, oldSignals = {};
+    sigemptyset(&signalSet);
+    sigaddset(&signalSet, SIGINT);
+    sigaddset(&signalSet, SIGTERM);
+    sigprocmask(SIG_BLOCK, &signalSet, &oldSignals);
+
+    const int signals = signalfd(-1, &signalSet, SFD_NONBLOCK | SFD_CLOEXEC);
+    shmLayout_t layout = BLANK_SHM_LAYOUT;
+    if (signals < 0 || createSegment(name, &layout) != GOOD_EXIT) {
+        if (signals < 0) fprintf(stderr, RED "Can't create signalfd: %s\n" RESET_C, strerror(errno));
+        else close(signals);
+        sigprocmask(SIG_SETMASK, &oldSignals, NULL);
+        return FAIL;
+    }
+
+    shmStats_t counters = BLANK_SHM_STATS;
+    shmHeader_t *header = layout.header;
+    const uint32_t *requestRing = (const uint32_t*) ((char*) header + layout.requestRingOffset);
+    uint32_t *responseRing = (uint32_t*) ((char*) header + layout.responseRingOffset);
+    const uint32_t mask = layout.slots - 1;
+    uint32_t requestHead = 0, responseTail = 0;
+
+    int running = 1;
+    while (running) {
+        if (header->requestTail.value.load(std::memory_order_acquire) == requestHead
+            && !shmWaitIndex(&header->requestTail, requestHead)) {
+            running = !signalCame(signals);
+            continue;
+        }
+
+        //index from broken client is dropped, slots of other indices are still valid
+        const uint32_t index = requestRing[requestHead & mask];
+        if (index < layout.slots) {
+            solveSlot(&layout, index, options, &counters);
+            responseRing[responseTail & mask] = index;
+            shmPublishIndex(&header->responseTail, ++responseTail);
+        }
+        //head is moved after answer, so client that attaches sees all old slots answered when head reaches tail
+        header->requestHead.value.store(++requestHead, std::memory_order_release);
+
+        if ((counters.requests + counters.failed) % SHM_SIGNAL_CHECK_PERIOD == 0)
+            running = !signalCame(signals);
+    }
+
+    header->state.store(SHM_STOPPED);
+    shmPublishIndex(&header->responseTail, responseTail);
+    munmap(header, layout.segmentSize);
+    shm_unlink(name);
+    close(signals);
+    sigprocmask(SIG_SETMASK, &oldSignals, NULL);
+
+    if (stats) *stats = counters;
+    return GOOD_EXIT;
+}
+
+#else
+
+enum error serveSharedMemory(const char name[], const batchOptions_t *options, shmStats_t *stats) {
+    (void) name;
+    (void) options;
+    if (stats) *stats = BLANK_SHM_STATS;
+    fprintf(stderr, RED "Shared memory mode is supported only on Linux\n" RESET_C);
+    return FAIL;
+}
+
+#endif
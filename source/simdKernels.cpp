@@ -0,0 +1,1205 @@
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <stdint.h>
+
+#include "quadrEquation.h"
+#include "simdKernels.h"
+#include "utils.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define X86_KERNELS
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
+
+//kernels store codes as 32-bit integers
+static_assert(sizeof(enum solutionCode) == sizeof(int32_t), "solutionCode must be 32-bit");
+
+
+/*!
+    @brief Branchless version of fixMinusZero() that compiler can inline
+
+    Result is the same as fixMinusZero() for every input, including NaN
+*/
+static inline double fixMinusZeroInline(double num);
+
+
+/// @brief fixMinusZeroInline() for float with EPSILON_F
+static inline float fixMinusZeroInlineF(float num);
+
+
+/*!
+    @brief Portable kernel, solveColumnsPortable() is it's instance for real roots
+
+    @tparam COMPLEX If true, negative discriminant gives COMPLEX_ROOTS like in solveEquationComplex():
+                    real part is doubleRoot and imaginary part is sqrt(|D|) / |2a|, both are computed anyway
+*/
+template <bool COMPLEX>
+static void solveColumnsPortableT(size_t count, const double a[], const double b[], const double c[],
+                                  enum solutionCode code[], double x1[], double x2[]);
+
+
+/// @brief Returns double kernel of specified type for real or complex roots, NULL if it isn't supported
+template <bool COMPLEX>
+static batchKernel_t kernelByType(enum kernelType type);
+
+
+/*!
+    @brief Portable classify kernel: the same codes as solveColumnsPortable(), but without sqrt and divisions
+
+    Also used for tails of SIMD classify kernels
+*/
+static void classifyColumnsPortable(size_t count, const double a[], const double b[], const double c[],
+                                    enum solutionCode code[]);
+
+
+/*!
+    @brief Portable sweep kernel, also used for tails of SIMD sweep kernels
+
+    @tparam B_VARIES If true, b varies and D = v*v - 4ac, else c varies and D = b*b - 4a*v
+    @tparam COMPLEX As in solveColumnsPortableT()
+*/
+template <bool B_VARIES, bool COMPLEX>
+static void solveSweepPortable(size_t first, size_t count, const sweepInvariants_t *sweep,
+                               double value[], enum solutionCode code[], double x1[], double x2[]);
+
+
+/// @brief Returns sweep kernel of specified type, NULL if it isn't supported
+template <bool B_VARIES, bool COMPLEX>
+static sweepKernel_t sweepKernelByType(enum kernelType type);
+
+
+#ifdef X86_KERNELS
+/// @brief Kernel with SSE2 instructions, every x86-64 CPU has them; COMPLEX as in solveColumnsPortableT()
+template <bool COMPLEX>
+static void solveColumnsSSE2(size_t count, const double a[], const double b[], const double c[],
+                             enum solutionCode code[], double x1[], double x2[]);
+
+/// @brief Kernel with AVX2 instructions
+template <bool COMPLEX>
+__attribute__((target("avx2")))
+static void solveColumnsAVX2(size_t count, const double a[], const double b[], const double c[],
+                             enum solutionCode code[], double x1[], double x2[]);
+
+/// @brief Kernel with AVX-512F instructions
+template <bool COMPLEX>
+__attribute__((target("avx512f")))
+static void solveColumnsAVX512(size_t count, const double a[], const double b[], const double c[],
+                               enum solutionCode code[], double x1[], double x2[]);
+
+/// @brief Classify kernel with SSE2 instructions
+static void classifyColumnsSSE2(size_t count, const double a[], const double b[], const double c[],
+                                enum solutionCode code[]);
+
+/// @brief Classify kernel with AVX2 instructions
+__attribute__((target("avx2")))
+static void classifyColumnsAVX2(size_t count, const double a[], const double b[], const double c[],
+                                enum solutionCode code[]);
+
+/// @brief Classify kernel with AVX-512F instructions
+__attribute__((target("avx512f")))
+static void classifyColumnsAVX512(size_t count, const double a[], const double b[], const double c[],
+                                  enum solutionCode code[]);
+
+/// @brief Sweep kernel with SSE2 instructions; B_VARIES and COMPLEX as in solveSweepPortable()
+template <bool B_VARIES, bool COMPLEX>
+static void solveSweepSSE2(size_t first, size_t count, const sweepInvariants_t *sweep,
+                           double value[], enum solutionCode code[], double x1[], double x2[]);
+
+/// @brief Sweep kernel with AVX2 instructions
+template <bool B_VARIES, bool COMPLEX>
+__attribute__((target("avx2")))
+static void solveSweepAVX2(size_t first, size_t count, const sweepInvariants_t *sweep,
+                           double value[], enum solutionCode code[], double x1[], double x2[]);
+
+/// @brief Sweep kernel with AVX-512F instructions
+template <bool B_VARIES, bool COMPLEX>
+__attribute__((target("avx512f")))
+static void solveSweepAVX512(size_t first, size_t count, const sweepInvariants_t *sweep,
+                             double value[], enum solutionCode code[], double x1[], double x2[]);
+
+/// @brief Single-precision kernel with SSE2 instructions
+static void solveColumnsSSE2F(size_t count, const float a[], const float b[], const float c[],
+                              enum solutionCode code[], float x1[], float x2[]);
+
+/// @brief Single-precision kernel with AVX2 instructions
+static void solveColumnsAVX2F(size_t count, const float a[], const float b[], const float c[],
+                              enum solutionCode code[], float x1[], float x2[]);
+
+/// @brief Single-precision kernel with AVX-512F instructions
+static void solveColumnsAVX512F(size_t count, const float a[], const float b[], const float c[],
+                                enum solutionCode code[], float x1[], float x2[]);
+
+/// @brief Returns 1 if OS saves registers specified by mask in XCR0
+static int osSupportsXState(uint64_t mask);
+#endif
+
+/// @brief Checks instruction sets of CPU, cpuid is slow in virtual machines, so it's called once by detectKernelType()
+static enum kernelType queryKernelType();
+
+
+static inline double fixMinusZeroInline(double num) {
+    const double absNum = fabs(num);
+    return (absNum < EPSILON) ? absNum : num;
+}
+
+
+static inline float fixMinusZeroInlineF(float num) {
+    const float absNum = fabsf(num);
+    return (absNum < EPSILON_F) ? absNum : num;
+}
+
+
+void solveColumnsPortable(size_t count, const double a[], const double b[], const double c[],
+                          enum solutionCode code[], double x1[], double x2[]) {
+    solveColumnsPortableT<false>(count, a, b, c, code, x1, x2);
+}
+
+
+template <bool COMPLEX>
+static void solveColumnsPortableT(size_t count, const double a[], const double b[], const double c[],
+                                  enum solutionCode code[], double x1[], double x2[]) {
+    for (size_t i = 0; i < count; i++) {
+        const double ai = a[i], bi = b[i], ci = c[i];
+
+        //fabs(NaN) <= DBL_MAX is false, so this is isfinite() without branches
+        const int finite = (fabs(ai) <= DBL_MAX) & (fabs(bi) <= DBL_MAX) & (fabs(ci) <= DBL_MAX);
+        const int aZero = fabs(ai) < EPSILON,
+                  bZero = fabs(bi) < EPSILON,
+                  cZero = fabs(ci) < EPSILON;
+
+        //every case is computed, unused results are thrown away
+        const double D      = bi*bi - 4*ai*ci;
+        const int    dNeg   = D < 0;
+        const double D_sqrt = sqrt(dNeg ? -D : D); //sqrt of |D| can't fail, NaN D keeps it's sign
+        const double twoA   = 2*ai;
+        const double linearRoot = -ci / bi;
+        const double doubleRoot = -bi / twoA;
+        const double root1 = (-bi - D_sqrt) / twoA;
+        const double root2 = (-bi + D_sqrt) / twoA;
+
+        //same comparisons as in isZero(D) and cmpDouble(D, 0) == -1; NaN D gives TWO_ROOTS
+        const int dZero = fabs(D) < EPSILON;
+
+        //complex roots are doubleRoot +- i*|D_sqrt / twoA|, only one more division
+        const int    negativeCode = COMPLEX ? COMPLEX_ROOTS : ZERO_ROOTS;
+        const double negativeX1   = COMPLEX ? doubleRoot : NAN;
+        const double negativeX2   = COMPLEX ? fabs(D_sqrt / twoA) : NAN;
+
+        const int linearCode    = bZero ? (cZero ? INF_ROOTS : ZERO_ROOTS) : ONE_ROOT;
+        const int quadraticCode = dZero ? ONE_ROOT : (dNeg ? negativeCode : TWO_ROOTS);
+        const int resultCode    = finite ? (aZero ? linearCode : quadraticCode) : BAD_INPUT;
+
+        const double quadraticX1 = dZero ? doubleRoot : (dNeg ? negativeX1 : root1);
+        const double quadraticX2 = dZero ? NAN : (dNeg ? negativeX2 : root2);
+        const double linearX1    = bZero ? NAN : linearRoot;
+
+        const double resultX1 = finite ? (aZero ? linearX1 : quadraticX1) : NAN;
+        const double resultX2 = (finite & !aZero) ? quadraticX2 : NAN;
+
+        code[i] = (enum solutionCode) resultCode;
+        x1[i] = fixMinusZeroInline(resultX1);
+        x2[i] = fixMinusZeroInline(resultX2);
+    }
+}
+
+
+static void classifyColumnsPortable(size_t count, const double a[], const double b[], const double c[],
+                                    enum solutionCode code[]) {
+    for (size_t i = 0; i < count; i++) {
+        const double ai = a[i], bi = b[i], ci = c[i];
+
+        const int finite = (fabs(ai) <= DBL_MAX) & (fabs(bi) <= DBL_MAX) & (fabs(ci) <= DBL_MAX);
+        const int aZero = fabs(ai) < EPSILON,
+                  bZero = fabs(bi) < EPSILON,
+                  cZero = fabs(ci) < EPSILON;
+
+        const double D = bi*bi - 4*ai*ci;
+        const int dNeg  = D < 0;
+        const int dZero = fabs(D) < EPSILON;
+
+        const int linearCode    = bZero ? (cZero ? INF_ROOTS : ZERO_ROOTS) : ONE_ROOT;
+        const int quadraticCode = dZero ? ONE_ROOT : (dNeg ? ZERO_ROOTS : TWO_ROOTS);
+        code[i] = (enum solutionCode) (finite ? (aZero ? linearCode : quadraticCode) : BAD_INPUT);
+    }
+}
+
+
+template <bool B_VARIES, bool COMPLEX>
+static void solveSweepPortable(size_t first, size_t count, const sweepInvariants_t *sweep,
+                               double value[], enum solutionCode code[], double x1[], double x2[]) {
+    const double start = sweep->start, step = sweep->step;
+    const double fixedTerm = sweep->fixedTerm, fourA = sweep->fourA, invTwoA = sweep->invTwoA;
+    for (size_t i = 0; i < count; i++) {
+        //value isn't accumulated, so error doesn't grow along sweep
+        const double v = start + (double) (first + i) * step;
+        const int finite = fabs(v) <= DBL_MAX;
+
+        //the fixed term is rounded as in b*b - 4*a*c, so D has the same bits as in solveEquation()
+        const double D      = B_VARIES ? v*v - fixedTerm : fixedTerm - fourA*v;
+        const int    dNeg   = D < 0;
+        const int    dZero  = fabs(D) < EPSILON;
+        const double D_sqrt = sqrt(dNeg ? -D : D);
+        const double negB   = B_VARIES ? -v : sweep->negB;
+        const double doubleRoot = B_VARIES ? negB * invTwoA : sweep->vertex;
+        const double root1 = (negB - D_sqrt) * invTwoA;
+        const double root2 = (negB + D_sqrt) * invTwoA;
+
+        const int    negativeCode = COMPLEX ? COMPLEX_ROOTS : ZERO_ROOTS;
+        const double negativeX1   = COMPLEX ? doubleRoot : NAN;
+        const double negativeX2   = COMPLEX ? fabs(D_sqrt * invTwoA) : NAN;
+
+        const int    quadraticCode = dZero ? ONE_ROOT : (dNeg ? negativeCode : TWO_ROOTS);
+        const double quadraticX1   = dZero ? doubleRoot : (dNeg ? negativeX1 : root1);
+        const double quadraticX2   = dZero ? NAN : (dNeg ? negativeX2 : root2);
+
+        value[i] = v;
+        code[i] = (enum solutionCode) (finite ? quadraticCode : BAD_INPUT);
+        x1[i] = fixMinusZeroInline(finite ? quadraticX1 : NAN);
+        x2[i] = fixMinusZeroInline(finite ? quadraticX2 : NAN);
+    }
+}
+
+
+void solveColumnsPortableF(size_t count, const float a[], const float b[], const float c[],
+                           enum solutionCode code[], float x1[], float x2[]) {
+    for (size_t i = 0; i < count; i++) {
+        const float ai = a[i], bi = b[i], ci = c[i];
+
+        const int finite = (fabsf(ai) <= FLT_MAX) & (fabsf(bi) <= FLT_MAX) & (fabsf(ci) <= FLT_MAX);
+        const int aZero = fabsf(ai) < EPSILON_F,
+                  bZero = fabsf(bi) < EPSILON_F,
+                  cZero = fabsf(ci) < EPSILON_F;
+
+        const float D      = bi*bi - 4*ai*ci;
+        const int   dNeg   = D < 0;
+        const float D_sqrt = sqrtf(dNeg ? -D : D);
+        const float twoA   = 2*ai;
+        const float linearRoot = -ci / bi;
+        const float doubleRoot = -bi / twoA;
+        const float root1 = (-bi - D_sqrt) / twoA;
+        const float root2 = (-bi + D_sqrt) / twoA;
+
+        const int dZero = fabsf(D) < EPSILON_F;
+
+        const int linearCode    = bZero ? (cZero ? INF_ROOTS : ZERO_ROOTS) : ONE_ROOT;
+        const int quadraticCode = dZero ? ONE_ROOT : (dNeg ? ZERO_ROOTS : TWO_ROOTS);
+        const int resultCode    = finite ? (aZero ? linearCode : quadraticCode) : BAD_INPUT;
+
+        const float quadraticX1 = dZero ? doubleRoot : (dNeg ? NAN : root1);
+        const float quadraticX2 = (dZero | dNeg) ? NAN : root2;
+        const float linearX1    = bZero ? NAN : linearRoot;
+
+        const float resultX1 = finite ? (aZero ? linearX1 : quadraticX1) : NAN;
+        const float resultX2 = (finite & !aZero) ? quadraticX2 : NAN;
+
+        code[i] = (enum solutionCode) resultCode;
+        x1[i] = fixMinusZeroInlineF(resultX1);
+        x2[i] = fixMinusZeroInlineF(resultX2);
+    }
+}
+
+
+#ifdef X86_KERNELS
+
+/// @brief select for SSE2: takes b where mask is set, else a
+#define SSE2_SELECT(mask, a, b) _mm_or_pd(_mm_and_pd((mask), (b)), _mm_andnot_pd((mask), (a)))
+
+template <bool COMPLEX>
+static void solveColumnsSSE2(size_t count, const double a[], const double b[], const double c[],
+                             enum solutionCode code[], double x1[], double x2[]) {
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d maxDouble = _mm_set1_pd(DBL_MAX), eps = _mm_set1_pd(EPSILON);
+    const __m128d zero = _mm_setzero_pd(), two = _mm_set1_pd(2), four = _mm_set1_pd(4), nan = _mm_set1_pd(NAN);
+    const __m128d zeroRoots = _mm_set1_pd(ZERO_ROOTS), oneRoot  = _mm_set1_pd(ONE_ROOT),
+                  twoRoots  = _mm_set1_pd(TWO_ROOTS),  infRoots = _mm_set1_pd(INF_ROOTS),
+                  badInput  = _mm_set1_pd(BAD_INPUT);
+    const __m128d negativeCode = _mm_set1_pd(COMPLEX ? COMPLEX_ROOTS : ZERO_ROOTS);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d va = _mm_loadu_pd(a + i), vb = _mm_loadu_pd(b + i), vc = _mm_loadu_pd(c + i);
+        const __m128d absA = _mm_andnot_pd(signMask, va),
+                      absB = _mm_andnot_pd(signMask, vb),
+                      absC = _mm_andnot_pd(signMask, vc);
+
+        const __m128d finite = _mm_and_pd(_mm_cmple_pd(absA, maxDouble),
+                               _mm_and_pd(_mm_cmple_pd(absB, maxDouble), _mm_cmple_pd(absC, maxDouble)));
+        const __m128d aZero = _mm_cmplt_pd(absA, eps),
+                      bZero = _mm_cmplt_pd(absB, eps),
+                      cZero = _mm_cmplt_pd(absC, eps);
+
+        const __m128d D = _mm_sub_pd(_mm_mul_pd(vb, vb), _mm_mul_pd(_mm_mul_pd(four, va), vc));
+        const __m128d dNeg = _mm_cmplt_pd(D, zero);
+        const __m128d dZero = _mm_cmplt_pd(_mm_andnot_pd(signMask, D), eps);
+        const __m128d D_sqrt = _mm_sqrt_pd(_mm_xor_pd(D, _mm_and_pd(dNeg, signMask)));
+
+        const __m128d twoA = _mm_mul_pd(two, va);
+        const __m128d negB = _mm_xor_pd(vb, signMask);
+        const __m128d linearRoot = _mm_div_pd(_mm_xor_pd(vc, signMask), vb);
+        const __m128d doubleRoot = _mm_div_pd(negB, twoA);
+        const __m128d root1 = _mm_div_pd(_mm_sub_pd(negB, D_sqrt), twoA);
+        const __m128d root2 = _mm_div_pd(_mm_add_pd(negB, D_sqrt), twoA);
+
+        const __m128d negativeX1 = COMPLEX ? doubleRoot : nan;
+        const __m128d negativeX2 = COMPLEX ? _mm_andnot_pd(signMask, _mm_div_pd(D_sqrt, twoA)) : nan;
+
+        const __m128d linearCode    = SSE2_SELECT(bZero, oneRoot, SSE2_SELECT(cZero, zeroRoots, infRoots));
+        const __m128d quadraticCode = SSE2_SELECT(dZero, SSE2_SELECT(dNeg, twoRoots, negativeCode), oneRoot);
+        const __m128d resultCode    = SSE2_SELECT(finite, badInput, SSE2_SELECT(aZero, quadraticCode, linearCode));
+
+        const __m128d quadraticX1 = SSE2_SELECT(dZero, SSE2_SELECT(dNeg, root1, negativeX1), doubleRoot);
+        const __m128d quadraticX2 = SSE2_SELECT(dZero, SSE2_SELECT(dNeg, root2, negativeX2), nan);
+        const __m128d linearX1    = SSE2_SELECT(bZero, linearRoot, nan);
+
+        __m128d resultX1 = SSE2_SELECT(finite, nan, SSE2_SELECT(aZero, quadraticX1, linearX1));
+        __m128d resultX2 = SSE2_SELECT(_mm_andnot_pd(aZero, finite), nan, quadraticX2);
+
+        const __m128d absX1 = _mm_andnot_pd(signMask, resultX1), absX2 = _mm_andnot_pd(signMask, resultX2);
+        resultX1 = SSE2_SELECT(_mm_cmplt_pd(absX1, eps), resultX1, absX1);
+        resultX2 = SSE2_SELECT(_mm_cmplt_pd(absX2, eps), resultX2, absX2);
+
+        _mm_storel_epi64((__m128i*) (code + i), _mm_cvtpd_epi32(resultCode));
+        _mm_storeu_pd(x1 + i, resultX1);
+        _mm_storeu_pd(x2 + i, resultX2);
+    }
+    solveColumnsPortableT<COMPLEX>(count - i, a + i, b + i, c + i, code + i, x1 + i, x2 + i);
+}
+
+
+static void classifyColumnsSSE2(size_t count, const double a[], const double b[], const double c[],
+                                enum solutionCode code[]) {
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d maxDouble = _mm_set1_pd(DBL_MAX), eps = _mm_set1_pd(EPSILON);
+    const __m128d zero = _mm_setzero_pd(), four = _mm_set1_pd(4);
+    const __m128d zeroRoots = _mm_set1_pd(ZERO_ROOTS), oneRoot  = _mm_set1_pd(ONE_ROOT),
+                  twoRoots  = _mm_set1_pd(TWO_ROOTS),  infRoots = _mm_set1_pd(INF_ROOTS),
+                  badInput  = _mm_set1_pd(BAD_INPUT);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d va = _mm_loadu_pd(a + i), vb = _mm_loadu_pd(b + i), vc = _mm_loadu_pd(c + i);
+        const __m128d absA = _mm_andnot_pd(signMask, va),
+                      absB = _mm_andnot_pd(signMask, vb),
+                      absC = _mm_andnot_pd(signMask, vc);
+
+        const __m128d finite = _mm_and_pd(_mm_cmple_pd(absA, maxDouble),
+                               _mm_and_pd(_mm_cmple_pd(absB, maxDouble), _mm_cmple_pd(absC, maxDouble)));
+        const __m128d aZero = _mm_cmplt_pd(absA, eps),
+                      bZero = _mm_cmplt_pd(absB, eps),
+                      cZero = _mm_cmplt_pd(absC, eps);
+
+        const __m128d D = _mm_sub_pd(_mm_mul_pd(vb, vb), _mm_mul_pd(_mm_mul_pd(four, va), vc));
+        const __m128d dNeg = _mm_cmplt_pd(D, zero);
+        const __m128d dZero = _mm_cmplt_pd(_mm_andnot_pd(signMask, D), eps);
+
+        const __m128d linearCode    = SSE2_SELECT(bZero, oneRoot, SSE2_SELECT(cZero, zeroRoots, infRoots));
+        const __m128d quadraticCode = SSE2_SELECT(dZero, SSE2_SELECT(dNeg, twoRoots, zeroRoots), oneRoot);
+        const __m128d resultCode    = SSE2_SELECT(finite, badInput, SSE2_SELECT(aZero, quadraticCode, linearCode));
+
+        _mm_storel_epi64((__m128i*) (code + i), _mm_cvtpd_epi32(resultCode));
+    }
+    classifyColumnsPortable(count - i, a + i, b + i, c + i, code + i);
+}
+
+template <bool B_VARIES, bool COMPLEX>
+static void solveSweepSSE2(size_t first, size_t count, const sweepInvariants_t *sweep,
+                           double value[], enum solutionCode code[], double x1[], double x2[]) {
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d maxDouble = _mm_set1_pd(DBL_MAX), eps = _mm_set1_pd(EPSILON);
+    const __m128d zero = _mm_setzero_pd(), nan = _mm_set1_pd(NAN);
+    const __m128d oneRoot = _mm_set1_pd(ONE_ROOT), twoRoots = _mm_set1_pd(TWO_ROOTS), badInput = _mm_set1_pd(BAD_INPUT);
+    const __m128d negativeCode = _mm_set1_pd(COMPLEX ? COMPLEX_ROOTS : ZERO_ROOTS);
+    const __m128d start = _mm_set1_pd(sweep->start), step = _mm_set1_pd(sweep->step);
+    const __m128d fixedTerm = _mm_set1_pd(sweep->fixedTerm), fourA = _mm_set1_pd(sweep->fourA);
+    const __m128d fixedNegB = _mm_set1_pd(sweep->negB), vertex = _mm_set1_pd(sweep->vertex);
+    const __m128d invTwoA = _mm_set1_pd(sweep->invTwoA);
+
+    //indices are whole numbers below 2^53, so they are exact in double
+    __m128d index = _mm_add_pd(_mm_set1_pd((double) first), _mm_set_pd(1, 0));
+    const __m128d width = _mm_set1_pd(2);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d v = _mm_add_pd(start, _mm_mul_pd(index, step));
+        index = _mm_add_pd(index, width);
+        const __m128d finite = _mm_cmple_pd(_mm_andnot_pd(signMask, v), maxDouble);
+
+        const __m128d D = B_VARIES ? _mm_sub_pd(_mm_mul_pd(v, v), fixedTerm) : _mm_sub_pd(fixedTerm, _mm_mul_pd(fourA, v));
+        const __m128d dNeg = _mm_cmplt_pd(D, zero);
+        const __m128d dZero = _mm_cmplt_pd(_mm_andnot_pd(signMask, D), eps);
+        const __m128d D_sqrt = _mm_sqrt_pd(_mm_xor_pd(D, _mm_and_pd(dNeg, signMask)));
+
+        const __m128d negB = B_VARIES ? _mm_xor_pd(v, signMask) : fixedNegB;
+        const __m128d doubleRoot = B_VARIES ? _mm_mul_pd(negB, invTwoA) : vertex;
+        const __m128d root1 = _mm_mul_pd(_mm_sub_pd(negB, D_sqrt), invTwoA);
+        const __m128d root2 = _mm_mul_pd(_mm_add_pd(negB, D_sqrt), invTwoA);
+
+        const __m128d negativeX1 = COMPLEX ? doubleRoot : nan;
+        const __m128d negativeX2 = COMPLEX ? _mm_andnot_pd(signMask, _mm_mul_pd(D_sqrt, invTwoA)) : nan;
+
+        const __m128d quadraticCode = SSE2_SELECT(dZero, SSE2_SELECT(dNeg, twoRoots, negativeCode), oneRoot);
+        const __m128d resultCode    = SSE2_SELECT(finite, badInput, quadraticCode);
+
+        __m128d resultX1 = SSE2_SELECT(finite, nan, SSE2_SELECT(dZero, SSE2_SELECT(dNeg, root1, negativeX1), doubleRoot));
+        __m128d resultX2 = SSE2_SELECT(finite, nan, SSE2_SELECT(dZero, SSE2_SELECT(dNeg, root2, negativeX2), nan));
+
+        const __m128d absX1 = _mm_andnot_pd(signMask, resultX1), absX2 = _mm_andnot_pd(signMask, resultX2);
+        resultX1 = SSE2_SELECT(_mm_cmplt_pd(absX1, eps), resultX1, absX1);
+        resultX2 = SSE2_SELECT(_mm_cmplt_pd(absX2, eps), resultX2, absX2);
+
+        _mm_storeu_pd(value + i, v);
+        _mm_storel_epi64((__m128i*) (code + i), _mm_cvtpd_epi32(resultCode));
+        _mm_storeu_pd(x1 + i, resultX1);
+        _mm_storeu_pd(x2 + i, resultX2);
+    }
+    solveSweepPortable<B_VARIES, COMPLEX>(first + i, count - i, sweep, value + i, code + i, x1 + i, x2 + i);
+}
+
+#undef SSE2_SELECT
+
+
+template <bool COMPLEX>
+__attribute__((target("avx2")))
+static void solveColumnsAVX2(size_t count, const double a[], const double b[], const double c[],
+                             enum solutionCode code[], double x1[], double x2[]) {
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d maxDouble = _mm256_set1_pd(DBL_MAX), eps = _mm256_set1_pd(EPSILON);
+    const __m256d zero = _mm256_setzero_pd(), two = _mm256_set1_pd(2), four = _mm256_set1_pd(4);
+    const __m256d nan = _mm256_set1_pd(NAN);
+    const __m256d zeroRoots = _mm256_set1_pd(ZERO_ROOTS), oneRoot  = _mm256_set1_pd(ONE_ROOT),
+                  twoRoots  = _mm256_set1_pd(TWO_ROOTS),  infRoots = _mm256_set1_pd(INF_ROOTS),
+                  badInput  = _mm256_set1_pd(BAD_INPUT);
+    const __m256d negativeCode = _mm256_set1_pd(COMPLEX ? COMPLEX_ROOTS : ZERO_ROOTS);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d va = _mm256_loadu_pd(a + i), vb = _mm256_loadu_pd(b + i), vc = _mm256_loadu_pd(c + i);
+        const __m256d absA = _mm256_andnot_pd(signMask, va),
+                      absB = _mm256_andnot_pd(signMask, vb),
+                      absC = _mm256_andnot_pd(signMask, vc);
+
+        const __m256d finite = _mm256_and_pd(_mm256_cmp_pd(absA, maxDouble, _CMP_LE_OQ),
+                               _mm256_and_pd(_mm256_cmp_pd(absB, maxDouble, _CMP_LE_OQ),
+                                             _mm256_cmp_pd(absC, maxDouble, _CMP_LE_OQ)));
+        const __m256d aZero = _mm256_cmp_pd(absA, eps, _CMP_LT_OQ),
+                      bZero = _mm256_cmp_pd(absB, eps, _CMP_LT_OQ),
+                      cZero = _mm256_cmp_pd(absC, eps, _CMP_LT_OQ);
+
+        //no fma here: b*b - 4ac must be rounded exactly like in scalar solver
+        const __m256d D = _mm256_sub_pd(_mm256_mul_pd(vb, vb), _mm256_mul_pd(_mm256_mul_pd(four, va), vc));
+        const __m256d dNeg = _mm256_cmp_pd(D, zero, _CMP_LT_OQ);
+        const __m256d dZero = _mm256_cmp_pd(_mm256_andnot_pd(signMask, D), eps, _CMP_LT_OQ);
+        const __m256d D_sqrt = _mm256_sqrt_pd(_mm256_xor_pd(D, _mm256_and_pd(dNeg, signMask)));
+
+        const __m256d twoA = _mm256_mul_pd(two, va);
+        const __m256d negB = _mm256_xor_pd(vb, signMask);
+        const __m256d linearRoot = _mm256_div_pd(_mm256_xor_pd(vc, signMask), vb);
+        const __m256d doubleRoot = _mm256_div_pd(negB, twoA);
+        const __m256d root1 = _mm256_div_pd(_mm256_sub_pd(negB, D_sqrt), twoA);
+        const __m256d root2 = _mm256_div_pd(_mm256_add_pd(negB, D_sqrt), twoA);
+
+        const __m256d negativeX1 = COMPLEX ? doubleRoot : nan;
+        const __m256d negativeX2 = COMPLEX ? _mm256_andnot_pd(signMask, _mm256_div_pd(D_sqrt, twoA)) : nan;
+
+        //blendv takes second argument where mask is set
+        const __m256d linearCode    = _mm256_blendv_pd(oneRoot, _mm256_blendv_pd(zeroRoots, infRoots, cZero), bZero);
+        const __m256d quadraticCode = _mm256_blendv_pd(_mm256_blendv_pd(twoRoots, negativeCode, dNeg), oneRoot, dZero);
+        const __m256d resultCode    = _mm256_blendv_pd(badInput,
+                                                       _mm256_blendv_pd(quadraticCode, linearCode, aZero), finite);
+
+        const __m256d quadraticX1 = _mm256_blendv_pd(_mm256_blendv_pd(root1, negativeX1, dNeg), doubleRoot, dZero);
+        const __m256d quadraticX2 = _mm256_blendv_pd(_mm256_blendv_pd(root2, negativeX2, dNeg), nan, dZero);
+        const __m256d linearX1    = _mm256_blendv_pd(linearRoot, nan, bZero);
+
+        __m256d resultX1 = _mm256_blendv_pd(nan, _mm256_blendv_pd(quadraticX1, linearX1, aZero), finite);
+        __m256d resultX2 = _mm256_blendv_pd(nan, quadraticX2, _mm256_andnot_pd(aZero, finite));
+
+        const __m256d absX1 = _mm256_andnot_pd(signMask, resultX1), absX2 = _mm256_andnot_pd(signMask, resultX2);
+        resultX1 = _mm256_blendv_pd(resultX1, absX1, _mm256_cmp_pd(absX1, eps, _CMP_LT_OQ));
+        resultX2 = _mm256_blendv_pd(resultX2, absX2, _mm256_cmp_pd(absX2, eps, _CMP_LT_OQ));
+
+        _mm_storeu_si128((__m128i*) (code + i), _mm256_cvtpd_epi32(resultCode));
+        _mm256_storeu_pd(x1 + i, resultX1);
+        _mm256_storeu_pd(x2 + i, resultX2);
+    }
+    solveColumnsPortableT<COMPLEX>(count - i, a + i, b + i, c + i, code + i, x1 + i, x2 + i);
+}
+
+
+__attribute__((target("avx2")))
+static void classifyColumnsAVX2(size_t count, const double a[], const double b[], const double c[],
+                                enum solutionCode code[]) {
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d maxDouble = _mm256_set1_pd(DBL_MAX), eps = _mm256_set1_pd(EPSILON);
+    const __m256d zero = _mm256_setzero_pd(), four = _mm256_set1_pd(4);
+    const __m256d zeroRoots = _mm256_set1_pd(ZERO_ROOTS), oneRoot  = _mm256_set1_pd(ONE_ROOT),
+                  twoRoots  = _mm256_set1_pd(TWO_ROOTS),  infRoots = _mm256_set1_pd(INF_ROOTS),
+                  badInput  = _mm256_set1_pd(BAD_INPUT);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d va = _mm256_loadu_pd(a + i), vb = _mm256_loadu_pd(b + i), vc = _mm256_loadu_pd(c + i);
+        const __m256d absA = _mm256_andnot_pd(signMask, va),
+                      absB = _mm256_andnot_pd(signMask, vb),
+                      absC = _mm256_andnot_pd(signMask, vc);
+
+        const __m256d finite = _mm256_and_pd(_mm256_cmp_pd(absA, maxDouble, _CMP_LE_OQ),
+                               _mm256_and_pd(_mm256_cmp_pd(absB, maxDouble, _CMP_LE_OQ),
+                                             _mm256_cmp_pd(absC, maxDouble, _CMP_LE_OQ)));
+        const __m256d aZero = _mm256_cmp_pd(absA, eps, _CMP_LT_OQ),
+                      bZero = _mm256_cmp_pd(absB, eps, _CMP_LT_OQ),
+                      cZero = _mm256_cmp_pd(absC, eps, _CMP_LT_OQ);
+
+        //no fma here: b*b - 4ac must be rounded exactly like in scalar solver
+        const __m256d D = _mm256_sub_pd(_mm256_mul_pd(vb, vb), _mm256_mul_pd(_mm256_mul_pd(four, va), vc));
+        const __m256d dNeg = _mm256_cmp_pd(D, zero, _CMP_LT_OQ);
+        const __m256d dZero = _mm256_cmp_pd(_mm256_andnot_pd(signMask, D), eps, _CMP_LT_OQ);
+
+        const __m256d linearCode    = _mm256_blendv_pd(oneRoot, _mm256_blendv_pd(zeroRoots, infRoots, cZero), bZero);
+        const __m256d quadraticCode = _mm256_blendv_pd(_mm256_blendv_pd(twoRoots, zeroRoots, dNeg), oneRoot, dZero);
+        const __m256d resultCode    = _mm256_blendv_pd(badInput,
+                                                       _mm256_blendv_pd(quadraticCode, linearCode, aZero), finite);
+
+        _mm_storeu_si128((__m128i*) (code + i), _mm256_cvtpd_epi32(resultCode));
+    }
+    classifyColumnsPortable(count - i, a + i, b + i, c + i, code + i);
+}
+
+
+template <bool B_VARIES, bool COMPLEX>
+__attribute__((target("avx2")))
+static void solveSweepAVX2(size_t first, size_t count, const sweepInvariants_t *sweep,
+                           double value[], enum solutionCode code[], double x1[], double x2[]) {
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    const __m256d maxDouble = _mm256_set1_pd(DBL_MAX), eps = _mm256_set1_pd(EPSILON);
+    const __m256d zero = _mm256_setzero_pd(), nan = _mm256_set1_pd(NAN);
+    const __m256d oneRoot  = _mm256_set1_pd(ONE_ROOT), twoRoots = _mm256_set1_pd(TWO_ROOTS),
+                  badInput = _mm256_set1_pd(BAD_INPUT);
+    const __m256d negativeCode = _mm256_set1_pd(COMPLEX ? COMPLEX_ROOTS : ZERO_ROOTS);
+    const __m256d start = _mm256_set1_pd(sweep->start), step = _mm256_set1_pd(sweep->step);
+    const __m256d fixedTerm = _mm256_set1_pd(sweep->fixedTerm), fourA = _mm256_set1_pd(sweep->fourA);
+    const __m256d fixedNegB = _mm256_set1_pd(sweep->negB), vertex = _mm256_set1_pd(sweep->vertex);
+    const __m256d invTwoA = _mm256_set1_pd(sweep->invTwoA);
+
+    __m256d index = _mm256_add_pd(_mm256_set1_pd((double) first), _mm256_set_pd(3, 2, 1, 0));
+    const __m256d width = _mm256_set1_pd(4);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        //no fma here: values and D must be rounded exactly like in portable kernel
+        const __m256d v = _mm256_add_pd(start, _mm256_mul_pd(index, step));
+        index = _mm256_add_pd(index, width);
+        const __m256d finite = _mm256_cmp_pd(_mm256_andnot_pd(signMask, v), maxDouble, _CMP_LE_OQ);
+
+        const __m256d D = B_VARIES ? _mm256_sub_pd(_mm256_mul_pd(v, v), fixedTerm)
+                                   : _mm256_sub_pd(fixedTerm, _mm256_mul_pd(fourA, v));
+        const __m256d dNeg = _mm256_cmp_pd(D, zero, _CMP_LT_OQ);
+        const __m256d dZero = _mm256_cmp_pd(_mm256_andnot_pd(signMask, D), eps, _CMP_LT_OQ);
+        const __m256d D_sqrt = _mm256_sqrt_pd(_mm256_xor_pd(D, _mm256_and_pd(dNeg, signMask)));
+
+        const __m256d negB = B_VARIES ? _mm256_xor_pd(v, signMask) : fixedNegB;
+        const __m256d doubleRoot = B_VARIES ? _mm256_mul_pd(negB, invTwoA) : vertex;
+        const __m256d root1 = _mm256_mul_pd(_mm256_sub_pd(negB, D_sqrt), invTwoA);
+        const __m256d root2 = _mm256_mul_pd(_mm256_add_pd(negB, D_sqrt), invTwoA);
+
+        const __m256d negativeX1 = COMPLEX ? doubleRoot : nan;
+        const __m256d negativeX2 = COMPLEX ? _mm256_andnot_pd(signMask, _mm256_mul_pd(D_sqrt, invTwoA)) : nan;
+
+        const __m256d quadraticCode = _mm256_blendv_pd(_mm256_blendv_pd(twoRoots, negativeCode, dNeg), oneRoot, dZero);
+        const __m256d resultCode    = _mm256_blendv_pd(badInput, quadraticCode, finite);
+
+        __m256d resultX1 = _mm256_blendv_pd(nan, _mm256_blendv_pd(_mm256_blendv_pd(root1, negativeX1, dNeg),
+                                                                  doubleRoot, dZero), finite);
+        __m256d resultX2 = _mm256_blendv_pd(nan, _mm256_blendv_pd(_mm256_blendv_pd(root2, negativeX2, dNeg),
+                                                                  nan, dZero), finite);
+
+        const __m256d absX1 = _mm256_andnot_pd(signMask, resultX1), absX2 = _mm256_andnot_pd(signMask, resultX2);
+        resultX1 = _mm256_blendv_pd(resultX1, absX1, _mm256_cmp_pd(absX1, eps, _CMP_LT_OQ));
+        resultX2 = _mm256_blendv_pd(resultX2, absX2, _mm256_cmp_pd(absX2, eps, _CMP_LT_OQ));
+
+        _mm256_storeu_pd(value + i, v);
+        _mm_storeu_si128((__m128i*) (code + i), _mm256_cvtpd_epi32(resultCode));
+        _mm256_storeu_pd(x1 + i, resultX1);
+        _mm256_storeu_pd(x2 + i, resultX2);
+    }
+    solveSweepPortable<B_VARIES, COMPLEX>(first + i, count - i, sweep, value + i, code + i, x1 + i, x2 + i);
+}
+
+
+/// @brief fixMinusZero() for 8 numbers
+__attribute__((target("avx512f")))
+static inline __m512d fixMinusZeroAVX512(__m512d num) {
+    const __m512d absNum = _mm512_abs_pd(num);
+    return _mm512_mask_mov_pd(num, _mm512_cmp_pd_mask(absNum, _mm512_set1_pd(EPSILON), _CMP_LT_OQ), absNum);
+}
+
+
+/// @brief Selects exit codes of 8 equations with masks of special cases and stores them, D < 0 gets negativeCode
+__attribute__((target("avx512f")))
+static inline void storeCodesAVX512(enum solutionCode code[], __mmask8 finite, __mmask8 linearOneRoot,
+                                    __mmask8 linearNoRoots, __mmask8 linearInfRoots, __mmask8 dNeg, __mmask8 dZero,
+                                    enum solutionCode negativeCode) {
+    //masked moves are applied from general case to special ones, so the last matching mask wins
+    __m512i resultCode = _mm512_set1_epi64(TWO_ROOTS);
+    resultCode = _mm512_mask_mov_epi64(resultCode, dNeg, _mm512_set1_epi64(negativeCode));
+    resultCode = _mm512_mask_mov_epi64(resultCode, dZero, _mm512_set1_epi64(ONE_ROOT));
+    resultCode = _mm512_mask_mov_epi64(resultCode, linearOneRoot, _mm512_set1_epi64(ONE_ROOT));
+    resultCode = _mm512_mask_mov_epi64(resultCode, linearNoRoots, _mm512_set1_epi64(ZERO_ROOTS));
+    resultCode = _mm512_mask_mov_epi64(resultCode, linearInfRoots, _mm512_set1_epi64(INF_ROOTS));
+    resultCode = _mm512_mask_mov_epi64(resultCode, (__mmask8) ~finite, _mm512_set1_epi64(BAD_INPUT));
+    //masked forms with defined source, unmasked ones use undefined register that gcc reports as uninitialized
+    _mm256_storeu_si256((__m256i*) code, _mm512_mask_cvtepi64_epi32(_mm256_setzero_si256(), 0xFF, resultCode));
+}
+
+
+template <bool COMPLEX>
+__attribute__((target("avx512f")))
+static void solveColumnsAVX512(size_t count, const double a[], const double b[], const double c[],
+                               enum solutionCode code[], double x1[], double x2[]) {
+    const __m512d maxDouble = _mm512_set1_pd(DBL_MAX), eps = _mm512_set1_pd(EPSILON);
+    const __m512d zero = _mm512_setzero_pd(), two = _mm512_set1_pd(2), four = _mm512_set1_pd(4);
+    const __m512d nan = _mm512_set1_pd(NAN);
+    const __m512i signBit = _mm512_set1_epi64(INT64_MIN);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512d va = _mm512_loadu_pd(a + i), vb = _mm512_loadu_pd(b + i), vc = _mm512_loadu_pd(c + i);
+        const __m512d absA = _mm512_abs_pd(va), absB = _mm512_abs_pd(vb), absC = _mm512_abs_pd(vc);
+
+        const __mmask8 finite = _mm512_cmp_pd_mask(absA, maxDouble, _CMP_LE_OQ)
+                              & _mm512_cmp_pd_mask(absB, maxDouble, _CMP_LE_OQ)
+                              & _mm512_cmp_pd_mask(absC, maxDouble, _CMP_LE_OQ);
+        const __mmask8 aZero = _mm512_cmp_pd_mask(absA, eps, _CMP_LT_OQ),
+                       bZero = _mm512_cmp_pd_mask(absB, eps, _CMP_LT_OQ),
+                       cZero = _mm512_cmp_pd_mask(absC, eps, _CMP_LT_OQ);
+
+        //no fma here: b*b - 4ac must be rounded exactly like in scalar solver
+        const __m512d D = _mm512_sub_pd(_mm512_mul_pd(vb, vb), _mm512_mul_pd(_mm512_mul_pd(four, va), vc));
+        const __mmask8 dNeg  = _mm512_cmp_pd_mask(D, zero, _CMP_LT_OQ);
+        const __mmask8 dZero = _mm512_cmp_pd_mask(_mm512_abs_pd(D), eps, _CMP_LT_OQ);
+        const __m512d D_sqrt = _mm512_mask_sqrt_pd(zero, 0xFF, _mm512_mask_sub_pd(D, dNeg, zero, D));
+
+        const __m512d twoA = _mm512_mul_pd(two, va);
+        //sign is flipped with xor, so -0 stays -0 as in scalar solver
+        const __m512d negB = _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(vb), signBit));
+        const __m512d negC = _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(vc), signBit));
+        const __m512d linearRoot = _mm512_div_pd(negC, vb);
+        const __m512d doubleRoot = _mm512_div_pd(negB, twoA);
+        const __m512d root1 = _mm512_div_pd(_mm512_sub_pd(negB, D_sqrt), twoA);
+        const __m512d root2 = _mm512_div_pd(_mm512_add_pd(negB, D_sqrt), twoA);
+
+        const __mmask8 linear = aZero, linearNoRoots = (__mmask8) (aZero & bZero);
+        storeCodesAVX512(code + i, finite, linear, linearNoRoots, (__mmask8) (linearNoRoots & cZero), dNeg, dZero,
+                         COMPLEX ? COMPLEX_ROOTS : ZERO_ROOTS);
+
+        //masked moves are applied from general case to special ones, so the last matching mask wins
+        __m512d resultX1 = _mm512_mask_mov_pd(root1, dNeg, COMPLEX ? doubleRoot : nan);
+        resultX1 = _mm512_mask_mov_pd(resultX1, dZero, doubleRoot);
+        resultX1 = _mm512_mask_mov_pd(resultX1, linear, linearRoot);
+        resultX1 = _mm512_mask_mov_pd(resultX1, (__mmask8) (linearNoRoots | ~finite), nan);
+
+        __m512d resultX2 = root2;
+        if (COMPLEX)
+            resultX2 = _mm512_mask_mov_pd(root2, dNeg, _mm512_abs_pd(_mm512_div_pd(D_sqrt, twoA)));
+        resultX2 = _mm512_mask_mov_pd(resultX2, (__mmask8) (dZero | (COMPLEX ? 0 : dNeg) | linear | ~finite), nan);
+
+        _mm512_storeu_pd(x1 + i, fixMinusZeroAVX512(resultX1));
+        _mm512_storeu_pd(x2 + i, fixMinusZeroAVX512(resultX2));
+    }
+    solveColumnsPortableT<COMPLEX>(count - i, a + i, b + i, c + i, code + i, x1 + i, x2 + i);
+}
+
+
+__attribute__((target("avx512f")))
+static void classifyColumnsAVX512(size_t count, const double a[], const double b[], const double c[],
+                                  enum solutionCode code[]) {
+    const __m512d maxDouble = _mm512_set1_pd(DBL_MAX), eps = _mm512_set1_pd(EPSILON);
+    const __m512d zero = _mm512_setzero_pd(), four = _mm512_set1_pd(4);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512d va = _mm512_loadu_pd(a + i), vb = _mm512_loadu_pd(b + i), vc = _mm512_loadu_pd(c + i);
+        const __m512d absA = _mm512_abs_pd(va), absB = _mm512_abs_pd(vb), absC = _mm512_abs_pd(vc);
+
+        const __mmask8 finite = _mm512_cmp_pd_mask(absA, maxDouble, _CMP_LE_OQ)
+                              & _mm512_cmp_pd_mask(absB, maxDouble, _CMP_LE_OQ)
+                              & _mm512_cmp_pd_mask(absC, maxDouble, _CMP_LE_OQ);
+        const __mmask8 aZero = _mm512_cmp_pd_mask(absA, eps, _CMP_LT_OQ),
+                       bZero = _mm512_cmp_pd_mask(absB, eps, _CMP_LT_OQ),
+                       cZero = _mm512_cmp_pd_mask(absC, eps, _CMP_LT_OQ);
+
+        //no fma here: b*b - 4ac must be rounded exactly like in scalar solver
+        const __m512d D = _mm512_sub_pd(_mm512_mul_pd(vb, vb), _mm512_mul_pd(_mm512_mul_pd(four, va), vc));
+        const __mmask8 dNeg  = _mm512_cmp_pd_mask(D, zero, _CMP_LT_OQ);
+        const __mmask8 dZero = _mm512_cmp_pd_mask(_mm512_abs_pd(D), eps, _CMP_LT_OQ);
+
+        const __mmask8 linearNoRoots = (__mmask8) (aZero & bZero);
+        storeCodesAVX512(code + i, finite, aZero, linearNoRoots, (__mmask8) (linearNoRoots & cZero), dNeg, dZero,
+                         ZERO_ROOTS);
+    }
+    classifyColumnsPortable(count - i, a + i, b + i, c + i, code + i);
+}
+
+
+template <bool B_VARIES, bool COMPLEX>
+__attribute__((target("avx512f")))
+static void solveSweepAVX512(size_t first, size_t count, const sweepInvariants_t *sweep,
+                             double value[], enum solutionCode code[], double x1[], double x2[]) {
+    const __m512d maxDouble = _mm512_set1_pd(DBL_MAX), eps = _mm512_set1_pd(EPSILON);
+    const __m512d zero = _mm512_setzero_pd(), nan = _mm512_set1_pd(NAN);
+    const __m512i signBit = _mm512_set1_epi64(INT64_MIN);
+    const __m512d start = _mm512_set1_pd(sweep->start), step = _mm512_set1_pd(sweep->step);
+    const __m512d fixedTerm = _mm512_set1_pd(sweep->fixedTerm), fourA = _mm512_set1_pd(sweep->fourA);
+    const __m512d fixedNegB = _mm512_set1_pd(sweep->negB), vertex = _mm512_set1_pd(sweep->vertex);
+    const __m512d invTwoA = _mm512_set1_pd(sweep->invTwoA);
+
+    __m512d index = _mm512_add_pd(_mm512_set1_pd((double) first), _mm512_set_pd(7, 6, 5, 4, 3, 2, 1, 0));
+    const __m512d width = _mm512_set1_pd(8);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        //no fma here: values and D must be rounded exactly like in portable kernel
+        const __m512d v = _mm512_add_pd(start, _mm512_mul_pd(index, step));
+        index = _mm512_add_pd(index, width);
+        const __mmask8 finite = _mm512_cmp_pd_mask(_mm512_abs_pd(v), maxDouble, _CMP_LE_OQ);
+
+        const __m512d D = B_VARIES ? _mm512_sub_pd(_mm512_mul_pd(v, v), fixedTerm)
+                                   : _mm512_sub_pd(fixedTerm, _mm512_mul_pd(fourA, v));
+        const __mmask8 dNeg  = _mm512_cmp_pd_mask(D, zero, _CMP_LT_OQ);
+        const __mmask8 dZero = _mm512_cmp_pd_mask(_mm512_abs_pd(D), eps, _CMP_LT_OQ);
+        const __m512d D_sqrt = _mm512_mask_sqrt_pd(zero, 0xFF, _mm512_mask_sub_pd(D, dNeg, zero, D));
+
+        const __m512d negB = B_VARIES ? _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(v), signBit))
+                                      : fixedNegB;
+        const __m512d doubleRoot = B_VARIES ? _mm512_mul_pd(negB, invTwoA) : vertex;
+        const __m512d root1 = _mm512_mul_pd(_mm512_sub_pd(negB, D_sqrt), invTwoA);
+        const __m512d root2 = _mm512_mul_pd(_mm512_add_pd(negB, D_sqrt), invTwoA);
+
+        storeCodesAVX512(code + i, finite, 0, 0, 0, dNeg, dZero, COMPLEX ? COMPLEX_ROOTS : ZERO_ROOTS);
+
+        __m512d resultX1 = _mm512_mask_mov_pd(root1, dNeg, COMPLEX ? doubleRoot : nan);
+        resultX1 = _mm512_mask_mov_pd(resultX1, dZero, doubleRoot);
+        resultX1 = _mm512_mask_mov_pd(resultX1, (__mmask8) ~finite, nan);
+
+        __m512d resultX2 = root2;
+        if (COMPLEX)
+            resultX2 = _mm512_mask_mov_pd(root2, dNeg, _mm512_abs_pd(_mm512_mul_pd(D_sqrt, invTwoA)));
+        resultX2 = _mm512_mask_mov_pd(resultX2, (__mmask8) (dZero | (COMPLEX ? 0 : dNeg) | ~finite), nan);
+
+        _mm512_storeu_pd(value + i, v);
+        _mm512_storeu_pd(x1 + i, fixMinusZeroAVX512(resultX1));
+        _mm512_storeu_pd(x2 + i, fixMinusZeroAVX512(resultX2));
+    }
+    solveSweepPortable<B_VARIES, COMPLEX>(first + i, count - i, sweep, value + i, code + i, x1 + i, x2 + i);
+}
+
+
+/// @brief select for SSE2: takes b where mask is set, else a
+#define SSE2_SELECT_PS(mask, a, b) _mm_or_ps(_mm_and_ps((mask), (b)), _mm_andnot_ps((mask), (a)))
+
+static void solveColumnsSSE2F(size_t count, const float a[], const float b[], const float c[],
+                              enum solutionCode code[], float x1[], float x2[]) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 maxFloat = _mm_set1_ps(FLT_MAX), eps = _mm_set1_ps(EPSILON_F);
+    const __m128 zero = _mm_setzero_ps(), two = _mm_set1_ps(2), four = _mm_set1_ps(4), nan = _mm_set1_ps(NAN);
+    const __m128 zeroRoots = _mm_set1_ps(ZERO_ROOTS), oneRoot  = _mm_set1_ps(ONE_ROOT),
+                 twoRoots  = _mm_set1_ps(TWO_ROOTS),  infRoots = _mm_set1_ps(INF_ROOTS),
+                 badInput  = _mm_set1_ps(BAD_INPUT);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 va = _mm_loadu_ps(a + i), vb = _mm_loadu_ps(b + i), vc = _mm_loadu_ps(c + i);
+        const __m128 absA = _mm_andnot_ps(signMask, va),
+                     absB = _mm_andnot_ps(signMask, vb),
+                     absC = _mm_andnot_ps(signMask, vc);
+
+        const __m128 finite = _mm_and_ps(_mm_cmple_ps(absA, maxFloat),
+                              _mm_and_ps(_mm_cmple_ps(absB, maxFloat), _mm_cmple_ps(absC, maxFloat)));
+        const __m128 aZero = _mm_cmplt_ps(absA, eps),
+                     bZero = _mm_cmplt_ps(absB, eps),
+                     cZero = _mm_cmplt_ps(absC, eps);
+
+        const __m128 D = _mm_sub_ps(_mm_mul_ps(vb, vb), _mm_mul_ps(_mm_mul_ps(four, va), vc));
+        const __m128 dNeg = _mm_cmplt_ps(D, zero);
+        const __m128 dZero = _mm_cmplt_ps(_mm_andnot_ps(signMask, D), eps);
+        const __m128 D_sqrt = _mm_sqrt_ps(_mm_xor_ps(D, _mm_and_ps(dNeg, signMask)));
+
+        const __m128 twoA = _mm_mul_ps(two, va);
+        const __m128 negB = _mm_xor_ps(vb, signMask);
+        const __m128 linearRoot = _mm_div_ps(_mm_xor_ps(vc, signMask), vb);
+        const __m128 doubleRoot = _mm_div_ps(negB, twoA);
+        const __m128 root1 = _mm_div_ps(_mm_sub_ps(negB, D_sqrt), twoA);
+        const __m128 root2 = _mm_div_ps(_mm_add_ps(negB, D_sqrt), twoA);
+
+        const __m128 linearCode    = SSE2_SELECT_PS(bZero, oneRoot, SSE2_SELECT_PS(cZero, zeroRoots, infRoots));
+        const __m128 quadraticCode = SSE2_SELECT_PS(dZero, SSE2_SELECT_PS(dNeg, twoRoots, zeroRoots), oneRoot);
+        const __m128 resultCode    = SSE2_SELECT_PS(finite, badInput, SSE2_SELECT_PS(aZero, quadraticCode, linearCode));
+
+        const __m128 quadraticX1 = SSE2_SELECT_PS(dZero, SSE2_SELECT_PS(dNeg, root1, nan), doubleRoot);
+        const __m128 quadraticX2 = SSE2_SELECT_PS(_mm_or_ps(dZero, dNeg), root2, nan);
+        const __m128 linearX1    = SSE2_SELECT_PS(bZero, linearRoot, nan);
+
+        __m128 resultX1 = SSE2_SELECT_PS(finite, nan, SSE2_SELECT_PS(aZero, quadraticX1, linearX1));
+        __m128 resultX2 = SSE2_SELECT_PS(_mm_andnot_ps(aZero, finite), nan, quadraticX2);
+
+        const __m128 absX1 = _mm_andnot_ps(signMask, resultX1), absX2 = _mm_andnot_ps(signMask, resultX2);
+        resultX1 = SSE2_SELECT_PS(_mm_cmplt_ps(absX1, eps), resultX1, absX1);
+        resultX2 = SSE2_SELECT_PS(_mm_cmplt_ps(absX2, eps), resultX2, absX2);
+
+        _mm_storeu_si128((__m128i*) (code + i), _mm_cvtps_epi32(resultCode));
+        _mm_storeu_ps(x1 + i, resultX1);
+        _mm_storeu_ps(x2 + i, resultX2);
+    }
+    solveColumnsPortableF(count - i, a + i, b + i, c + i, code + i, x1 + i, x2 + i);
+}
+
+#undef SSE2_SELECT_PS
+
+
+__attribute__((target("avx2")))
+static void solveColumnsAVX2F(size_t count, const float a[], const float b[], const float c[],
+                              enum solutionCode code[], float x1[], float x2[]) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const __m256 maxFloat = _mm256_set1_ps(FLT_MAX), eps = _mm256_set1_ps(EPSILON_F);
+    const __m256 zero = _mm256_setzero_ps(), two = _mm256_set1_ps(2), four = _mm256_set1_ps(4);
+    const __m256 nan = _mm256_set1_ps(NAN);
+    const __m256 zeroRoots = _mm256_set1_ps(ZERO_ROOTS), oneRoot  = _mm256_set1_ps(ONE_ROOT),
+                 twoRoots  = _mm256_set1_ps(TWO_ROOTS),  infRoots = _mm256_set1_ps(INF_ROOTS),
+                 badInput  = _mm256_set1_ps(BAD_INPUT);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 va = _mm256_loadu_ps(a + i), vb = _mm256_loadu_ps(b + i), vc = _mm256_loadu_ps(c + i);
+        const __m256 absA = _mm256_andnot_ps(signMask, va),
+                     absB = _mm256_andnot_ps(signMask, vb),
+                     absC = _mm256_andnot_ps(signMask, vc);
+
+        const __m256 finite = _mm256_and_ps(_mm256_cmp_ps(absA, maxFloat, _CMP_LE_OQ),
+                              _mm256_and_ps(_mm256_cmp_ps(absB, maxFloat, _CMP_LE_OQ),
+                                            _mm256_cmp_ps(absC, maxFloat, _CMP_LE_OQ)));
+        const __m256 aZero = _mm256_cmp_ps(absA, eps, _CMP_LT_OQ),
+                     bZero = _mm256_cmp_ps(absB, eps, _CMP_LT_OQ),
+                     cZero = _mm256_cmp_ps(absC, eps, _CMP_LT_OQ);
+
+        //no fma here: b*b - 4ac must be rounded exactly like in scalar solver
+        const __m256 D = _mm256_sub_ps(_mm256_mul_ps(vb, vb), _mm256_mul_ps(_mm256_mul_ps(four, va), vc));
+        const __m256 dNeg = _mm256_cmp_ps(D, zero, _CMP_LT_OQ);
+        const __m256 dZero = _mm256_cmp_ps(_mm256_andnot_ps(signMask, D), eps, _CMP_LT_OQ);
+        const __m256 D_sqrt = _mm256_sqrt_ps(_mm256_xor_ps(D, _mm256_and_ps(dNeg, signMask)));
+
+        const __m256 twoA = _mm256_mul_ps(two, va);
+        const __m256 negB = _mm256_xor_ps(vb, signMask);
+        const __m256 linearRoot = _mm256_div_ps(_mm256_xor_ps(vc, signMask), vb);
+        const __m256 doubleRoot = _mm256_div_ps(negB, twoA);
+        const __m256 root1 = _mm256_div_ps(_mm256_sub_ps(negB, D_sqrt), twoA);
+        const __m256 root2 = _mm256_div_ps(_mm256_add_ps(negB, D_sqrt), twoA);
+
+        //blendv takes second argument where mask is set
+        const __m256 linearCode    = _mm256_blendv_ps(oneRoot, _mm256_blendv_ps(zeroRoots, infRoots, cZero), bZero);
+        const __m256 quadraticCode = _mm256_blendv_ps(_mm256_blendv_ps(twoRoots, zeroRoots, dNeg), oneRoot, dZero);
+        const __m256 resultCode    = _mm256_blendv_ps(badInput,
+                                                      _mm256_blendv_ps(quadraticCode, linearCode, aZero), finite);
+
+        const __m256 quadraticX1 = _mm256_blendv_ps(_mm256_blendv_ps(root1, nan, dNeg), doubleRoot, dZero);
+        const __m256 quadraticX2 = _mm256_blendv_ps(root2, nan, _mm256_or_ps(dZero, dNeg));
+        const __m256 linearX1    = _mm256_blendv_ps(linearRoot, nan, bZero);
+
+        __m256 resultX1 = _mm256_blendv_ps(nan, _mm256_blendv_ps(quadraticX1, linearX1, aZero), finite);
+        __m256 resultX2 = _mm256_blendv_ps(nan, quadraticX2, _mm256_andnot_ps(aZero, finite));
+
+        const __m256 absX1 = _mm256_andnot_ps(signMask, resultX1), absX2 = _mm256_andnot_ps(signMask, resultX2);
+        resultX1 = _mm256_blendv_ps(resultX1, absX1, _mm256_cmp_ps(absX1, eps, _CMP_LT_OQ));
+        resultX2 = _mm256_blendv_ps(resultX2, absX2, _mm256_cmp_ps(absX2, eps, _CMP_LT_OQ));
+
+        _mm256_storeu_si256((__m256i*) (code + i), _mm256_cvtps_epi32(resultCode));
+        _mm256_storeu_ps(x1 + i, resultX1);
+        _mm256_storeu_ps(x2 + i, resultX2);
+    }
+    solveColumnsPortableF(count - i, a + i, b + i, c + i, code + i, x1 + i, x2 + i);
+}
+
+
+/// @brief fixMinusZeroInlineF() for 16 numbers
+__attribute__((target("avx512f")))
+static inline __m512 fixMinusZeroAVX512F(__m512 num) {
+    const __m512 absNum = _mm512_abs_ps(num);
+    return _mm512_mask_mov_ps(num, _mm512_cmp_ps_mask(absNum, _mm512_set1_ps(EPSILON_F), _CMP_LT_OQ), absNum);
+}
+
+
+/// @brief storeCodesAVX512() for 16 equations
+__attribute__((target("avx512f")))
+static inline void storeCodesAVX512F(enum solutionCode code[], __mmask16 finite, __mmask16 linearOneRoot,
+                                     __mmask16 linearNoRoots, __mmask16 linearInfRoots, __mmask16 dNeg, __mmask16 dZero) {
+    __m512i resultCode = _mm512_set1_epi32(TWO_ROOTS);
+    resultCode = _mm512_mask_mov_epi32(resultCode, dNeg, _mm512_set1_epi32(ZERO_ROOTS));
+    resultCode = _mm512_mask_mov_epi32(resultCode, dZero, _mm512_set1_epi32(ONE_ROOT));
+    resultCode = _mm512_mask_mov_epi32(resultCode, linearOneRoot, _mm512_set1_epi32(ONE_ROOT));
+    resultCode = _mm512_mask_mov_epi32(resultCode, linearNoRoots, _mm512_set1_epi32(ZERO_ROOTS));
+    resultCode = _mm512_mask_mov_epi32(resultCode, linearInfRoots, _mm512_set1_epi32(INF_ROOTS));
+    resultCode = _mm512_mask_mov_epi32(resultCode, (__mmask16) ~finite, _mm512_set1_epi32(BAD_INPUT));
+    _mm512_storeu_si512((void*) code, resultCode);
+}
+
+
+__attribute__((target("avx512f")))
+static void solveColumnsAVX512F(size_t count, const float a[], const float b[], const float c[],
+                                enum solutionCode code[], float x1[], float x2[]) {
+    const __m512 maxFloat = _mm512_set1_ps(FLT_MAX), eps = _mm512_set1_ps(EPSILON_F);
+    const __m512 zero = _mm512_setzero_ps(), two = _mm512_set1_ps(2), four = _mm512_set1_ps(4);
+    const __m512 nan = _mm512_set1_ps(NAN);
+    const __m512i signBit = _mm512_set1_epi32(INT32_MIN);
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m512 va = _mm512_loadu_ps(a + i), vb = _mm512_loadu_ps(b + i), vc = _mm512_loadu_ps(c + i);
+        const __m512 absA = _mm512_abs_ps(va), absB = _mm512_abs_ps(vb), absC = _mm512_abs_ps(vc);
+
+        const __mmask16 finite = _mm512_cmp_ps_mask(absA, maxFloat, _CMP_LE_OQ)
+                               & _mm512_cmp_ps_mask(absB, maxFloat, _CMP_LE_OQ)
+                               & _mm512_cmp_ps_mask(absC, maxFloat, _CMP_LE_OQ);
+        const __mmask16 aZero = _mm512_cmp_ps_mask(absA, eps, _CMP_LT_OQ),
+                        bZero = _mm512_cmp_ps_mask(absB, eps, _CMP_LT_OQ),
+                        cZero = _mm512_cmp_ps_mask(absC, eps, _CMP_LT_OQ);
+
+        //no fma here: b*b - 4ac must be rounded exactly like in scalar solver
+        const __m512 D = _mm512_sub_ps(_mm512_mul_ps(vb, vb), _mm512_mul_ps(_mm512_mul_ps(four, va), vc));
+        const __mmask16 dNeg  = _mm512_cmp_ps_mask(D, zero, _CMP_LT_OQ);
+        const __mmask16 dZero = _mm512_cmp_ps_mask(_mm512_abs_ps(D), eps, _CMP_LT_OQ);
+        const __m512 D_sqrt = _mm512_mask_sqrt_ps(zero, 0xFFFF, _mm512_mask_sub_ps(D, dNeg, zero, D));
+
+        const __m512 twoA = _mm512_mul_ps(two, va);
+        //sign is flipped with xor, so -0 stays -0 as in scalar solver
+        const __m512 negB = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(vb), signBit));
+        const __m512 negC = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(vc), signBit));
+        const __m512 linearRoot = _mm512_div_ps(negC, vb);
+        const __m512 doubleRoot = _mm512_div_ps(negB, twoA);
+        const __m512 root1 = _mm512_div_ps(_mm512_sub_ps(negB, D_sqrt), twoA);
+        const __m512 root2 = _mm512_div_ps(_mm512_add_ps(negB, D_sqrt), twoA);
+
+        const __mmask16 linear = aZero, linearNoRoots = (__mmask16) (aZero & bZero);
+        storeCodesAVX512F(code + i, finite, linear, linearNoRoots, (__mmask16) (linearNoRoots & cZero), dNeg, dZero);
+
+        //masked moves are applied from general case to special ones, so the last matching mask wins
+        __m512 resultX1 = _mm512_mask_mov_ps(root1, dNeg, nan);
+        resultX1 = _mm512_mask_mov_ps(resultX1, dZero, doubleRoot);
+        resultX1 = _mm512_mask_mov_ps(resultX1, linear, linearRoot);
+        resultX1 = _mm512_mask_mov_ps(resultX1, (__mmask16) (linearNoRoots | ~finite), nan);
+
+        __m512 resultX2 = _mm512_mask_mov_ps(root2, (__mmask16) (dZero | dNeg | linear | ~finite), nan);
+
+        _mm512_storeu_ps(x1 + i, fixMinusZeroAVX512F(resultX1));
+        _mm512_storeu_ps(x2 + i, fixMinusZeroAVX512F(resultX2));
+    }
+    solveColumnsPortableF(count - i, a + i, b + i, c + i, code + i, x1 + i, x2 + i);
+}
+
+
+static int osSupportsXState(uint64_t mask) {
+    uint32_t eax = 0, edx = 0;
+    __asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    const uint64_t xcr0 = ((uint64_t) edx << 32) | eax;
+    return (xcr0 & mask) == mask;
+}
+
+
+static enum kernelType queryKernelType() {
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return KERNEL_PORTABLE;
+
+    const int hasSSE2    = (edx >> 26) & 1;
+    const int hasOSXSAVE = (ecx >> 27) & 1;
+    enum kernelType best = hasSSE2 ? KERNEL_SSE2 : KERNEL_PORTABLE;
+    if (!hasOSXSAVE)
+        return best;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return best;
+    const int hasAVX2    = (ebx >>  5) & 1;
+    const int hasAVX512F = (ebx >> 16) & 1;
+
+    const uint64_t XSTATE_YMM = 0x6;  //SSE and AVX state
+    const uint64_t XSTATE_ZMM = 0xE6; //+ opmask and upper halves of zmm registers
+
+    if (hasAVX2 && osSupportsXState(XSTATE_YMM))
+        best = KERNEL_AVX2;
+    if (hasAVX512F && osSupportsXState(XSTATE_ZMM))
+        best = KERNEL_AVX512;
+    return best;
+}
+
+#else
+
+static enum kernelType queryKernelType() {
+    return KERNEL_PORTABLE;
+}
+
+#endif
+
+
+enum kernelType detectKernelType() {
+    static const enum kernelType best = queryKernelType();
+    return best;
+}
+
+
+template <bool COMPLEX>
+static batchKernel_t kernelByType(enum kernelType type) {
+    if (type > detectKernelType())
+        return NULL;
+
+    switch (type) {
+        case KERNEL_PORTABLE:
+            return solveColumnsPortableT<COMPLEX>;
+#ifdef X86_KERNELS
+        case KERNEL_SSE2:
+            return solveColumnsSSE2<COMPLEX>;
+        case KERNEL_AVX2:
+            return solveColumnsAVX2<COMPLEX>;
+        case KERNEL_AVX512:
+            return solveColumnsAVX512<COMPLEX>;
+#else
+        case KERNEL_SSE2:
+        case KERNEL_AVX2:
+        case KERNEL_AVX512:
+#endif
+        case KERNEL_TYPES_COUNT:
+        default:
+            return NULL;
+    }
+}
+
+
+batchKernel_t getKernelByType(enum kernelType type) {
+    return kernelByType<false>(type);
+}
+
+
+batchKernel_t getBatchKernel() {
+    static const batchKernel_t bestKernel = getKernelByType(detectKernelType());
+    return bestKernel;
+}
+
+
+batchKernel_t getComplexKernelByType(enum kernelType type) {
+    return kernelByType<true>(type);
+}
+
+
+batchKernel_t getBatchKernelComplex() {
+    static const batchKernel_t bestKernel = getComplexKernelByType(detectKernelType());
+    return bestKernel;
+}
+
+
+classifyKernel_t getClassifyKernelByType(enum kernelType type) {
+    if (type > detectKernelType())
+        return NULL;
+
+    switch (type) {
+        case KERNEL_PORTABLE:
+            return classifyColumnsPortable;
+#ifdef X86_KERNELS
+        case KERNEL_SSE2:
+            return classifyColumnsSSE2;
+        case KERNEL_AVX2:
+            return classifyColumnsAVX2;
+        case KERNEL_AVX512:
+            return classifyColumnsAVX512;
+#else
+        case KERNEL_SSE2:
+        case KERNEL_AVX2:
+        case KERNEL_AVX512:
+#endif
+        case KERNEL_TYPES_COUNT:
+        default:
+            return NULL;
+    }
+}
+
+
+classifyKernel_t getClassifyKernel() {
+    static const classifyKernel_t bestKernel = getClassifyKernelByType(detectKernelType());
+    return bestKernel;
+}
+
+
+template <bool B_VARIES, bool COMPLEX>
+static sweepKernel_t sweepKernelByType(enum kernelType type) {
+    if (type > detectKernelType())
+        return NULL;
+
+    switch (type) {
+        case KERNEL_PORTABLE:
+            return solveSweepPortable<B_VARIES, COMPLEX>;
+#ifdef X86_KERNELS
+        case KERNEL_SSE2:
+            return solveSweepSSE2<B_VARIES, COMPLEX>;
+        case KERNEL_AVX2:
+            return solveSweepAVX2<B_VARIES, COMPLEX>;
+        case KERNEL_AVX512:
+            return solveSweepAVX512<B_VARIES, COMPLEX>;
+#else
+        case KERNEL_SSE2:
+        case KERNEL_AVX2:
+        case KERNEL_AVX512:
+#endif
+        case KERNEL_TYPES_COUNT:
+        default:
+            return NULL;
+    }
+}
+
+
+sweepKernel_t getSweepKernelByType(enum kernelType type, int bVaries, int complex) {
+    if (bVaries)
+        return complex ? sweepKernelByType<true, true>(type) : sweepKernelByType<true, false>(type);
+    return complex ? sweepKernelByType<false, true>(type) : sweepKernelByType<false, false>(type);
+}
+
+
+batchKernelF_t getKernelFByType(enum kernelType type) {
+    if (type > detectKernelType())
+        return NULL;
+
+    switch (type) {
+        case KERNEL_PORTABLE:
+            return solveColumnsPortableF;
+#ifdef X86_KERNELS
+        case KERNEL_SSE2:
+            return solveColumnsSSE2F;
+        case KERNEL_AVX2:
+            return solveColumnsAVX2F;
+        case KERNEL_AVX512:
+            return solveColumnsAVX512F;
+#else
+        case KERNEL_SSE2:
+        case KERNEL_AVX2:
+        case KERNEL_AVX512:
+#endif
+        case KERNEL_TYPES_COUNT:
+        default:
+            return NULL;
+    }
+}
+
+
+batchKernelF_t getBatchKernelF() {
+    static const batchKernelF_t bestKernel = getKernelFByType(detectKernelType());
+    return bestKernel;
+}
+
+
+const char *kernelName(enum kernelType type) {
+    switch (type) {
+        case KERNEL_PORTABLE:   return "portable";
+        case KERNEL_SSE2:       return "sse2";
+        case KERNEL_AVX2:       return "avx2";
+        case KERNEL_AVX512:     return "avx512";
+        case KERNEL_TYPES_COUNT:
+        default:                return "unknown";
+    }
+}
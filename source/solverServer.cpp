@@ -0,0 +1,576 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "colors.h"
+#include "quadraticPrinter.h"
+#include "batchSolver.h"
+#include "preciseSolver.h"
+#include "resultCache.h"
+#include "batchDedup.h"
+#include "asyncIO.h"
+#include "polynomialSolver.h"
+#include "batchProcessor.h"
+#include "solverServer.h"
+#include "tracer.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#endif
+
+
+/// @brief Every power of 2 of latency histogram is split to 2^LATENCY_SUB_BITS buckets
+const size_t LATENCY_SUB_BITS = 2;
+const size_t LATENCY_SUB_BUCKETS = 1 << LATENCY_SUB_BITS;
+
+
+/// @brief Returns bucket of histogram for latency
+static size_t latencyBucket(uint64_t ns);
+
+
+/// @brief Returns the greatest latency of bucket that holds requests with given rank, but not more than maximum
+static uint64_t latencyPercentile(const serverStats_t *stats, double share);
+
+
+static size_t latencyBucket(uint64_t ns) {
+    if (ns < LATENCY_SUB_BUCKETS) return (size_t) ns;
+
+    //bits after the highest one choose bucket inside power of 2
+    const size_t power = 63 - (size_t) __builtin_clzll(ns);
+    const size_t sub = (size_t) (ns >> (power - LATENCY_SUB_BITS)) - LATENCY_SUB_BUCKETS;
+    const size_t bucket = (power - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS + sub;
+    return (bucket < LATENCY_BUCKETS) ? bucket : LATENCY_BUCKETS - 1;
+}
+
+
+uint64_t latencyBucketLow(size_t bucket) {
+    if (bucket < LATENCY_SUB_BUCKETS) return bucket;
+
+    const size_t power = bucket / LATENCY_SUB_BUCKETS + LATENCY_SUB_BITS - 1;
+    return (uint64_t) (LATENCY_SUB_BUCKETS + bucket % LATENCY_SUB_BUCKETS) << (power - LATENCY_SUB_BITS);
+}
+
+
+static uint64_t latencyPercentile(const serverStats_t *stats, double share) {
+    uint64_t total = 0;
+    for (size_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+        total += stats->buckets[bucket];
+    if (total == 0) return 0;
+
+    const uint64_t rank = (uint64_t) (share * (double) (total - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket + 1 < LATENCY_BUCKETS; bucket++) {
+        seen += stats->buckets[bucket];
+        if (seen >= rank) {
+            const uint64_t high = latencyBucketLow(bucket + 1) - 1;
+            return (high < stats->max) ? high : stats->max;
+        }
+    }
+    return stats->max;
+}
+
+
+#ifdef __linux__
+
+/// @brief Minimal free space in input buffer of client before read
+const size_t SERVER_READ_SIZE = 1 << 16;
+
+/// @brief Maximum number of events taken by one epoll_wait()
+const int SERVER_MAX_EVENTS = 64;
+
+/// @brief Length of queue of connections that aren't accepted yet
+const int SERVER_BACKLOG = 128;
+
+/// @brief Bytes of coefficients and bytes of results of one equation
+const size_t SOLVE_ROW_SIZE = 3 * sizeof(double);
+const size_t REPLY_ROW_SIZE = 2 * sizeof(double) + sizeof(int32_t);
+
+/// @brief Frames are padded to it, so columns of doubles are aligned in buffers
+const size_t FRAME_ALIGNMENT = sizeof(double);
+
+static_assert(sizeof(enum solutionCode) == sizeof(int32_t), "code column is array of int32");
+
+
+/// @brief Connection with it's unprocessed requests and unsent replies
+typedef struct serverClient {
+    int fd;
+    uint32_t events;            ///< Events that client is registered for in epoll
+
+    char *input;                ///< Received bytes, starts with the first unprocessed frame
+    size_t inputSize;
+    size_t inputCapacity;
+    uint64_t inputTime;         ///< Time of the last read, complete frames were received not later
+
+    char *output;               ///< Replies, bytes before outputSent are already sent
+    size_t outputSent;
+    size_t outputSize;
+    size_t outputCapacity;
+
+    int eof;                    ///< Client won't send more, connection is closed after the last reply
+} serverClient_t;
+
+const serverClient_t BLANK_SERVER_CLIENT = {-1, 0, NULL, 0, 0, 0, NULL, 0, 0, 0, 0};
+
+
+/// @brief State of event loop
+typedef struct solverServer {
+    int epoll;
+    int listener;                           ///< Listening socket
+    int signals;                            ///< signalfd for SIGINT and SIGTERM
+    std::vector<serverClient_t*> clients;   ///< Clients indexed by their descriptors, NULL for other descriptors
+    const batchOptions_t *options;
+    serverStats_t stats;
+} solverServer_t;
+
+
+/// @brief Returns monotonic time in ns
+static uint64_t nowNs();
+
+
+/// @brief Creates listening socket, removes stale socket with the same path
+static int openListener(const char path[]);
+
+
+/// @brief Accepts all waiting connections and registers them in epoll
+static void acceptClients(solverServer_t *server);
+
+
+/// @brief Frees client and closes it's connection
+static void closeClient(solverServer_t *server, serverClient_t *client);
+
+
+/*!
+    @brief Handles epoll events of client: reads requests, answers them and sends replies
+
+    Client is closed if it has sent bad frame, connection is broken or everything is answered after eof
+*/
+static void serveClient(solverServer_t *server, serverClient_t *client, uint32_t events);
+
+
+/// @brief Reads once from socket to input buffer, sets eof if client has closed it's side
+static enum error readClient(serverClient_t *client);
+
+
+/// @brief Sends replies until socket buffer is full
+static enum error writeClient(serverClient_t *client);
+
+
+/*!
+    @brief Answers complete frames of input buffer in order
+
+    @param[in, out] server Server
+    @param[in, out] client Client
+    @param[out] answered Number of answered frames
+
+    @return FAIL if frame is too big or memory can't be allocated
+
+    Stops when client has SERVER_OUTPUT_LIMIT bytes of unsent replies
+*/
+static enum error processFrames(solverServer_t *server, serverClient_t *client, size_t *answered);
+
+
+/// @brief Puts reply for one request to output buffer
+static enum error answerFrame(solverServer_t *server, serverClient_t *client, const serverFrameHeader_t *request,
+                              const char *payload);
+
+
+/// @brief Returns pointer to free space of at least size bytes at the end of output buffer
+static char *reserveOutput(serverClient_t *client, size_t size);
+
+
+/// @brief Registers client for reading only if it isn't backpressured and for writing if it has unsent replies
+static enum error updateEvents(solverServer_t *server, serverClient_t *client);
+
+
+/// @brief Fills percentiles of stats from their histogram
+static void finishStats(serverStats_t *stats);
+
+
+static uint64_t nowNs() {
+    struct timespec time = {};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t) time.tv_sec * 1000000000ULL + (uint64_t) time.tv_nsec;
+}
+
+
+static int openListener(const char path[]) {
+    struct sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, RED "Path of socket \"%s\" is too long\n" RESET_C, path);
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener < 0) {
+        fprintf(stderr, RED "Can't create socket: %s\n" RESET_C, strerror(errno));
+        return -1;
+    }
+
+    //socket is stale if nobody accepts connections on it
+    struct stat info = {};
+    if (lstat(path, &info) == 0 && S_ISSOCK(info.st_mode)) {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        const int alive = probe >= 0 && connect(probe, (struct sockaddr*) &address, sizeof(address)) == 0;
+        if (probe >= 0) close(probe);
+        if (alive) {
+            fprintf(stderr, RED "Socket \"%s\" is already served\n" RESET_C, path);
+            close(listener);
+            return -1;
+        }
+        unlink(path);
+    }
+
+    if (bind(listener, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(listener, SERVER_BACKLOG) != 0) {
+        fprintf(stderr, RED "Can't listen on \"%s\": %s\n" RESET_C, path, strerror(errno));
+        close(listener);
+        return -1;
+    }
+    return listener;
+}
+
+
+static void acceptClients(solverServer_t *server) {
+    for (;;) {
+        const int fd = accept4(server->listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EINTR && errno != ECONNABORTED)
+                fprintf(stderr, RED "Can't accept client: %s\n" RESET_C, strerror(errno));
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            return;
+        }
+
+        serverClient_t *client = (serverClient_t*) malloc(sizeof(serverClient_t));
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        int registered = 0;
+        if (client) {
+            *client = BLANK_SERVER_CLIENT;
+            client->fd = fd;
+            client->events = EPOLLIN;
+            try {
+                if ((size_t) fd >= server->clients.size()) server->clients.resize((size_t) fd + 1, NULL);
+                registered = epoll_ctl(server->epoll, EPOLL_CTL_ADD, fd, &event) == 0;
+            } catch (...) {}
+        }
+        if (!registered) {
+            fprintf(stderr, RED "Can't register client\n" RESET_C);
+            free(client);
+            close(fd);
+            continue;
+        }
+        server->clients[(size_t) fd] = client;
+        server->stats.clients++;
+    }
+}
+
+
+static void closeClient(solverServer_t *server, serverClient_t *client) {
+    epoll_ctl(server->epoll, EPOLL_CTL_DEL, client->fd, NULL);
+    close(client->fd);
+    server->clients[(size_t) client->fd] = NULL;
+    server->stats.clients--;
+
+    free(client->input);
+    free(client->output);
+    free(client);
+}
+
+
+static void serveClient(solverServer_t *server, serverClient_t *client, uint32_t events) {
+    int broken = (events & EPOLLERR) != 0;
+
+    if (!broken && (client->events & EPOLLIN) && (events & (EPOLLIN | EPOLLHUP)))
+        broken = readClient(client) != GOOD_EXIT;
+
+    //answers of one pass can unblock frames that were stopped by backpressure
+    for (size_t answered = 1; !broken && answered > 0;) {
+        broken = processFrames(server, client, &answered) != GOOD_EXIT || writeClient(client) != GOOD_EXIT;
+        if (client->outputSize > client->outputSent) break;
+    }
+
+    if (broken || (client->eof && client->outputSize == client->outputSent) || updateEvents(server, client) != GOOD_EXIT)
+        closeClient(server, client);
+}
+
+
+static enum error readClient(serverClient_t *client) {
+    size_t needed = client->inputSize + SERVER_READ_SIZE;
+    if (client->inputSize >= sizeof(serverFrameHeader_t)) {
+        //the whole frame fits, so big request is read with few calls
+        serverFrameHeader_t header = {};
+        memcpy(&header, client->input, sizeof(header));
+        if (header.size <= SERVER_MAX_PAYLOAD && sizeof(header) + header.size > needed)
+            needed = sizeof(header) + header.size;
+    }
+    if (needed > client->inputCapacity) {
+        const size_t capacity = (needed > 2 * client->inputCapacity) ? needed : 2 * client->inputCapacity;
+        char *input = (char*) realloc(client->input, capacity);
+        if (!input) {
+            fprintf(stderr, RED "Can't allocate memory for requests of client\n" RESET_C);
+            return FAIL;
+        }
+        client->input = input;
+        client->inputCapacity = capacity;
+    }
+
+    const ssize_t received = read(client->fd, client->input + client->inputSize, client->inputCapacity - client->inputSize);
+    if (received < 0)
+        return (errno == EAGAIN || errno == EINTR) ? GOOD_EXIT : FAIL;
+    if (received == 0)
+        client->eof = 1;
+    client->inputSize += (size_t) received;
+    client->inputTime = nowNs();
+    return GOOD_EXIT;
+}
+
+
+static enum error writeClient(serverClient_t *client) {
+    while (client->outputSent < client->outputSize) {
+        const ssize_t sent = send(client->fd, client->output + client->outputSent,
+                                  client->outputSize - client->outputSent, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return (errno == EAGAIN) ? GOOD_EXIT : FAIL;
+        }
+        client->outputSent += (size_t) sent;
+    }
+    client->outputSent = client->outputSize = 0;
+    return GOOD_EXIT;
+}
+
+
+static enum error processFrames(solverServer_t *server, serverClient_t *client, size_t *answered) {
+    *answered = 0;
+    size_t offset = 0;
+    enum error result = GOOD_EXIT;
+
+    while (client->inputSize - offset >= sizeof(serverFrameHeader_t)
+           && client->outputSize - client->outputSent < SERVER_OUTPUT_LIMIT) {
+        serverFrameHeader_t header = {};
+        memcpy(&header, client->input + offset, sizeof(header));
+        if (header.size > SERVER_MAX_PAYLOAD) {
+            fprintf(stderr, RED "Client sent frame of %u bytes, connection is closed\n" RESET_C,
+                    (unsigned) header.size);
+            return FAIL;
+        }
+        if (client->inputSize - offset - sizeof(header) < header.size) break;
+
+        //frame after payload of odd size is moved, so it's columns can be read in place
+        if ((offset + sizeof(header)) % FRAME_ALIGNMENT != 0) {
+            memmove(client->input, client->input + offset, client->inputSize - offset);
+            client->inputSize -= offset;
+            offset = 0;
+        }
+        result = answerFrame(server, client, &header, client->input + offset + sizeof(header));
+        if (result != GOOD_EXIT) break;
+        offset += sizeof(header) + header.size;
+        (*answered)++;
+    }
+
+    memmove(client->input, client->input + offset, client->inputSize - offset);
+    client->inputSize -= offset;
+    return result;
+}
+
+
+static enum error answerFrame(solverServer_t *server, serverClient_t *client, const serverFrameHeader_t *request,
+                              const char *payload) {
+    serverFrameHeader_t reply = {0, request->type, SERVER_OK, request->id};
+    if (request->type == SERVER_SOLVE && request->size % SOLVE_ROW_SIZE != 0)
+        reply.status = SERVER_BAD_SIZE;
+    else if (request->type == SERVER_STATS && request->size != 0)
+        reply.status = SERVER_BAD_SIZE;
+    else if (request->type != SERVER_SOLVE && request->type != SERVER_STATS)
+        reply.status = SERVER_BAD_TYPE;
+
+    if (reply.status == SERVER_OK && request->type == SERVER_STATS) {
+        char *out = reserveOutput(client, sizeof(reply) + sizeof(serverStats_t));
+        if (!out) return FAIL;
+        serverStats_t stats = server->stats;
+        finishStats(&stats);
+        reply.size = sizeof(stats);
+        memcpy(out, &reply, sizeof(reply));
+        memcpy(out + sizeof(reply), &stats, sizeof(stats));
+        client->outputSize += sizeof(reply) + sizeof(stats);
+        return GOOD_EXIT;
+    }
+
+    if (reply.status == SERVER_OK) {
+        const size_t count = request->size / SOLVE_ROW_SIZE;
+        const size_t size = (count * REPLY_ROW_SIZE + FRAME_ALIGNMENT - 1) / FRAME_ALIGNMENT * FRAME_ALIGNMENT;
+        char *out = reserveOutput(client, sizeof(reply) + size);
+        if (!out) return FAIL;
+
+        const double *a = (const double*) payload;
+        double *x1 = (double*) (out + sizeof(reply));
+        double *x2 = x1 + count;
+        enum solutionCode *code = (enum solutionCode*) (x2 + count);
+        memset(x1, 0, size);
+        TRACE_BEGIN(solveSpan);
+        const enum error solved = solveColumnsParallel(count, a, a + count, a + 2 * count, code, x1, x2, server->options);
+        TRACE_END(solveSpan, "solve request");
+        if (solved == GOOD_EXIT) {
+            reply.size = (uint32_t) size;
+            server->stats.requests++;
+            server->stats.equations += count;
+
+            const uint64_t latency = nowNs() - client->inputTime;
+            server->stats.buckets[latencyBucket(latency)]++;
+            if (latency > server->stats.max) server->stats.max = latency;
+        } else
+            reply.status = SERVER_SOLVER_FAILED;
+    }
+
+    char *out = reserveOutput(client, sizeof(reply));
+    if (!out) return FAIL;
+    memcpy(out, &reply, sizeof(reply));
+    client->outputSize += sizeof(reply) + reply.size;
+    return GOOD_EXIT;
+}
+
+
+static char *reserveOutput(serverClient_t *client, size_t size) {
+    //sent bytes are dropped, but replies stay aligned
+    const size_t shift = client->outputSent / FRAME_ALIGNMENT * FRAME_ALIGNMENT;
+    if (shift > 0 && client->outputSize + size > client->outputCapacity) {
+        memmove(client->output, client->output + shift, client->outputSize - shift);
+        client->outputSent -= shift;
+        client->outputSize -= shift;
+    }
+
+    if (client->outputSize + size > client->outputCapacity) {
+        const size_t needed = client->outputSize + size;
+        const size_t capacity = (needed > 2 * client->outputCapacity) ? needed : 2 * client->outputCapacity;
+        char *output = (char*) realloc(client->output, capacity);
+        if (!output) {
+            fprintf(stderr, RED "Can't allocate memory for replies to client\n" RESET_C);
+            return NULL;
+        }
+        client->output = output;
+        client->outputCapacity = capacity;
+    }
+    return client->output + client->outputSize;
+}
+
+
+static enum error updateEvents(solverServer_t *server, serverClient_t *client) {
+    const size_t unsent = client->outputSize - client->outputSent;
+    uint32_t events = 0;
+    if (!client->eof && unsent < SERVER_OUTPUT_LIMIT) events |= EPOLLIN;
+    if (unsent > 0) events |= EPOLLOUT;
+    if (events == client->events) return GOOD_EXIT;
+
+    struct epoll_event event = {};
+    event.events = events;
+    event.data.fd = client->fd;
+    if (epoll_ctl(server->epoll, EPOLL_CTL_MOD, client->fd, &event) != 0) return FAIL;
+    client->events = events;
+    return GOOD_EXIT;
+}
+
+
+static void finishStats(serverStats_t *stats) {
+    stats->p50 = latencyPercentile(stats, 0.50);
+    stats->p99 = latencyPercentile(stats, 0.99);
+}
+
+
+enum error serveSolver(const char path[], const batchOptions_t *options, serverStats_t *stats) {
+    MY_ASSERT(path, return FAIL);
+    MY_ASSERT(options, return FAIL);
+
+    solverServer_t server = {-1, -1, -1, {}, options, {}};
+
+    sigset_t signals = {}, oldSignals = {};
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &signals, &oldSignals);
+
+    server.listener = openListener(path);
+    server.signals = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    server.epoll = epoll_create1(EPOLL_CLOEXEC);
+
+    enum error result = GOOD_EXIT;
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = server.listener;
+    if (server.listener < 0 || server.signals < 0 || server.epoll < 0
+        || epoll_ctl(server.epoll, EPOLL_CTL_ADD, server.listener, &event) != 0)
+        result = FAIL;
+    event.data.fd = server.signals;
+    if (result == GOOD_EXIT && epoll_ctl(server.epoll, EPOLL_CTL_ADD, server.signals, &event) != 0)
+        result = FAIL;
+    if (result != GOOD_EXIT && server.listener >= 0)
+        fprintf(stderr, RED "Can't start event loop: %s\n" RESET_C, strerror(errno));
+
+    struct epoll_event events[SERVER_MAX_EVENTS] = {};
+    int running = (result == GOOD_EXIT);
+    while (running) {
+        const int ready = epoll_wait(server.epoll, events, SERVER_MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, RED "epoll_wait failed: %s\n" RESET_C, strerror(errno));
+            result = FAIL;
+            break;
+        }
+
+        for (int i = 0; i < ready; i++) {
+            const int fd = events[i].data.fd;
+            if (fd == server.signals) {
+                //signal is taken from queue, so it isn't delivered when mask is restored
+                struct signalfd_siginfo info = {};
+                if (read(server.signals, &info, sizeof(info)) == (ssize_t) sizeof(info))
+                    running = 0;
+            }
+            else if (fd == server.listener)
+                acceptClients(&server);
+            else if ((size_t) fd < server.clients.size() && server.clients[(size_t) fd])
+                serveClient(&server, server.clients[(size_t) fd], events[i].events);
+        }
+    }
+
+    for (serverClient_t *client : server.clients)
+        if (client) closeClient(&server, client);
+    if (server.listener >= 0) {
+        close(server.listener);
+        unlink(path);
+    }
+    if (server.signals >= 0) close(server.signals);
+    if (server.epoll >= 0) close(server.epoll);
+    sigprocmask(SIG_SETMASK, &oldSignals, NULL);
+
+    if (stats) {
+        *stats = server.stats;
+        finishStats(stats);
+    }
+    return result;
+}
+
+#else
+
+enum error serveSolver(const char path[], const batchOptions_t *options, serverStats_t *stats) {
+    (void) path;
+    (void) options;
+    if (stats) *stats = serverStats_t {};
+    fprintf(stderr, RED "Server mode is supported only on Linux\n" RESET_C);
+    return FAIL;
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+
+#include "error.h"
+#include "spscRing.h"
+
+
+/// @brief Size of cache line, indexes of producer and consumer are aligned to it
+const size_t RING_LINE_SIZE = 64;
+
+
+struct spscRing {
+    alignas(RING_LINE_SIZE) std::atomic<size_t> head {0};  ///< Next item to take, written by consumer
+    size_t cachedTail = 0;                                  ///< Consumer's copy of tail
+
+    alignas(RING_LINE_SIZE) std::atomic<size_t> tail {0};  ///< Next free place, written by producer
+    size_t cachedHead = 0;                                  ///< Producer's copy of head
+
+    alignas(RING_LINE_SIZE) size_t mask = 0;                ///< Capacity - 1
+    void **items = NULL;
+
+    alignas(RING_LINE_SIZE) std::atomic<int> sleeping {0};  ///< Number of threads that sleep on changed
+    std::mutex lock {};                                     ///< Protects sleep, so wake up isn't lost
+    std::condition_variable changed {};                     ///< Notified when index moves while someone sleeps
+};
+
+
+/*!
+    @brief Waits a bit before the next try: spins SPSC_SPIN_LIMIT times, then sleeps until index moves
+
+    @param[in] ring Pointer to ring
+    @param[in] index Index of the other side
+    @param[in] seen Value of index that was seen by the failed try
+    @param[in] tries Number of failed tries
+*/
+static void backoff(spscRing_t *ring, const std::atomic<size_t> *index, size_t seen, size_t tries);
+
+
+/// @brief Wakes the other side if it sleeps in backoff(), called after index is moved
+static void wakeOtherSide(spscRing_t *ring);
+
+
+static void backoff(spscRing_t *ring, const std::atomic<size_t> *index, size_t seen, size_t tries) {
+    if (tries < SPSC_SPIN_LIMIT) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+        return;
+    }
+    std::unique_lock<std::mutex> guard(ring->lock);
+    ring->sleeping.fetch_add(1);
+    //index is checked after sleeping is set, so the other side either sees sleeping or it's move is seen here
+    ring->changed.wait_for(guard, std::chrono::milliseconds(SPSC_WAIT_MS), [&]{ return index->load() != seen; });
+    ring->sleeping.fetch_sub(1);
+}
+
+
+static void wakeOtherSide(spscRing_t *ring) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring->sleeping.load(std::memory_order_relaxed) == 0) return;
+    std::lock_guard<std::mutex> guard(ring->lock);
+    ring->changed.notify_all();
+}
+
+
+spscRing_t *spscRingCreate(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) size *= 2;
+
+    spscRing_t *ring = new (std::nothrow) spscRing_t;
+    void **items = (void**) calloc(size, sizeof(void*));
+    if (!ring || !items) {
+        fprintf(stderr, RED "Can't allocate memory for ring\n" RESET_C);
+        delete ring;
+        free(items);
+        return NULL;
+    }
+    ring->mask = size - 1;
+    ring->items = items;
+    return ring;
+}
+
+
+void spscRingDestroy(spscRing_t *ring) {
+    if (!ring) return;
+    free(ring->items);
+    delete ring;
+}
+
+
+int spscTryPush(spscRing_t *ring, void *item) {
+    MY_ASSERT(ring, return 0);
+    const size_t tail = ring->tail.load(std::memory_order_relaxed);
+    if (tail - ring->cachedHead > ring->mask) {
+        ring->cachedHead = ring->head.load(std::memory_order_acquire);
+        if (tail - ring->cachedHead > ring->mask) return 0;
+    }
+    ring->items[tail & ring->mask] = item;
+    ring->tail.store(tail + 1, std::memory_order_release);
+    wakeOtherSide(ring);
+    return 1;
+}
+
+
+int spscTryPop(spscRing_t *ring, void **item) {
+    MY_ASSERT(ring, return 0);
+    MY_ASSERT(item, return 0);
+    const size_t head = ring->head.load(std::memory_order_relaxed);
+    if (head == ring->cachedTail) {
+        ring->cachedTail = ring->tail.load(std::memory_order_acquire);
+        if (head == ring->cachedTail) return 0;
+    }
+    *item = ring->items[head & ring->mask];
+    ring->head.store(head + 1, std::memory_order_release);
+    wakeOtherSide(ring);
+    return 1;
+}
+
+
+void spscPush(spscRing_t *ring, void *item) {
+    MY_ASSERT(ring, return);
+    for (size_t tries = 0; !spscTryPush(ring, item); tries++)
+        backoff(ring, &ring->head, ring->cachedHead, tries);
+}
+
+
+void *spscPop(spscRing_t *ring) {
+    MY_ASSERT(ring, return NULL);
+    void *item = NULL;
+    for (size_t tries = 0; !spscTryPop(ring, &item); tries++)
+        backoff(ring, &ring->tail, ring->cachedTail, tries);
+    return item;
+}
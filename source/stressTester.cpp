@@ -0,0 +1,398 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <chrono>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "colors.h"
+#include "quadraticPrinter.h"
+#include "batchSolver.h"
+#include "preciseSolver.h"
+#include "resultCache.h"
+#include "batchDedup.h"
+#include "asyncIO.h"
+#include "polynomialSolver.h"
+#include "batchProcessor.h"
+#include "unitTester.h"
+#include "utils.h"
+#include "stressTester.h"
+#include "tracer.h"
+
+
+/// @brief Roots are k / ROOT_SCALE with |k| <= ROOT_STEPS
+const int64_t ROOT_STEPS = 1 << 15;
+const double ROOT_SCALE = 256;
+
+/// @brief Leading coefficients are m / LEADING_SCALE with 1 <= |m| <= LEADING_STEPS
+const int64_t LEADING_STEPS = 1 << 8;
+const double LEADING_SCALE = 16;
+
+/// @brief Free term of STRESS_NO_ROOTS family is q = n / LEADING_SCALE with 1 <= |n| <= SHIFT_STEPS
+const int64_t SHIFT_STEPS = 1 << 12;
+
+/// @brief Roots of STRESS_RANDOM_ROOTS are in [-ROOT_LIMIT, ROOT_LIMIT] and at least 1 apart
+const double ROOT_LIMIT = 128;
+
+/// @brief |a| of continuous families except STRESS_TINY_LEADING is in [MIN_LEADING, MAX_LEADING]
+const double MIN_LEADING = 1.0 / 16;
+const double MAX_LEADING = 16;
+
+/// @brief STRESS_NEAR_DOUBLE keeps |a| <= 1 and |r| <= NEAR_DOUBLE_CENTER, so error of D is far below EPSILON
+const double NEAR_DOUBLE_CENTER = 4;
+
+/// @brief STRESS_FAR_ROOTS has |x1| in [FAR_ROOT_MIN, FAR_ROOT_MAX] and |x2| in [NEAR_ROOT_MIN, 1]
+const double FAR_ROOT_MIN = 1 << 10;
+const double FAR_ROOT_MAX = 1 << 16;
+const double NEAR_ROOT_MIN = 1.0 / (1 << 10);
+
+
+/// @brief Expected answers of one block
+typedef struct stressBlock {
+    quadraticBatch_t batch;             ///< Generated coefficients and answers of solver
+    solution_t *expected;               ///< Answers from chosen roots
+    unsigned char *family;              ///< enum stressFamily of every equation
+} stressBlock_t;
+
+const stressBlock_t BLANK_STRESS_BLOCK = {BLANK_BATCH, NULL, NULL};
+
+
+/// @brief Returns next number of xorshift64* generator, same as in benchmarks
+static uint64_t stressRandom(uint64_t *state);
+
+
+/// @brief Returns random integer in [min, max]
+static int64_t stressRandomInt(uint64_t *state, int64_t min, int64_t max);
+
+
+/// @brief Returns random root, multiple of 1/ROOT_SCALE
+static double randomRoot(uint64_t *state);
+
+
+/// @brief Returns random nonzero coefficient with random sign, multiple of 1/LEADING_SCALE
+static double randomLeading(uint64_t *state);
+
+
+/// @brief Returns random double in [min, max) with all 53 bits of mantissa random
+static double randomUniform(uint64_t *state, double min, double max);
+
+
+/// @brief Returns random double with |x| in [min, max) and random sign
+static double randomSigned(uint64_t *state, double min, double max);
+
+
+/*!
+    @brief Generates equation of one of continuous families, coefficients are rounded
+
+    Expected roots are the chosen ones, error of solver on rounded coefficients is far below EPSILON,
+    so answers are compared with cmpDouble() like exact families. <br>
+    Near-degenerate families keep distance from EPSILON thresholds of absoluteEpsilonRule,
+    so expected code doesn't depend on rounding
+*/
+static void generateContinuous(uint64_t *state, enum stressFamily family, quadraticEquation_t *equation,
+                               solution_t *expected);
+
+
+/*!
+    @brief Allocates columns and expected answers for capacity equations
+
+    @return GOOD_EXIT or FAIL if memory can't be allocated
+*/
+static enum error stressBlockAlloc(stressBlock_t *block, size_t capacity);
+
+
+/// @brief Frees block and sets it to BLANK_STRESS_BLOCK
+static void stressBlockFree(stressBlock_t *block);
+
+
+/// @brief Prints generated equation, expected and given answers to stderr
+static void printStressFailure(const stressBlock_t *block, size_t row, size_t number);
+
+
+/// @brief Returns seconds between two points of time
+static double secondsSince(std::chrono::steady_clock::time_point start);
+
+
+static uint64_t stressRandom(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+
+static int64_t stressRandomInt(uint64_t *state, int64_t min, int64_t max) {
+    //modulo bias is below 2^-40 for these ranges
+    return min + (int64_t) (stressRandom(state) % (uint64_t) (max - min + 1));
+}
+
+
+static double randomRoot(uint64_t *state) {
+    return (double) stressRandomInt(state, -ROOT_STEPS, ROOT_STEPS) / ROOT_SCALE;
+}
+
+
+static double randomLeading(uint64_t *state) {
+    const double value = (double) stressRandomInt(state, 1, LEADING_STEPS) / LEADING_SCALE;
+    return (stressRandom(state) & 1) ? -value : value;
+}
+
+
+static double randomUniform(uint64_t *state, double min, double max) {
+    return min + (max - min) * ldexp((double) (stressRandom(state) >> 11), -53);
+}
+
+
+static double randomSigned(uint64_t *state, double min, double max) {
+    const double value = randomUniform(state, min, max);
+    return (stressRandom(state) & 1) ? -value : value;
+}
+
+
+static void generateContinuous(uint64_t *state, enum stressFamily family, quadraticEquation_t *equation,
+                               solution_t *expected) {
+    switch (family) {
+        case STRESS_RANDOM_ROOTS: {
+            const double a = randomSigned(state, MIN_LEADING, MAX_LEADING);
+            double r1 = randomUniform(state, -ROOT_LIMIT, ROOT_LIMIT), r2 = r1;
+            while (fabs(r2 - r1) < 1) r2 = randomUniform(state, -ROOT_LIMIT, ROOT_LIMIT);
+            if (r1 > r2) swap(&r1, &r2, sizeof(r1));
+            equation->a = a;
+            equation->b = -a * (r1 + r2);
+            equation->c = a * r1 * r2;
+            *expected = {TWO_ROOTS, r1, r2};
+            break;
+        }
+        case STRESS_TINY_LEADING: {
+            //|a| below EPSILON is zero, so equation is linear; above it D = a^2 (r1 - r2)^2 is below EPSILON
+            const int linear = (int) (stressRandom(state) & 1);
+            const double a = linear ? randomSigned(state, EPSILON / 4, EPSILON * 0.9)
+                                    : randomSigned(state, EPSILON * 1.1, EPSILON * 4);
+            const double r1 = randomUniform(state, -ROOT_LIMIT, ROOT_LIMIT);
+            const double r2 = randomUniform(state, -ROOT_LIMIT, ROOT_LIMIT);
+            if (linear) {
+                const double b = randomSigned(state, MIN_LEADING, MAX_LEADING);
+                equation->a = a;
+                equation->b = b;
+                equation->c = -b * r1;
+                *expected = {ONE_ROOT, r1, NAN};
+            } else {
+                equation->a = a;
+                equation->b = -a * (r1 + r2);
+                equation->c = a * r1 * r2;
+                *expected = {ONE_ROOT, (r1 + r2) / 2, NAN};
+            }
+            break;
+        }
+        case STRESS_NEAR_DOUBLE: {
+            //a(x - r)^2 - D/(4a) has discriminant D, it is below EPSILON/4 or at least 4 EPSILON by absolute value
+            const double a = randomSigned(state, MIN_LEADING, 1);
+            const double r = randomUniform(state, -NEAR_DOUBLE_CENTER, NEAR_DOUBLE_CENTER);
+            const int kind = (int) stressRandomInt(state, 0, 2);
+            const double D = (kind == 0) ? randomUniform(state, -EPSILON / 4, EPSILON / 4)
+                                         : randomSigned(state, 4 * EPSILON, 64 * EPSILON);
+            const double shift = sqrt(fabs(D)) / (2 * fabs(a));
+            equation->a = a;
+            equation->b = -2 * a * r;
+            equation->c = a * r * r - D / (4 * a);
+            if (kind == 0)
+                *expected = {ONE_ROOT, r, NAN};
+            else if (D > 0)
+                *expected = {TWO_ROOTS, r - shift, r + shift};
+            else
+                *expected = {ZERO_ROOTS, r, shift}; //complex roots r +- i*shift for complex mode
+            break;
+        }
+        case STRESS_FAR_ROOTS: {
+            const double a = randomSigned(state, MIN_LEADING, MAX_LEADING);
+            double r1 = randomSigned(state, FAR_ROOT_MIN, FAR_ROOT_MAX);
+            double r2 = randomSigned(state, NEAR_ROOT_MIN, 1);
+            equation->a = a;
+            equation->b = -a * (r1 + r2);
+            equation->c = a * r1 * r2;
+            if (r1 > r2) swap(&r1, &r2, sizeof(r1));
+            *expected = {TWO_ROOTS, r1, r2};
+            break;
+        }
+        case STRESS_TWO_ROOTS:
+        case STRESS_DOUBLE_ROOT:
+        case STRESS_NO_ROOTS:
+        case STRESS_LINEAR:
+        case STRESS_DEGENERATE:
+        case STRESS_FAMILIES:
+        default:
+            MY_ASSERT(0 && "family isn't continuous", return);
+    }
+}
+
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+enum stressFamily generateStressEquation(uint64_t *state, quadraticEquation_t *equation, solution_t *expected) {
+    MY_ASSERT(state && *state, return STRESS_FAMILIES);
+    MY_ASSERT(equation, return STRESS_FAMILIES);
+    MY_ASSERT(expected, return STRESS_FAMILIES);
+
+    const enum stressFamily family = (enum stressFamily) stressRandomInt(state, 0, STRESS_FAMILIES - 1);
+    *expected = BLANK_SOLUTION;
+    switch (family) {
+        case STRESS_TWO_ROOTS: {
+            const double a = randomLeading(state);
+            int64_t k1 = stressRandomInt(state, -ROOT_STEPS, ROOT_STEPS), k2 = k1;
+            while (k2 == k1) k2 = stressRandomInt(state, -ROOT_STEPS, ROOT_STEPS);
+            if (k1 > k2) swap(&k1, &k2, sizeof(k1));
+            const double r1 = (double) k1 / ROOT_SCALE, r2 = (double) k2 / ROOT_SCALE;
+            equation->a = a;
+            equation->b = -a * (r1 + r2);
+            equation->c = a * r1 * r2;
+            *expected = {TWO_ROOTS, r1, r2};
+            break;
+        }
+        case STRESS_DOUBLE_ROOT: {
+            const double a = randomLeading(state), r = randomRoot(state);
+            equation->a = a;
+            equation->b = -2 * a * r;
+            equation->c = a * r * r;
+            *expected = {ONE_ROOT, r, NAN};
+            break;
+        }
+        case STRESS_NO_ROOTS: {
+            const double a = randomLeading(state), p = randomRoot(state);
+            const double q = (double) stressRandomInt(state, 1, SHIFT_STEPS) / LEADING_SCALE;
+            equation->a = a;
+            equation->b = -2 * a * p;
+            equation->c = a * p * p + ((a > 0) ? q : -q); //discriminant is -4aq < 0
+            *expected = {ZERO_ROOTS, p, sqrt(q / fabs(a))}; //complex roots p +- i*sqrt(q/|a|) for complex mode
+            break;
+        }
+        case STRESS_LINEAR: {
+            const double b = randomLeading(state), r = randomRoot(state);
+            equation->a = 0;
+            equation->b = b;
+            equation->c = -b * r;
+            *expected = {ONE_ROOT, r, NAN};
+            break;
+        }
+        case STRESS_RANDOM_ROOTS:
+        case STRESS_TINY_LEADING:
+        case STRESS_NEAR_DOUBLE:
+        case STRESS_FAR_ROOTS:
+            generateContinuous(state, family, equation, expected);
+            break;
+        case STRESS_DEGENERATE:
+        case STRESS_FAMILIES:
+        default: {
+            const int zero = (int) (stressRandom(state) & 1);
+            equation->a = 0;
+            equation->b = 0;
+            equation->c = zero ? 0 : randomLeading(state);
+            expected->code = zero ? INF_ROOTS : ZERO_ROOTS;
+            break;
+        }
+    }
+    return family;
+}
+
+
+static enum error stressBlockAlloc(stressBlock_t *block, size_t capacity) {
+    PROPAGATE_ERROR(batchAlloc(&block->batch, capacity));
+    block->expected = (solution_t*) calloc(capacity, sizeof(solution_t));
+    block->family = (unsigned char*) calloc(capacity, sizeof(unsigned char));
+    if (!block->expected || !block->family) {
+        fprintf(stderr, RED "Can't allocate memory for stress test\n" RESET_C);
+        return FAIL;
+    }
+    return GOOD_EXIT;
+}
+
+
+static void stressBlockFree(stressBlock_t *block) {
+    batchFree(&block->batch);
+    free(block->expected);
+    free(block->family);
+    *block = BLANK_STRESS_BLOCK;
+}
+
+
+static void printStressFailure(const stressBlock_t *block, size_t row, size_t number) {
+    const quadraticBatch_t *batch = &block->batch;
+    fprintf(stderr, RED "Equation %zu (%s): a = %.17g, b = %.17g, c = %.17g\n"
+            "    expected code %d, x1 = %.17g, x2 = %.17g\n"
+            "    got      code %d, x1 = %.17g, x2 = %.17g" RESET_C "\n",
+            number, STRESS_FAMILY_NAMES[block->family[row]], batch->a[row], batch->b[row], batch->c[row],
+            block->expected[row].code, block->expected[row].x1, block->expected[row].x2,
+            batch->code[row], batch->x1[row], batch->x2[row]);
+}
+
+
+enum error runStressTest(size_t count, uint64_t seed, const batchOptions_t *options, stressStats_t *stats) {
+    MY_ASSERT(options, return FAIL);
+    MY_ASSERT(stats, return FAIL);
+    if (options->single) {
+        fprintf(stderr, "Stress test checks double solvers, single precision can't be used\n");
+        return BAD_EXIT;
+    }
+    if (seed == 0) {
+        fprintf(stderr, "Seed of stress test must not be 0\n");
+        return BAD_EXIT;
+    }
+
+    *stats = BLANK_STRESS_STATS;
+    stressBlock_t block = BLANK_STRESS_BLOCK;
+    if (stressBlockAlloc(&block, (count < STRESS_BLOCK) ? count : STRESS_BLOCK) != GOOD_EXIT) {
+        stressBlockFree(&block);
+        return FAIL;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t state = seed;
+    enum error result = GOOD_EXIT;
+    for (size_t begin = 0; begin < count && result == GOOD_EXIT; begin += STRESS_BLOCK) {
+        quadraticBatch_t *batch = &block.batch;
+        batch->size = (count - begin > STRESS_BLOCK) ? STRESS_BLOCK : count - begin;
+        TRACE_BEGIN(generateSpan);
+        for (size_t i = 0; i < batch->size; i++) {
+            quadraticEquation_t equation = BLANK_QUADRATIC_EQUATION;
+            block.family[i] = (unsigned char) generateStressEquation(&state, &equation, &block.expected[i]);
+            //only degenerate equations have ZERO_ROOTS without complex roots
+            if (options->complex && block.expected[i].code == ZERO_ROOTS && block.family[i] != STRESS_DEGENERATE)
+                block.expected[i].code = COMPLEX_ROOTS;
+            batch->a[i] = equation.a;
+            batch->b[i] = equation.b;
+            batch->c[i] = equation.c;
+        }
+        TRACE_END(generateSpan, "generate block");
+
+        const auto solveStart = std::chrono::steady_clock::now();
+        result = solveColumnsParallel(batch->size, batch->a, batch->b, batch->c,
+                                      batch->code, batch->x1, batch->x2, options);
+        stats->solveTime += secondsSince(solveStart);
+
+        TRACE_BEGIN(checkSpan);
+        for (size_t i = 0; i < batch->size && result == GOOD_EXIT; i++) {
+            const solution_t answer = {batch->code[i], batch->x1[i], batch->x2[i]};
+            stats->familyEquations[block.family[i]]++;
+            //classify mode doesn't find roots, only codes are checked
+            if (options->classify ? answer.code == block.expected[i].code : answerMatches(answer, block.expected[i]))
+                continue;
+
+            if (!options->silent && stats->failed < STRESS_PRINTED_FAILURES)
+                printStressFailure(&block, i, begin + i + 1);
+            stats->failed++;
+            stats->familyFailed[block.family[i]]++;
+        }
+        stats->equations += batch->size;
+        TRACE_END(checkSpan, "check block");
+    }
+    stats->wallTime = secondsSince(start);
+
+    stressBlockFree(&block);
+    if (result != GOOD_EXIT) return result;
+    return stats->failed ? BAD_EXIT : GOOD_EXIT;
+}
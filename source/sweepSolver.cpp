@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "error.h"
+#include "quadrEquation.h"
+#include "colors.h"
+#include "quadraticPrinter.h"
+#include "batchSolver.h"
+#include "simdKernels.h"
+#include "preciseSolver.h"
+#include "resultCache.h"
+#include "batchDedup.h"
+#include "asyncIO.h"
+#include "polynomialSolver.h"
+#include "batchProcessor.h"
+#include "sweepSolver.h"
+#include "utils.h"
+#include "tracer.h"
+
+
+/// @brief Maximum length of line "value code x1 x2"
+const size_t MAX_SWEEP_LINE_LEN = MAX_NUMBER_LEN + 1 + MAX_RESULT_LINE_LEN;
+
+
+/*!
+    @brief Solves points of sweep that can't be hoisted: columns are generated by blocks and solved by batch kernel
+
+    @param[in] sweep Sweep
+    @param[in] kernel Batch kernel
+    @param[in] first, count Range of points
+    @param[out] value, code, x1, x2 Columns for values and results
+*/
+static void solveSweepColumns(const sweep_t *sweep, batchKernel_t kernel, size_t first, size_t count,
+                              double value[], enum solutionCode code[], double x1[], double x2[]);
+
+
+double sweepValue(const sweep_t *sweep, size_t index) {
+    return sweep->start + (double) index * sweep->step;
+}
+
+
+enum error parseSweep(const char text[], enum sweepCoefficient *coefficient, double *start, double *stop, double *step) {
+    MY_ASSERT(coefficient, return FAIL);
+    MY_ASSERT(start && stop && step, return FAIL);
+    if (!text) return BAD_EXIT;
+
+    char name = 0;
+    int length = 0;
+    if (sscanf(text, "%c:%lf:%lf:%lf%n", &name, start, stop, step, &length) != 4 || text[length] != '\0')
+        return BAD_EXIT;
+    switch (name) {
+        case 'a': *coefficient = SWEEP_A; return GOOD_EXIT;
+        case 'b': *coefficient = SWEEP_B; return GOOD_EXIT;
+        case 'c': *coefficient = SWEEP_C; return GOOD_EXIT;
+        default:  return BAD_EXIT;
+    }
+}
+
+
+enum error sweepInit(sweep_t *sweep, const quadraticEquation_t *equation, enum sweepCoefficient coefficient,
+                     double start, double stop, double step, int complex) {
+    MY_ASSERT(sweep, return FAIL);
+    MY_ASSERT(equation, return FAIL);
+    *sweep = BLANK_SWEEP;
+
+    if (!isfinite(start) || !isfinite(stop) || !isfinite(step) || !(fabs(step) > 0)) {
+        fprintf(stderr, "Range of sweep must be finite and step can't be 0\n");
+        return BAD_EXIT;
+    }
+    const double steps = (stop - start) / step;
+    if (!(steps > -SWEEP_STEP_TOLERANCE) || steps + 1 >= (double) SWEEP_MAX_POINTS) {
+        fprintf(stderr, "Step of sweep must move start towards stop, number of points must be below 2^52\n");
+        return BAD_EXIT;
+    }
+
+    sweep->coefficient = coefficient;
+    sweep->start = start;
+    sweep->step = step;
+    sweep->count = (size_t) floor(steps + SWEEP_STEP_TOLERANCE * fmax(1, steps)) + 1;
+    sweep->complex = complex;
+    sweepRebase(sweep, equation->a, equation->b, equation->c);
+    return GOOD_EXIT;
+}
+
+
+void sweepRebase(sweep_t *sweep, double a, double b, double c) {
+    MY_ASSERT(sweep, return);
+    sweep->a = a;
+    sweep->b = b;
+    sweep->c = c;
+
+    //a is divisor of roots, so only sweeps with fixed nonzero a have invariants
+    const enum sweepCoefficient coefficient = sweep->coefficient;
+    const int fixedFinite = isfinite(a) && (coefficient == SWEEP_B || isfinite(b))
+                                        && (coefficient == SWEEP_C || isfinite(c));
+    sweep->hoisted = coefficient != SWEEP_A && fixedFinite && !isZero(a);
+    if (sweep->hoisted) {
+        sweepInvariants_t *invariants = &sweep->invariants;
+        invariants->start = sweep->start;
+        invariants->step = sweep->step;
+        //4*a*c is (4*a)*c in solveEquation(), so both invariants give the same D
+        invariants->fixedTerm = (coefficient == SWEEP_B) ? 4*a*c : b*b;
+        invariants->fourA = 4*a;
+        invariants->negB = -b;
+        invariants->vertex = -b / (2*a);
+        invariants->invTwoA = 1 / (2*a);
+    }
+}
+
+
+static void solveSweepColumns(const sweep_t *sweep, batchKernel_t kernel, size_t first, size_t count,
+                              double value[], enum solutionCode code[], double x1[], double x2[]) {
+    //varying column is value itself, fixed ones are filled once
+    double fixed1[SWEEP_COLUMNS_BLOCK] = {}, fixed2[SWEEP_COLUMNS_BLOCK] = {};
+    const double fixedValue1 = (sweep->coefficient == SWEEP_A) ? sweep->b : sweep->a;
+    const double fixedValue2 = (sweep->coefficient == SWEEP_C) ? sweep->b : sweep->c;
+    for (size_t i = 0; i < SWEEP_COLUMNS_BLOCK; i++) {
+        fixed1[i] = fixedValue1;
+        fixed2[i] = fixedValue2;
+    }
+
+    for (size_t begin = 0; begin < count; begin += SWEEP_COLUMNS_BLOCK) {
+        const size_t size = (count - begin > SWEEP_COLUMNS_BLOCK) ? SWEEP_COLUMNS_BLOCK : count - begin;
+        double *varying = value + begin;
+        for (size_t i = 0; i < size; i++)
+            varying[i] = sweepValue(sweep, first + begin + i);
+
+        const double *a = (sweep->coefficient == SWEEP_A) ? varying : fixed1;
+        const double *b = (sweep->coefficient == SWEEP_A) ? fixed1 : ((sweep->coefficient == SWEEP_B) ? varying : fixed2);
+        const double *c = (sweep->coefficient == SWEEP_C) ? varying : fixed2;
+        kernel(size, a, b, c, code + begin, x1 + begin, x2 + begin);
+    }
+}
+
+
+enum error solveSweepByType(const sweep_t *sweep, enum kernelType type, size_t first, size_t count,
+                            double value[], enum solutionCode code[], double x1[], double x2[]) {
+    MY_ASSERT(sweep, return FAIL);
+    MY_ASSERT(first <= sweep->count && count <= sweep->count - first, return FAIL);
+    if (count == 0) return GOOD_EXIT;
+    MY_ASSERT(value && code && x1 && x2, return FAIL);
+
+    if (sweep->hoisted) {
+        const sweepKernel_t kernel = getSweepKernelByType(type, sweep->coefficient == SWEEP_B, sweep->complex);
+        if (!kernel) return BAD_EXIT;
+        kernel(first, count, &sweep->invariants, value, code, x1, x2);
+        return GOOD_EXIT;
+    }
+
+    const batchKernel_t kernel = sweep->complex ? getComplexKernelByType(type) : getKernelByType(type);
+    if (!kernel) return BAD_EXIT;
+    solveSweepColumns(sweep, kernel, first, count, value, code, x1, x2);
+    return GOOD_EXIT;
+}
+
+
+enum error solveSweep(const sweep_t *sweep, size_t first, size_t count,
+                      double value[], enum solutionCode code[], double x1[], double x2[]) {
+    static const enum kernelType bestType = detectKernelType();
+    return solveSweepByType(sweep, bestType, first, count, value, code, x1, x2);
+}
+
+
+enum error writeSweepText(FILE *out, const sweep_t *sweep, enum numberStyle style, int codesOnly) {
+    MY_ASSERT(out, return FAIL);
+    MY_ASSERT(sweep, return FAIL);
+
+    quadraticBatch_t batch = BLANK_BATCH;
+    char *buffer = (char*) malloc(SWEEP_CHUNK * MAX_SWEEP_LINE_LEN);
+    if (!buffer || batchAlloc(&batch, SWEEP_CHUNK) != GOOD_EXIT) {
+        fprintf(stderr, RED "Can't allocate memory for sweep\n" RESET_C);
+        free(buffer);
+        batchFree(&batch);
+        return FAIL;
+    }
+
+    //column a of batch holds values of varying coefficient
+    enum error result = GOOD_EXIT;
+    for (size_t begin = 0; begin < sweep->count && result == GOOD_EXIT; begin += SWEEP_CHUNK) {
+        const size_t size = (sweep->count - begin > SWEEP_CHUNK) ? SWEEP_CHUNK : sweep->count - begin;
+        TRACE_BEGIN(solveSpan);
+        result = solveSweep(sweep, begin, size, batch.a, batch.code, batch.x1, batch.x2);
+        TRACE_END(solveSpan, "solve sweep chunk");
+        if (result != GOOD_EXIT) break;
+
+        TRACE_BEGIN(formatSpan);
+        char *pos = buffer;
+        for (size_t i = 0; i < size; i++) {
+            pos += formatNumber(pos, batch.a[i], style);
+            *pos++ = ' ';
+            if (codesOnly)
+                pos += formatCodeLine(pos, batch.code[i]);
+            else
+                pos += formatResultLine(pos, batch.code[i], batch.x1[i], batch.x2[i], style);
+        }
+        TRACE_END(formatSpan, "format sweep chunk");
+
+        TRACE_BEGIN(writeSpan);
+        const size_t written = (size_t) (pos - buffer);
+        if (fwrite(buffer, 1, written, out) != written) {
+            fprintf(stderr, RED "Can't write results\n" RESET_C);
+            result = FAIL;
+        }
+        TRACE_END(writeSpan, "write sweep chunk");
+    }
+    free(buffer);
+    batchFree(&batch);
+    return result;
+}
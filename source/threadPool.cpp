@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <pthread.h>
+#endif
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+
+#include "error.h"
+#include "threadPool.h"
+#include "tracer.h"
+
+
+/// @brief Task in worker queue
+typedef struct poolTask {
+    taskFunction_t function;    ///< Function to run
+    void *arg;                  ///< Argument of function
+} poolTask_t;
+
+
+/// @brief Task queue of one worker
+typedef struct workerQueue {
+    std::mutex lock {};         ///< Protects tasks
+    std::deque<poolTask_t> tasks {};
+} workerQueue_t;
+
+
+struct threadPool {
+    std::vector<std::thread> threads {};
+    std::vector<workerQueue_t> queues {};
+
+    std::mutex sleepLock {};                ///< Used by idle workers and threadPoolWait()
+    std::condition_variable taskAdded {};   ///< Notified when task is submitted or pool stops
+    std::condition_variable allDone {};     ///< Notified when unfinished becomes 0
+
+    std::atomic<size_t> queued {0};         ///< Tasks that are in queues
+    std::atomic<size_t> unfinished {0};     ///< Tasks that are in queues or running
+    std::atomic<size_t> nextQueue {0};      ///< Queue for next task submitted from outside
+    std::atomic<bool> stop {false};
+};
+
+
+/// @brief Piece of range for threadPoolParallelFor()
+typedef struct rangeTask {
+    size_t begin, end;          ///< Range [begin, end)
+    rangeFunction_t function;   ///< Function that processes range
+    void *arg;                  ///< Argument of function
+} rangeTask_t;
+
+
+/// @brief Index of worker queue for current thread, -1 if thread isn't worker
+static thread_local long currentWorker = -1;
+
+
+/*!
+    @brief Takes task from own queue or steals it from others
+
+    @param[in] pool Pointer to pool
+    @param[in] self Index of worker
+    @param[out] task Taken task
+
+    @return 1 if task was taken, else 0
+
+    Both owner and thieves take the oldest task, so chunks are finished roughly in order they were submitted
+*/
+static int takeTask(threadPool_t *pool, size_t self, poolTask_t *task);
+
+
+/// @brief Runs rangeTask_t, used as task function
+static void runRangeTask(void *task);
+
+
+/// @brief Main loop of worker thread
+static void workerLoop(threadPool_t *pool, size_t self);
+
+
+size_t hardwareThreads() {
+    const unsigned int threads = std::thread::hardware_concurrency();
+    return (threads == 0) ? 1 : threads;
+}
+
+
+threadPool_t *threadPoolCreate(size_t threads) {
+    if (threads == 0) threads = hardwareThreads();
+
+    threadPool_t *pool = new (std::nothrow) threadPool_t;
+    if (!pool) {
+        fprintf(stderr, RED "Can't allocate memory for thread pool\n" RESET_C);
+        return NULL;
+    }
+#ifndef _WIN32
+    //workers inherit signal mask, so SIGINT and SIGTERM go to creator, servers take them from signalfd
+    sigset_t allSignals = {}, oldSignals = {};
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_BLOCK, &allSignals, &oldSignals);
+#endif
+    int started = 1;
+    try {
+        pool->queues = std::vector<workerQueue_t>(threads);
+        pool->threads.reserve(threads);
+        for (size_t i = 0; i < threads; i++)
+            pool->threads.emplace_back(workerLoop, pool, i);
+    } catch (...) {
+        started = 0;
+    }
+#ifndef _WIN32
+    pthread_sigmask(SIG_SETMASK, &oldSignals, NULL);
+#endif
+
+    if (!started) {
+        fprintf(stderr, RED "Can't start worker threads\n" RESET_C);
+        threadPoolDestroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+
+void threadPoolDestroy(threadPool_t *pool) {
+    if (!pool) return;
+
+    if (!pool->threads.empty())
+        threadPoolWait(pool);
+    {
+        std::lock_guard<std::mutex> guard(pool->sleepLock);
+        pool->stop = true;
+    }
+    pool->taskAdded.notify_all();
+
+    for (std::thread &thread : pool->threads)
+        thread.join();
+    delete pool;
+}
+
+
+enum error threadPoolSubmit(threadPool_t *pool, taskFunction_t function, void *arg) {
+    MY_ASSERT(pool, return FAIL);
+    MY_ASSERT(function, return FAIL);
+
+    const size_t queueIndex = (currentWorker >= 0) ? (size_t) currentWorker
+                                                   : pool->nextQueue.fetch_add(1) % pool->queues.size();
+    pool->unfinished++;
+    {
+        //incremented under sleepLock, so sleeping worker can't miss it; before push, so it never underflows
+        std::lock_guard<std::mutex> guard(pool->sleepLock);
+        pool->queued++;
+    }
+    {
+        std::lock_guard<std::mutex> guard(pool->queues[queueIndex].lock);
+        pool->queues[queueIndex].tasks.push_back({function, arg});
+    }
+    pool->taskAdded.notify_one();
+    return GOOD_EXIT;
+}
+
+
+void threadPoolWait(threadPool_t *pool) {
+    MY_ASSERT(pool, return);
+    MY_ASSERT(currentWorker < 0, return);
+
+    std::unique_lock<std::mutex> guard(pool->sleepLock);
+    pool->allDone.wait(guard, [pool] { return pool->unfinished == 0; });
+}
+
+
+enum error threadPoolParallelFor(threadPool_t *pool, size_t count, size_t grain, rangeFunction_t function, void *arg) {
+    MY_ASSERT(function, return FAIL);
+    if (count == 0) return GOOD_EXIT;
+    if (!pool) {
+        function(0, count, arg);
+        return GOOD_EXIT;
+    }
+
+    //a few pieces per thread, so threads that finished early can steal work
+    const size_t TASKS_PER_THREAD = 4;
+    size_t pieceSize = (count + TASKS_PER_THREAD * pool->threads.size() - 1) / (TASKS_PER_THREAD * pool->threads.size());
+    if (pieceSize < grain) pieceSize = grain;
+    const size_t pieces = (count + pieceSize - 1) / pieceSize;
+
+    rangeTask_t *tasks = (rangeTask_t*) calloc(pieces, sizeof(rangeTask_t));
+    if (!tasks) {
+        fprintf(stderr, RED "Can't allocate memory for tasks\n" RESET_C);
+        return FAIL;
+    }
+    for (size_t i = 0; i < pieces; i++) {
+        tasks[i].begin = i * pieceSize;
+        tasks[i].end = (tasks[i].begin + pieceSize < count) ? tasks[i].begin + pieceSize : count;
+        tasks[i].function = function;
+        tasks[i].arg = arg;
+        threadPoolSubmit(pool, runRangeTask, tasks + i);
+    }
+    threadPoolWait(pool);
+    free(tasks);
+    return GOOD_EXIT;
+}
+
+
+static void runRangeTask(void *task) {
+    const rangeTask_t *range = (const rangeTask_t*) task;
+    range->function(range->begin, range->end, range->arg);
+}
+
+
+size_t threadPoolSize(const threadPool_t *pool) {
+    MY_ASSERT(pool, return 0);
+    return pool->threads.size();
+}
+
+
+static int takeTask(threadPool_t *pool, size_t self, poolTask_t *task) {
+    const size_t queuesCount = pool->queues.size();
+    for (size_t shift = 0; shift < queuesCount; shift++) {
+        workerQueue_t &queue = pool->queues[(self + shift) % queuesCount];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.tasks.empty()) continue;
+
+        *task = queue.tasks.front();
+        queue.tasks.pop_front();
+        pool->queued--;
+        return 1;
+    }
+    return 0;
+}
+
+
+static void workerLoop(threadPool_t *pool, size_t self) {
+    currentWorker = (long) self;
+    TRACE_THREAD_NAME("worker");
+    while (true) {
+        poolTask_t task = {NULL, NULL};
+        if (takeTask(pool, self, &task)) {
+            task.function(task.arg);
+            if (--pool->unfinished == 0) {
+                std::lock_guard<std::mutex> guard(pool->sleepLock);
+                pool->allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(pool->sleepLock);
+        pool->taskAdded.wait(guard, [pool] { return pool->stop || pool->queued > 0; });
+        if (pool->stop && pool->queued == 0) return;
+    }
+}
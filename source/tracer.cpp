@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "error.h"
+#include "tracer.h"
+
+
+/// @brief Span of work in one thread
+typedef struct traceEvent {
+    const char *name;           ///< Name of span
+    uint64_t start;             ///< Ticks at the beginning
+    uint64_t end;               ///< Ticks at the end
+} traceEvent_t;
+
+
+/// @brief Spans of one thread, only this thread writes to it until traceDump()
+typedef struct traceBuffer {
+    traceEvent_t *events;       ///< Recorded spans
+    size_t count;               ///< Number of spans
+    size_t capacity;            ///< Number of allocated spans
+    size_t dropped;             ///< Spans that didn't fit in TRACE_MAX_EVENTS or in memory
+    size_t tid;                 ///< Number of thread in trace, starts with 1
+    const char *threadName;     ///< Name from traceThreadName() or NULL
+} traceBuffer_t;
+
+const traceBuffer_t BLANK_TRACE_BUFFER = {NULL, 0, 0, 0, 0, NULL};
+
+
+/// @brief State of tracer, buffers of threads are kept after threads end
+typedef struct tracer {
+    std::atomic<bool> enabled {false};
+    std::mutex lock {};                         ///< Protects buffers
+    std::vector<traceBuffer_t*> buffers {};
+    uint64_t enableTicks = 0;                   ///< traceNow() in traceEnable()
+    std::chrono::steady_clock::time_point enableTime {};
+} tracer_t;
+
+
+static tracer_t tracer;
+
+/// @brief Buffer of current thread, created by the first span
+static thread_local traceBuffer_t *threadBuffer = NULL;
+
+
+/*!
+    @brief Returns buffer of current thread, creates and registers it if needed
+
+    @return Pointer to buffer or NULL if memory can't be allocated
+*/
+static traceBuffer_t *currentBuffer();
+
+
+/// @brief Writes event of one span in JSON
+static void writeTraceEvent(FILE *file, const traceBuffer_t *buffer, const traceEvent_t *event, uint64_t base,
+                            double ticksPerMicrosecond, int *first);
+
+
+uint64_t traceNow() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+
+static traceBuffer_t *currentBuffer() {
+    if (threadBuffer) return threadBuffer;
+
+    traceBuffer_t *buffer = (traceBuffer_t*) calloc(1, sizeof(traceBuffer_t));
+    if (!buffer) return NULL;
+    *buffer = BLANK_TRACE_BUFFER;
+
+    std::lock_guard<std::mutex> guard(tracer.lock);
+    tracer.buffers.push_back(buffer);
+    buffer->tid = tracer.buffers.size();
+    threadBuffer = buffer;
+    return buffer;
+}
+
+
+void traceRecord(const char *name, uint64_t start) {
+    if (!tracer.enabled.load(std::memory_order_relaxed)) return;
+    const uint64_t end = traceNow();
+
+    traceBuffer_t *buffer = currentBuffer();
+    if (!buffer) return;
+    if (buffer->count == buffer->capacity) {
+        const size_t capacity = buffer->capacity ? 2 * buffer->capacity : TRACE_INITIAL_EVENTS;
+        traceEvent_t *events = (capacity <= TRACE_MAX_EVENTS) ?
+                               (traceEvent_t*) realloc(buffer->events, capacity * sizeof(traceEvent_t)) : NULL;
+        if (!events) {
+            buffer->dropped++;
+            return;
+        }
+        buffer->events = events;
+        buffer->capacity = capacity;
+    }
+    buffer->events[buffer->count++] = {name, start, end};
+}
+
+
+void traceThreadName(const char *name) {
+    if (!tracer.enabled.load(std::memory_order_relaxed)) return;
+    traceBuffer_t *buffer = currentBuffer();
+    if (buffer) buffer->threadName = name;
+}
+
+
+enum error traceEnable() {
+#ifdef ENABLE_TRACING
+    tracer.enableTicks = traceNow();
+    tracer.enableTime = std::chrono::steady_clock::now();
+    tracer.enabled = true;
+    traceThreadName("main");
+    return GOOD_EXIT;
+#else
+    fprintf(stderr, "Tracing isn't supported in this build, compile with -DENABLE_TRACING\n");
+    return BAD_EXIT;
+#endif
+}
+
+
+static void writeTraceEvent(FILE *file, const traceBuffer_t *buffer, const traceEvent_t *event, uint64_t base,
+                            double ticksPerMicrosecond, int *first) {
+    fprintf(file, "%s\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %zu, \"ts\": %.3f, \"dur\": %.3f}",
+            *first ? "" : ",", event->name, buffer->tid, (double) (event->start - base) / ticksPerMicrosecond,
+            (double) (event->end - event->start) / ticksPerMicrosecond);
+    *first = 0;
+}
+
+
+enum error traceDump(const char name[]) {
+    MY_ASSERT(name, return FAIL);
+    tracer.enabled = false;
+
+    //ticks are calibrated on the whole traced run, it's long enough for TSC
+    const uint64_t ticks = traceNow() - tracer.enableTicks;
+    const double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now()
+                                                                          - tracer.enableTime).count();
+    const double ticksPerMicrosecond = (ticks > 0 && microseconds > 0) ? (double) ticks / microseconds : 1000;
+
+    std::lock_guard<std::mutex> guard(tracer.lock);
+    //spans can start before traceEnable(), time of trace begins with the earliest one
+    uint64_t base = tracer.enableTicks;
+    size_t dropped = 0;
+    for (const traceBuffer_t *buffer : tracer.buffers) {
+        for (size_t i = 0; i < buffer->count; i++)
+            if (buffer->events[i].start < base) base = buffer->events[i].start;
+        dropped += buffer->dropped;
+    }
+
+    enum error result = GOOD_EXIT;
+    FILE *file = fopen(name, "w");
+    if (!file) {
+        fprintf(stderr, "Can't create file \"%s\"\n", name);
+        result = FAIL;
+    } else {
+        int first = 1;
+        fprintf(file, "{\"displayTimeUnit\": \"ns\", \"otherData\": {\"droppedSpans\": %zu}, \"traceEvents\": [", dropped);
+        for (const traceBuffer_t *buffer : tracer.buffers) {
+            if (buffer->threadName) {
+                fprintf(file, "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %zu, "
+                        "\"args\": {\"name\": \"%s\"}}", first ? "" : ",", buffer->tid, buffer->threadName);
+                first = 0;
+            }
+            for (size_t i = 0; i < buffer->count; i++)
+                writeTraceEvent(file, buffer, &buffer->events[i], base, ticksPerMicrosecond, &first);
+        }
+        fprintf(file, "\n]}\n");
+        if (ferror(file) | fclose(file)) {
+            fprintf(stderr, "Can't write file \"%s\"\n", name);
+            result = FAIL;
+        }
+    }
+    if (dropped > 0)
+        fprintf(stderr, "Trace: %zu spans were dropped, buffers of threads are full\n", dropped);
+
+    for (traceBuffer_t *buffer : tracer.buffers) {
+        free(buffer->events);
+        free(buffer);
+    }
+    tracer.buffers.clear();
+    threadBuffer = NULL;
+    return result;
+}
@@ -1,33 +1,313 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 #include "error.h"
 #include "quadrEquation.h"
 #include "colors.h"
 #include "quadraticSolver.h"
+#include "preciseSolver.h"
+#include "batchSolver.h"
+#include "simdKernels.h"
+#include "polynomialSolver.h"
+#include "resultCache.h"
 #include "quadraticPrinter.h"
+#include "batchDedup.h"
+#include "asyncIO.h"
+#include "batchProcessor.h"
+#include "solverServer.h"
+#include "sweepSolver.h"
+#include "planeMap.h"
 #include "unitTester.h"
 #include "utils.h"
+#include "genericSolver.h"
+#include "inputHandler.h"
+#include "mappedFile.h"
 
 #include "testData.h"
 
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <thread>
+#endif
+
+/// @brief Function that solves test equation and checks answer
+typedef enum error (*testRunner_t)(unitTest_t test);
+
+
+/// @brief Capacity of cache used by runTestCached(), all internal tests fit in it
+const size_t TEST_CACHE_CAPACITY = 1024;
+
+/// @brief Cache used by runTestCached(), exists only while unitTestingInternal() runs cached tests
+static resultCache_t *testCache = NULL;
+
+
 /*!
     @brief Runs unit-tests
 
     @param[in] testData Array of unit tests
     @param[in] testSize Number of tests in array
     @param[in] silent: if 1 - unit testing should go silently, if 0 - print all messages
+    @param[in] runner Function that runs one test: runTest(), runTestPrecise() or runTestCached()
 
     @return error code
 
     Expects testData.h to be included
 */
-static enum error unitTesting(const unitTest_t testData[], int testSize, int silent);
+static enum error unitTesting(const unitTest_t testData[], int testSize, int silent, testRunner_t runner);
+
+
+/*!
+    @brief Runs unit tests of polynomial solver like unitTesting() does
+
+    @param[in] testData Array of tests
+    @param[in] testSize Number of tests in array
+    @param[in] silent: if 1 - unit testing should go silently, if 0 - print all messages
+
+    @return error code
+*/
+static enum error polyUnitTesting(const polyTest_t testData[], int testSize, int silent);
+
+
+/*!
+    @brief Solves all tests by columns with complex kernel of every type supported by CPU
+
+    @param[in] testData Array of tests, expected answers are the same as for runTestComplex()
+    @param[in] testSize Number of tests in array
+
+    @return GOOD_EXIT if every kernel gives expected answers, else BAD_EXIT
+*/
+static enum error complexKernelsTesting(const unitTest_t testData[], int testSize);
+
+
+/// @brief Coefficients that aren't in test tables, kernels must handle them exactly like solveEquation()
+const double SPECIAL_KERNEL_ROWS[][3] = {
+    {0, 0, 0},          {-0.0, -0.0, -0.0},  {0, 0, 1},        {0, -0.0, 1},     {0, 2, -0.0},
+    {1, 0, -0.0},       {-0.0, 1, 1},        {NAN, 1, 1},      {1, NAN, 1},      {1, 1, NAN},
+    {INFINITY, 1, 1},   {1, -INFINITY, 1},   {1, 1, INFINITY}, {0, INFINITY, 1}, {0, 0, NAN},
+};
+
+/// @brief Number of times rows are repeated by realKernelsTesting(), so vector loops and their tails are checked
+const int KERNEL_TEST_REPEATS = 3;
+
+
+/*!
+    @brief Solves tests and special rows with double and float kernels of every type supported by CPU
+
+    @param[in] testData Array of tests, only coefficients are used
+    @param[in] testSize Number of tests in array
+
+    @return GOOD_EXIT if every kernel gives bit-identical answers to solveEquation() and solveEquationF(), else BAD_EXIT
+*/
+static enum error realKernelsTesting(const unitTest_t testData[], int testSize);
+
+
+/// @brief Number of times tests are repeated by classifyKernelsTesting(), so packed codes take several words
+const int CLASSIFY_TEST_REPEATS = 5;
+
+
+/*!
+    @brief Classifies tests by columns with classify kernel of every type supported by CPU and with packed column
+
+    @param[in] testData Array of tests, only codes are compared
+    @param[in] testSize Number of tests in array
+
+    @return GOOD_EXIT if every kernel and unpacked column give expected codes, else BAD_EXIT
+
+    Tests are repeated CLASSIFY_TEST_REPEATS times, so vector loops, their tails and borders of packed words are checked
+*/
+static enum error classifyKernelsTesting(const unitTest_t testData[], int testSize);
+
+
+/// @brief Number of points that sweepTesting() solves at once in its second pass
+const size_t SWEEP_TEST_PIECE = 3;
+
+/// @brief Number of columns that planeTesting() classifies at once
+const size_t PLANE_TEST_PIECE = 4;
+
+
+/*!
+    @brief Solves sweeps with kernels of every type supported by CPU and compares every point with solveEquation()
+
+    @param[in] testData Array of sweep tests
+    @param[in] testSize Number of tests in array
+
+    @return GOOD_EXIT if every point has the same value and answer, else BAD_EXIT
+
+    Every sweep is solved twice: at once and by pieces of SWEEP_TEST_PIECE points, so values of pieces
+    that don't start at 0 and tails of vector loops are checked
+*/
+static enum error sweepTesting(const sweepTest_t testData[], int testSize);
+
+
+/*!
+    @brief Classifies rows of planes by pieces with kernels of every type and compares codes with solveEquation()
+
+    @param[in] testData Array of plane tests
+    @param[in] testSize Number of tests in array
+
+    @return GOOD_EXIT if every point has the same code, else BAD_EXIT
+*/
+static enum error planeTesting(const planeTest_t testData[], int testSize);
+
+
+#ifdef __linux__
+/// @brief Number of equations in requests of framing tests, odd, so code column of reply is padded
+const size_t SERVER_TEST_ROWS = 37;
+
+/// @brief Number of equations in requests that are sent without reading replies
+const size_t SERVER_FLOOD_ROWS = 4096;
+
+/// @brief Client stops sending if server hasn't read anything for this time, so server is backpressured
+const int SERVER_STALL_MS = 100;
+
+/// @brief Client that has sent this many bytes without backpressure fails the test
+const size_t SERVER_FLOOD_LIMIT = 16 * SERVER_OUTPUT_LIMIT;
+
+/// @brief Time in ms that test waits for server to start or to answer
+const int SERVER_TEST_TIMEOUT_MS = 5000;
+
+
+/// @brief Server of serverTesting() that runs in it's own thread
+typedef struct serverTest {
+    char path[64];              ///< Path of socket
+    batchOptions_t options;     ///< Default batch settings
+    serverStats_t stats;        ///< Counters of server at shutdown
+    enum error result;          ///< Result of serveSolver()
+} serverTest_t;
+
+
+/*!
+    @brief Runs server of Unix socket in thread and checks it's protocol as client
+
+    @return GOOD_EXIT if frames split to pieces and sent together are answered in order, frames of bad size
+            get SERVER_BAD_SIZE without closing connection and server stops reading client that doesn't take replies
+
+    Server is stopped with SIGTERM to it's thread, it's taken from signalfd like SIGINT in serve mode
+*/
+static enum error serverTesting();
+
+
+/// @brief Runs serveSolver() for serverTest_t, function of server thread
+static void runTestServer(serverTest_t *test);
+
+
+/// @brief Connects to server, retries while it creates socket
+static int connectTestServer(const char path[]);
+
+
+/// @brief Sends size bytes, socket must be blocking
+static enum error sendTestBytes(int fd, const void *data, size_t size);
+
+
+/// @brief Receives exactly size bytes, socket must be blocking
+static enum error receiveTestBytes(int fd, void *data, size_t size);
+
+
+/// @brief Writes SERVER_SOLVE frame with rows of fillTestRows() to buffer and returns it's size
+static size_t putSolveFrame(char *buffer, size_t rows, uint64_t id);
+
+
+/// @brief Fills columns of count equations that cover all exit codes
+static void fillTestRows(size_t count, double a[], double b[], double c[]);
 
 
-static enum error unitTesting(const unitTest_t testData[], int testSize, int silent) {
+/*!
+    @brief Receives reply and checks it's header and, for SERVER_SOLVE, roots of fillTestRows() equations
+
+    @return GOOD_EXIT if reply has expected id, type, status and rows match solveEquation(), else BAD_EXIT
+*/
+static enum error checkTestReply(int fd, uint64_t id, uint16_t type, enum serverStatus status, size_t rows);
+
+
+/// @brief Sends SERVER_FLOOD_ROWS requests without reading replies until server stops reading, then takes all replies
+static enum error floodTestServer(int fd);
+#endif
+
+
+/*!
+    @brief Compares solved equation of test with expected data
+
+    @param[in] test Test with solved equation
+
+    @return GOOD_EXIT if answer matches, else BAD_EXIT
+*/
+static enum error checkTestAnswer(unitTest_t test);
+
+
+/*!
+    @brief Checks test like checkTestAnswer(), but with solveQuadraticT(), so it can run at compile time
+
+    @tparam T Type of numbers that test is solved with
+
+    @param[in] test Test with coefficients and expected data
+
+    @return true if answer matches
+*/
+template <typename T>
+static constexpr bool testPassesT(const unitTest_t &test);
+
+
+/*!
+    @brief Checks all tests with testPassesT() for float, double and long double
+
+    @return Index of the first failed test or count if all tests pass
+*/
+static constexpr size_t firstFailedTest(const unitTest_t testData[], size_t count);
+
+
+template <typename T>
+static constexpr bool testPassesT(const unitTest_t &test) {
+    typedSolution<T> answer = BLANK_TYPED_SOLUTION<T>;
+    solveQuadraticT<T, checkedPolicy_t>((T) test.inputData.a, (T) test.inputData.b, (T) test.inputData.c, &answer);
+
+    const solution_t expected = test.expectedData;
+    if (answer.code != expected.code) return false;
+    if (classifyQuadraticT<T, checkedPolicy_t>((T) test.inputData.a, (T) test.inputData.b, (T) test.inputData.c)
+        != answer.code) return false;
+    if (answer.code == ONE_ROOT || answer.code == TWO_ROOTS) {
+        if (!(constexprAbs(answer.x1 - (T) expected.x1) < epsilonFor<T>())) return false;
+    }
+    if (answer.code == TWO_ROOTS) {
+        if (!(constexprAbs(answer.x2 - (T) expected.x2) < epsilonFor<T>())) return false;
+    }
+    return true;
+}
+
+
+static constexpr size_t firstFailedTest(const unitTest_t testData[], size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (!testPassesT<float>(testData[i]) || !testPassesT<double>(testData[i]) || !testPassesT<long double>(testData[i]))
+            return i;
+    }
+    return count;
+}
+
+//the same tests are run by unitTestingInternal(), here they fail the build
+static_assert(firstFailedTest(internalTestData, internalTestSize) == internalTestSize,
+              "internalTestData from testData.h fails at compile time");
+
+//zero rule of policy decides what is tiny: exactZeroRule keeps coefficients that solveEquation() drops
+static_assert(classifyQuadraticT<double, checkedPolicy_t>(1e-12, 1, -1) == ONE_ROOT
+              && classifyQuadraticT<double, solverPolicy<true, exactZeroRule>>(1e-12, 1, -1) == TWO_ROOTS
+              && classifyQuadraticT<double, checkedPolicy_t>(1e-12, 1e-12, 1e-12) == INF_ROOTS
+              && classifyQuadraticT<double, solverPolicy<true, exactZeroRule>>(1e-12, 1e-12, 1e-12) == ZERO_ROOTS,
+              "exactZeroRule must treat only 0 and -0 as zeros");
+
+
+static enum error unitTesting(const unitTest_t testData[], int testSize, int silent, testRunner_t runner) {
     for (int testIndex = 0; testIndex < testSize; testIndex++) {
-        if (runTest(testData[testIndex]) != GOOD_EXIT) {
+        if (runner(testData[testIndex]) != GOOD_EXIT) {
             fprintf(stderr, RED_BKG "UNIT TESTING FAILED on test %d" RESET_C "\n", testIndex + 1);
             return BAD_EXIT;
         }
@@ -39,52 +319,683 @@ static enum error unitTesting(const unitTest_t testData[], int testSize, int sil
 }
 
 
+static enum error complexKernelsTesting(const unitTest_t testData[], int testSize) {
+    quadraticBatch_t batch = BLANK_BATCH;
+    PROPAGATE_ERROR(batchAlloc(&batch, (size_t) testSize));
+    for (int i = 0; i < testSize; i++) {
+        batch.a[i] = testData[i].inputData.a;
+        batch.b[i] = testData[i].inputData.b;
+        batch.c[i] = testData[i].inputData.c;
+    }
+
+    enum error result = GOOD_EXIT;
+    for (int type = 0; type < KERNEL_TYPES_COUNT && result == GOOD_EXIT; type++) {
+        const batchKernel_t kernel = getComplexKernelByType((enum kernelType) type);
+        if (!kernel) continue;
+
+        kernel((size_t) testSize, batch.a, batch.b, batch.c, batch.code, batch.x1, batch.x2);
+        for (int i = 0; i < testSize && result == GOOD_EXIT; i++) {
+            const solution_t answer = {batch.code[i], batch.x1[i], batch.x2[i]};
+            if (answerMatches(answer, testData[i].expectedData)) continue;
+
+            fprintf(stderr, RED_BKG "UNIT TESTING FAILED on test %d with complex %s kernel:" RESET_C
+                    " code %d, x1 = %lg, x2 = %lg\n", i + 1, kernelName((enum kernelType) type),
+                    answer.code, answer.x1, answer.x2);
+            result = BAD_EXIT;
+        }
+    }
+    batchFree(&batch);
+    return result;
+}
+
+
+static enum error realKernelsTesting(const unitTest_t testData[], int testSize) {
+    const size_t rows = (size_t) testSize + sizeof(SPECIAL_KERNEL_ROWS) / sizeof(SPECIAL_KERNEL_ROWS[0]);
+    const size_t count = rows * KERNEL_TEST_REPEATS;
+    quadraticBatch_t batch = BLANK_BATCH;
+    quadraticBatchF_t batchF = BLANK_BATCH_F;
+    if (batchAlloc(&batch, count) != GOOD_EXIT || batchAllocF(&batchF, count) != GOOD_EXIT) {
+        batchFree(&batch);
+        return FAIL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const size_t row = i % rows;
+        if (row < (size_t) testSize) {
+            batch.a[i] = testData[row].inputData.a;
+            batch.b[i] = testData[row].inputData.b;
+            batch.c[i] = testData[row].inputData.c;
+        } else {
+            batch.a[i] = SPECIAL_KERNEL_ROWS[row - (size_t) testSize][0];
+            batch.b[i] = SPECIAL_KERNEL_ROWS[row - (size_t) testSize][1];
+            batch.c[i] = SPECIAL_KERNEL_ROWS[row - (size_t) testSize][2];
+        }
+        batchF.a[i] = (float) batch.a[i];
+        batchF.b[i] = (float) batch.b[i];
+        batchF.c[i] = (float) batch.c[i];
+    }
+
+    enum error result = GOOD_EXIT;
+    for (int type = 0; type < KERNEL_TYPES_COUNT && result == GOOD_EXIT; type++) {
+        const batchKernel_t kernel = getKernelByType((enum kernelType) type);
+        if (kernel) kernel(count, batch.a, batch.b, batch.c, batch.code, batch.x1, batch.x2);
+        for (size_t i = 0; kernel && i < count && result == GOOD_EXIT; i++) {
+            quadraticEquation_t equation = {batch.a[i], batch.b[i], batch.c[i], BLANK_SOLUTION};
+            solveEquation(&equation);
+            if (batch.code[i] == equation.answer.code && memcmp(&batch.x1[i], &equation.answer.x1, sizeof(double)) == 0
+                && memcmp(&batch.x2[i], &equation.answer.x2, sizeof(double)) == 0) continue;
+
+            fprintf(stderr, RED_BKG "UNIT TESTING FAILED on row %zu with %s kernel:" RESET_C
+                    " code %d, x1 = %lg, x2 = %lg instead of code %d, x1 = %lg, x2 = %lg\n", i % rows + 1,
+                    kernelName((enum kernelType) type), batch.code[i], batch.x1[i], batch.x2[i],
+                    equation.answer.code, equation.answer.x1, equation.answer.x2);
+            result = BAD_EXIT;
+        }
+
+        const batchKernelF_t kernelF = getKernelFByType((enum kernelType) type);
+        if (kernelF) kernelF(count, batchF.a, batchF.b, batchF.c, batchF.code, batchF.x1, batchF.x2);
+        for (size_t i = 0; kernelF && i < count && result == GOOD_EXIT; i++) {
+            quadraticEquationF_t equation = {batchF.a[i], batchF.b[i], batchF.c[i], BLANK_SOLUTION_F};
+            solveEquationF(&equation);
+            if (batchF.code[i] == equation.answer.code && memcmp(&batchF.x1[i], &equation.answer.x1, sizeof(float)) == 0
+                && memcmp(&batchF.x2[i], &equation.answer.x2, sizeof(float)) == 0) continue;
+
+            fprintf(stderr, RED_BKG "UNIT TESTING FAILED on row %zu with single-precision %s kernel:" RESET_C
+                    " code %d, x1 = %g, x2 = %g instead of code %d, x1 = %g, x2 = %g\n", i % rows + 1,
+                    kernelName((enum kernelType) type), batchF.code[i], batchF.x1[i], batchF.x2[i],
+                    equation.answer.code, equation.answer.x1, equation.answer.x2);
+            result = BAD_EXIT;
+        }
+    }
+    batchFree(&batch);
+    batchFreeF(&batchF);
+    return result;
+}
+
+
+static enum error classifyKernelsTesting(const unitTest_t testData[], int testSize) {
+    const size_t count = (size_t) testSize * CLASSIFY_TEST_REPEATS;
+    quadraticBatch_t batch = BLANK_BATCH;
+    uint64_t *packed = (uint64_t*) calloc(packedCodeWords(count), sizeof(uint64_t));
+    if (!packed || batchAlloc(&batch, count) != GOOD_EXIT) {
+        free(packed);
+        return FAIL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        batch.a[i] = testData[i % (size_t) testSize].inputData.a;
+        batch.b[i] = testData[i % (size_t) testSize].inputData.b;
+        batch.c[i] = testData[i % (size_t) testSize].inputData.c;
+    }
+
+    enum error result = GOOD_EXIT;
+    //the last pass checks packed column instead of kernel
+    for (int type = 0; type <= KERNEL_TYPES_COUNT && result == GOOD_EXIT; type++) {
+        const char *name = (type == KERNEL_TYPES_COUNT) ? "packed" : kernelName((enum kernelType) type);
+        if (type == KERNEL_TYPES_COUNT) {
+            classifyEquationsPacked(count, batch.a, batch.b, batch.c, packed);
+            for (size_t i = 0; i < count; i++)
+                batch.code[i] = unpackCode(packed, i);
+        } else {
+            const classifyKernel_t kernel = getClassifyKernelByType((enum kernelType) type);
+            if (!kernel) continue;
+            kernel(count, batch.a, batch.b, batch.c, batch.code);
+        }
+
+        for (size_t i = 0; i < count && result == GOOD_EXIT; i++) {
+            const enum solutionCode expected = testData[i % (size_t) testSize].expectedData.code;
+            if (batch.code[i] == expected) continue;
+
+            fprintf(stderr, RED_BKG "UNIT TESTING FAILED on test %zu with %s classify kernel:" RESET_C
+                    " expected code %d, got %d\n", i % (size_t) testSize + 1, name, expected, batch.code[i]);
+            result = BAD_EXIT;
+        }
+    }
+    batchFree(&batch);
+    free(packed);
+    return result;
+}
+
+
+static enum error sweepTesting(const sweepTest_t testData[], int testSize) {
+    enum error result = GOOD_EXIT;
+    for (int testIndex = 0; testIndex < testSize && result == GOOD_EXIT; testIndex++) {
+        const sweepTest_t *test = &testData[testIndex];
+        enum sweepCoefficient coefficient = SWEEP_C;
+        double start = 0, stop = 0, step = 0;
+        sweep_t sweep = BLANK_SWEEP;
+        if (parseSweep(test->range, &coefficient, &start, &stop, &step) != GOOD_EXIT ||
+            sweepInit(&sweep, &test->base, coefficient, start, stop, step, test->complex) != GOOD_EXIT ||
+            sweep.count != test->count) {
+            fprintf(stderr, RED_BKG "UNIT TESTING FAILED on sweep test %d:" RESET_C " %zu points instead of %zu\n",
+                    testIndex + 1, sweep.count, test->count);
+            return BAD_EXIT;
+        }
+
+        quadraticBatch_t batch = BLANK_BATCH;
+        PROPAGATE_ERROR(batchAlloc(&batch, sweep.count));
+        for (int pass = 0; pass < 2 * KERNEL_TYPES_COUNT && result == GOOD_EXIT; pass++) {
+            const enum kernelType type = (enum kernelType) (pass / 2);
+            if (!getKernelByType(type)) continue;
+
+            const size_t piece = (pass % 2) ? SWEEP_TEST_PIECE : sweep.count;
+            for (size_t first = 0; first < sweep.count; first += piece) {
+                const size_t size = (sweep.count - first > piece) ? piece : sweep.count - first;
+                solveSweepByType(&sweep, type, first, size, batch.a + first, batch.code + first,
+                                 batch.x1 + first, batch.x2 + first);
+            }
+
+            for (size_t i = 0; i < sweep.count && result == GOOD_EXIT; i++) {
+                const double value = start + (double) i * step;
+                quadraticEquation_t equation = test->base;
+                equation.answer = BLANK_SOLUTION;
+                if (coefficient == SWEEP_A)      equation.a = value;
+                else if (coefficient == SWEEP_B) equation.b = value;
+                else                             equation.c = value;
+                if (test->complex) solveEquationComplex(&equation);
+                else               solveEquation(&equation);
+
+                solution_t expected = equation.answer;
+                if (expected.code == TWO_ROOTS && expected.x1 > expected.x2)
+                    swap(&expected.x1, &expected.x2, sizeof(expected.x1));
+                const solution_t answer = {batch.code[i], batch.x1[i], batch.x2[i]};
+                if (memcmp(&batch.a[i], &value, sizeof(value)) == 0 && answerMatches(answer, expected)) continue;
+
+                fprintf(stderr, RED_BKG "UNIT TESTING FAILED on sweep test %d, point %zu with %s kernel:" RESET_C
+                        " value %lg, code %d, x1 = %lg, x2 = %lg\n", testIndex + 1, i, kernelName(type),
+                        batch.a[i], answer.code, answer.x1, answer.x2);
+                result = BAD_EXIT;
+            }
+        }
+        batchFree(&batch);
+    }
+    return result;
+}
+
+
+static enum error planeTesting(const planeTest_t testData[], int testSize) {
+    enum error result = GOOD_EXIT;
+    for (int testIndex = 0; testIndex < testSize && result == GOOD_EXIT; testIndex++) {
+        const planeTest_t *test = &testData[testIndex];
+        plane_t plane = BLANK_PLANE;
+        if (planeInit(&plane, &test->base, test->description, test->complex) != GOOD_EXIT ||
+            plane.columns.count != test->width || plane.rows.count != test->height) {
+            fprintf(stderr, RED_BKG "UNIT TESTING FAILED on plane test %d:" RESET_C " %zu x %zu points instead of %zu x %zu\n",
+                    testIndex + 1, plane.columns.count, plane.rows.count, test->width, test->height);
+            return BAD_EXIT;
+        }
+
+        quadraticBatch_t batch = BLANK_BATCH;
+        PROPAGATE_ERROR(batchAlloc(&batch, PLANE_TEST_PIECE));
+        for (int type = 0; type < KERNEL_TYPES_COUNT && result == GOOD_EXIT; type++) {
+            if (!getKernelByType((enum kernelType) type)) continue;
+
+            for (size_t row = 0; row < plane.rows.count && result == GOOD_EXIT; row++) {
+                for (size_t first = 0; first < plane.columns.count && result == GOOD_EXIT; first += PLANE_TEST_PIECE) {
+                    const size_t size = (plane.columns.count - first > PLANE_TEST_PIECE) ? PLANE_TEST_PIECE
+                                                                                        : plane.columns.count - first;
+                    classifyPlaneRowByType(&plane, (enum kernelType) type, row, first, size, &batch);
+
+                    for (size_t i = 0; i < size && result == GOOD_EXIT; i++) {
+                        const double values[] = {sweepValue(&plane.columns, first + i), sweepValue(&plane.rows, row)};
+                        const enum sweepCoefficient coefficients[] = {plane.columns.coefficient, plane.rows.coefficient};
+                        quadraticEquation_t equation = test->base;
+                        equation.answer = BLANK_SOLUTION;
+                        for (int axis = 0; axis < 2; axis++) {
+                            if (coefficients[axis] == SWEEP_A)      equation.a = values[axis];
+                            else if (coefficients[axis] == SWEEP_B) equation.b = values[axis];
+                            else                                    equation.c = values[axis];
+                        }
+                        if (test->complex) solveEquationComplex(&equation);
+                        else               solveEquation(&equation);
+                        if (batch.code[i] == equation.answer.code) continue;
+
+                        fprintf(stderr, RED_BKG "UNIT TESTING FAILED on plane test %d, point (%zu, %zu) with %s kernel:" RESET_C
+                                " code %d instead of %d\n", testIndex + 1, first + i, row, kernelName((enum kernelType) type),
+                                batch.code[i], equation.answer.code);
+                        result = BAD_EXIT;
+                    }
+                }
+            }
+        }
+        batchFree(&batch);
+    }
+    return result;
+}
+
+
+#ifdef __linux__
+static void runTestServer(serverTest_t *test) {
+    test->result = serveSolver(test->path, &test->options, &test->stats);
+}
+
+
+static int connectTestServer(const char path[]) {
+    struct sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+    const struct timespec pause = {0, 1000000};
+    for (int waited = 0; waited < SERVER_TEST_TIMEOUT_MS; waited++) {
+        const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, (const struct sockaddr*) &address, sizeof(address)) == 0) return fd;
+        close(fd);
+        nanosleep(&pause, NULL);
+    }
+    return -1;
+}
+
+
+static enum error sendTestBytes(int fd, const void *data, size_t size) {
+    for (size_t sent = 0; sent < size;) {
+        const ssize_t part = send(fd, (const char*) data + sent, size - sent, MSG_NOSIGNAL);
+        if (part < 0 && errno == EINTR) continue;
+        if (part <= 0) return FAIL;
+        sent += (size_t) part;
+    }
+    return GOOD_EXIT;
+}
+
+
+static enum error receiveTestBytes(int fd, void *data, size_t size) {
+    for (size_t received = 0; received < size;) {
+        struct pollfd wait = {fd, POLLIN, 0};
+        if (poll(&wait, 1, SERVER_TEST_TIMEOUT_MS) <= 0) return FAIL;
+        const ssize_t part = recv(fd, (char*) data + received, size - received, 0);
+        if (part < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+        if (part <= 0) return FAIL;
+        received += (size_t) part;
+    }
+    return GOOD_EXIT;
+}
+
+
+static void fillTestRows(size_t count, double a[], double b[], double c[]) {
+    for (size_t i = 0; i < count; i++) {
+        a[i] = (double) (i % 3) - 1;
+        b[i] = (double) (i % 7) - 3;
+        c[i] = (double) (i % 5) - 2;
+    }
+}
+
+
+static size_t putSolveFrame(char *buffer, size_t rows, uint64_t id) {
+    const serverFrameHeader_t header = {(uint32_t) (rows * 3 * sizeof(double)), SERVER_SOLVE, 0, id};
+    memcpy(buffer, &header, sizeof(header));
+    double *a = (double*) (buffer + sizeof(header));
+    fillTestRows(rows, a, a + rows, a + 2 * rows);
+    return sizeof(header) + header.size;
+}
+
+
+static enum error checkTestReply(int fd, uint64_t id, uint16_t type, enum serverStatus status, size_t rows) {
+    serverFrameHeader_t header = {};
+    if (receiveTestBytes(fd, &header, sizeof(header)) != GOOD_EXIT) {
+        fprintf(stderr, RED_BKG "UNIT TESTING FAILED: server didn't answer request %llu" RESET_C "\n",
+                (unsigned long long) id);
+        return BAD_EXIT;
+    }
+    size_t size = 0;
+    if (status == SERVER_OK && type == SERVER_SOLVE)
+        size = (rows * (2 * sizeof(double) + sizeof(int32_t)) + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+    else if (status == SERVER_OK)
+        size = sizeof(serverStats_t);
+    if (header.id != id || header.type != type || header.status != status || header.size != size) {
+        fprintf(stderr, RED_BKG "UNIT TESTING FAILED: reply to request %llu:" RESET_C " id %llu, type %u, status %u,"
+                " size %u instead of type %u, status %d, size %zu\n", (unsigned long long) id,
+                (unsigned long long) header.id, (unsigned) header.type, (unsigned) header.status, (unsigned) header.size,
+                type, status, size);
+        return BAD_EXIT;
+    }
+
+    char *payload = (char*) calloc(size + 1, 1);
+    if (!payload) return FAIL;
+    enum error result = receiveTestBytes(fd, payload, size);
+    if (result == GOOD_EXIT && status == SERVER_OK && type == SERVER_SOLVE) {
+        double a[SERVER_TEST_ROWS] = {}, b[SERVER_TEST_ROWS] = {}, c[SERVER_TEST_ROWS] = {};
+        fillTestRows(rows, a, b, c);
+        const double *x1 = (const double*) payload, *x2 = x1 + rows;
+        const int32_t *code = (const int32_t*) (x2 + rows);
+        for (size_t i = 0; i < rows && result == GOOD_EXIT; i++) {
+            quadraticEquation_t equation = {a[i], b[i], c[i], BLANK_SOLUTION};
+            solveEquation(&equation);
+            //answerMatches() sorts only given roots
+            if (equation.answer.code == TWO_ROOTS && equation.answer.x1 > equation.answer.x2)
+                swap(&equation.answer.x1, &equation.answer.x2, sizeof(equation.answer.x1));
+            if (answerMatches({(enum solutionCode) code[i], x1[i], x2[i]}, equation.answer)) continue;
+
+            fprintf(stderr, RED_BKG "UNIT TESTING FAILED on row %zu of request %llu:" RESET_C
+                    " code %d, x1 = %lg, x2 = %lg\n", i, (unsigned long long) id, code[i], x1[i], x2[i]);
+            result = BAD_EXIT;
+        }
+    } else if (result == GOOD_EXIT && status == SERVER_OK && type == SERVER_STATS) {
+        serverStats_t stats = {};
+        memcpy(&stats, payload, sizeof(stats));
+        if (stats.requests != 2 || stats.equations != 2 * SERVER_TEST_ROWS || stats.clients != 1) {
+            fprintf(stderr, RED_BKG "UNIT TESTING FAILED: server stats:" RESET_C " %llu requests, %llu equations,"
+                    " %llu clients\n", (unsigned long long) stats.requests, (unsigned long long) stats.equations,
+                    (unsigned long long) stats.clients);
+            result = BAD_EXIT;
+        }
+    }
+    free(payload);
+    return result;
+}
+
+
+static enum error floodTestServer(int fd) {
+    const size_t replySize = sizeof(serverFrameHeader_t) + SERVER_FLOOD_ROWS * (2 * sizeof(double) + sizeof(int32_t));
+    char *request = (char*) calloc(sizeof(serverFrameHeader_t) + SERVER_FLOOD_ROWS * 3 * sizeof(double), 1);
+    char *reply = (char*) calloc(replySize, 1);
+    if (!request || !reply) {
+        free(request);
+        free(reply);
+        return FAIL;
+    }
+    const size_t requestSize = putSolveFrame(request, SERVER_FLOOD_ROWS, 0);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    //requests are sent until socket stays full, id of request is it's number
+    size_t requests = 0, requestSent = 0, written = 0;
+    int stalled = 0;
+    enum error result = GOOD_EXIT;
+    while (!stalled && written < SERVER_FLOOD_LIMIT) {
+        const ssize_t part = send(fd, request + requestSent, requestSize - requestSent, MSG_NOSIGNAL);
+        if (part > 0) {
+            //request is counted by it's first sent byte, id of the next one is written after the last byte
+            if (requestSent == 0) requests++;
+            requestSent = (requestSent + (size_t) part) % requestSize;
+            written += (size_t) part;
+            if (requestSent == 0) {
+                serverFrameHeader_t header = {};
+                memcpy(&header, request, sizeof(header));
+                header.id = requests;
+                memcpy(request, &header, sizeof(header));
+            }
+        } else if (part < 0 && errno == EAGAIN) {
+            struct pollfd wait = {fd, POLLOUT, 0};
+            stalled = poll(&wait, 1, SERVER_STALL_MS) == 0;
+        } else if (part < 0 && errno != EINTR) {
+            result = FAIL;
+            break;
+        }
+    }
+    if (result == GOOD_EXIT && !stalled) {
+        fprintf(stderr, RED_BKG "UNIT TESTING FAILED: server read %zu bytes of requests without taking replies"
+                RESET_C "\n", written);
+        result = BAD_EXIT;
+    }
+
+    //the last request is finished while replies are taken, replies must come in order
+    size_t replies = 0, replyFilled = 0;
+    while (result == GOOD_EXIT && replies < requests) {
+        struct pollfd wait = {fd, (short) (POLLIN | ((requestSent > 0) ? POLLOUT : 0)), 0};
+        if (poll(&wait, 1, SERVER_TEST_TIMEOUT_MS) <= 0) {
+            fprintf(stderr, RED_BKG "UNIT TESTING FAILED: server answered %zu of %zu requests" RESET_C "\n",
+                    replies, requests);
+            result = BAD_EXIT;
+            break;
+        }
+        if ((wait.revents & POLLOUT) && requestSent > 0) {
+            const ssize_t part = send(fd, request + requestSent, requestSize - requestSent, MSG_NOSIGNAL);
+            if (part > 0) requestSent = (requestSent + (size_t) part) % requestSize;
+        }
+        if (!(wait.revents & POLLIN)) continue;
+
+        const ssize_t part = recv(fd, reply + replyFilled, replySize - replyFilled, 0);
+        if (part <= 0) {
+            if (part < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+            result = FAIL;
+            break;
+        }
+        replyFilled += (size_t) part;
+        if (replyFilled < replySize) continue;
+
+        serverFrameHeader_t header = {};
+        memcpy(&header, reply, sizeof(header));
+        if (header.id != replies || header.status != SERVER_OK || header.size != replySize - sizeof(header)) {
+            fprintf(stderr, RED_BKG "UNIT TESTING FAILED: reply %zu of flood has id %llu, status %u, size %u"
+                    RESET_C "\n", replies, (unsigned long long) header.id, (unsigned) header.status,
+                    (unsigned) header.size);
+            result = BAD_EXIT;
+        }
+        replies++;
+        replyFilled = 0;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    free(request);
+    free(reply);
+    return result;
+}
+
+
+static enum error serverTesting() {
+    serverTest_t *test = (serverTest_t*) calloc(1, sizeof(serverTest_t));
+    if (!test) return FAIL;
+    snprintf(test->path, sizeof(test->path), "/tmp/kvadratka-test-%d.sock", (int) getpid());
+    test->options = DEFAULT_BATCH_OPTIONS;
+    test->options.silent = 1;
+    test->result = FAIL;
+    std::thread server(runTestServer, test);
+
+    const int fd = connectTestServer(test->path);
+    enum error result = (fd >= 0) ? GOOD_EXIT : FAIL;
+    const size_t frameSize = sizeof(serverFrameHeader_t) + SERVER_TEST_ROWS * 3 * sizeof(double);
+    char frames[3 * (sizeof(serverFrameHeader_t) + SERVER_TEST_ROWS * 3 * sizeof(double))] = {};
+    const struct timespec pause = {0, 5000000};
+
+    //frame split inside header and payload is read by pieces
+    if (result == GOOD_EXIT) {
+        putSolveFrame(frames, SERVER_TEST_ROWS, 1);
+        const size_t pieces[] = {3, sizeof(serverFrameHeader_t), frameSize - 5, frameSize};
+        for (size_t piece = 0, sent = 0; piece < sizeof(pieces) / sizeof(pieces[0]) && result == GOOD_EXIT; piece++) {
+            result = sendTestBytes(fd, frames + sent, pieces[piece] - sent);
+            sent = pieces[piece];
+            nanosleep(&pause, NULL);
+        }
+        if (result == GOOD_EXIT) result = checkTestReply(fd, 1, SERVER_SOLVE, SERVER_OK, SERVER_TEST_ROWS);
+    }
+    //frames sent together are answered in order
+    if (result == GOOD_EXIT) {
+        size_t size = putSolveFrame(frames, SERVER_TEST_ROWS, 2);
+        const serverFrameHeader_t stats = {0, SERVER_STATS, 0, 3};
+        memcpy(frames + size, &stats, sizeof(stats));
+        size += sizeof(stats);
+        result = sendTestBytes(fd, frames, size);
+        if (result == GOOD_EXIT) result = checkTestReply(fd, 2, SERVER_SOLVE, SERVER_OK, SERVER_TEST_ROWS);
+        if (result == GOOD_EXIT) result = checkTestReply(fd, 3, SERVER_STATS, SERVER_OK, 0);
+    }
+    //bad frames are answered with status, the next frame after payload of odd size is still read
+    if (result == GOOD_EXIT) {
+        const serverFrameHeader_t badSolve = {23, SERVER_SOLVE, 0, 4}, badStats = {8, SERVER_STATS, 0, 5};
+        const serverFrameHeader_t badType = {0, 9, 0, 6};
+        size_t size = 0;
+        memcpy(frames + size, &badSolve, sizeof(badSolve));
+        size += sizeof(badSolve) + badSolve.size;
+        memcpy(frames + size, &badStats, sizeof(badStats));
+        size += sizeof(badStats) + badStats.size;
+        memcpy(frames + size, &badType, sizeof(badType));
+        size += sizeof(badType);
+        size += putSolveFrame(frames + size, SERVER_TEST_ROWS, 7);
+        result = sendTestBytes(fd, frames, size);
+        if (result == GOOD_EXIT) result = checkTestReply(fd, 4, SERVER_SOLVE, SERVER_BAD_SIZE, 0);
+        if (result == GOOD_EXIT) result = checkTestReply(fd, 5, SERVER_STATS, SERVER_BAD_SIZE, 0);
+        if (result == GOOD_EXIT) result = checkTestReply(fd, 6, 9, SERVER_BAD_TYPE, 0);
+        if (result == GOOD_EXIT) result = checkTestReply(fd, 7, SERVER_SOLVE, SERVER_OK, SERVER_TEST_ROWS);
+    }
+    if (result == GOOD_EXIT)
+        result = floodTestServer(fd);
+
+    if (fd >= 0) close(fd);
+    pthread_kill(server.native_handle(), SIGTERM);
+    server.join();
+    if (result == GOOD_EXIT && test->result != GOOD_EXIT) {
+        fprintf(stderr, RED_BKG "UNIT TESTING FAILED: server stopped with error" RESET_C "\n");
+        result = BAD_EXIT;
+    }
+    free(test);
+    return result;
+}
+#endif
+
+
+static enum error polyUnitTesting(const polyTest_t testData[], int testSize, int silent) {
+    for (int testIndex = 0; testIndex < testSize; testIndex++) {
+        if (runPolyTest(testData[testIndex]) != GOOD_EXIT) {
+            fprintf(stderr, RED_BKG "UNIT TESTING FAILED on polynomial test %d" RESET_C "\n", testIndex + 1);
+            return BAD_EXIT;
+        }
+        else if (!silent) {
+            fprintf(stderr, GREEN_BKG "Test #%d passed" RESET_C "\n", testIndex+1);
+        }
+    }
+    return GOOD_EXIT;
+}
+
+
 enum error unitTestingInternal(int silent) {
     #ifndef TEST_DATA_INCLUDED
             fprintf(stderr, "Include test data\n");
             return FAIL;
     #endif
-    return unitTesting(internalTestData, internalTestSize, silent);
+    PROPAGATE_ERROR(unitTesting(internalTestData, internalTestSize, silent, runTest));
+    PROPAGATE_ERROR(realKernelsTesting(internalTestData, internalTestSize));
+
+    //precise solver must pass the same tests and ill-conditioned ones
+    if (!silent)
+        fprintf(stderr, "Precise solver:\n");
+    PROPAGATE_ERROR(unitTesting(internalTestData, internalTestSize, silent, runTestPrecise));
+    PROPAGATE_ERROR(unitTesting(preciseTestData, preciseTestSize, silent, runTestPrecise));
+
+    if (!silent)
+        fprintf(stderr, "Complex roots:\n");
+    PROPAGATE_ERROR(unitTesting(complexTestData, complexTestSize, silent, runTestComplex));
+    PROPAGATE_ERROR(complexKernelsTesting(complexTestData, complexTestSize));
+
+    //codes of classify mode must be the same as codes of full solver
+    if (!silent)
+        fprintf(stderr, "Classify mode:\n");
+    PROPAGATE_ERROR(unitTesting(internalTestData, internalTestSize, silent, runTestClassify));
+    PROPAGATE_ERROR(classifyKernelsTesting(internalTestData, internalTestSize));
+
+    if (!silent)
+        fprintf(stderr, "Sweeps:\n");
+    PROPAGATE_ERROR(sweepTesting(sweepTestData, sweepTestSize));
+
+    if (!silent)
+        fprintf(stderr, "Plane maps:\n");
+    PROPAGATE_ERROR(planeTesting(planeTestData, planeTestSize));
+
+#ifdef __linux__
+    if (!silent)
+        fprintf(stderr, "Socket protocol:\n");
+    PROPAGATE_ERROR(serverTesting());
+#endif
+
+    if (!silent)
+        fprintf(stderr, "Polynomial solver:\n");
+    PROPAGATE_ERROR(polyUnitTesting(polynomialTestData, polynomialTestSize, silent));
+
+    //the first pass fills cache, the second one must get the same answers from it
+    if (!silent)
+        fprintf(stderr, "Cached solver:\n");
+    testCache = resultCacheCreate(TEST_CACHE_CAPACITY, 1);
+    if (!testCache) return FAIL;
+    enum error result = unitTesting(internalTestData, internalTestSize, silent, runTestCached);
+    if (result == GOOD_EXIT)
+        result = unitTesting(internalTestData, internalTestSize, silent, runTestCached);
+
+    const cacheStats_t stats = resultCacheStats(testCache);
+    resultCacheDestroy(testCache);
+    testCache = NULL;
+    if (result == GOOD_EXIT && stats.hits != internalTestSize) {
+        fprintf(stderr, RED "Cache had %zu hits instead of %u\n" RESET_C, stats.hits, internalTestSize);
+        return BAD_EXIT;
+    }
+    return result;
 }
 
 
 enum error unitTestingFile(const char name[], int silent) {
-    FILE* testsF = fopen(name, "r");
-    if (!testsF) {
-        fprintf(stderr, "Can't read file \"%s\"\n", name);
+    mappedFile_t testsFile = BLANK_MAPPED_FILE;
+    if (mapFile(name, &testsFile) != GOOD_EXIT)
         return FAIL;
-    }
 
+    unitTest_t *testData = NULL;
     int testCount = 0;
-    if (fscanf(testsF, " %d ", &testCount) != 1) {
+    enum error parseResult = parseUnitTests(testsFile.data, testsFile.size, &testData, &testCount);
+    unmapFile(&testsFile);
+    if (parseResult != GOOD_EXIT)
+        return parseResult;
+
+    if (unitTesting(testData, testCount, silent, runTest) != GOOD_EXIT) {
+        free(testData);
+        return BAD_EXIT;
+    }
+    free(testData);
+
+    return GOOD_EXIT;
+
+}
+
+
+enum error parseUnitTests(const char *text, size_t size, unitTest_t **tests, int *testCount) {
+    MY_ASSERT(tests, return FAIL);
+    MY_ASSERT(testCount, return FAIL);
+    MY_ASSERT(text || size == 0, return FAIL);
+    *tests = NULL;
+    *testCount = 0;
+
+    const size_t MAX_LEN = 100;
+    char word[MAX_LEN] = {};
+    const char *pos = text, *end = text + size;
+    size_t line = 1;
+
+    long count = 0;
+    char *countEnd = NULL;
+    if (scanWordFromBuffer(&pos, end, word, MAX_LEN, &line) == GOOD_EXIT)
+        count = strtol(word, &countEnd, 10);
+    if (!countEnd || *countEnd != '\0' || count < 0 || count > INT_MAX) {
         fprintf(stderr, "Can't read number of tests\n");
-        fclose(testsF);
         return BAD_EXIT;
-    };
+    }
 
-    unitTest_t *testData = (unitTest_t*) calloc(testCount, sizeof(unitTest_t));
+    unitTest_t *testData = (unitTest_t*) calloc((size_t) count + 1, sizeof(unitTest_t));
     if (!testData) {
         fprintf(stderr, RED "Can't allocate memory for tests\n" RESET_C);
-        fclose(testsF);
         return FAIL;
     }
 
-    for (int i = 0; i < testCount; i++) {
-        if (readUnitTest(testsF, testData+i) != GOOD_EXIT) {
-            fclose(testsF);
-            return BAD_EXIT;
-        }
-    }
-    fclose(testsF);
+    for (int testIndex = 0; testIndex < count; testIndex++) {
+        unitTest_t *test = testData + testIndex;
+        double *numbers[] = {&test->inputData.a, &test->inputData.b, &test->inputData.c,
+                             NULL, &test->expectedData.x1, &test->expectedData.x2};
+        *test = BLANK_TEST;
 
-    if (unitTesting(testData, testCount, silent) != GOOD_EXIT) {
-        free(testData);
-        return BAD_EXIT;
+        for (size_t field = 0; field < sizeof(numbers) / sizeof(numbers[0]); field++) {
+            enum error scanResult = scanWordFromBuffer(&pos, end, word, MAX_LEN, &line);
+            if (scanResult == GOOD_EXIT) {
+                if (numbers[field]) {
+                    char *numberEnd = NULL;
+                    *numbers[field] = strtod(word, &numberEnd);
+                    if (*numberEnd != '\0') scanResult = BAD_EXIT;
+                } else if (parseSolutionCode(word, &test->expectedData.code) != GOOD_EXIT) {
+                    fprintf(stderr, "Can't parse solutionCode enum\n");
+                    scanResult = BAD_EXIT;
+                }
+            }
+
+            if (scanResult != GOOD_EXIT) {
+                fprintf(stderr, "Can't read test #%d: line %zu\n", testIndex + 1, line);
+                free(testData);
+                return BAD_EXIT;
+            }
+        }
     }
-    free(testData);
 
+    *tests = testData;
+    *testCount = (int) count;
     return GOOD_EXIT;
-
 }
 
 
@@ -109,9 +1020,10 @@ enum error readUnitTest(FILE* testsF, unitTest_t* test) {
 
 enum error parseSolutionCode(const char solutionStr[], enum solutionCode* code) {
     int tempCode = 0;
-    const int ENUM_SIZE = 6;
+    const int ENUM_SIZE = 9;
     const char *literals[ENUM_SIZE] = \
-        {"BLANK_ROOT", "ZERO_ROOTS", "ONE_ROOT", "TWO_ROOTS", "INF_ROOTS", "BAD_INPUT"};
+        {"BLANK_ROOT", "ZERO_ROOTS", "ONE_ROOT", "TWO_ROOTS", "INF_ROOTS", "BAD_INPUT", "THREE_ROOTS", "FOUR_ROOTS",
+         "COMPLEX_ROOTS"};
 
     if (sscanf(solutionStr, " %d ", &tempCode) == 1) {
         *code = (enum solutionCode) tempCode;
@@ -131,47 +1043,114 @@ enum error parseSolutionCode(const char solutionStr[], enum solutionCode* code)
 
 enum error runTest(unitTest_t test) {
     solveEquation(&test.inputData);
+    return checkTestAnswer(test);
+}
+
+
+enum error runTestPrecise(unitTest_t test) {
+    solveEquationPrecise(&test.inputData, NULL);
+    return checkTestAnswer(test);
+}
+
+
+enum error runTestComplex(unitTest_t test) {
+    solveEquationComplex(&test.inputData);
+    return checkTestAnswer(test);
+}
+
+
+enum error runTestClassify(unitTest_t test) {
+    classifyEquation(&test.inputData);
+    if (test.inputData.answer.code == test.expectedData.code)
+        return GOOD_EXIT;
+
+    printKvadr(&test.inputData, PRETTY_NUMBERS); //print equation
+    fprintf(stderr, RED_BKG "Exit code doesn't match: " GREEN_BKG "expected %d, " CYAN_BKG "got %d" RESET_C "\n",
+            test.expectedData.code, test.inputData.answer.code);
+    return BAD_EXIT;
+}
+
+
+enum error runTestCached(unitTest_t test) {
+    MY_ASSERT(testCache, return FAIL);
+    solveEquationCached(testCache, &test.inputData);
+    return checkTestAnswer(test);
+}
+
+
+enum error runPolyTest(polyTest_t test) {
+    solvePolynomial(&test.inputData);
+    const polySolution_t result = test.inputData.answer, expected = test.expectedData;
+
+    int rootsMatch = (result.code == expected.code);
+    for (int i = 0; i < MAX_DEGREE && rootsMatch; i++) {
+        if (!isnan(expected.roots[i]) || !isnan(result.roots[i])) { //big roots are compared relatively
+            const double size = fmax(1, fabs(expected.roots[i]));
+            rootsMatch = (cmpDouble(result.roots[i] / size, expected.roots[i] / size) == 0);
+        }
+    }
+    if (rootsMatch) return GOOD_EXIT;
+
+    fprintf(stderr, RED_BKG "Polynomial of degree %d:" RESET_C, test.inputData.degree);
+    for (int i = 0; i <= test.inputData.degree; i++)
+        fprintf(stderr, " %lg", test.inputData.coeffs[i]);
+    fprintf(stderr, "\n" GREEN_BKG "expected code %d, roots %lg %lg %lg %lg" RESET_C "\n"
+            CYAN_BKG "got code %d, roots %lg %lg %lg %lg" RESET_C "\n",
+            expected.code, expected.roots[0], expected.roots[1], expected.roots[2], expected.roots[3],
+            result.code, result.roots[0], result.roots[1], result.roots[2], result.roots[3]);
+    return BAD_EXIT;
+}
+
+
+int answerMatches(solution_t result, solution_t expected) {
+    if (result.code != expected.code) return 0;
+    switch (result.code) {
+        case INF_ROOTS:
+        case BLANK_ROOT:
+        case BAD_INPUT:
+        case ZERO_ROOTS:
+            return 1;
+        case ONE_ROOT:
+            return cmpDouble(result.x1, expected.x1) == 0;
+        case TWO_ROOTS:
+            if (result.x1 > result.x2)
+                swap(&result.x1, &result.x2, sizeof(result.x1));
+            return cmpDouble(result.x1, expected.x1) == 0 && cmpDouble(result.x2, expected.x2) == 0;
+        case COMPLEX_ROOTS: //real and imaginary parts aren't sorted
+            return cmpDouble(result.x1, expected.x1) == 0 && cmpDouble(result.x2, expected.x2) == 0;
+        case THREE_ROOTS:
+        case FOUR_ROOTS:
+        default:
+            return 0;
+    }
+}
+
+
+static enum error checkTestAnswer(unitTest_t test) {
     solution_t result = test.inputData.answer;
+    if (answerMatches(result, test.expectedData))
+        return GOOD_EXIT;
 
     if (result.code != test.expectedData.code) { //checking exit code first
-        printKvadr(&test.inputData); //print equation
+        printKvadr(&test.inputData, PRETTY_NUMBERS); //print equation
         fprintf(stderr, RED_BKG "Exit code doesn't match: " GREEN_BKG "expected %d, " CYAN_BKG "got %d" RESET_C "\n",
                 test.expectedData.code, result.code);
-        return BAD_EXIT;
-    } else {
-        switch (result.code) {
-            case INF_ROOTS:
-            case BLANK_ROOT:
-            case BAD_INPUT:
-            case ZERO_ROOTS:
-                return GOOD_EXIT;
-            case ONE_ROOT:
-                if(cmpDouble(result.x1, test.expectedData.x1) != 0) {
-                    printKvadr(&test.inputData); //print equation
-                    fprintf(stderr, RED_BKG "Answers doesn't match: " RESET_C "\n" GREEN_BKG
-                    "expected x = %lg," RESET_C "\n" CYAN_BKG
-                    "     got x = %lg" RESET_C "\n",
-                    test.expectedData.x1, result.x1);
-                    return BAD_EXIT;
-                } else
-                    return GOOD_EXIT;
-            case TWO_ROOTS:
-                if (result.x1 > result.x2)
-                    swap(&result.x1, &result.x2, sizeof(result.x1));
-                if (cmpDouble(result.x1, test.expectedData.x1) != 0 || cmpDouble(result.x2, test.expectedData.x2) != 0) {
-                    printKvadr(&test.inputData); //print equation
-                    fprintf(stderr, RED_BKG "Answers doesn't match: " RESET_C "\n" GREEN_BKG
-                    "expected x1 = %lg, x2 = %lg" RESET_C "\n" RED_BKG
-                    "Got      x1 = %lg, x2 = %lg" RESET_C "\n",
-                            test.expectedData.x1, test.expectedData.x2, result.x1, result.x2);
-                    return BAD_EXIT;
-                } else
-                    return GOOD_EXIT;
-            default:
-                return BAD_EXIT;
-        }
+    } else if (result.code == ONE_ROOT) {
+        printKvadr(&test.inputData, PRETTY_NUMBERS); //print equation
+        fprintf(stderr, RED_BKG "Answers doesn't match: " RESET_C "\n" GREEN_BKG
+        "expected x = %lg," RESET_C "\n" CYAN_BKG
+        "     got x = %lg" RESET_C "\n",
+        test.expectedData.x1, result.x1);
+    } else if (result.code == TWO_ROOTS) {
+        if (result.x1 > result.x2)
+            swap(&result.x1, &result.x2, sizeof(result.x1));
+        printKvadr(&test.inputData, PRETTY_NUMBERS); //print equation
+        fprintf(stderr, RED_BKG "Answers doesn't match: " RESET_C "\n" GREEN_BKG
+        "expected x1 = %lg, x2 = %lg" RESET_C "\n" RED_BKG
+        "Got      x1 = %lg, x2 = %lg" RESET_C "\n",
+                test.expectedData.x1, test.expectedData.x2, result.x1, result.x2);
     }
-    return STRANGE_EXIT;
+    return BAD_EXIT;
 }
 
 
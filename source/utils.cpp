@@ -1,5 +1,10 @@
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 #include <cstdint>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 #include "utils.h"
 
 int cmpDouble(const double a, const double b) {
@@ -14,7 +19,8 @@ int isZero(const double a) {
 }
 
 int myIsInf(const double a) {
-    uint64_t binA = *((const uint64_t *)  &a);
+    uint64_t binA = 0;
+    memcpy(&binA, &a, sizeof(binA)); //cast of pointer would break strict aliasing, memcpy is optimized to one move
     const int k = 11, n = 64, m = n - k -1;
     //double: sign  exponent mantissa
     //bits    1     k = 11   m = 52
@@ -30,7 +36,8 @@ int myIsInf(const double a) {
 
 
 int myIsNan(const double a) {
-    uint64_t binA = *((const uint64_t *) &a);
+    uint64_t binA = 0;
+    memcpy(&binA, &a, sizeof(binA));
     const int k = 11, n = 64, m = n - k -1;
     //double: sign  exponent mantissa
     //bits    1     k = 11   m = 52
@@ -45,6 +52,26 @@ int myIsNan(const double a) {
 }
 
 
+uint64_t hashCoeffBits(double a, double b, double c) {
+    uint64_t bitsA = 0, bitsB = 0, bitsC = 0;
+    memcpy(&bitsA, &a, sizeof(bitsA));
+    memcpy(&bitsB, &b, sizeof(bitsB));
+    memcpy(&bitsC, &c, sizeof(bitsC));
+
+    //multiply-rotate of every word, then finalizer of MurmurHash3
+    uint64_t hash = bitsA * 0x9E3779B97F4A7C15ULL;
+    hash = ((hash << 31) | (hash >> 33)) ^ (bitsB * 0xC2B2AE3D27D4EB4FULL);
+    hash = ((hash << 31) | (hash >> 33)) ^ (bitsC * 0x165667B19E3779F9ULL);
+
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+
 void swap(void *a, void *b, size_t size) {
     char *ac = (char*) a, *bc = (char*) b;
     char c = 0;
@@ -59,3 +86,26 @@ void swap(void *a, void *b, size_t size) {
 double fixMinusZero(const double num) {
     return (isZero(num)) ? fabs(num) : num;
 }
+
+
+void *alignedCalloc(size_t alignment, size_t size) {
+    //aligned_alloc requires size to be multiple of alignment
+    size_t alignedSize = (size + alignment - 1) / alignment * alignment;
+    if (alignedSize == 0) alignedSize = alignment;
+#ifdef _WIN32
+    void *ptr = _aligned_malloc(alignedSize, alignment);
+#else
+    void *ptr = aligned_alloc(alignment, alignedSize);
+#endif
+    if (ptr) memset(ptr, 0, alignedSize);
+    return ptr;
+}
+
+
+void alignedFree(void *ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}